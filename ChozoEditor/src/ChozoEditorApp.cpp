@@ -7,7 +7,7 @@ namespace Chozo {
     {
     public:
         ChozoEditor()
-            : Application("Chozo Editor")
+            : Application("Chozo Editor", ThreadingPolicy::MultiThreaded)
         {
             CZ_INFO("Welcome to Chozo Editor!");
             PushLayer(new EditorLayer());
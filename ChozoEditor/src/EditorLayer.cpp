@@ -166,6 +166,7 @@ namespace Chozo {
         m_EnvironmentPanel.OnImGuiRender();
         m_MaterialPanel.OnImGuiRender();
         m_TextureViewerPanel.OnImGuiRender();
+        m_TextureStreamingPanel.OnImGuiRender();
 
         // --------------------
         // Settings panel
@@ -182,6 +183,19 @@ namespace Chozo {
         // ImGui::Text("Lines: %d", Renderer2D::GetStats().LineCount);
         ImGui::Text("Triangles: %d", Renderer::GetStats().GetTotalTrianglesCount());
         ImGui::Text("Vertices: %d", Renderer::GetStats().GetTotalVerticesCount());
+        ImGui::Text("Culled meshlets: %d", Renderer::GetStats().CulledMeshlets);
+        ImGui::Text("State calls: %d issued, %d filtered", Renderer::GetStats().IssuedStateCalls, Renderer::GetStats().FilteredStateCalls);
+        ImGui::Text("Texture uploads: %.2f MB (%d pending)", (float)Renderer::GetStats().UploadedTextureBytes / (1024.0f * 1024.0f), Renderer::GetStats().PendingTextureUploads);
+        ImGui::Checkbox("Async texture uploads", &Renderer::GetConfig().EnableAsyncTextureUploads);
+        ImGui::Checkbox("Depth pre-pass", &Renderer::GetConfig().EnableDepthPrePass);
+        bool overdraw = m_ViewportRenderer->IsOverdrawVisualization();
+        if (ImGui::Checkbox("Overdraw visualization", &overdraw))
+            m_ViewportRenderer->SetOverdrawVisualization(overdraw);
+        if (overdraw)
+        {
+            ImGui::Text("Shaded fragments: %d", Renderer::GetStats().ShadedFragments);
+            ImGui::Text("Overdraw: %.2fx", Renderer::GetStats().Overdraw);
+        }
         ImGui::Text("ClearColor:"); ImGui::SameLine();
         ImGui::ColorEdit4("##ClearColor", glm::value_ptr(clearColor));
 
@@ -204,7 +218,7 @@ namespace Chozo {
         }
 
         std::string buttons[4] = {
-            "Position", "Normal", "Depth", "BaseColor"
+            "BaseColor", "Normal", "MaterialProps", "Emission"
         };
         for (int i = 0; i < std::size(buttons); i++)
         {
@@ -217,6 +231,20 @@ namespace Chozo {
             }
         }
 
+        if(ImGui::Button("Depth"))
+        {
+            TextureViewerPanel::Open();
+            Ref<Texture2D> texture = m_ViewportRenderer->GetGeometryPass()->GetDepthOutput();
+            TextureViewerPanel::SetTexture(texture);
+        }
+
+        if(ImGui::Button("Overdraw"))
+        {
+            TextureViewerPanel::Open();
+            Ref<Texture2D> texture = m_ViewportRenderer->GetOverdrawPass()->GetOutput(0);
+            TextureViewerPanel::SetTexture(texture);
+        }
+
         std::string materialButtons[4] = {
              "Ambient", "Specular", "Metallic", "Roughness"
         };
@@ -300,7 +328,7 @@ namespace Chozo {
             {
                 TextureViewerPanel::Open();
 
-                Ref<Texture2D> texture = m_ViewportRenderer->GetSolidPass()->GetOutput(1);
+                Ref<Texture2D> texture = m_ViewportRenderer->GetSolidPass()->GetDepthOutput();
                 TextureViewerPanel::SetTexture(texture);
             }
         }
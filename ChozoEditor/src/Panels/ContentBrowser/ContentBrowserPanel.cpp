@@ -539,6 +539,7 @@ namespace Chozo {
         textureSpec.WrapR = ImageParameter::CLAMP_TO_EDGE;
         textureSpec.WrapS = ImageParameter::CLAMP_TO_EDGE;
         textureSpec.WrapT = ImageParameter::CLAMP_TO_EDGE;
+        textureSpec.Usage = TextureUsage::Color;
 
         switch (type)
         {
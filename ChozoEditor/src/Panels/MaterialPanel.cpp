@@ -10,12 +10,22 @@ namespace Chozo {
 	MaterialPanel* MaterialPanel::s_Instance;
     bool MaterialPanel::s_Show = false;
 
+    // Timer wheel key of the preview update, the task finds the panel through s_Instance.
+    static const uint64_t s_PreviewUpdateKey = std::hash<std::string_view>()("MaterialPanel::PreviewUpdate");
+
     MaterialPanel::MaterialPanel()
     {
         s_Instance = this;
         Init();
     }
 
+    MaterialPanel::~MaterialPanel()
+    {
+        Application::Get().GetTimerWheel().Cancel(s_PreviewUpdateKey);
+        if (s_Instance == this)
+            s_Instance = nullptr;
+    }
+
     void MaterialPanel::Init()
     {
         const auto checkerboard = Renderer::GetCheckerboardTexture();
@@ -28,6 +38,9 @@ namespace Chozo {
     void MaterialPanel::SetMaterial(AssetHandle handle)
     {
         s_Instance->m_Material = handle;
+        // Edits of the previous material never reach the preview.
+        s_Instance->m_PendingProps.clear();
+        Application::Get().GetTimerWheel().Cancel(s_PreviewUpdateKey);
 
         if (!handle)
             return;
@@ -230,9 +243,17 @@ namespace Chozo {
 
     void MaterialPanel::OnMaterialChange(const std::string& name, const MaterialProp& value)
     {
-        const auto renderer = ThumbnailRenderer::GetRenderer<MaterialThumbnailRenderer>();
-        std::visit([&](const auto& v) {
-            renderer->SetMaterialProp(name, v);
-        }, value);
+        // Slider drags change a prop every frame, the preview takes the latest values in a single render.
+        s_Instance->m_PendingProps[name] = value;
+        Application::Get().GetTimerWheel().Debounce(s_PreviewUpdateKey, 50, []() {
+            if (!s_Instance || s_Instance->m_PendingProps.empty())
+                return;
+
+            const auto renderer = ThumbnailRenderer::GetRenderer<MaterialThumbnailRenderer>();
+            for (const auto& [propName, prop] : s_Instance->m_PendingProps)
+                renderer->SetMaterialProp(propName, prop);
+            s_Instance->m_PendingProps.clear();
+            renderer->Update();
+        });
     }
 }
@@ -39,6 +39,7 @@ namespace Chozo {
     {
     public:
         MaterialPanel();
+        ~MaterialPanel();
 
         static void Init();
         static void SetMaterial(AssetHandle handle);
@@ -62,5 +63,7 @@ namespace Chozo {
 
         AssetHandle m_Material;
         Ref<Texture2D> m_BaseColorTexture, m_MetallicTexture, m_RoughnessTexture, m_NormalTexture;
+        // Edits the preview hasn't taken yet, applied together once they stop coming.
+        std::unordered_map<std::string, MaterialProp> m_PendingProps;
     };
 }
@@ -361,7 +361,7 @@ namespace Chozo {
 
             if (!component.Dynamic)
             {
-                const AssetMetadata metadata = Application::GetAssetManager()->GetMetadata(component.Source);
+                const AssetMetadata metadata = Application::GetAssetManager()->GetMetadata(component.Source.GetHandle());
 
                 DrawColumnPath("File", metadata, [&](const AssetMetadata& sourceMetadata) {
                     if (sourceMetadata.Type == AssetType::Texture)
@@ -452,6 +452,10 @@ namespace Chozo {
                 if (ImGui::SliderFloat("##Intensity", &target, 0.0f, 10.0f))
                     component.Intensity = target;
             });
+            DrawColumnValue<float>("Radius", component.Radius, [&](auto& target) {
+                if (ImGui::DragFloat("##Radius", &target, 0.1f, 0.01f, 1000.0f))
+                    component.Radius = target;
+            });
         });
 
         DrawComponent<SpotLightComponent>("Light", entity, [](auto& component)
@@ -475,6 +479,10 @@ namespace Chozo {
                 if (ImGui::SliderFloat("##Angle", &target, 0.0f, 180.0f))
                     component.Angle = target;
             });
+            DrawColumnValue<float>("Radius", component.Radius, [&](auto& target) {
+                if (ImGui::DragFloat("##Radius", &target, 0.1f, 0.01f, 1000.0f))
+                    component.Radius = target;
+            });
         });
     }
 
@@ -567,7 +575,7 @@ namespace Chozo {
         DrawComponent<MeshComponent>("Material", entity, [this](MeshComponent& component)
         {
             Ref<MaterialTable> materialTable = component.MeshInstance->GetMaterials();
-            AssetHandle handle = component.MaterialHandle;
+            AssetHandle handle = component.MaterialHandle.GetHandle();
 
             Ref<Material> material = Application::GetAssetManager()->GetAsset(handle);
             auto name = material ? material->GetName() : "Solid";
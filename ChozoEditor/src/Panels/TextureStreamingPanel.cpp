@@ -0,0 +1,71 @@
+#include "TextureStreamingPanel.h"
+
+#include "PropertyUI.h"
+#include "Chozo/Renderer/TextureStreamer.h"
+
+namespace Chozo {
+
+    namespace Utils {
+
+        static float ToMegabytes(const uint64_t size)
+        {
+            return (float)size / (1024.0f * 1024.0f);
+        }
+    }
+
+    void TextureStreamingPanel::OnImGuiRender()
+    {
+        ImGui::Begin("Texture Streaming");
+
+        auto& config = Renderer::GetConfig();
+        DrawColumnValue<bool>("Enabled", config.EnableTextureStreaming, [&](auto& target) {
+            ImGui::Checkbox("##Enabled", &target);
+        });
+
+        int budget = (int)(config.TextureStreamingBudget >> 20);
+        DrawColumnValue<int>("Budget (MB)", budget, [&](auto& target) {
+            if (ImGui::DragInt("##Budget", &target, 8.0f, 16, 8192))
+                config.TextureStreamingBudget = (uint64_t)target << 20;
+        });
+
+        const TextureStreamingStatistics stats = TextureStreamer::GetStatistics();
+        ImGui::Separator();
+        ImGui::Text("Textures: %d, reads in flight: %d", (int)stats.Textures.size(), stats.PendingReads);
+        ImGui::ProgressBar(stats.Budget ? (float)stats.ResidentSize / (float)stats.Budget : 0.0f, ImVec2(-1.0f, 0.0f));
+        ImGui::Text("Resident: %.1f / %.1f MB (%.1f MB with every level)", Utils::ToMegabytes(stats.ResidentSize), Utils::ToMegabytes(stats.Budget), Utils::ToMegabytes(stats.FullSize));
+        ImGui::Text("Streamed in: %.1f MB, evicted: %.1f MB", Utils::ToMegabytes(stats.StreamedSize), Utils::ToMegabytes(stats.EvictedSize));
+
+        constexpr ImGuiTableFlags flags = ImGuiTableFlags_Resizable | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY | ImGuiTableFlags_BordersInnerV;
+        if (ImGui::BeginTable("Residency", 5, flags))
+        {
+            ImGui::TableSetupScrollFreeze(0, 1);
+            ImGui::TableSetupColumn("Texture");
+            ImGui::TableSetupColumn("Resident");
+            ImGui::TableSetupColumn("Required");
+            ImGui::TableSetupColumn("Size (MB)");
+            ImGui::TableSetupColumn("Idle frames");
+            ImGui::TableHeadersRow();
+
+            for (const auto& texture : stats.Textures)
+            {
+                const uint32_t residentWidth = std::max(texture.Width >> texture.ResidentMip, 1u);
+                const uint32_t residentHeight = std::max(texture.Height >> texture.ResidentMip, 1u);
+
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::Text("%s", texture.Name.c_str());
+                ImGui::TableNextColumn();
+                ImGui::Text("mip %d (%dx%d)%s", texture.ResidentMip, residentWidth, residentHeight, texture.Streaming ? " *" : "");
+                ImGui::TableNextColumn();
+                ImGui::Text("mip %d / %d", texture.RequiredMip, texture.MipLevels - 1);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.2f", Utils::ToMegabytes(texture.ResidentSize));
+                ImGui::TableNextColumn();
+                ImGui::Text("%llu", (unsigned long long)texture.IdleFrames);
+            }
+            ImGui::EndTable();
+        }
+
+        ImGui::End();
+    }
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "Chozo.h"
+
+namespace Chozo {
+
+    // Residency of the streamed textures against the budget, with the streaming settings.
+    class TextureStreamingPanel
+    {
+    public:
+        TextureStreamingPanel() = default;
+
+        void OnImGuiRender();
+    };
+}
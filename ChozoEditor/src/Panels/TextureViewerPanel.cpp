@@ -73,11 +73,12 @@ namespace Chozo {
                 // float height = m_ViewportSize.x * 0.75;
                 // m_Viewport_FBO->Resize(width, height);
 
-                // TODO: Change to Async Commandbuffer
-                m_Viewport_FBO->Bind();
                 m_Material->Set("u_Texture", m_Texture);
-                RenderCommand::RenderFullscreenQuad(m_Pipeline, m_Material);
-                m_Viewport_FBO->Unbind();
+                Renderer::Submit([framebuffer = m_Viewport_FBO, pipeline = m_Pipeline, material = m_Material]() {
+                    framebuffer->Bind();
+                    RenderCommand::RenderFullscreenQuad(pipeline, material);
+                    framebuffer->Unbind();
+                });
 
                 DrawImage(m_FBOTexture);
                 // CZ_CORE_INFO("{0}, {1}", m_FBOTexture->GetWidth(), m_FBOTexture->GetHeight());
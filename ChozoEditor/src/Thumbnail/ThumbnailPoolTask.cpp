@@ -2,6 +2,9 @@
 #include "ThumbnailRenderer.h"
 #include "ThumbnailManager.h"
 
+#include "Chozo/Renderer/ImageConverter.h"
+#include "Chozo/Renderer/TextureCompressor.h"
+
 namespace Chozo {
 
     void ThumbnailPoolTask::Execute()
@@ -19,9 +22,27 @@ namespace Chozo {
         if (Source->GetAssetType() == AssetType::Texture)
         {
             auto src = Source.As<Texture2D>();
-            isHDR = src->GetSpecification().Format == ImageFormat::HDR;
-            srcSize.x = static_cast<float>(src->GetWidth());
-            srcSize.y = static_cast<float>(src->GetHeight());
+            const ImageFormat format = src->GetSpecification().Format;
+            isHDR = Image::IsHDRFormat(format);
+            // Streamed textures hold their pixels from the resident mip on.
+            const uint32_t width = std::max(src->GetWidth() >> src->GetResidentMip(), 1u);
+            const uint32_t height = std::max(src->GetHeight() >> src->GetResidentMip(), 1u);
+            srcSize.x = static_cast<float>(width);
+            srcSize.y = static_cast<float>(height);
+
+            // The exporter tone maps from RGBA32F, compact HDR storage is expanded first.
+            if (isHDR && format != ImageFormat::RGBA32F && ImageData)
+            {
+                Buffer expanded = ImageConverter::ToRGBA32F(ImageData.Data, (uint64_t)width * height, format);
+                ImageData = SharedBuffer(expanded.Data, expanded.Size);
+                expanded.Release();
+            }
+            else if (Image::IsCompressedFormat(format) && ImageData)
+            {
+                Buffer pixels = TextureCompressor::Decompress(ImageData.Data, width, height, format);
+                ImageData = SharedBuffer(pixels.Data, pixels.Size);
+                pixels.Release();
+            }
 
             if (srcSize.x < srcSize.y)
                 outputSize.x = outputSize.y * (srcSize.x / srcSize.y);
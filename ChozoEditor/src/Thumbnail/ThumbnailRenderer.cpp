@@ -178,8 +178,6 @@ namespace Chozo {
         std::visit([&](const auto& v) {
             m_Material->Set(name, v);
         }, value);
-
-        Update();
     }
 
     void MaterialThumbnailRenderer::UpdateCache()
@@ -0,0 +1,6 @@
+#version 450
+
+// Depth only, the pipeline masks the color writes.
+void main()
+{
+}
@@ -0,0 +1,33 @@
+#version 450
+
+#include "Includes/VertexPacking.glsl"
+
+// Only the position stream is bound, the expression matches GBuffer.glsl.vert so the depth test
+// of the geometry pass can use Equal.
+layout(location = 0) in vec4 a_Position;
+
+layout(std140, binding = 0) uniform CameraData
+{
+    mat4 u_ProjectionMatrix;
+    mat4 u_ViewMatrix;
+    mat4 u_InverseViewProjectionMatrix;
+};
+
+layout(push_constant) uniform VertexUniforms
+{
+    mat4 ModelMatrix;
+    vec4 PositionOffset;
+    vec4 PositionScale;
+} u_VertUniforms;
+
+invariant gl_Position;
+
+void main()
+{
+    vec3 localPosition = DecodePosition(a_Position, u_VertUniforms.PositionOffset, u_VertUniforms.PositionScale);
+    vec4 modelPosition = u_VertUniforms.ModelMatrix * vec4(localPosition, 1.0);
+    vec4 viewPosition = u_ViewMatrix * modelPosition;
+    vec4 projectionPosition = u_ProjectionMatrix * viewPosition;
+
+    gl_Position = projectionPosition;
+}
@@ -1,15 +1,20 @@
 #version 450
 
-layout(location = 0) out vec3 o_Position;
-layout(location = 1) out vec3 o_Normal;
-layout(location = 2) out vec3 o_Depth;
-layout(location = 3) out vec3 o_BaseColor;
-layout(location = 4) out vec4 o_MaterialProperties;
-layout(location = 5) out int o_EntityID;
+#pragma multi_compile _ ENABLE_BASE_COLOR_TEX
+#pragma multi_compile _ ENABLE_METALLIC_TEX
+#pragma multi_compile _ ENABLE_ROUGHNESS_TEX
+#pragma multi_compile _ ENABLE_NORMAL_TEX
+
+#include "Includes/GBufferPacking.glsl"
+
+layout(location = 0) out vec4 o_BaseColor;
+layout(location = 1) out vec2 o_Normal;
+layout(location = 2) out vec4 o_MaterialProperties;
+layout(location = 3) out vec3 o_Emission;
+layout(location = 4) out int o_EntityID;
 
 layout(location = 0) in vec3 v_Normal;
 layout(location = 1) in vec2 v_TexCoord;
-layout(location = 2) in vec3 v_FragPosition;
 
 layout(push_constant) uniform PushConstants
 {
@@ -19,41 +24,54 @@ layout(push_constant) uniform PushConstants
     float Reflectance;
     float Ambient;
     float AmbientStrength;
-
-    int EnableBaseColorTex;
-    int EnableMetallicTex;
-    int EnableRoughnessTex;
-    int EnableNormalTex;
+    vec3 EmissiveColor;
 
     int ID;
 } u_Material;
 
+#ifdef ENABLE_NORMAL_TEX
 layout(binding = 0) uniform sampler2D u_NormalTex;
+#endif
+#ifdef ENABLE_BASE_COLOR_TEX
 layout(binding = 1) uniform sampler2D u_BaseColorTex;
+#endif
+#ifdef ENABLE_METALLIC_TEX
 layout(binding = 2) uniform sampler2D u_MetallicTex;
+#endif
+#ifdef ENABLE_ROUGHNESS_TEX
 layout(binding = 3) uniform sampler2D u_RoughnessTex;
+#endif
 layout(binding = 4) uniform sampler2D u_AmbientTex;
 
-float near = 0.1;
-float far  = 20.0;
-
-float LinearizeDepth(float depth) 
-{
-    float z = depth * 2.0 - 1.0; // back to NDC 
-    return (2.0 * near * far) / (far + near - z * (far - near));    
-}
-
 void main()
 {
-    float depth = LinearizeDepth(pow(gl_FragCoord.z, 0.3)) / far;
-
-    o_Position = v_FragPosition;
-    o_Normal = (u_Material.EnableNormalTex == 1) ? texture(u_NormalTex, v_TexCoord).rgb * 2.0 - vec3(1.0) : normalize(v_Normal);
-    o_Depth = vec3(depth);
-    o_BaseColor = (u_Material.EnableBaseColorTex == 1) ? texture(u_BaseColorTex, v_TexCoord).rgb : u_Material.BaseColor;
-    o_MaterialProperties.r = (u_Material.EnableMetallicTex == 1) ? texture(u_MetallicTex, v_TexCoord).g : u_Material.Metallic;
-    o_MaterialProperties.g = (u_Material.EnableRoughnessTex == 1) ? texture(u_RoughnessTex, v_TexCoord).r : u_Material.Roughness;
-    o_MaterialProperties.b = u_Material.Reflectance;
-    o_MaterialProperties.a = u_Material.Ambient * u_Material.AmbientStrength;
+    vec3 normal;
+#ifdef ENABLE_NORMAL_TEX
+    // BC5 normal maps only store x and y.
+    normal.xy = texture(u_NormalTex, v_TexCoord).rg * 2.0 - vec2(1.0);
+    normal.z = sqrt(max(1.0 - dot(normal.xy, normal.xy), 0.0));
+#else
+    normal = v_Normal;
+#endif
+    o_Normal = EncodeGBufferNormal(normal);
+#ifdef ENABLE_BASE_COLOR_TEX
+    o_BaseColor.rgb = texture(u_BaseColorTex, v_TexCoord).rgb;
+#else
+    o_BaseColor.rgb = u_Material.BaseColor;
+#endif
+#ifdef ENABLE_METALLIC_TEX
+    o_BaseColor.a = texture(u_MetallicTex, v_TexCoord).g;
+#else
+    o_BaseColor.a = u_Material.Metallic;
+#endif
+#ifdef ENABLE_ROUGHNESS_TEX
+    o_MaterialProperties.r = texture(u_RoughnessTex, v_TexCoord).r;
+#else
+    o_MaterialProperties.r = u_Material.Roughness;
+#endif
+    o_MaterialProperties.g = u_Material.Reflectance;
+    o_MaterialProperties.b = u_Material.Ambient * u_Material.AmbientStrength;
+    o_MaterialProperties.a = 1.0;
+    o_Emission = u_Material.EmissiveColor;
     o_EntityID = u_Material.ID;
 }
\ No newline at end of file
@@ -1,7 +1,7 @@
 #include "./Math.glsl"
 #include "./GBuffer.glsl"
+#include "./SphericalHarmonics.glsl"
 
-layout(binding = 4) uniform samplerCube u_IrradianceMap;
 layout(binding = 5) uniform samplerCube u_PrefilterMap;
 layout(binding = 6) uniform sampler2D u_BRDFLutTex;
 
@@ -34,7 +34,7 @@ vec3 PrefilteredRadiance(const BRDFContext BRDFCtx, const vec3 r, float perceptu
 
 vec3 DiffuseIrradiance(const vec3 n, const BRDFContext BRDFCtx)
 {
-    return textureLod(u_IrradianceMap, n, BRDFCtx.IBLRoughnessOneLevel).rgb;
+    return EvaluateIrradianceSH(u_Scene.IrradianceSH, n);
 }
 
 void InitBRDFContext(const GBufferData GBuffer, out BRDFContext BRDFCtx)
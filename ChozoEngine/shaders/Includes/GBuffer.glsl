@@ -1,10 +1,20 @@
 #include "../Snippets/Fragment/Varyings.glsl"
 #include "../Snippets/Fragment/Scene.glsl"
 
-layout(binding = 0) uniform sampler2D u_PositionTex;
+#include "./GBufferPacking.glsl"
+
+layout(std140, binding = 0) uniform CameraData
+{
+    mat4 u_ProjectionMatrix;
+    mat4 u_ViewMatrix;
+    mat4 u_InverseViewProjectionMatrix;
+};
+
+layout(binding = 0) uniform sampler2D u_DepthTex;
 layout(binding = 1) uniform sampler2D u_NormalTex;
 layout(binding = 2) uniform sampler2D u_BaseColorTex;
 layout(binding = 3) uniform sampler2D u_MaterialPropTex;
+layout(binding = 8) uniform sampler2D u_EmissionTex;
 
 struct GBufferData
 {
@@ -15,6 +25,7 @@ struct GBufferData
     float Reflectance;
 
     float AO;
+    vec3 Emission;
     highp vec3 Position;
     vec3 Normal;
     vec3 View;
@@ -23,20 +34,22 @@ struct GBufferData
 
 void InitGBuffer(out GBufferData GBuffer)
 {
+    vec4 baseColor = texture(u_BaseColorTex, v_TexCoord);
     vec4 materialProps = texture(u_MaterialPropTex, v_TexCoord);
 
-    GBuffer.BaseColor           = texture(u_BaseColorTex, v_TexCoord).rgb;
-    GBuffer.Metallic            = materialProps.r;
-    GBuffer.PerceptualRoughness = max(materialProps.g, 0.001);
+    GBuffer.BaseColor           = baseColor.rgb;
+    GBuffer.Metallic            = baseColor.a;
+    GBuffer.PerceptualRoughness = max(materialProps.r, 0.001);
     GBuffer.Roughness           = GBuffer.PerceptualRoughness * GBuffer.PerceptualRoughness;
-    GBuffer.Reflectance         = materialProps.b;
+    GBuffer.Reflectance         = materialProps.g;
 
 //    GBuffer.EnergyCompensation = vec3(1.0);
     //    GBuffer.EnergyCompensation = 1.0 + f0 * (1.0 / dfg.y - 1.0);
 
     GBuffer.AO        = 1.0;
-    GBuffer.Position  = texture(u_PositionTex, v_TexCoord).rgb;
-    GBuffer.Normal    = normalize(texture(u_NormalTex, v_TexCoord).rgb);
+    GBuffer.Emission  = texture(u_EmissionTex, v_TexCoord).rgb;
+    GBuffer.Position  = ReconstructPosition(v_TexCoord, texture(u_DepthTex, v_TexCoord).r, u_InverseViewProjectionMatrix);
+    GBuffer.Normal    = DecodeGBufferNormal(texture(u_NormalTex, v_TexCoord).rg);
     GBuffer.View      = normalize(u_Scene.CameraPosition - GBuffer.Position);
 //    GBuffer.Reflected = reflect(-GBuffer.View, GBuffer.Normal);
     GBuffer.Reflected = 2.0 * dot(GBuffer.View, GBuffer.Normal) * GBuffer.Normal - GBuffer.View;
@@ -0,0 +1,36 @@
+//------------------------------------------------------------------------------
+// G-buffer packing, written by the geometry pass and read by the lighting passes
+//------------------------------------------------------------------------------
+// 0: RGBA8          base color (rgb), metallic (a)
+// 1: RG16           octahedral encoded world normal
+// 2: RGBA8          roughness (r), reflectance (g), ambient occlusion (b)
+// 3: R11G11B10F     emission
+// 4: RED32I         entity id
+// depth             position is reconstructed from it and the inverse view-projection
+
+#include "./VertexPacking.glsl"
+
+vec2 OctEncode(vec3 n)
+{
+    n /= abs(n.x) + abs(n.y) + abs(n.z);
+    vec2 e = n.xy;
+    if (n.z < 0.0)
+        e = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+    return e;
+}
+
+vec2 EncodeGBufferNormal(vec3 normal)
+{
+    return OctEncode(normalize(normal)) * 0.5 + 0.5;
+}
+
+vec3 DecodeGBufferNormal(vec2 encoded)
+{
+    return OctDecode(encoded * 2.0 - 1.0);
+}
+
+vec3 ReconstructPosition(vec2 texCoord, float depth, mat4 inverseViewProjection)
+{
+    vec4 position = inverseViewProjection * vec4(vec3(texCoord, depth) * 2.0 - 1.0, 1.0);
+    return position.xyz / position.w;
+}
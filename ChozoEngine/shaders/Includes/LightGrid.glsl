@@ -0,0 +1,44 @@
+// Clustered light grid built on the CPU, see LightGrid.h. 16x9 screen tiles times 24 exponential depth slices.
+#define LIGHT_GRID_TILE_COUNT_X 16u
+#define LIGHT_GRID_TILE_COUNT_Y 9u
+#define LIGHT_GRID_SLICE_COUNT 24u
+
+layout(std140, binding = 5) uniform LightGridData
+{
+    mat4 ViewMatrix;
+    vec2 ViewportSize;
+    float SliceScale;
+    float SliceBias;
+} u_LightGridData;
+
+// Per cluster (offset, pointCount | spotCount << 16), then the light index lists.
+layout(binding = 7) uniform usamplerBuffer u_LightGrid;
+
+struct LightCluster
+{
+    uint Offset;
+    uint PointLightCount;
+    uint SpotLightCount;
+};
+
+LightCluster GetLightCluster(const highp vec3 worldPosition, const vec2 fragCoord)
+{
+    float depth = max(-(u_LightGridData.ViewMatrix * vec4(worldPosition, 1.0)).z, 1e-4);
+    uint slice = uint(clamp(log(depth) * u_LightGridData.SliceScale + u_LightGridData.SliceBias, 0.0, float(LIGHT_GRID_SLICE_COUNT - 1u)));
+    uvec2 tile = uvec2(clamp(fragCoord / u_LightGridData.ViewportSize * vec2(LIGHT_GRID_TILE_COUNT_X, LIGHT_GRID_TILE_COUNT_Y),
+        vec2(0.0), vec2(LIGHT_GRID_TILE_COUNT_X - 1u, LIGHT_GRID_TILE_COUNT_Y - 1u)));
+    uint index = tile.x + tile.y * LIGHT_GRID_TILE_COUNT_X + slice * LIGHT_GRID_TILE_COUNT_X * LIGHT_GRID_TILE_COUNT_Y;
+
+    uint counts = texelFetch(u_LightGrid, int(index * 2u + 1u)).r;
+
+    LightCluster cluster;
+    cluster.Offset = texelFetch(u_LightGrid, int(index * 2u)).r;
+    cluster.PointLightCount = counts & 0xFFFFu;
+    cluster.SpotLightCount = counts >> 16u;
+    return cluster;
+}
+
+uint GetLightIndex(const uint offset)
+{
+    return texelFetch(u_LightGrid, int(offset)).r;
+}
@@ -1,4 +1,5 @@
 #include "../Snippets/Fragment/Light.glsl"
+#include "./LightGrid.glsl"
 #include "./Math.glsl"
 #include "./GBuffer.glsl"
 #include "./BRDF.glsl"
@@ -128,7 +129,24 @@ vec3 EvaluatePunctualLight(const GBufferData GBuffer, const BRDFContext BRDFCtx,
     light.h = normalize(GBuffer.View + light.l);
     light.Intensity = pointLight.Intensity;
     light.Color = pointLight.Color;
-    light.Attenuation = GetDistanceAttenuation(posToLight, pointLight.Intensity, 10.0);
+    light.Attenuation = GetDistanceAttenuation(posToLight, pointLight.Intensity, pointLight.Radius);
+    return SurfaceShading(GBuffer, BRDFCtx, light);
+}
+
+vec3 EvaluateSpotLight(const GBufferData GBuffer, const BRDFContext BRDFCtx, const SpotLight spotLight)
+{
+    highp vec3 posToLight = spotLight.Position - GBuffer.Position;
+
+    Light light;
+    light.l = normalize(posToLight);
+    light.h = normalize(GBuffer.View + light.l);
+    light.Intensity = spotLight.Intensity;
+    light.Color = spotLight.Color;
+
+    float cosInner = cos(radians(spotLight.Angle));
+    float cosOuter = cos(radians(spotLight.Angle + spotLight.AngleAttenuation));
+    light.Attenuation = GetDistanceAttenuation(posToLight, spotLight.Intensity, spotLight.Radius)
+        * GetAngleAttenuation(-light.l, normalize(spotLight.Direction), cosOuter, cosInner);
     return SurfaceShading(GBuffer, BRDFCtx, light);
 }
 
@@ -137,7 +155,7 @@ vec3 EvaluatePunctualLight(const GBufferData GBuffer, const BRDFContext BRDFCtx,
  * This function evaluates all lights one by one:
  * - Image based lights (IBL)
  * - Directional lights
- * - Punctual lights
+ * - Punctual lights, only those of the light grid cluster the fragment falls into
  *
  * Area lights are currently not supported.
  *d
@@ -155,10 +173,18 @@ vec3 EvaluateLights(const GBufferData GBuffer, BRDFContext BRDFContext)
         color += EvaluateDirectionalLight(GBuffer, BRDFContext, dirLight);
     }
 
-    for (int i = 0; i < u_PointLights.LightCount; i++)
+    LightCluster cluster = GetLightCluster(GBuffer.Position, gl_FragCoord.xy);
+    uint offset = cluster.Offset;
+    for (uint i = 0u; i < cluster.PointLightCount; i++)
     {
-        PointLight pointLight = u_PointLights.Lights[i];
+        PointLight pointLight = u_PointLights.Lights[GetLightIndex(offset++)];
         color += EvaluatePunctualLight(GBuffer, BRDFContext, pointLight);
     }
+
+    for (uint i = 0u; i < cluster.SpotLightCount; i++)
+    {
+        SpotLight spotLight = u_SpotLights.Lights[GetLightIndex(offset++)];
+        color += EvaluateSpotLight(GBuffer, BRDFContext, spotLight);
+    }
     return color;
 }
@@ -0,0 +1,20 @@
+//------------------------------------------------------------------------------
+// Irradiance from 9 spherical harmonics coefficients, projected on the CPU (SphericalHarmonics.cpp)
+//------------------------------------------------------------------------------
+// The clamped cosine lobe and the Lambert 1/PI are folded into the coefficients, the basis
+// here has to match the one they were projected with.
+
+vec3 EvaluateIrradianceSH(const vec4 sh[9], const vec3 d)
+{
+    vec3 irradiance =
+        sh[0].rgb * 0.282095 +
+        sh[1].rgb * 0.488603 * d.y +
+        sh[2].rgb * 0.488603 * d.z +
+        sh[3].rgb * 0.488603 * d.x +
+        sh[4].rgb * 1.092548 * d.x * d.y +
+        sh[5].rgb * 1.092548 * d.y * d.z +
+        sh[6].rgb * 0.315392 * (3.0 * d.z * d.z - 1.0) +
+        sh[7].rgb * 1.092548 * d.x * d.z +
+        sh[8].rgb * 0.546274 * (d.x * d.x - d.y * d.y);
+    return max(irradiance, vec3(0.0));
+}
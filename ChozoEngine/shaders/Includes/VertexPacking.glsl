@@ -0,0 +1,36 @@
+//------------------------------------------------------------------------------
+// Packed mesh vertices, see MeshPacker
+//------------------------------------------------------------------------------
+// a_Position.xyz is either a float position or unorm16 relative to the mesh-wide bounding box,
+// PositionOffset/PositionScale map both back to the local position.
+// a_Position.w holds the bitangent sign as 0 or 1.
+// a_NormalTangent holds the octahedral encoded normal (xy) and tangent (zw).
+
+vec3 OctDecode(vec2 e)
+{
+    vec3 n = vec3(e.xy, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+    n.x += n.x >= 0.0 ? -t : t;
+    n.y += n.y >= 0.0 ? -t : t;
+    return normalize(n);
+}
+
+vec3 DecodePosition(vec4 position, vec4 offset, vec4 scale)
+{
+    return position.xyz * scale.xyz + offset.xyz;
+}
+
+vec3 DecodeNormal(vec4 normalTangent)
+{
+    return OctDecode(normalTangent.xy);
+}
+
+vec3 DecodeTangent(vec4 normalTangent)
+{
+    return OctDecode(normalTangent.zw);
+}
+
+vec3 DecodeBinormal(vec3 normal, vec3 tangent, float sign)
+{
+    return cross(normal, tangent) * (sign * 2.0 - 1.0);
+}
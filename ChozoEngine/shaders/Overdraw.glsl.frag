@@ -0,0 +1,9 @@
+#version 450
+
+layout(location = 0) out vec4 o_Color;
+
+// Added up by the blending of the overdraw pass, a pixel shaded 8 times reaches full red.
+void main()
+{
+    o_Color = vec4(0.125, 0.0625, 0.03125, 1.0);
+}
@@ -18,6 +18,7 @@ void main()
     vec3 light = EvaluateLights(GBuffer, BRDFCtx);
 
     color += light;
+    color += GBuffer.Emission;
 
     float alpha = 1.0;
 
@@ -5,11 +5,19 @@ layout(location = 0) out vec4 o_Color;
 layout(location = 0) in vec2 v_TexCoord;
 layout(location = 1) in vec3 v_FragPosition;
 
-layout(binding = 0) uniform sampler2D u_PositionTex;
+layout(binding = 0) uniform sampler2D u_DepthTex;
 layout(binding = 1) uniform sampler2D u_NormalTex;
 layout(binding = 2) uniform sampler2D u_BaseColorTex;
 layout(binding = 3) uniform sampler2D u_MaterialPropTex;
 
+layout(std140, binding = 0) uniform CameraData
+{
+    mat4 u_ProjectionMatrix;
+    mat4 u_ViewMatrix;
+    mat4 u_InverseViewProjectionMatrix;
+};
+
+#include "Includes/GBufferPacking.glsl"
 #include "Snippets/Fragment/Scene.glsl"
 #include "Snippets/Fragment/Light.glsl"
 
@@ -102,15 +110,16 @@ void main()
     vec3 spotLights = vec3(0.0);
     vec3 finalLight = vec3(0.0);
 
-    vec3 gPosition = texture(u_PositionTex, v_TexCoord).rgb;
-    vec3 gNormal = texture(u_NormalTex, v_TexCoord).rgb;
-    vec3 gDiffuse = texture(u_BaseColorTex, v_TexCoord).rgb;
+    vec3 gPosition = ReconstructPosition(v_TexCoord, texture(u_DepthTex, v_TexCoord).r, u_InverseViewProjectionMatrix);
+    vec3 gNormal = DecodeGBufferNormal(texture(u_NormalTex, v_TexCoord).rg);
+    vec4 gBaseColor = texture(u_BaseColorTex, v_TexCoord);
     vec4 gMaterialProps = texture(u_MaterialPropTex, v_TexCoord);
 
-    float gMetallic = gMaterialProps.r;
-    float gRoughness = gMaterialProps.g;
+    vec3 gDiffuse = gBaseColor.rgb;
+    float gMetallic = gBaseColor.a;
+    float gRoughness = gMaterialProps.r;
+    float gSpecular = gMaterialProps.g;
     float gAmbient = gMaterialProps.b;
-    float gSpecular = gMaterialProps.a;
 
     Material material;
     material.Diffuse = gDiffuse;
@@ -14,7 +14,7 @@ void main()
 {
     vec3 color = vec3(0.0);
     float alpha = 1.0;
-    float depth = 0.0;
+    // Depth attachments, cleared to 1.0 where nothing was drawn.
     float solidDepth = texture(u_SolidDepthTex, v_TexCoord).r;
     float PBRDepth = texture(u_PBRDepthTex, v_TexCoord).r;
 
@@ -22,20 +22,9 @@ void main()
     vec4 solidLayer = texture(u_SolidTex, v_TexCoord);
     vec4 PBRLayer = texture(u_PBRTex, v_TexCoord);
 
-    if (solidDepth > 0.0 || PBRDepth > 0.0)
+    if (solidDepth < 1.0 || PBRDepth < 1.0)
     {
-        if (solidDepth > 0.0 && PBRDepth > 0.0)
-        {
-            color = (solidDepth < PBRDepth) ? solidLayer.rgb : PBRLayer.rgb;
-        }
-        else if (solidDepth > 0.0)
-        {
-            color = solidLayer.rgb;
-        }
-        else
-        {
-            color = PBRLayer.rgb;
-        }
+        color = (solidDepth < PBRDepth) ? solidLayer.rgb : PBRLayer.rgb;
     }
     else
     {
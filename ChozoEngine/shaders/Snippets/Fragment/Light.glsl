@@ -9,6 +9,7 @@ struct PointLight
     highp vec3 Position;
     float Intensity;
     vec3 Color;
+    float Radius;
 };
 
 struct SpotLight
@@ -19,6 +20,7 @@ struct SpotLight
     float AngleAttenuation;
     vec3 Color;
     float Angle;
+    float Radius;
 };
 
 struct Light
@@ -2,4 +2,5 @@ layout(std140, binding = 1) uniform SceneData
 {
     vec3 CameraPosition; // Offset = 32
     float EnvironmentMapIntensity;
+    vec4 IrradianceSH[9];
 } u_Scene;
\ No newline at end of file
@@ -1,8 +1,8 @@
-layout(location = 0) in vec3 a_Position;
-layout(location = 1) in vec3 a_Normal;
+#include "../../Includes/VertexPacking.glsl"
+
+layout(location = 0) in vec4 a_Position;
+layout(location = 1) in vec4 a_NormalTangent;
 layout(location = 2) in vec2 a_TexCoord;
-layout(location = 3) in vec3 a_Bitangent;
-layout(location = 4) in vec3 a_Tangent;
 
 layout(std140, binding = 0) uniform CameraData
 {
@@ -14,6 +14,8 @@ layout(std140, binding = 0) uniform CameraData
 layout(push_constant) uniform VertexUniforms
 {
     mat4 ModelMatrix;
+    vec4 PositionOffset;
+    vec4 PositionScale;
 } u_VertUniforms;
 
 layout(location = 0) out vec3 v_Normal;
@@ -1,9 +1,10 @@
-vec4 modelPosition = u_VertUniforms.ModelMatrix * vec4(a_Position, 1.0);
+vec3 localPosition = DecodePosition(a_Position, u_VertUniforms.PositionOffset, u_VertUniforms.PositionScale);
+vec4 modelPosition = u_VertUniforms.ModelMatrix * vec4(localPosition, 1.0);
 vec4 viewPosition = u_ViewMatrix * modelPosition;
 vec4 projectionPosition = u_ProjectionMatrix * viewPosition;
 
 gl_Position = projectionPosition;
 
-v_Normal = a_Normal;
+v_Normal = DecodeNormal(a_NormalTangent);
 v_TexCoord = a_TexCoord;
 v_FragPosition = vec3(modelPosition);
\ No newline at end of file
@@ -1,5 +1,7 @@
 #include "AssetImporter.h"
 
+#include "Chozo/Renderer/TextureStreamer.h"
+
 namespace Chozo
 {
 
@@ -32,6 +34,10 @@ namespace Chozo
         fs::path filepath = Utils::File::GetAssetDirectory() / path;
         fs::path dest = filepath.parent_path() / (filepath.filename().string() + ".asset");
 
+        // Streamed textures read their missing levels from the file before it is rewritten.
+        if (metadata.Type == AssetType::Texture)
+            TextureStreamer::MakeResident(asset.As<Texture2D>());
+
         FileStreamWriter stream(dest);
         // uint64_t start = stream.GetStreamPosition();
         AssetFileHeader header;
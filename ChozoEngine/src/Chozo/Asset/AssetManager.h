@@ -4,13 +4,15 @@
 
 #include "Asset.h"
 
+#include <atomic>
+
 namespace Chozo {
 
 	class AssetManager : public RefCounted
 	{
 	public:
-		AssetManager() = default;
-		~AssetManager() override = default;
+		AssetManager() { BumpGeneration(); }
+		~AssetManager() override { BumpGeneration(); }
 
 		virtual Ref<Asset> GetAsset(AssetHandle assetHandle) = 0;
 		virtual std::vector<AssetMetadata> GetAssetsModified() = 0;
@@ -24,5 +26,13 @@ namespace Chozo {
 		virtual std::unordered_set<AssetHandle> GetAllAssetsWithType(AssetType type) = 0;
 		virtual const std::unordered_map<AssetHandle, Ref<Asset>>& GetLoadedAssets() = 0;
 		virtual const std::unordered_map<AssetHandle, Ref<Asset>>& GetMemoryOnlyAssets() = 0;
+
+		// Changes whenever a handle may resolve to a different asset (load, reload, unload), see AssetRef.
+		static uint64_t GetGeneration() { return s_Generation.load(std::memory_order_relaxed); }
+	protected:
+		static void BumpGeneration() { s_Generation.fetch_add(1, std::memory_order_relaxed); }
+	private:
+		// Starts above zero, so a new AssetRef always resolves once.
+		inline static std::atomic<uint64_t> s_Generation = 1;
 	};
 }
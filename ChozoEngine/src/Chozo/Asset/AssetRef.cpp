@@ -0,0 +1,11 @@
+#include "AssetRef.h"
+
+#include "Chozo/Core/Application.h"
+
+namespace Chozo {
+
+    Ref<Asset> AssetRefBase::Resolve(const AssetHandle handle)
+    {
+        return Application::GetAssetManager()->GetAsset(handle);
+    }
+}
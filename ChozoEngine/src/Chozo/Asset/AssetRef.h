@@ -0,0 +1,59 @@
+#pragma once
+
+#include "czpch.h"
+
+#include "AssetManager.h"
+
+namespace Chozo {
+
+    class AssetRefBase
+    {
+    public:
+        AssetHandle GetHandle() const { return m_Handle; }
+    protected:
+        AssetRefBase() = default;
+        explicit AssetRefBase(const AssetHandle handle) : m_Handle(handle) {}
+
+        // Goes through Application's asset manager, which may load the asset synchronously.
+        static Ref<Asset> Resolve(AssetHandle handle);
+    protected:
+        AssetHandle m_Handle = 0;
+        mutable uint64_t m_Generation = 0;
+    };
+
+    // Asset handle that keeps what it last resolved to. The asset manager is only asked again when the handle
+    // changes or the manager's generation moved on, otherwise Get is a single integer compare.
+    template<typename T>
+    class AssetRef : public AssetRefBase
+    {
+    public:
+        AssetRef() = default;
+        AssetRef(const AssetHandle handle) : AssetRefBase(handle) {} // NOLINT
+
+        AssetRef& operator=(const AssetHandle handle)
+        {
+            if (handle != m_Handle)
+            {
+                m_Handle = handle;
+                m_Generation = 0;
+                m_Asset = nullptr;
+            }
+            return *this;
+        }
+
+        const Ref<T>& Get() const
+        {
+            if (m_Generation != AssetManager::GetGeneration())
+            {
+                m_Asset = m_Handle != 0 ? Resolve(m_Handle).template As<T>() : nullptr;
+                // Read after resolving, a load it triggered bumped the generation already.
+                m_Generation = AssetManager::GetGeneration();
+            }
+            return m_Asset;
+        }
+
+        bool IsSet() const { return m_Handle != 0; }
+    private:
+        mutable Ref<T> m_Asset;
+    };
+}
@@ -3,8 +3,12 @@
 #include "Chozo/Core/Application.h"
 #include "Chozo/Project/Project.h"
 #include "Chozo/Renderer/Renderer.h"
+#include "Chozo/Renderer/ImageConverter.h"
+#include "Chozo/Renderer/TextureCompressor.h"
+#include "Chozo/Renderer/TextureStreamer.h"
 #include "Chozo/Renderer/Texture.h"
 #include "Chozo/Renderer/Material.h"
+#include "Chozo/Renderer/MeshPacker.h"
 #include "Chozo/Renderer/Geometry/BoxGeometry.h"
 #include "Chozo/Renderer/Geometry/SphereGeometry.h"
 
@@ -290,7 +294,7 @@ namespace Chozo {
             out << YAML::Key << "Intensity" << YAML::Value << sc.Intensity;
             out << YAML::Key << "Lod" << YAML::Value << sc.Lod;
             out << YAML::Key << "Dynamic" << YAML::Value << sc.Dynamic;
-            out << YAML::Key << "Source" << YAML::Value << sc.Source;
+            out << YAML::Key << "Source" << YAML::Value << sc.Source.GetHandle();
             out << YAML::Key << "TurbidityAzimuthInclination" << YAML::Value << sc.TurbidityAzimuthInclination;
 
             out << YAML::EndMap;
@@ -359,7 +363,7 @@ namespace Chozo {
 
             out << YAML::Key << "Material" << YAML::Value;
             out << YAML::BeginMap;
-            out << YAML::Key << "Handle" << YAML::Value << mc.MaterialHandle;
+            out << YAML::Key << "Handle" << YAML::Value << mc.MaterialHandle.GetHandle();
             out << YAML::EndMap;
 
             out << YAML::EndMap;
@@ -386,6 +390,7 @@ namespace Chozo {
             auto& pc = entity.GetComponent<PointLightComponent>();
             out << YAML::Key << "Color" << YAML::Value << pc.Color;
             out << YAML::Key << "Intensity" << YAML::Value << pc.Intensity;
+            out << YAML::Key << "Radius" << YAML::Value << pc.Radius;
 
             out << YAML::EndMap;
         }
@@ -401,6 +406,7 @@ namespace Chozo {
             out << YAML::Key << "AngleAttenuation" << YAML::Value << sc.AngleAttenuation;
             out << YAML::Key << "Color" << YAML::Value << sc.Color;
             out << YAML::Key << "Angle" << YAML::Value << sc.Angle;
+            out << YAML::Key << "Radius" << YAML::Value << sc.Radius;
 
             out << YAML::EndMap;
         }
@@ -596,6 +602,8 @@ namespace Chozo {
                     auto& comp = deserializedEntity.AddComponent<PointLightComponent>();
                     comp.Color = pointLightComponent["Color"].as<glm::vec3>();
                     comp.Intensity = pointLightComponent["Intensity"].as<float>();
+                    if (pointLightComponent["Radius"])
+                        comp.Radius = pointLightComponent["Radius"].as<float>();
                 }
 
                 if (auto spotLightComponent = entity["SpotLightComponent"])
@@ -606,6 +614,8 @@ namespace Chozo {
                     comp.AngleAttenuation = spotLightComponent["AngleAttenuation"].as<float>();
                     comp.Color = spotLightComponent["Color"].as<glm::vec3>();
                     comp.Angle = spotLightComponent["Angle"].as<float>();
+                    if (spotLightComponent["Radius"])
+                        comp.Radius = spotLightComponent["Radius"].as<float>();
                 }
             }
         }
@@ -626,6 +636,20 @@ namespace Chozo {
 		const uint64_t metadataAbsolutePosition = stream.GetStreamPosition();
 		stream.WriteZero(sizeof(TextureFileMetadata));
 
+        // Write mip table
+        const Texture2DSpecification spec = texture->GetSpecification();
+        CZ_CORE_ASSERT(spec.ResidentMip == 0, "Streamed textures are made resident before they are saved!");
+        if (spec.MipLevels > 1)
+        {
+            for (uint32_t level = 0; level < spec.MipLevels; level++)
+            {
+                TextureMipInfo mip;
+                mip.Offset = Image::GetMipChainSize(spec.Format, texture->GetWidth(), texture->GetHeight(), level);
+                mip.Size = Image::GetImageSize(spec.Format, std::max(texture->GetWidth() >> level, 1u), std::max(texture->GetHeight() >> level, 1u));
+                stream.WriteRaw(mip);
+            }
+        }
+
         // Write buffer
 		Buffer buffer;
         texture->CopyToHostBuffer(buffer);
@@ -635,7 +659,7 @@ namespace Chozo {
         // Write metadata
         textureMetada.Format = (uint16_t)texture->GetSpecification().Format;
         textureMetada.Samples = texture->GetSpecification().Samples;
-        textureMetada.Mipmap = (uint8_t)texture->GetSpecification().Mipmap;
+        textureMetada.Mipmap = (uint8_t)spec.MipLevels;
         textureMetada.Width = texture->GetWidth();
         textureMetada.Height = texture->GetHeight();
         textureMetada.MinFilter = (uint16_t)texture->GetSpecification().MinFilter;
@@ -667,18 +691,83 @@ namespace Chozo {
 		spec.Width = textureMetada.Width;
 		spec.Height = textureMetada.Height;
 		spec.Mipmap = (bool)textureMetada.Mipmap;
+		spec.MipLevels = std::max<uint32_t>(textureMetada.Mipmap, 1);
 		spec.MinFilter = (ImageParameter)textureMetada.MinFilter;
 		spec.MagFilter = (ImageParameter)textureMetada.MagFilter;
 		spec.WrapR = (ImageParameter)textureMetada.WrapR;
 		spec.WrapS = (ImageParameter)textureMetada.WrapS;
 		spec.WrapT = (ImageParameter)textureMetada.WrapT;
 
-        // Read buffer
+        // Read mip table
+        std::vector<TextureMipInfo> mips(spec.MipLevels > 1 ? spec.MipLevels : 0);
+        for (auto& mip : mips)
+            stream.ReadRaw(mip);
+
+        uint32_t bufferSize = 0;
+        stream.ReadRaw(bufferSize);
+        const uint64_t pixelOffset = stream.GetStreamPosition();
+
+        // Levels are uploaded from their offsets in the chain, a table that disagrees leaves level 0 only.
+        for (uint32_t level = 0; level < (uint32_t)mips.size(); level++)
+        {
+            const uint64_t offset = Image::GetMipChainSize(spec.Format, spec.Width, spec.Height, level);
+            if (mips[level].Offset != offset || mips[level].Offset + mips[level].Size > bufferSize)
+            {
+                CZ_CORE_WARN("Texture {} has a mip table that doesn't match its pixels, only level 0 is loaded.", metadata.FilePath.string());
+                spec.MipLevels = 1;
+                break;
+            }
+        }
+
+        // Read buffer, streamed textures leave the levels larger than their initial resident mip in the file.
+        // Blocks the driver lacks are decompressed whole below, those textures stay out of streaming.
+        const bool decompress = Image::IsCompressedFormat(spec.Format) && !Renderer::IsCompressedFormatSupported(spec.Format);
+        spec.ResidentMip = decompress ? 0 : TextureStreamer::GetInitialResidentMip(spec);
+        const uint64_t skippedSize = Image::GetMipChainSize(spec.Format, spec.Width, spec.Height, spec.ResidentMip);
+        stream.SetStreamPosition(pixelOffset + skippedSize);
+
         Buffer buffer;
-        stream.ReadBuffer(buffer);
+        stream.ReadBuffer(buffer, bufferSize - (uint32_t)skippedSize);
+
+        // Written before HDR imports were stored compact, converted so the next save persists the smaller format.
+        const ImageFormat hdrFormat = Renderer::GetConfig().HDRTextureFormat;
+        if (spec.Format == ImageFormat::RGBA32F && hdrFormat != ImageFormat::RGBA32F && Image::IsHDRFormat(hdrFormat)
+            && buffer.Size == (uint64_t)spec.Width * spec.Height * Image::GetBytesPerPixel(spec.Format))
+        {
+            Buffer compact = ImageConverter::FromRGBA32F(buffer.As<float>(), (uint64_t)spec.Width * spec.Height, hdrFormat);
+            buffer.Release();
+            buffer = compact;
+            spec.Format = hdrFormat;
+        }
+
+        // Blocks written on a machine whose driver had a format this one lacks (BC7 on macOS).
+        if (decompress)
+        {
+            CZ_CORE_WARN("Texture {} is stored in a block format the driver lacks, decompressing it.", metadata.FilePath.string());
+            Buffer pixels;
+            pixels.Allocate(Image::GetMipChainSize(ImageFormat::RGBA, spec.Width, spec.Height, spec.MipLevels));
+            for (uint32_t level = 0; level < spec.MipLevels; level++)
+            {
+                const uint32_t levelWidth = std::max(spec.Width >> level, 1u), levelHeight = std::max(spec.Height >> level, 1u);
+                Buffer levelPixels = TextureCompressor::Decompress(static_cast<uint8_t*>(buffer.Data) + Image::GetMipChainSize(spec.Format, spec.Width, spec.Height, level),
+                    levelWidth, levelHeight, spec.Format);
+                memcpy(static_cast<uint8_t*>(pixels.Data) + Image::GetMipChainSize(ImageFormat::RGBA, spec.Width, spec.Height, level), levelPixels.Data, levelPixels.Size);
+                levelPixels.Release();
+            }
+            buffer.Release();
+            buffer = pixels;
+            spec.Format = ImageFormat::RGBA;
+        }
+
         Ref<Texture2D> texture = Texture2D::Create(buffer, spec);
         buffer.Release();
 
+        if (spec.ResidentMip > 0)
+        {
+            fs::path filepath = Utils::File::GetAssetDirectory() / metadata.FilePath;
+            TextureStreamer::Register(texture, filepath.parent_path() / (filepath.filename().string() + ".asset"), pixelOffset);
+        }
+
         return texture;
     }
 
@@ -840,14 +929,18 @@ namespace Chozo {
         stream.WriteArray(meshSource->m_Submeshes);
         meshSourceMetadata.SubMeshArraySize = (stream.GetStreamPosition() - start) - meshSourceMetadata.SubMeshArrayOffset;
 
+        // Choose the smallest layouts that can represent this mesh
+        meshSourceMetadata.VertexBufferFormat = MeshPacker::ChooseVertexFormat(meshSource->m_Buffer.Vertexs, meshSource->m_Submeshes);
+        meshSourceMetadata.IndexBufferFormat = MeshPacker::ChooseIndexFormat(meshSource->m_Buffer.Indexs);
+
         // Write vertex buffer
         meshSourceMetadata.VertexBufferOffset = stream.GetStreamPosition() - start;
-        stream.WriteArray(meshSource->m_Buffer.Vertexs);
+        stream.WriteArray(MeshPacker::PackVertices(meshSource->m_Buffer.Vertexs, meshSource->m_Submeshes, meshSourceMetadata.VertexBufferFormat));
         meshSourceMetadata.VertexBufferSize = (stream.GetStreamPosition() - start) - meshSourceMetadata.VertexBufferOffset;
 
         // Write index buffer
         meshSourceMetadata.IndexBufferOffset = stream.GetStreamPosition() - start;
-        stream.WriteArray(meshSource->m_Buffer.Indexs);
+        stream.WriteArray(MeshPacker::PackIndices(meshSource->m_Buffer.Indexs, meshSourceMetadata.IndexBufferFormat));
         meshSourceMetadata.IndexBufferSize = (stream.GetStreamPosition() - start) - meshSourceMetadata.IndexBufferOffset;
 
         // Write material buffer
@@ -955,6 +1048,18 @@ namespace Chozo {
         fs::path filepath = Utils::File::GetAssetDirectory() / path;
         fs::path dest = filepath.parent_path() / (filepath.filename().string() + ".asset");
 
+		// Older files lay the metadata and submeshes out differently, reading them would follow bad offsets.
+		const uint64_t metadataPosition = stream.GetStreamPosition();
+		AssetFileHeader header;
+		stream.SetStreamPosition(0);
+		stream.ReadRaw<AssetFileHeader>(header);
+		if (header.Version != AssetFileHeader::CurrentVersion)
+		{
+			CZ_CORE_ERROR("Mesh asset {} has version {}, expected {}. Re-import the mesh.", dest.string(), header.Version, AssetFileHeader::CurrentVersion);
+			return nullptr;
+		}
+		stream.SetStreamPosition(metadataPosition);
+
 		Ref<MeshSource> meshSource = Ref<MeshSource>::Create();
 
 		uint64_t streamOffset = 0;
@@ -976,12 +1081,17 @@ namespace Chozo {
         stream.ReadArray(meshSource->m_Submeshes);
 
         // Read vertex buffer
+		std::vector<uint8_t> vertexData;
 		stream.SetStreamPosition(meshSourceMetadata.VertexBufferOffset + streamOffset);
-		stream.ReadArray(meshSource->m_Buffer.Vertexs);
+		stream.ReadArray(vertexData);
+		meshSource->m_Buffer.Vertexs = MeshPacker::UnpackVertices(vertexData, meshSource->m_Submeshes, meshSourceMetadata.VertexBufferFormat);
+		meshSource->m_VertexFormat = meshSourceMetadata.VertexBufferFormat;
 
         // Read index buffer
+		std::vector<uint8_t> indexData;
         stream.SetStreamPosition(meshSourceMetadata.IndexBufferOffset + streamOffset);
-		stream.ReadArray(meshSource->m_Buffer.Indexs);
+		stream.ReadArray(indexData);
+		meshSource->m_Buffer.Indexs = MeshPacker::UnpackIndices(indexData, meshSourceMetadata.IndexBufferFormat);
 
         // Read materials
         std::vector<MeshMaterial> meshMaterials;
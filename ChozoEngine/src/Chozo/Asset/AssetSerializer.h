@@ -3,13 +3,17 @@
 #include "Asset.h"
 #include "Chozo/Scene/Scene.h"
 #include "Chozo/Renderer/Material.h"
+#include "Chozo/Renderer/Mesh.h"
 #include "Chozo/FileSystem/FileStream.h"
 
 namespace Chozo {
 
 	struct AssetFileHeader
 	{
-		uint32_t Version = 1;
+		// Bumped when a serializer's binary layout changes, 2 added mesh LODs, packed vertices and meshlets.
+		static constexpr uint32_t CurrentVersion = 2;
+
+		uint32_t Version = CurrentVersion;
 		uint16_t Type{};
 	};
 
@@ -43,7 +47,7 @@ namespace Chozo {
 
 		uint32_t Samples;
 		uint32_t Width, Height;
-		uint8_t Mipmap;
+		uint8_t Mipmap; // Mip level count, files written before the chains were stored have 0 or 1
 		uint16_t WrapR;
 		uint16_t WrapS;
 		uint16_t WrapT;
@@ -51,6 +55,13 @@ namespace Chozo {
 		uint16_t MagFilter;
 	};
 
+	// One per level after the metadata when there is more than one, offsets from the start of the pixel data.
+	struct TextureMipInfo
+	{
+		uint64_t Offset{};
+		uint64_t Size{};
+	};
+
     class TextureSerializer final : public AssetSerializer
 	{
 	public:
@@ -153,6 +164,9 @@ namespace Chozo {
 		uint32_t Flags{};
 		AABB BoundingBox;
 
+		VertexFormat VertexBufferFormat = VertexFormat::Compact;
+		IndexFormat IndexBufferFormat = IndexFormat::UInt32;
+
 		uint64_t NodeArrayOffset{};
 		uint64_t NodeArraySize{};
 
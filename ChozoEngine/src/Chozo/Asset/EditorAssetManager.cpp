@@ -61,6 +61,7 @@ namespace Chozo {
 
         m_AssetRegistry[metadata.Handle] = metadata;
         m_MemoryAssets[asset->Handle] = asset;
+        BumpGeneration();
 
         return asset->Handle;
     }
@@ -90,6 +91,7 @@ namespace Chozo {
         m_AssetRegistry.Remove(handle);
         m_LoadedAssets.erase(handle);
         m_MemoryAssets.erase(handle);
+        BumpGeneration();
 
         WriteRegistryToFile();
 
@@ -150,6 +152,7 @@ namespace Chozo {
         metadata.Type = type;
         metadata.LastModifiedAt = metadata.ModifiedAt;
         m_AssetRegistry[metadata.Handle] = metadata;
+        BumpGeneration();
         CZ_CORE_TRACE("Import asset {0} , {1}.", std::to_string(metadata.Handle), metadata.IsModified());
         return metadata.Handle;
     }
@@ -182,6 +185,7 @@ namespace Chozo {
             asset->Handle = metadata.Handle;
             m_LoadedAssets[metadata.Handle] = asset;
             m_AssetRegistry[metadata.Handle] = metadata;
+            BumpGeneration();
             CZ_CORE_TRACE("Loading asset {0} from {1} finished.", std::to_string(metadata.Handle), metadata.FilePath.string());
             RegisterAssetCallback(asset);
             return metadata.Handle;
@@ -252,6 +256,7 @@ namespace Chozo {
 
         m_LoadedAssets[asset->Handle] = asset;
         m_AssetRegistry[metadata.Handle] = metadata;
+        BumpGeneration();
 
         WriteRegistryToFile();
     }
@@ -300,6 +305,7 @@ namespace Chozo {
     {
         AssetRegistrySerializer serializer(m_AssetRegistry);
         m_AssetRegistry = serializer.Deserialize("../assets/AssetRegistry.czar");
+        BumpGeneration();
     }
 
     void EditorAssetManager::ProcessDirectory(const fs::path &directoryPath)
@@ -11,7 +11,8 @@ namespace Chozo {
 
     Application* Application::s_Instance = nullptr;
 
-    Application::Application(const std::string& name)
+    Application::Application(const std::string& name, const ThreadingPolicy threadingPolicy)
+        : m_RenderThread(threadingPolicy)
     {
         CZ_CORE_ASSERT(!s_Instance, "Application already exists!");
         s_Instance = this;
@@ -31,10 +32,13 @@ namespace Chozo {
 
         m_ImGuiLayer = new ImGuiLayer();
         PushOverlay(m_ImGuiLayer);
+
+        m_RenderThread.Run();
     }
 
     Application::~Application()
     {
+        m_RenderThread.Terminate();
 		Renderer::Shutdown();
     }
 
@@ -71,22 +75,38 @@ namespace Chozo {
             const TimeStep timeStep = time - m_LastFrameTime;
             m_LastFrameTime = time;
 
+            const bool multiThreaded = m_RenderThread.GetThreadingPolicy() == ThreadingPolicy::MultiThreaded;
+            if (multiThreaded)
+            {
+                // Wait for frame N-1, then hand frame N to the render thread and record N+1 alongside it.
+                m_RenderThread.BlockUntilRenderComplete();
+                m_RenderThread.NextFrame();
+                m_RenderThread.Kick();
+            }
+
             Renderer::Begin();
 
+            m_TimerWheel.Tick();
             m_Pool->Update();
 
             for (Layer* layer : m_LayerStack)
                 layer->OnUpdate(timeStep);
 
-            // TODO: execute this stuff on render thread.
             m_ImGuiLayer->Begin();
             for (Layer* layer : m_LayerStack)
                 layer->OnImGuiRender();
             m_ImGuiLayer->End();
 
-            Renderer::End();
-
-            m_Window->OnUpdate();
+            if (multiThreaded)
+            {
+                Renderer::Submit([window = m_Window.get()]() { window->SwapBuffers(); });
+                m_Window->ProcessEvents();
+            }
+            else
+            {
+                m_RenderThread.Pump();
+                m_Window->OnUpdate();
+            }
         }
     }
 
@@ -5,6 +5,8 @@
 #include "Chozo/Core/Window.h"
 #include "Chozo/Core/LayerStack.h"
 #include "Chozo/Core/Pool.h"
+#include "Chozo/Core/RenderThread.h"
+#include "Chozo/Core/TimerWheel.h"
 
 #include "Chozo/Events/Event.h"
 #include "Chozo/Events/ApplicationEvent.h"
@@ -18,7 +20,7 @@ namespace Chozo
     class Application
     {
     public:
-        explicit Application(const std::string& name);
+        explicit Application(const std::string& name, ThreadingPolicy threadingPolicy = ThreadingPolicy::SingleThreaded);
         virtual ~Application();
 
         void Run();
@@ -31,6 +33,8 @@ namespace Chozo
 
         Window& GetWindow() const { return *m_Window; }
         Ref<Pool>& GetPool() { return m_Pool; }
+        RenderThread& GetRenderThread() { return m_RenderThread; }
+        TimerWheel& GetTimerWheel() { return m_TimerWheel; }
         ImGuiLayer& GetImGuiLayer() const { return *m_ImGuiLayer; }
         static Application& Get() { return *s_Instance; }
 
@@ -45,6 +49,8 @@ namespace Chozo
         LayerStack m_LayerStack;
         TimeStep m_TimeStep;
         float m_LastFrameTime = 0.0f;
+        RenderThread m_RenderThread;
+        TimerWheel m_TimerWheel;
     private:
         static Application* s_Instance;
 		Ref<EditorAssetManager> m_AssetManager;
@@ -2,6 +2,34 @@
 
 namespace Chozo {
 
+    Pool* Pool::s_Instance = nullptr;
+
+    Pool::Pool()
+    {
+        // The thread calling ParallelFor takes indices as well.
+        const uint32_t workerCount = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+        m_Workers.reserve(workerCount);
+        for (uint32_t i = 0; i < workerCount; i++)
+            m_Workers.emplace_back([this]() { WorkerLoop(); });
+
+        s_Instance = this;
+    }
+
+    Pool::~Pool()
+    {
+        if (s_Instance == this)
+            s_Instance = nullptr;
+
+        {
+            std::lock_guard lock(m_JobMutex);
+            m_Stopping = true;
+        }
+        m_JobCondition.notify_all();
+
+        for (auto& worker : m_Workers)
+            worker.join();
+    }
+
     void Pool::Update()
     {
         if (m_Pause)
@@ -51,4 +79,99 @@ namespace Chozo {
             tasks.erase(it);
     }
 
+    void Pool::ParallelFor(const uint32_t count, const std::function<void(uint32_t)>& func)
+    {
+        Pool* pool = s_Instance;
+        if (!pool || count < 2)
+        {
+            for (uint32_t i = 0; i < count; i++)
+                func(i);
+            return;
+        }
+
+        const auto job = std::make_shared<ParallelJob>();
+        job->Func = &func;
+        job->Count = count;
+        {
+            std::lock_guard lock(pool->m_JobMutex);
+            pool->m_Jobs.push_back(job);
+        }
+        pool->m_JobCondition.notify_all();
+
+        // Also makes nested calls from inside func safe, every index is eventually taken by a running thread.
+        pool->RunJob(*job);
+
+        std::unique_lock lock(pool->m_JobMutex);
+        pool->m_Jobs.erase(std::remove(pool->m_Jobs.begin(), pool->m_Jobs.end(), job), pool->m_Jobs.end());
+        pool->m_JobCondition.wait(lock, [&job]() { return job->Done == job->Count; });
+    }
+
+    void Pool::Dispatch(std::function<void()>&& func)
+    {
+        Pool* pool = s_Instance;
+        if (!pool)
+        {
+            func();
+            return;
+        }
+
+        {
+            std::lock_guard lock(pool->m_JobMutex);
+            pool->m_Dispatched.push_back(std::move(func));
+        }
+        // Threads waiting for a ParallelFor share the condition, a single wake up could miss the workers.
+        pool->m_JobCondition.notify_all();
+    }
+
+    void Pool::WorkerLoop()
+    {
+        while (true)
+        {
+            std::shared_ptr<ParallelJob> job;
+            std::function<void()> func;
+            {
+                std::unique_lock lock(m_JobMutex);
+                m_JobCondition.wait(lock, [this]() { return m_Stopping || !m_Jobs.empty() || !m_Dispatched.empty(); });
+                if (!m_Jobs.empty())
+                {
+                    job = m_Jobs.front();
+                }
+                else if (!m_Dispatched.empty())
+                {
+                    func = std::move(m_Dispatched.front());
+                    m_Dispatched.pop_front();
+                }
+                else
+                {
+                    return;
+                }
+            }
+
+            if (func)
+            {
+                func();
+                continue;
+            }
+
+            RunJob(*job);
+
+            // Every index is taken, the job no longer needs workers.
+            std::lock_guard lock(m_JobMutex);
+            m_Jobs.erase(std::remove(m_Jobs.begin(), m_Jobs.end(), job), m_Jobs.end());
+        }
+    }
+
+    void Pool::RunJob(ParallelJob& job)
+    {
+        for (uint32_t i = job.Next++; i < job.Count; i = job.Next++)
+        {
+            (*job.Func)(i);
+            if (++job.Done == job.Count)
+            {
+                std::lock_guard lock(m_JobMutex);
+                m_JobCondition.notify_all();
+            }
+        }
+    }
+
 } // namespace Chozo
@@ -4,13 +4,19 @@
 
 #include "PoolTask.h"
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
 namespace Chozo {
 
     class Pool final : public RefCounted
     {
     public:
-        Pool() = default;
-        ~Pool() override = default;
+        Pool();
+        ~Pool() override;
 
         inline void Start() { m_Pause = false; }
         inline void Pause() { m_Pause = true; }
@@ -18,9 +24,36 @@ namespace Chozo {
         bool TaskExists(Ref<PoolTask> task);
         void AddTask(const Ref<PoolTask>& task);
         void RemoveTask(Ref<PoolTask> task);
+
+        // Calls func for every index in [0, count) on the workers of the application's pool and the calling thread,
+        // returns once all calls have. Runs on the calling thread alone while no pool exists, in tools and tests.
+        static void ParallelFor(uint32_t count, const std::function<void(uint32_t)>& func);
+        // Runs func on one of the application pool's workers and returns right away, ParallelFor calls go first.
+        // Runs it on the calling thread while no pool exists. Work queued when the pool stops still runs.
+        static void Dispatch(std::function<void()>&& func);
+    private:
+        struct ParallelJob
+        {
+            const std::function<void(uint32_t)>* Func = nullptr;
+            uint32_t Count = 0;
+            std::atomic<uint32_t> Next = 0;
+            std::atomic<uint32_t> Done = 0;
+        };
+
+        void WorkerLoop();
+        void RunJob(ParallelJob& job);
     private:
         bool m_Pause{true};
         std::vector<Ref<PoolTask>> m_Tasks;
+
+        std::vector<std::thread> m_Workers;
+        std::vector<std::shared_ptr<ParallelJob>> m_Jobs;
+        std::deque<std::function<void()>> m_Dispatched;
+        std::mutex m_JobMutex;
+        std::condition_variable m_JobCondition;
+        bool m_Stopping = false;
+
+        static Pool* s_Instance;
     };
     
 } // namespace Chozo
@@ -0,0 +1,166 @@
+#include "RenderThread.h"
+
+#include "Application.h"
+#include "Chozo/Renderer/Renderer.h"
+
+#include <GLFW/glfw3.h>
+
+namespace Chozo {
+
+    static std::thread::id s_RenderThreadID;
+    // The render thread owning the context, null unless a multi threaded one runs.
+    static RenderThread* s_ContextOwner = nullptr;
+
+    RenderThread::RenderThread(const ThreadingPolicy policy)
+        : m_ThreadingPolicy(policy), m_Thread("Render Thread")
+    {
+    }
+
+    RenderThread::~RenderThread()
+    {
+        Terminate();
+    }
+
+    void RenderThread::Run()
+    {
+        m_Running = true;
+        if (m_ThreadingPolicy == ThreadingPolicy::MultiThreaded)
+        {
+            // The render thread owns the window context from here on.
+            GLFWwindow* window = Application::Get().GetWindow().GetNativeWindow();
+            glfwMakeContextCurrent(nullptr);
+            s_ContextOwner = this;
+
+            m_Thread.Dispatch([this, window]() {
+                s_RenderThreadID = std::this_thread::get_id();
+                glfwMakeContextCurrent(window);
+                Renderer::RenderThreadFunc(this);
+                glfwMakeContextCurrent(nullptr);
+            });
+        }
+        else
+        {
+            s_RenderThreadID = std::this_thread::get_id();
+        }
+    }
+
+    void RenderThread::Terminate()
+    {
+        if (!m_Running)
+            return;
+
+        if (m_ThreadingPolicy == ThreadingPolicy::MultiThreaded)
+        {
+            // Let the last kicked frame finish, then wake the render thread so it observes m_Running and exits.
+            BlockUntilRenderComplete();
+            m_Running = false;
+            Kick();
+            m_Thread.Join();
+
+            s_ContextOwner = nullptr;
+            glfwMakeContextCurrent(Application::Get().GetWindow().GetNativeWindow());
+        }
+        m_Running = false;
+    }
+
+    void RenderThread::Wait(const State waitForState)
+    {
+        std::unique_lock lock(m_Mutex);
+        m_Condition.wait(lock, [this, waitForState]() { return m_State == waitForState; });
+    }
+
+    void RenderThread::WaitAndSet(const State waitForState, const State setToState)
+    {
+        std::unique_lock lock(m_Mutex);
+        m_Condition.wait(lock, [this, waitForState]() { return m_State == waitForState; });
+        m_State = setToState;
+        m_Condition.notify_all();
+    }
+
+    void RenderThread::Set(const State setToState)
+    {
+        std::lock_guard lock(m_Mutex);
+        m_State = setToState;
+        m_Condition.notify_all();
+    }
+
+    void RenderThread::NextFrame()
+    {
+        Renderer::SwapQueues();
+    }
+
+    void RenderThread::BlockUntilRenderComplete()
+    {
+        if (m_ThreadingPolicy == ThreadingPolicy::SingleThreaded)
+            return;
+
+        Wait(State::Idle);
+    }
+
+    void RenderThread::Kick()
+    {
+        if (m_ThreadingPolicy == ThreadingPolicy::SingleThreaded)
+        {
+            Set(State::Kick);
+            Renderer::WaitAndRender(this);
+            return;
+        }
+
+        // Not over an ExecuteBlocking request another thread made since the last fence.
+        WaitAndSet(State::Idle, State::Kick);
+    }
+
+    void RenderThread::Pump()
+    {
+        NextFrame();
+        Kick();
+        BlockUntilRenderComplete();
+    }
+
+    void RenderThread::WaitForKick()
+    {
+        std::unique_lock lock(m_Mutex);
+        while (true)
+        {
+            m_Condition.wait(lock, [this]() { return m_State == State::Kick || m_State == State::Execute; });
+            if (m_State == State::Kick)
+                break;
+
+            lock.unlock();
+            (*m_BlockingFunc)();
+            lock.lock();
+
+            m_BlockingFunc = nullptr;
+            m_State = State::Idle;
+            m_Condition.notify_all();
+        }
+
+        m_State = State::Busy;
+        m_Condition.notify_all();
+    }
+
+    bool RenderThread::IsCurrentThreadRT()
+    {
+        return std::this_thread::get_id() == s_RenderThreadID;
+    }
+
+    bool RenderThread::OwnsContext()
+    {
+        return !s_ContextOwner || IsCurrentThreadRT();
+    }
+
+    void RenderThread::ExecuteBlocking(const std::function<void()>& func)
+    {
+        RenderThread* renderThread = s_ContextOwner;
+        CZ_CORE_ASSERT(renderThread, "No render thread to execute on!");
+
+        // Idle means the last kicked frame is done, so func lands between it and the one being recorded.
+        std::unique_lock lock(renderThread->m_Mutex);
+        renderThread->m_Condition.wait(lock, [renderThread]() { return renderThread->m_State == State::Idle; });
+        renderThread->m_BlockingFunc = &func;
+        renderThread->m_State = State::Execute;
+        renderThread->m_Condition.notify_all();
+
+        renderThread->m_Condition.wait(lock, [renderThread, &func]() { return renderThread->m_BlockingFunc != &func; });
+    }
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "Thread.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+
+namespace Chozo {
+
+    enum class ThreadingPolicy
+    {
+        None = 0,
+        // Commands recorded in a frame execute on the main thread at the end of that frame.
+        SingleThreaded,
+        // A render thread owning the GL context executes frame N while the main thread records frame N+1.
+        // Every GL call goes through Renderer::Submit or Renderer::SubmitAndWait in this mode.
+        MultiThreaded
+    };
+
+    class RenderThread
+    {
+    public:
+        enum class State
+        {
+            Idle = 0,
+            Busy,
+            Kick,
+            // An ExecuteBlocking request is waiting for the idle render thread.
+            Execute
+        };
+
+        explicit RenderThread(ThreadingPolicy policy);
+        ~RenderThread();
+
+        void Run();
+        void Terminate();
+        bool IsRunning() const { return m_Running; }
+        ThreadingPolicy GetThreadingPolicy() const { return m_ThreadingPolicy; }
+
+        void Wait(State waitForState);
+        void WaitAndSet(State waitForState, State setToState);
+        void Set(State setToState);
+
+        // Swaps the submission and execution command queues, the render thread must be idle.
+        void NextFrame();
+        // Fence for the frame handed to the render thread by the last Kick.
+        void BlockUntilRenderComplete();
+        // Hands the queue recorded last frame to the render thread.
+        void Kick();
+        // NextFrame, Kick and execute on the calling thread, used by the single threaded policy.
+        void Pump();
+        // Render thread, waits for the next Kick and runs the ExecuteBlocking requests that come in meanwhile.
+        void WaitForKick();
+
+        static bool IsCurrentThreadRT();
+        // Whether the calling thread may call GL directly: the render thread while a multi threaded one runs,
+        // every thread otherwise.
+        static bool OwnsContext();
+        // Runs func on the multi threaded render thread between two frames and returns once it has.
+        static void ExecuteBlocking(const std::function<void()>& func);
+    private:
+        ThreadingPolicy m_ThreadingPolicy;
+        Thread m_Thread;
+        std::atomic<bool> m_Running = false;
+
+        std::mutex m_Mutex;
+        std::condition_variable m_Condition;
+        State m_State = State::Idle;
+        const std::function<void()>* m_BlockingFunc = nullptr;
+    };
+}
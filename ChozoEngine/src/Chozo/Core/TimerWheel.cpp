@@ -0,0 +1,119 @@
+#include "TimerWheel.h"
+
+namespace Chozo {
+
+    TimerWheel::TimerWheel(const uint32_t slotCount, const uint32_t tickMillis)
+        : m_TickMillis(std::max(tickMillis, 1u)), m_Start(std::chrono::steady_clock::now())
+    {
+        CZ_CORE_ASSERT(slotCount > 0, "TimerWheel needs at least one slot!");
+        m_Slots.resize(slotCount);
+    }
+
+    void TimerWheel::Debounce(const uint64_t key, const uint32_t delay, Task&& task)
+    {
+        std::lock_guard lock(m_Mutex);
+        Schedule(key, GetCurrentTick() + ToTicks(delay), std::move(task));
+    }
+
+    void TimerWheel::Throttle(const uint64_t key, const uint32_t interval, Task&& task)
+    {
+        std::lock_guard lock(m_Mutex);
+
+        const uint64_t now = GetCurrentTick();
+        auto& windowEnd = m_ThrottleWindows[key];
+        if (windowEnd <= now && m_Timers.find(key) == m_Timers.end())
+        {
+            windowEnd = now + ToTicks(interval);
+            Schedule(key, now + 1, std::move(task));
+            return;
+        }
+
+        // The trailing run opens the next window, so a steady stream of calls runs once per interval.
+        const uint64_t deadline = std::max(windowEnd, now + 1);
+        windowEnd = deadline + ToTicks(interval);
+        Schedule(key, deadline, std::move(task));
+    }
+
+    void TimerWheel::Cancel(const uint64_t key)
+    {
+        std::lock_guard lock(m_Mutex);
+        m_Timers.erase(key);
+    }
+
+    bool TimerWheel::IsPending(const uint64_t key)
+    {
+        std::lock_guard lock(m_Mutex);
+        return m_Timers.find(key) != m_Timers.end();
+    }
+
+    void TimerWheel::Tick()
+    {
+        std::vector<Task> dueTasks;
+        {
+            std::lock_guard lock(m_Mutex);
+
+            const uint64_t now = GetCurrentTick();
+            // After a stall longer than a revolution every slot is visited once, anything overdue still fires.
+            const uint64_t last = std::min(now, m_Tick + m_Slots.size());
+            for (uint64_t tick = m_Tick + 1; tick <= last; tick++)
+            {
+                auto& slot = m_Slots[tick % m_Slots.size()];
+                size_t kept = 0;
+                for (auto& entry : slot)
+                {
+                    if (entry.Deadline > now)
+                    {
+                        slot[kept++] = entry;
+                        continue;
+                    }
+
+                    auto it = m_Timers.find(entry.Key);
+                    if (it != m_Timers.end() && it->second.Deadline == entry.Deadline)
+                    {
+                        dueTasks.emplace_back(std::move(it->second.Callback));
+                        m_Timers.erase(it);
+                    }
+                }
+                slot.resize(kept);
+            }
+            m_Tick = std::max(m_Tick, now);
+
+            // A closed window without a trailing run pending behaves like no window at all.
+            for (auto it = m_ThrottleWindows.begin(); it != m_ThrottleWindows.end();)
+            {
+                if (it->second <= now && m_Timers.find(it->first) == m_Timers.end())
+                    it = m_ThrottleWindows.erase(it);
+                else
+                    ++it;
+            }
+        }
+
+        for (auto& task : dueTasks)
+            task();
+    }
+
+    uint64_t TimerWheel::GetCurrentTick() const
+    {
+        const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - m_Start).count();
+        return (uint64_t)elapsed / m_TickMillis;
+    }
+
+    uint64_t TimerWheel::ToTicks(const uint32_t millis) const
+    {
+        return std::max<uint64_t>((millis + m_TickMillis - 1) / m_TickMillis, 1);
+    }
+
+    void TimerWheel::Schedule(const uint64_t key, uint64_t deadline, Task&& task)
+    {
+        // Slots up to m_Tick have been visited already.
+        deadline = std::max(deadline, m_Tick + 1);
+
+        auto& timer = m_Timers[key];
+        const bool queued = timer.Callback && timer.Deadline == deadline;
+        timer.Deadline = deadline;
+        timer.Callback = std::move(task);
+
+        if (!queued)
+            m_Slots[deadline % m_Slots.size()].push_back({ key, deadline });
+    }
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "czpch.h"
+
+#include <chrono>
+#include <mutex>
+
+namespace Chozo {
+
+    // Hashed timer wheel ticked from the main loop, tasks run on the thread that calls Tick.
+    // Tasks are keyed, scheduling a key that is still pending replaces its task instead of adding another one.
+    class TimerWheel
+    {
+    public:
+        using Task = std::function<void()>;
+
+        explicit TimerWheel(uint32_t slotCount = 256, uint32_t tickMillis = 10);
+
+        // Runs task once delay ms have passed without another Debounce on the same key.
+        void Debounce(uint64_t key, uint32_t delay, Task&& task);
+        // Runs task at most once per interval ms. A call outside the window runs on the next tick,
+        // calls inside it replace the pending task, which runs when the window closes.
+        void Throttle(uint64_t key, uint32_t interval, Task&& task);
+        void Cancel(uint64_t key);
+        bool IsPending(uint64_t key);
+
+        void Tick();
+    private:
+        uint64_t GetCurrentTick() const;
+        uint64_t ToTicks(uint32_t millis) const;
+        void Schedule(uint64_t key, uint64_t deadline, Task&& task);
+    private:
+        struct Timer
+        {
+            uint64_t Deadline = 0;
+            Task Callback;
+        };
+
+        struct SlotEntry
+        {
+            uint64_t Key;
+            uint64_t Deadline;
+        };
+
+        uint32_t m_TickMillis;
+        std::chrono::steady_clock::time_point m_Start;
+        uint64_t m_Tick = 0;
+
+        // Entries stay in their slot when a key is rescheduled and are skipped once their deadline no longer matches.
+        std::vector<std::vector<SlotEntry>> m_Slots;
+        std::unordered_map<uint64_t, Timer> m_Timers;
+        // Tick at which the current throttle window of a key closes.
+        std::unordered_map<uint64_t, uint64_t> m_ThrottleWindows;
+        std::mutex m_Mutex;
+    };
+}
@@ -170,9 +170,18 @@ namespace Chozo {
     {
         glfwMakeContextCurrent(m_Window);
 
+        SwapBuffers();
+        ProcessEvents();
+    }
+
+    void Window::SwapBuffers()
+    {
         /* Swap front and back buffers */
         m_Context->SwapBuffers();
+    }
 
+    void Window::ProcessEvents()
+    {
         /* Poll for and process events */
         glfwPollEvents();
     }
@@ -34,6 +34,9 @@ namespace Chozo {
         void Init(const WindowProps& props);
         void Shutdown();
         void OnUpdate();
+        // Split halves of OnUpdate, the render thread swaps while the main thread keeps polling events.
+        void SwapBuffers();
+        void ProcessEvents();
 
         [[nodiscard]] unsigned int GetWidth() const { return m_Data.Width; }
         [[nodiscard]] unsigned int GetHeight() const { return m_Data.Height; }
@@ -4,11 +4,16 @@
 
 #include "Chozo/Core/Application.h"
 #include "Chozo/Renderer/Renderer.h"
+#include "Chozo/Renderer/MeshOptimizer.h"
+#include "Chozo/Renderer/MeshPacker.h"
 
 namespace Chozo {
 
     namespace Utils {
 
+        constexpr uint32_t MaxSubmeshLODs = 3;
+        constexpr float LODMaxError = 0.05f;
+
         glm::mat4 Mat4FromAIMatrix4x4(const aiMatrix4x4& matrix)
         {
             glm::mat4 result;
@@ -79,6 +84,8 @@ namespace Chozo {
 				CZ_CORE_ASSERT(mesh->HasNormals(), "Meshes require normals.");
 
                 // Vertices
+				std::vector<Vertex> vertexs;
+				vertexs.reserve(mesh->mNumVertices);
 				auto& aabb = submesh.BoundingBox;
 				aabb.Min = { FLT_MAX, FLT_MAX, FLT_MAX };
 				aabb.Max = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
@@ -103,18 +110,53 @@ namespace Chozo {
 					if (mesh->HasTextureCoords(0))
 						vertex.TexCoord = { mesh->mTextureCoords[0][i].x, mesh->mTextureCoords[0][i].y };
 
-					meshSource->m_Buffer.Vertexs.push_back(vertex);
+					vertexs.push_back(vertex);
 				}
 
                 // Indices
+				std::vector<Index> indexs;
+				indexs.reserve(mesh->mNumFaces);
 				for (size_t i = 0; i < mesh->mNumFaces; i++)
 				{
 					CZ_CORE_ASSERT(mesh->mFaces[i].mNumIndices == 3, "Must have 3 indices.");
 					Index index = { mesh->mFaces[i].mIndices[0], mesh->mFaces[i].mIndices[1], mesh->mFaces[i].mIndices[2] };
-					meshSource->m_Buffer.Indexs.push_back(index);
+					indexs.push_back(index);
+				}
+
+				// Reorder for the post-transform cache, overdraw and vertex fetch before anything references the order.
+				MeshOptimizer::OptimizeSubmesh(vertexs, indexs);
+
+				submesh.Meshlets = MeshOptimizer::BuildMeshlets(vertexs, indexs);
+				for (auto& meshlet : submesh.Meshlets)
+					meshlet.BaseIndex += submesh.BaseIndex;
 
-					meshSource->m_TriangleCache[m].emplace_back(meshSource->m_Buffer.Vertexs[index.V1 + submesh.BaseVertex], meshSource->m_Buffer.Vertexs[index.V2 + submesh.BaseVertex], meshSource->m_Buffer.Vertexs[index.V3 + submesh.BaseVertex]);
+				meshSource->m_Buffer.Vertexs.insert(meshSource->m_Buffer.Vertexs.end(), vertexs.begin(), vertexs.end());
+				meshSource->m_Buffer.Indexs.insert(meshSource->m_Buffer.Indexs.end(), indexs.begin(), indexs.end());
+
+				// LODs, each halves the triangle count and shares the submesh vertices.
+				size_t previousTriangleCount = indexs.size();
+				for (uint32_t lod = 1; lod <= Utils::MaxSubmeshLODs; lod++)
+				{
+					float error = 0.0f;
+					std::vector<Index> lodIndexs = MeshOptimizer::Simplify(vertexs, indexs, indexs.size() >> lod, Utils::LODMaxError, &error);
+					// Stop once the simplifier can't make meaningful progress within the error limit.
+					if (lodIndexs.empty() || lodIndexs.size() * 10 > previousTriangleCount * 9)
+						break;
+
+					MeshOptimizer::OptimizeVertexCache(lodIndexs, (uint32_t)vertexs.size());
+
+					SubmeshLOD& submeshLOD = submesh.LODs.emplace_back();
+					submeshLOD.BaseIndex = indexCount;
+					submeshLOD.IndexCount = (uint32_t)lodIndexs.size() * 3;
+					submeshLOD.Error = error;
+					indexCount += submeshLOD.IndexCount;
+
+					meshSource->m_Buffer.Indexs.insert(meshSource->m_Buffer.Indexs.end(), lodIndexs.begin(), lodIndexs.end());
+					previousTriangleCount = lodIndexs.size();
 				}
+
+				for (const auto& index : indexs)
+					meshSource->m_TriangleCache[m].emplace_back(vertexs[index.V1], vertexs[index.V2], vertexs[index.V3]);
             }
 
             MeshNode& rootNode = meshSource->m_Nodes.emplace_back();
@@ -133,6 +175,8 @@ namespace Chozo {
 				meshSource->m_BoundingBox.Max.y = glm::max(meshSource->m_BoundingBox.Max.y, max.y);
 				meshSource->m_BoundingBox.Max.z = glm::max(meshSource->m_BoundingBox.Max.z, max.z);
 			}
+
+			meshSource->m_VertexFormat = MeshPacker::ChooseVertexFormat(meshSource->m_Buffer.Vertexs, meshSource->m_Submeshes);
         }
 
 		// Materials
@@ -147,17 +191,16 @@ namespace Chozo {
 
 				auto mi = Material::Create(Renderer::GetRendererData().m_ShaderLibrary->Get("Geometry"), aiMaterialName.data);
 
-				glm::vec3 baseColorColor(0.8f);
-				float emission = 0.0f;
+				glm::vec3 baseColorColor(0.8f), emissiveColor(0.0f);
 				aiColor3D aiColor, aiEmission;
 				if (aiMaterial->Get(AI_MATKEY_COLOR_DIFFUSE, aiColor) == AI_SUCCESS)
 					baseColorColor = { aiColor.r, aiColor.g, aiColor.b };
 
 				if (aiMaterial->Get(AI_MATKEY_COLOR_EMISSIVE, aiEmission) == AI_SUCCESS)
-					emission = aiEmission.r;
+					emissiveColor = { aiEmission.r, aiEmission.g, aiEmission.b };
 
 				mi->Set("u_Material.BaseColor", baseColorColor);
-				// mi->Set("u_Material.Emission", emission);
+				mi->Set("u_Material.EmissiveColor", emissiveColor);
 
 				float metallic, roughness;
 				if (aiMaterial->Get(AI_MATKEY_REFLECTIVITY, metallic) != aiReturn_SUCCESS)
@@ -274,13 +317,15 @@ namespace Chozo {
 			spec.MinFilter = ImageParameter::LINEAR;
 			spec.MagFilter = ImageParameter::LINEAR;
 			spec.DebugName = fileName;
+			spec.Usage = propType == MaterialPropType::BaseColor ? TextureUsage::Color
+				: propType == MaterialPropType::Normal ? TextureUsage::Normal : TextureUsage::Data;
 
 			if (auto aiTexEmbedded = scene->GetEmbeddedTexture(aiTexPath.C_Str()))
 			{
 				spec.Format = ImageFormat::RGBA;
 				spec.Width = aiTexEmbedded->mWidth;
 				spec.Height = aiTexEmbedded->mHeight;
-				Buffer imageBuffer = TextureImporter::ToBufferFromMemory(Buffer(aiTexEmbedded->pcData, spec.Width), spec.Format, spec.Width, spec.Height);
+				Buffer imageBuffer = TextureImporter::ToBufferFromMemory(Buffer(aiTexEmbedded->pcData, spec.Width), spec.Format, spec.Width, spec.Height, spec.Usage, &spec.MipLevels, spec.WrapS, spec.WrapT);
 				texture = Texture2D::Create(imageBuffer, spec);
 			}
 			else
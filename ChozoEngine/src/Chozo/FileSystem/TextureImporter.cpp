@@ -1,12 +1,87 @@
 #include "TextureImporter.h"
 
+#include "Chozo/Renderer/ImageConverter.h"
+#include "Chozo/Renderer/Renderer.h"
+#include "Chozo/Renderer/MipGenerator.h"
+#include "Chozo/Renderer/TextureCompressor.h"
+
 #include "stb_image.h"
 
 namespace Chozo {
 
-    Buffer TextureImporter::ToBufferFromFile(const std::string &path, ImageFormat &outFormat, uint32_t &outWidth, uint32_t &outHeight, bool flipY)
+    namespace Utils {
+
+        // stb loads HDRs as RGBA32F, converts them to the storage format set in the renderer config.
+        static Buffer CompactHDRBuffer(float* pixels, const int width, const int height, ImageFormat& outFormat)
+        {
+            const ImageFormat format = Renderer::GetConfig().HDRTextureFormat;
+            if (!pixels || format == ImageFormat::RGBA32F || !Image::IsHDRFormat(format))
+            {
+                Buffer imageBuffer;
+                imageBuffer.Data = (byte*)pixels;
+                imageBuffer.Size = (uint64_t)width * height * 4 * sizeof(float);
+                outFormat = ImageFormat::HDR;
+                return imageBuffer;
+            }
+
+            Buffer imageBuffer = ImageConverter::FromRGBA32F(pixels, (uint64_t)width * height, format);
+            stbi_image_free(pixels);
+            outFormat = format;
+            return imageBuffer;
+        }
+
+        // Builds the mip chain and block compresses it when the usage and the renderer config ask for it,
+        // the stb pixels are replaced by the result.
+        static void ProcessLDRBuffer(Buffer& imageBuffer, const uint32_t width, const uint32_t height, const TextureUsage usage, ImageFormat& outFormat, uint32_t* outMipLevels,
+            const ImageParameter wrapS, const ImageParameter wrapT)
+        {
+            if (usage == TextureUsage::None)
+                return;
+
+            const auto& config = Renderer::GetConfig();
+            uint32_t levels = 1;
+            bool ownedByStb = true;
+            if (outMipLevels && config.TextureMipFilter != MipFilter::None)
+            {
+                Buffer chain = MipGenerator::Generate(static_cast<const uint8_t*>(imageBuffer.Data), width, height, usage, config.TextureMipFilter, wrapS, wrapT, levels);
+                stbi_image_free(imageBuffer.Data);
+                imageBuffer = chain;
+                ownedByStb = false;
+            }
+            if (outMipLevels)
+                *outMipLevels = levels;
+
+            const auto* pixels = static_cast<const uint8_t*>(imageBuffer.Data);
+            const ImageFormat format = TextureCompressor::SelectFormat(usage, pixels, width, height, config.TextureCompression);
+            if (format == ImageFormat::None)
+                return;
+
+            Buffer blocks;
+            blocks.Allocate(Image::GetMipChainSize(format, width, height, levels));
+            for (uint32_t level = 0; level < levels; level++)
+            {
+                const uint32_t levelWidth = std::max(width >> level, 1u), levelHeight = std::max(height >> level, 1u);
+                Buffer levelBlocks = TextureCompressor::Compress(pixels + Image::GetMipChainSize(ImageFormat::RGBA, width, height, level),
+                    levelWidth, levelHeight, format, config.TextureCompression);
+                memcpy(static_cast<uint8_t*>(blocks.Data) + Image::GetMipChainSize(format, width, height, level), levelBlocks.Data, levelBlocks.Size);
+                levelBlocks.Release();
+            }
+
+            if (ownedByStb)
+                stbi_image_free(imageBuffer.Data);
+            else
+                imageBuffer.Release();
+            imageBuffer = blocks;
+            outFormat = format;
+        }
+    }
+
+    Buffer TextureImporter::ToBufferFromFile(const std::string &path, ImageFormat &outFormat, uint32_t &outWidth, uint32_t &outHeight, bool flipY, TextureUsage usage, uint32_t* outMipLevels,
+        ImageParameter wrapS, ImageParameter wrapT)
     {
 		Buffer imageBuffer;
+        if (outMipLevels)
+            *outMipLevels = 1;
 
 		int width, height, channels;
         stbi_set_flip_vertically_on_load(flipY);
@@ -15,15 +90,15 @@ namespace Chozo {
 		{
             // float gamma = ExtractGammaFromHDR(path);
             // CZ_CORE_INFO("file: {}, gamma: {}", path, gamma);
-			imageBuffer.Data = (byte*)stbi_loadf(path.c_str(), &width, &height, &channels, 4);
-			imageBuffer.Size = width * height * 4 * sizeof(float);
-			outFormat = ImageFormat::HDR;
+			imageBuffer = Utils::CompactHDRBuffer(stbi_loadf(path.c_str(), &width, &height, &channels, 4), width, height, outFormat);
 		}
         else
 		{
 			imageBuffer.Data = stbi_load(path.c_str(), &width, &height, &channels, 4);
 			imageBuffer.Size = width * height * 4;
 			outFormat = ImageFormat::RGBA;
+			if (imageBuffer.Data)
+				Utils::ProcessLDRBuffer(imageBuffer, width, height, usage, outFormat, outMipLevels, wrapS, wrapT);
 		}
 
 		if (!imageBuffer.Data)
@@ -37,24 +112,27 @@ namespace Chozo {
 		return imageBuffer;
     }
 
-    Buffer TextureImporter::ToBufferFromMemory(Buffer buffer, ImageFormat &outFormat, uint32_t &outWidth, uint32_t &outHeight)
+    Buffer TextureImporter::ToBufferFromMemory(Buffer buffer, ImageFormat &outFormat, uint32_t &outWidth, uint32_t &outHeight, TextureUsage usage, uint32_t* outMipLevels,
+        ImageParameter wrapS, ImageParameter wrapT)
     {
         Buffer imageBuffer;
+        if (outMipLevels)
+            *outMipLevels = 1;
 
 		int width, height, channels;
         stbi_set_flip_vertically_on_load(1);
 
 		if (stbi_is_hdr_from_memory((const stbi_uc*)buffer.Data, (int)buffer.Size))
 		{
-			imageBuffer.Data = (byte*)stbi_loadf_from_memory((const stbi_uc*)buffer.Data, (int)buffer.Size, &width, &height, &channels, STBI_rgb_alpha);
-			imageBuffer.Size = width * height * 4 * sizeof(float);
-			outFormat = ImageFormat::HDR;
+			imageBuffer = Utils::CompactHDRBuffer(stbi_loadf_from_memory((const stbi_uc*)buffer.Data, (int)buffer.Size, &width, &height, &channels, STBI_rgb_alpha), width, height, outFormat);
 		}
 		else
 		{
 			imageBuffer.Data = stbi_load_from_memory((const stbi_uc*)buffer.Data, (int)buffer.Size, &width, &height, &channels, STBI_rgb_alpha);
 			imageBuffer.Size = width * height * 4;
 			outFormat = ImageFormat::RGBA;
+			if (imageBuffer.Data)
+				Utils::ProcessLDRBuffer(imageBuffer, width, height, usage, outFormat, outMipLevels, wrapS, wrapT);
 		}
 
 		if (!imageBuffer.Data)
@@ -9,8 +9,12 @@ namespace Chozo {
 	class TextureImporter
 	{
 	public:
-		static Buffer ToBufferFromFile(const std::string &path, ImageFormat& outFormat, uint32_t& outWidth, uint32_t& outHeight, bool flipY = false);
-		static Buffer ToBufferFromMemory(Buffer buffer, ImageFormat& outFormat, uint32_t& outWidth, uint32_t& outHeight);
+		// 8-bit images of textures with a usage come back block compressed, see TextureCompressor. When
+		// outMipLevels is given they also come with their mip chain, filtered for the wrap modes, see MipGenerator.
+		static Buffer ToBufferFromFile(const std::string &path, ImageFormat& outFormat, uint32_t& outWidth, uint32_t& outHeight, bool flipY = false, TextureUsage usage = TextureUsage::None, uint32_t* outMipLevels = nullptr,
+			ImageParameter wrapS = ImageParameter::CLAMP_TO_EDGE, ImageParameter wrapT = ImageParameter::CLAMP_TO_EDGE);
+		static Buffer ToBufferFromMemory(Buffer buffer, ImageFormat& outFormat, uint32_t& outWidth, uint32_t& outHeight, TextureUsage usage = TextureUsage::None, uint32_t* outMipLevels = nullptr,
+			ImageParameter wrapS = ImageParameter::CLAMP_TO_EDGE, ImageParameter wrapT = ImageParameter::CLAMP_TO_EDGE);
         static float ExtractGammaFromHDR(const std::string& filepath);
 	};
 }
@@ -4,10 +4,35 @@
 #include "imgui_impl_glfw.h"
 
 #include "Chozo/Core/Application.h"
+#include "Chozo/Renderer/Renderer.h"
+#include "Chozo/Renderer/Backend/OpenGL/OpenGLStateCache.h"
 
 #include <GLFW/glfw3.h>
 
 namespace Chozo {
+
+    namespace Utils {
+
+        // ImGui reuses its draw lists every frame, the render thread draws from a copy made when the frame ends.
+        struct ImGuiDrawSnapshot
+        {
+            ImDrawData DrawData;
+
+            explicit ImGuiDrawSnapshot(const ImDrawData* drawData)
+                : DrawData(*drawData)
+            {
+                for (auto& list : DrawData.CmdLists)
+                    list = list->CloneOutput();
+            }
+
+            ~ImGuiDrawSnapshot()
+            {
+                for (auto* list : DrawData.CmdLists)
+                    IM_DELETE(list);
+            }
+        };
+    }
+
     ImGuiLayer::ImGuiLayer()
         : Layer("ImGuiLayer")
     {
@@ -25,7 +50,9 @@ namespace Chozo {
         io.ConfigFlags |= ImGuiConfigFlags_NavEnableKeyboard;     // Enable Keyboard Controls
         io.ConfigFlags |= ImGuiConfigFlags_NavEnableGamepad;      // Enable Gamepad Controls
         io.ConfigFlags |= ImGuiConfigFlags_DockingEnable;         // Enable Docking
-        io.ConfigFlags |= ImGuiConfigFlags_ViewportsEnable;       // Enable Multi-Viewport / Platform Windows
+        // Platform windows are rendered by the thread that creates them, only the single threaded policy has them.
+        if (Application::Get().GetRenderThread().GetThreadingPolicy() != ThreadingPolicy::MultiThreaded)
+            io.ConfigFlags |= ImGuiConfigFlags_ViewportsEnable;   // Enable Multi-Viewport / Platform Windows
         //io.ConfigViewportsNoAutoMerge = true;
         //io.ConfigViewportsNoTaskBarIcon = true;
 
@@ -58,6 +85,8 @@ namespace Chozo {
         auto window = static_cast<GLFWwindow*>(Application::Get().GetWindow().GetNativeWindow());
         ImGui_ImplGlfw_InitForOpenGL(window, true);
         ImGui_ImplOpenGL3_Init("#version 410");
+        // Created while the main thread still has the context, so NewFrame never touches GL.
+        ImGui_ImplOpenGL3_CreateDeviceObjects();
     }
 
     void ImGuiLayer::OnDetach()
@@ -98,7 +127,10 @@ namespace Chozo {
 
         // Rendering
         ImGui::Render();
-        ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+        Renderer::Submit([snapshot = std::make_shared<Utils::ImGuiDrawSnapshot>(ImGui::GetDrawData())]() {
+            OpenGLStateCache::BindFramebuffer(0);
+            ImGui_ImplOpenGL3_RenderDrawData(&snapshot->DrawData);
+        });
 
         if (io.ConfigFlags & ImGuiConfigFlags_ViewportsEnable)
         {
@@ -1,6 +1,8 @@
 #include "OpenGLFramebuffer.h"
 
 #include "OpenGLUtils.h"
+#include "OpenGLStateCache.h"
+#include "Chozo/Renderer/Renderer.h"
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
@@ -25,65 +27,95 @@ namespace Chozo {
 
     OpenGLFramebuffer::~OpenGLFramebuffer()
     {
-        Release();
+        Renderer::SubmitResourceFree([rendererID = m_RendererID, colorAttachments = m_ColorAttachments,
+            depthAttachment = m_DepthAttachment, depthRenderbuffer = m_Specification.DepthRenderbuffer]() {
+            if (rendererID)
+            {
+                OpenGLStateCache::OnFramebufferDeleted(rendererID);
+                glDeleteFramebuffers(1, &rendererID); GCE;
+            }
+            if (!colorAttachments.empty())
+            {
+                for (auto attachment : colorAttachments)
+                    OpenGLStateCache::OnTextureDeleted(attachment);
+                glDeleteTextures(colorAttachments.size(), colorAttachments.data()); GCE;
+            }
+            if (depthAttachment)
+            {
+                if (depthRenderbuffer)
+                {
+                    glDeleteRenderbuffers(1, &depthAttachment); GCE;
+                }
+                else
+                {
+                    OpenGLStateCache::OnTextureDeleted(depthAttachment);
+                    glDeleteTextures(1, &depthAttachment); GCE;
+                }
+            }
+        });
     }
 
     void OpenGLFramebuffer::Invalidate()
     {
-        Release();
+        Renderer::SubmitAndWait([&]() {
+            Release();
 
-        glGenFramebuffers(1, &m_RendererID); GCE;
-        glBindFramebuffer(GL_FRAMEBUFFER, m_RendererID); GCE;
+            glGenFramebuffers(1, &m_RendererID); GCE;
+            OpenGLStateCache::BindFramebuffer(m_RendererID);
 
-        bool multisampled = m_Specification.Samples > 1;
+            bool multisampled = m_Specification.Samples > 1;
 
-        // Attachments
-        if (m_ColorAttachmentSpecs.size())
-            CreateColorAttachmentImages(m_Specification.Samples, m_ColorAttachmentSpecs, m_Specification.Width, m_Specification.Height);
+            // Attachments
+            if (m_ColorAttachmentSpecs.size())
+                CreateColorAttachmentImages(m_Specification.Samples, m_ColorAttachmentSpecs, m_Specification.Width, m_Specification.Height);
 
-        if (m_DepthAttachmentSpec.TextureFormat != ImageFormat::None)
-        {
-            if (m_Specification.DepthRenderbuffer)
+            if (m_DepthAttachmentSpec.TextureFormat != ImageFormat::None)
             {
-                glGenRenderbuffers(1, &m_DepthAttachment); GCE;
-                glBindRenderbuffer(GL_RENDERBUFFER, m_DepthAttachment); GCE;
-                glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, m_Specification.Width, m_Specification.Height); GCE;
-                glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, m_DepthAttachment); GCE;
+                if (m_Specification.DepthRenderbuffer)
+                {
+                    glGenRenderbuffers(1, &m_DepthAttachment); GCE;
+                    glBindRenderbuffer(GL_RENDERBUFFER, m_DepthAttachment); GCE;
+                    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, m_Specification.Width, m_Specification.Height); GCE;
+                    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, m_DepthAttachment); GCE;
+                }
+                else
+                    CreateDepthAttachmentImage(m_Specification.Samples, m_DepthAttachmentSpec, m_Specification.Width, m_Specification.Height);
             }
-            else
-                CreateDepthAttachmentImage(m_Specification.Samples, m_DepthAttachmentSpec, m_Specification.Width, m_Specification.Height);
-        }
 
-        if (m_ColorAttachments.size() > 1)
-        {
-            CZ_CORE_ASSERT(m_ColorAttachments.size() <= 8, "");
-            GLenum buffers[8] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1, GL_COLOR_ATTACHMENT2, GL_COLOR_ATTACHMENT3, GL_COLOR_ATTACHMENT4, GL_COLOR_ATTACHMENT5, GL_COLOR_ATTACHMENT6, GL_COLOR_ATTACHMENT7 };
-            glDrawBuffers(m_ColorAttachments.size(), buffers); GCE;
-        }
-        else if (m_ColorAttachments.empty())
-        {
-            // Only depth-pass
-            glDrawBuffer(GL_NONE); GCE;
-        }
+            if (m_ColorAttachments.size() > 1)
+            {
+                CZ_CORE_ASSERT(m_ColorAttachments.size() <= 8, "");
+                GLenum buffers[8] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1, GL_COLOR_ATTACHMENT2, GL_COLOR_ATTACHMENT3, GL_COLOR_ATTACHMENT4, GL_COLOR_ATTACHMENT5, GL_COLOR_ATTACHMENT6, GL_COLOR_ATTACHMENT7 };
+                glDrawBuffers(m_ColorAttachments.size(), buffers); GCE;
+            }
+            else if (m_ColorAttachments.empty())
+            {
+                // Only depth-pass
+                glDrawBuffer(GL_NONE); GCE;
+            }
 
-        GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
-        if (status != GL_FRAMEBUFFER_COMPLETE)
-        {
-            CZ_CORE_ERROR("Framebuffer is incomplete! Status: {0}", status);
-            CZ_CORE_ASSERT(false, "");
-        }
+            GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+            if (status != GL_FRAMEBUFFER_COMPLETE)
+            {
+                CZ_CORE_ERROR("Framebuffer is incomplete! Status: {0}", status);
+                CZ_CORE_ASSERT(false, "");
+            }
+        });
     }
 
     void OpenGLFramebuffer::Release()
     {
         if (m_RendererID)
         {
+            OpenGLStateCache::OnFramebufferDeleted(m_RendererID);
             glDeleteFramebuffers(1, &m_RendererID); GCE;
             m_RendererID = 0;
         }
         
         if (!m_ColorAttachments.empty())
         {
+            for (auto attachment : m_ColorAttachments)
+                OpenGLStateCache::OnTextureDeleted(attachment);
             glDeleteTextures(m_ColorAttachments.size(), m_ColorAttachments.data()); GCE;
             m_ColorAttachments.clear();
         }
@@ -97,6 +129,7 @@ namespace Chozo {
             }
             else
             {
+                OpenGLStateCache::OnTextureDeleted(m_DepthAttachment);
                 glDeleteTextures(1, &m_DepthAttachment); GCE;
             }
 
@@ -108,13 +141,13 @@ namespace Chozo {
 
     void OpenGLFramebuffer::Bind() const
     {
-        glBindFramebuffer(GL_FRAMEBUFFER, m_RendererID); GCE;
-        glViewport(0, 0, m_Specification.Width, m_Specification.Height); GCE;
+        OpenGLStateCache::BindFramebuffer(m_RendererID);
+        OpenGLStateCache::Viewport(0, 0, (int)m_Specification.Width, (int)m_Specification.Height);
     }
 
     void OpenGLFramebuffer::Unbind() const
     {
-        glBindFramebuffer(GL_FRAMEBUFFER, 0); GCE;
+        OpenGLStateCache::BindFramebuffer(0);
     }
 
     void OpenGLFramebuffer::Resize(uint32_t width, uint32_t height, int mip)
@@ -127,37 +160,42 @@ namespace Chozo {
 
         if (m_Specification.Width != width || m_Specification.Height != height)
         {
-            m_Specification.Width = width;
-            m_Specification.Height = height;
+            // The render thread reads the extent when binding, it changes between frames along with the storage.
+            Renderer::SubmitAndWait([&]() {
+                m_Specification.Width = width;
+                m_Specification.Height = height;
 
-            Bind();
-            for (auto& images : m_ColorAttachmentImages)
-                images->Resize(width, height);
+                Bind();
+                for (auto& images : m_ColorAttachmentImages)
+                    images->Resize(width, height);
 
-            if (m_DepthAttachmentImage)
-            {
-                if (m_Specification.DepthRenderbuffer)
+                if (m_DepthAttachmentImage)
                 {
-                    glBindRenderbuffer(GL_RENDERBUFFER, m_DepthAttachment); GCE;
-                    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height); GCE;
-                } else {
-                    m_DepthAttachmentImage->Resize(width, height);
-                    if (mip > -1)
-                        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, m_DepthAttachment, mip);
+                    if (m_Specification.DepthRenderbuffer)
+                    {
+                        glBindRenderbuffer(GL_RENDERBUFFER, m_DepthAttachment); GCE;
+                        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height); GCE;
+                    } else {
+                        m_DepthAttachmentImage->Resize(width, height);
+                        if (mip > -1)
+                            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, m_DepthAttachment, mip);
+                    }
                 }
-            }
+            });
             // Unbind();
         }
     }
 
     int OpenGLFramebuffer::ReadPixel(uint32_t attachmentIndex, int x, int y)
     {
-        Bind();
         CZ_CORE_ASSERT(attachmentIndex < m_ColorAttachments.size(), "attachmentIndex is larger than colorAttachments size");
-        glReadBuffer(GL_COLOR_ATTACHMENT0 + attachmentIndex); GCE;
         int pixelData;
-        glReadPixels(x, y, 1, 1, GL_RED_INTEGER, GL_INT, &pixelData); GCE;
-        Unbind();
+        Renderer::SubmitAndWait([&]() {
+            Bind();
+            glReadBuffer(GL_COLOR_ATTACHMENT0 + attachmentIndex); GCE;
+            glReadPixels(x, y, 1, 1, GL_RED_INTEGER, GL_INT, &pixelData); GCE;
+            Unbind();
+        });
         return pixelData;
     }
 #if 0
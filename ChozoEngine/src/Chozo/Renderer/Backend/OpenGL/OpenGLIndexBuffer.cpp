@@ -1,44 +1,57 @@
 #include "OpenGLIndexBuffer.h"
 
 #include "OpenGLUtils.h"
+#include "Chozo/Renderer/Renderer.h"
 
 #include <glad/glad.h>
 
 namespace Chozo {
     
-    OpenGLIndexBuffer::OpenGLIndexBuffer(void* indices, uint32_t count)
-        : m_Count(count)
+    OpenGLIndexBuffer::OpenGLIndexBuffer(void* indices, uint32_t count, IndexFormat format)
+        : m_Count(count), m_Format(format), m_End(0)
     {
-        glGenBuffers(1, &m_RendererID); GCE;
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID); GCE;
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * sizeof(uint32_t), indices, GL_STATIC_DRAW); GCE;
+        // Uploads go through the copy target, binding GL_ELEMENT_ARRAY_BUFFER would change whichever vertex array is bound.
+        Renderer::SubmitAndWait([&]() {
+            glGenBuffers(1, &m_RendererID); GCE;
+            glBindBuffer(GL_COPY_WRITE_BUFFER, m_RendererID); GCE;
+            glBufferData(GL_COPY_WRITE_BUFFER, count * IndexFormatSize(m_Format), indices, GL_STATIC_DRAW); GCE;
+        });
     }
 
     OpenGLIndexBuffer::~OpenGLIndexBuffer()
     {
-        glDeleteBuffers(1, &m_RendererID); GCE;
+        Renderer::SubmitResourceFree([rendererID = m_RendererID]() {
+            glDeleteBuffers(1, &rendererID); GCE;
+        });
     }
 
     void OpenGLIndexBuffer::SetData(uint32_t offset, uint32_t count, void* indices)
     {
-        Bind();
-        glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, offset * sizeof(uint32_t), count * sizeof(uint32_t), indices); GCE;
+        Renderer::SubmitAndWait([&]() {
+            glBindBuffer(GL_COPY_WRITE_BUFFER, m_RendererID); GCE;
+            uint32_t indexSize = IndexFormatSize(m_Format);
+            glBufferSubData(GL_COPY_WRITE_BUFFER, offset * indexSize, count * indexSize, indices); GCE;
+        });
         m_Count = count;
-        m_End = std::max((uint32_t)(count * sizeof(uint32_t)), m_End);
+        m_End = std::max(count * indexSize, m_End);
     }
 
     void OpenGLIndexBuffer::ClearData()
     {
-        Bind();
-        uint32_t indices[m_End / sizeof(uint32_t)];
-        glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, m_End, indices); GCE;
+        Renderer::SubmitAndWait([&]() {
+            glBindBuffer(GL_COPY_WRITE_BUFFER, m_RendererID); GCE;
+            uint8_t indices[m_End];
+            glBufferSubData(GL_COPY_WRITE_BUFFER, 0, m_End, indices); GCE;
+        });
     }
 
     void OpenGLIndexBuffer::Resize(uint32_t count)
     {
-        Bind();
-        uint32_t indices[count];
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * sizeof(uint32_t), indices, GL_STATIC_DRAW); GCE;
+        Renderer::SubmitAndWait([&]() {
+            glBindBuffer(GL_COPY_WRITE_BUFFER, m_RendererID); GCE;
+            uint8_t indices[count * IndexFormatSize(m_Format)];
+            glBufferData(GL_COPY_WRITE_BUFFER, count * IndexFormatSize(m_Format), indices, GL_STATIC_DRAW); GCE;
+        });
     }
 
     void OpenGLIndexBuffer::Bind() const
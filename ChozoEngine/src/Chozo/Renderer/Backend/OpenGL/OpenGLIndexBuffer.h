@@ -7,7 +7,7 @@ namespace Chozo {
     class OpenGLIndexBuffer : public IndexBuffer
     {
     public:
-        OpenGLIndexBuffer(void* indices, uint32_t count);
+        OpenGLIndexBuffer(void* indices, uint32_t count, IndexFormat format = IndexFormat::UInt32);
         virtual ~OpenGLIndexBuffer();
 
         virtual void SetData(uint32_t offset, uint32_t count, void* indices) override;
@@ -19,9 +19,11 @@ namespace Chozo {
 
         virtual const RendererID GetRendererID() const override { return m_RendererID; };
         virtual uint32_t GetCount() const override { return m_Count; }
+        virtual IndexFormat GetFormat() const override { return m_Format; }
     private:
         uint32_t m_RendererID;
         uint32_t m_Count;
+        IndexFormat m_Format;
         uint32_t m_End;
     };
 }
\ No newline at end of file
@@ -26,6 +26,24 @@ namespace Chozo {
         return false;
     }
 
+    // ENABLE_BASE_COLOR_TEX -> u_Material.EnableBaseColorTex
+    static std::string KeywordToUniformName(const std::string& keyword)
+    {
+        std::string name = "u_Material.";
+        bool upper = true;
+        for (const char c : keyword)
+        {
+            if (c == '_')
+            {
+                upper = true;
+                continue;
+            }
+            name += upper ? (char)std::toupper(c) : (char)std::tolower(c);
+            upper = false;
+        }
+        return name;
+    }
+
     OpenGLMaterial::OpenGLMaterial(const Ref<Shader> &shader, std::string name)
         : m_Shader(shader.As<OpenGLShader>()), m_Name(std::move(name))
     {
@@ -44,9 +62,13 @@ namespace Chozo {
     {
         CZ_CORE_ASSERT(m_Shader == other->GetShader(), "Copy material failed because shader is not same.");
 
-        m_TextureSlots = other->GetAllTextures();
-        m_TextureSlotIndex = other->GetLastTextureSlotIndex();
-        m_TextureAssetHandles = other->GetTextureAssetHandles();
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_TextureSlots = other->GetAllTextures();
+            m_TextureSlotIndex = other->GetLastTextureSlotIndex();
+            m_TextureAssetHandles = other->GetTextureAssetHandles();
+            m_State = nullptr;
+        }
 
         auto uniforms = other.As<OpenGLMaterial>()->GetUniforms();
         for (const auto& [uniformName, uniformValue] : uniforms)
@@ -55,7 +77,11 @@ namespace Chozo {
 
     void OpenGLMaterial::Set(const std::string &name, const UniformValue &value)
     {
-        m_Uniforms[name] = value;
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Uniforms[name] = value;
+            m_State = nullptr;
+        }
 
         HandleModified();
     }
@@ -65,6 +91,7 @@ namespace Chozo {
         if (texture->GetAssetType() != AssetType::Texture)
             return;
 
+        std::unique_lock<std::mutex> lock(m_Mutex);
         int textureIndex = -1;
 
         for (int i = 0; i < m_TextureSlots.size(); i++)
@@ -88,6 +115,8 @@ namespace Chozo {
         }
 
         m_Uniforms[name] = textureIndex;
+        m_State = nullptr;
+        lock.unlock();
 
         HandleModified();
     }
@@ -96,6 +125,7 @@ namespace Chozo {
     {
         if (Application::GetAssetManager()->IsAssetHandleValid(handle))
         {
+            std::unique_lock<std::mutex> lock(m_Mutex);
             int textureIndex = -1;
             for (int i = 0; i < m_TextureSlots.size(); i++)
             {
@@ -115,6 +145,8 @@ namespace Chozo {
             }
 
             m_Uniforms[name] = textureIndex;
+            m_State = nullptr;
+            lock.unlock();
 
             HandleModified();
         }
@@ -130,8 +162,27 @@ namespace Chozo {
         Set(name, texture.As<Texture>());
     }
 
+    std::map<std::string, UniformValue> OpenGLMaterial::GetUniforms()
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return m_Uniforms;
+    }
+
+    std::vector<Ref<Texture>> OpenGLMaterial::GetAllTextures() const
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return m_TextureSlots;
+    }
+
+    uint32_t OpenGLMaterial::GetLastTextureSlotIndex() const
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return m_TextureSlotIndex;
+    }
+
     Ref<Texture2D> OpenGLMaterial::GetTexture(std::string name)
     {
+        std::lock_guard<std::mutex> lock(m_Mutex);
         const UniformValue value = m_Uniforms[name];
         uint32_t slotIndex = 0;
 
@@ -163,26 +214,67 @@ namespace Chozo {
         return texture;
     }
 
-    void OpenGLMaterial::Bind()
+    Ref<OpenGLMaterialState> OpenGLMaterial::Capture()
     {
-        BindTextures();
-        m_Shader->Bind();
-        for (const auto&[name, value] : m_Uniforms)
-            m_Shader->Shader::SetUniform(name, value);
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        // A relink may have changed which keyword each mask bit stands for.
+        if (m_State && m_State->LinkCount == m_Shader->GetLinkCount())
+            return m_State;
+
+        Ref<OpenGLMaterialState> state = Ref<OpenGLMaterialState>::Create();
+        state->Shader = m_Shader;
+        state->LinkCount = m_Shader->GetLinkCount();
+        state->KeywordMask = GetKeywordMask();
+        state->HasKeywords = !m_Keywords.empty();
+        state->Uniforms.assign(m_Uniforms.begin(), m_Uniforms.end());
+
+        // Slots whose asset isn't loaded yet are looked up again by the next capture.
+        bool resolved = true;
+        state->Textures.resize(m_TextureSlotIndex);
+        for (uint32_t i = 0; i < m_TextureSlotIndex; i++)
+        {
+            if (!m_TextureSlots[i])
+            {
+                const auto handle = std::get<1>(m_TextureAssetHandles[i]);
+                m_TextureSlots[i] = Application::GetAssetManager()->GetAsset(handle).As<Texture2D>();
+            }
+            state->Textures[i] = m_TextureSlots[i];
+            resolved &= (bool)m_TextureSlots[i];
+        }
+
+        if (resolved)
+            m_State = state;
+        return state;
     }
 
-    void OpenGLMaterial::BindTextures()
+    uint32_t OpenGLMaterial::GetKeywordMask()
     {
-        for (uint32_t i = 0; i < m_TextureSlotIndex; i++)
+        const auto keywords = m_Shader->GetKeywords();
+        if (keywords != m_Keywords)
+        {
+            m_Keywords = keywords;
+            m_KeywordUniforms.clear();
+            for (const auto& keyword : m_Keywords)
+                m_KeywordUniforms.push_back(KeywordToUniformName(keyword));
+        }
+
+        uint32_t mask = 0;
+        for (uint32_t i = 0; i < m_KeywordUniforms.size(); i++)
+        {
+            auto it = m_Uniforms.find(m_KeywordUniforms[i]);
+            if (it != m_Uniforms.end() && Utils::GetBool(it->second))
+                mask |= 1u << i;
+        }
+        return mask;
+    }
+
+    Ref<OpenGLShader> OpenGLMaterialState::Bind() const
+    {
+        for (uint32_t i = 0; i < Textures.size(); i++)
         {
-            auto texture = m_TextureSlots[i];
+            const auto& texture = Textures[i];
             if (!texture)
-            {
-                auto handle = std::get<1>(m_TextureAssetHandles[i]);
-                texture = Application::GetAssetManager()->GetAsset(handle).As<Texture2D>();
-                if (texture)
-                    m_TextureSlots[i] = texture;
-            }
+                continue;
 
             switch (texture->GetType())
             {
@@ -197,6 +289,18 @@ namespace Chozo {
                 break;
             }
         }
+
+        Ref<OpenGLShader> shader = Shader->GetVariant(KeywordMask).As<OpenGLShader>();
+        shader->Bind();
+
+        // Keyword flags and the samplers they strip don't exist in every variant.
+        for (const auto&[name, value] : Uniforms)
+        {
+            if (HasKeywords && !shader->HasUniform(name))
+                continue;
+            shader->Shader::SetUniform(name, value);
+        }
+        return shader;
     }
 
     void OpenGLMaterial::PopulateUniforms(const Ref<OpenGLShader> &shader)
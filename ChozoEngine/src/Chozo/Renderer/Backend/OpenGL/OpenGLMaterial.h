@@ -6,6 +6,21 @@
 
 namespace Chozo {
 
+    // Material parameters as they were when a draw was recorded. The render thread binds these while the
+    // main thread keeps editing the material.
+    struct OpenGLMaterialState : public RefCounted
+    {
+        Ref<OpenGLShader> Shader;
+        uint32_t LinkCount = 0;
+        uint32_t KeywordMask = 0;
+        bool HasKeywords = false;
+        std::vector<std::pair<std::string, UniformValue>> Uniforms;
+        std::vector<Ref<Texture>> Textures;
+
+        // Binds the shader variant selected by the keyword flags and returns it.
+        Ref<OpenGLShader> Bind() const;
+    };
+
     class OpenGLMaterial : public Material
     {
     public:
@@ -24,20 +39,29 @@ namespace Chozo {
 		std::string GetName() override { return m_Name; }
 		Ref<Shader> GetShader() const override { return m_Shader; }
 
-        std::map<std::string, UniformValue> GetUniforms() override { return m_Uniforms; }
+        std::map<std::string, UniformValue> GetUniforms() override;
         Ref<Texture2D> GetTexture(std::string name) override;
 
-        std::vector<Ref<Texture>> GetAllTextures() const override { return m_TextureSlots; }
-        uint32_t GetLastTextureSlotIndex() const override { return m_TextureSlotIndex; }
+        std::vector<Ref<Texture>> GetAllTextures() const override;
+        uint32_t GetLastTextureSlotIndex() const override;
 
-        void Bind();
-        void BindTextures();
+        // Any thread. Only rebuilt after the material changed, draws recorded in between share it.
+        Ref<OpenGLMaterialState> Capture();
         void PopulateUniforms(const Ref<OpenGLShader>& shader);
+    private:
+        uint32_t GetKeywordMask();
     private:
         Ref<OpenGLShader> m_Shader;
+        // Keyword i of the shader is enabled by the bool uniform m_KeywordUniforms[i].
+        std::vector<std::string> m_Keywords;
+        std::vector<std::string> m_KeywordUniforms;
 		std::string m_Name;
         std::map<std::string, UniformValue> m_Uniforms;
         std::vector<Ref<Texture>> m_TextureSlots;
         uint32_t m_TextureSlotIndex = 0;
+
+        // Guards the parameters above, the render thread captures them while the main thread edits.
+        mutable std::mutex m_Mutex;
+        Ref<OpenGLMaterialState> m_State;
     };
 }
\ No newline at end of file
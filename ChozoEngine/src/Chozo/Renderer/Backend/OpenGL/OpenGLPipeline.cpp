@@ -1,6 +1,7 @@
 #include "OpenGLPipeline.h"
 
 #include "OpenGLShader.h"
+#include "Chozo/Renderer/Renderer.h"
 
 namespace Chozo
 {
@@ -18,4 +19,23 @@ namespace Chozo
         for (auto [name, uniformBuffer] : m_UBs)
             m_Spec.Shader.As<OpenGLShader>()->SetUniformBlockBinding(std::string(name), uniformBuffer.As<OpenGLUniformBuffer>()->GetBindingPoint());
     }
+
+    void OpenGLPipeline::BindInputs(const Ref<Shader>& shader)
+    {
+        // Material textures are assigned from slot 0 upwards, pipeline inputs count down from the top.
+        int slot = (int)Renderer::GetMaxTextureSlots() - 1;
+        for (auto& [name, storageBuffer] : m_SBs)
+        {
+            storageBuffer->Bind(slot);
+            shader->SetUniform(name, slot);
+            slot--;
+        }
+
+        for (auto& [name, texture] : m_Textures)
+        {
+            texture->Bind(slot);
+            shader->SetUniform(name, slot);
+            slot--;
+        }
+    }
 }
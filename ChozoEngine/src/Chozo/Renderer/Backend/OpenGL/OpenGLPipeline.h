@@ -2,6 +2,8 @@
 
 #include "Chozo/Renderer/Pipeline.h"
 #include "OpenGLUniformBuffer.h"
+#include "OpenGLStorageBuffer.h"
+#include "OpenGLTexture.h"
 
 namespace Chozo
 {
@@ -13,13 +15,19 @@ namespace Chozo
         ~OpenGLPipeline() = default;
 
         virtual PipelineSpecification GetSpec() const override { return m_Spec; }
+        virtual PipelineSpecification& GetSpecification() override { return m_Spec; }
         virtual inline Ref<Shader> GetShader() const override { return m_Spec.Shader; }
         virtual inline Ref<Framebuffer> GetTargetFramebuffer() const override { return m_Spec.TargetFramebuffer; }
+        virtual void SetTargetFramebuffer(const Ref<Framebuffer>& framebuffer) override { m_Spec.TargetFramebuffer = framebuffer; }
 
         void BindUniformBlock();
+        // Binds the storage buffers and input textures to the last texture units and points their samplers at them, shader must be bound.
+        void BindInputs(const Ref<Shader>& shader);
     private:
         PipelineSpecification m_Spec;
         std::unordered_map<std::string, Ref<OpenGLUniformBuffer>> m_UBs;
+        std::unordered_map<std::string, Ref<OpenGLStorageBuffer>> m_SBs;
+        std::unordered_map<std::string, Ref<OpenGLTexture2D>> m_Textures;
 
         friend class OpenGLRenderPass;
     };
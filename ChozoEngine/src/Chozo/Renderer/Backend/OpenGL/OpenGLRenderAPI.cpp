@@ -5,15 +5,37 @@
 #include "Chozo/Renderer/Renderer.h"
 #include "Chozo/Renderer/Renderer2D.h"
 #include "Chozo/Renderer/Mesh.h"
+#include "Chozo/Renderer/MeshPacker.h"
 #include "OpenGLPipeline.h"
 #include "OpenGLRenderPass.h"
 #include "OpenGLMaterial.h"
 #include "OpenGLTexture.h"
+#include "OpenGLTextureUploader.h"
+#include "OpenGLUniformBuffer.h"
+#include "OpenGLShaderCompiler.h"
+#include "OpenGLStateCache.h"
 
 #include <glad/glad.h>
 
 namespace Chozo {
 
+    namespace Utils {
+
+        static GLenum GetGLCompareOperator(const DepthCompareOperator op)
+        {
+            switch (op)
+            {
+                case DepthCompareOperator::Less:        return GL_LESS;
+                case DepthCompareOperator::LessOrEqual: return GL_LEQUAL;
+                case DepthCompareOperator::Equal:       return GL_EQUAL;
+                case DepthCompareOperator::Always:      return GL_ALWAYS;
+            }
+
+            CZ_CORE_ASSERT(false, "Unknown DepthCompareOperator!");
+            return GL_LESS;
+        }
+    }
+
     static const glm::mat4 CubeTextureCaptureViews[] = 
     {
         glm::lookAt(glm::vec3(0.0f), glm::vec3( 1.0f,  0.0f,  0.0f), glm::vec3(0.0f, -1.0f,  0.0f)),
@@ -28,12 +50,48 @@ namespace Chozo {
 
     void OpenGLRenderAPI::Init()
     {
-        glEnable(GL_BLEND); GCE;
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA); GCE;
+        OpenGLShaderCompiler::InitProgramBinaryCache();
+
+        OpenGLStateCache::SetCapability(GL_BLEND, true);
+        OpenGLStateCache::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-        glEnable(GL_DEPTH_TEST); GCE;
-        glEnable(GL_STENCIL_TEST); GCE;
+        OpenGLStateCache::SetCapability(GL_DEPTH_TEST, true);
+        OpenGLStateCache::SetCapability(GL_STENCIL_TEST, true);
         // glPolygonMode(GL_FRONT_AND_BACK, GL_LINE); GCE;
+
+        OpenGLUniformBuffer::InitRingBuffer();
+        OpenGLTextureUploader::Init();
+    }
+
+    void OpenGLRenderAPI::Shutdown()
+    {
+        OpenGLUniformBuffer::ShutdownRingBuffer();
+        OpenGLTextureUploader::Shutdown();
+
+        for (auto& query : m_FragmentQueries)
+        {
+            if (query.RendererID)
+            {
+                glDeleteQueries(1, &query.RendererID); GCE;
+            }
+            query = {};
+        }
+    }
+
+    void OpenGLRenderAPI::BeginFrame()
+    {
+        OpenGLUniformBuffer::NextFrame();
+
+        // Stats were just reset, this reports the state calls of the previous frame.
+        Renderer::GetRendererData().Stats.FilteredStateCalls = OpenGLStateCache::GetFilteredCallCount();
+        Renderer::GetRendererData().Stats.IssuedStateCalls = OpenGLStateCache::GetIssuedCallCount();
+        OpenGLStateCache::ResetCallCounts();
+
+        ResolveFragmentQueries(false);
+        Renderer::GetRendererData().Stats.ShadedFragments = m_ShadedFragments;
+        Renderer::GetRendererData().Stats.Overdraw = m_Overdraw;
+
+        OpenGLTextureUploader::NextFrame();
     }
 
     uint32_t OpenGLRenderAPI::GetMaxTextureSlots()
@@ -43,6 +101,36 @@ namespace Chozo {
         return maxTextureImageUnits;
     }
 
+    bool OpenGLRenderAPI::IsCompressedFormatSupported(const ImageFormat format)
+    {
+        int major, minor;
+        glGetIntegerv(GL_MAJOR_VERSION, &major); GCE;
+        glGetIntegerv(GL_MINOR_VERSION, &minor); GCE;
+
+        auto hasExtension = [](const char* name) {
+            int count;
+            glGetIntegerv(GL_NUM_EXTENSIONS, &count); GCE;
+            for (int i = 0; i < count; i++)
+            {
+                if (std::strcmp((const char*)glGetStringi(GL_EXTENSIONS, i), name) == 0)
+                    return true;
+            }
+            return false;
+        };
+
+        switch (format)
+        {
+            // S3TC never made it into core, every desktop driver exposes it though.
+            case ImageFormat::BC1:
+            case ImageFormat::BC3: return hasExtension("GL_EXT_texture_compression_s3tc");
+            // RGTC is core since 3.0.
+            case ImageFormat::BC5: return true;
+            // BPTC is core since 4.2, macOS stops at 4.1.
+            case ImageFormat::BC7: return major > 4 || (major == 4 && minor >= 2) || hasExtension("GL_ARB_texture_compression_bptc");
+            default: return false;
+        }
+    }
+
     void Chozo::OpenGLRenderAPI::SetClearColor(const glm::vec4& color)
     {
         glClearColor(color.r, color.g, color.b, color.a); GCE;
@@ -55,12 +143,31 @@ namespace Chozo {
 
     void OpenGLRenderAPI::DrawIndexed(const Ref<VertexArray>& vertexArray, uint32_t indexCount, uint32_t indexOffset, uint32_t vertexOffset)
     {
-        uint32_t count = indexCount ? indexCount : vertexArray->GetIndexBuffer()->GetCount();
+        const auto& indexBuffer = vertexArray->GetIndexBuffer();
+        uint32_t count = indexCount ? indexCount : indexBuffer->GetCount();
+        // The index and vertex buffers are part of the vertex array state.
         vertexArray->Bind();
-        vertexArray->GetIndexBuffer()->Bind();
-        for(Ref<VertexBuffer> vertexBuffer : vertexArray->GetVertexBuffers())
-            vertexBuffer->Bind();
-        glDrawElementsBaseVertex(GL_TRIANGLES, count, GL_UNSIGNED_INT, (void*)(indexOffset * sizeof(GLuint)), vertexOffset); GCE;
+        GLenum indexType = indexBuffer->GetFormat() == IndexFormat::UInt16 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+        glDrawElementsBaseVertex(GL_TRIANGLES, count, indexType, (void*)((uintptr_t)indexOffset * IndexFormatSize(indexBuffer->GetFormat())), vertexOffset); GCE;
+    }
+
+    void OpenGLRenderAPI::DrawIndexedRanges(const Ref<VertexArray>& vertexArray, const IndexRange* ranges, uint32_t rangeCount, uint32_t vertexOffset)
+    {
+        const auto& indexBuffer = vertexArray->GetIndexBuffer();
+        vertexArray->Bind();
+
+        GLenum indexType = indexBuffer->GetFormat() == IndexFormat::UInt16 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+        uint32_t indexSize = IndexFormatSize(indexBuffer->GetFormat());
+
+        std::vector<GLsizei> counts(rangeCount);
+        std::vector<const void*> offsets(rangeCount);
+        std::vector<GLint> baseVertices(rangeCount, (GLint)vertexOffset);
+        for (size_t i = 0; i < rangeCount; i++)
+        {
+            counts[i] = (GLsizei)ranges[i].IndexCount;
+            offsets[i] = (const void*)((uintptr_t)ranges[i].BaseIndex * indexSize);
+        }
+        glMultiDrawElementsBaseVertex(GL_TRIANGLES, counts.data(), indexType, offsets.data(), (GLsizei)rangeCount, baseVertices.data()); GCE;
     }
 
     void OpenGLRenderAPI::DrawLines(const Ref<VertexArray>& vertexArray, uint32_t vertexCount)
@@ -98,7 +205,7 @@ namespace Chozo {
         shader->SetUniform("u_FragUniforms.TextureLod", skyboxLod);
 
         // TODO: Change to pipeline context status.
-        glDepthFunc(GL_LEQUAL); GCE;
+        OpenGLStateCache::DepthFunc(GL_LEQUAL);
         DrawIndexed(Renderer::GetRendererData().BoxMesh->GetVertexArray(), 0);
         ResetGLContext();
     }
@@ -137,6 +244,9 @@ namespace Chozo {
         auto fbo = pipeline->GetTargetFramebuffer();
         auto shader = pipeline->GetShader();
 
+        // The bake is kept, it can't sample the placeholder.
+        OpenGLTextureUploader::Flush();
+
         fbo->Bind();
         pipeline.As<OpenGLPipeline>()->BindUniformBlock();
         texture.As<OpenGLTexture2D>()->Bind();
@@ -163,7 +273,7 @@ namespace Chozo {
 
         fbo->Bind();
         pipeline.As<OpenGLPipeline>()->BindUniformBlock();
-        if (material) { material.As<OpenGLMaterial>()->Bind(); }
+        if (material) { material.As<OpenGLMaterial>()->Capture()->Bind(); }
         shader->Bind();
         for (uint32_t i = 0; i < 6; i++)
         {
@@ -186,14 +296,14 @@ namespace Chozo {
 
         fbo->Bind();
         pipeline.As<OpenGLPipeline>()->BindUniformBlock();
-        if (material) { material.As<OpenGLMaterial>()->Bind(); }
+        if (material) { material.As<OpenGLMaterial>()->Capture()->Bind(); }
         shader->Bind();
-        unsigned int maxMipLevels = 5;
+        unsigned int maxMipLevels = Renderer::PrefilteredMapMipLevels;
         for (unsigned int mip = 0; mip < maxMipLevels; ++mip)
         {
             // reisze framebuffer according to mip-level size.
-            unsigned int mipWidth  = static_cast<unsigned int>(128 * std::pow(0.5, mip));
-            unsigned int mipHeight = static_cast<unsigned int>(128 * std::pow(0.5, mip));
+            unsigned int mipWidth  = static_cast<unsigned int>(Renderer::PrefilteredMapResolution * std::pow(0.5, mip));
+            unsigned int mipHeight = static_cast<unsigned int>(Renderer::PrefilteredMapResolution * std::pow(0.5, mip));
             fbo->Resize(mipWidth, mipHeight, mip);
 
             float roughness = (float)mip / (float)(maxMipLevels - 1);
@@ -240,12 +350,13 @@ namespace Chozo {
 
     void OpenGLRenderAPI::SubmitCubeMap(Ref<RenderCommandBuffer> commandBuffer, Ref<Pipeline> pipeline, Ref<TextureCube> cubemap, Ref<Material> material)
     {
-        commandBuffer->AddCommand([pipeline, cubemap, material, this]()
+        Ref<OpenGLMaterialState> state = material ? material.As<OpenGLMaterial>()->Capture() : nullptr;
+        commandBuffer->AddCommand([pipeline, cubemap, state, this]()
         {
             auto shader = pipeline->GetShader();
 
             pipeline.As<OpenGLPipeline>()->BindUniformBlock();
-            if (material) { material.As<OpenGLMaterial>()->Bind(); }
+            if (state) { state->Bind(); }
             shader->Bind();
             for (uint32_t i = 0; i < 6; i++)
             {
@@ -262,32 +373,40 @@ namespace Chozo {
     }
 
     void OpenGLRenderAPI::RenderFullscreenQuad(Ref<Pipeline> pipeline, Ref<Material> material)
+    {
+        DrawFullscreenQuad(pipeline, material ? material.As<OpenGLMaterial>()->Capture().Raw() : nullptr);
+    }
+
+    void OpenGLRenderAPI::SubmitFullscreenQuad(Ref<RenderCommandBuffer> commandBuffer, Ref<Pipeline> pipeline, Ref<Material> material)
+    {
+        Ref<OpenGLMaterialState> state = material ? material.As<OpenGLMaterial>()->Capture() : nullptr;
+        commandBuffer->AddCommand([pipeline, state, this]()
+        {
+            DrawFullscreenQuad(pipeline, state.Raw());
+        });
+    }
+
+    void OpenGLRenderAPI::DrawFullscreenQuad(const Ref<Pipeline>& pipeline, const OpenGLMaterialState* state)
     {
         auto shader = pipeline->GetShader();
 
         pipeline.As<OpenGLPipeline>()->BindUniformBlock();
-        if (material) { material.As<OpenGLMaterial>()->Bind(); }
+        if (state) { state->Bind(); }
         shader->Bind();
+        pipeline.As<OpenGLPipeline>()->BindInputs(shader);
         PrepareGLContext(pipeline);
         Renderer2D::DrawFullScreenQuad();
         ResetGLContext();
     }
 
-    void OpenGLRenderAPI::SubmitFullscreenQuad(Ref<RenderCommandBuffer> commandBuffer, Ref<Pipeline> pipeline, Ref<Material> material)
-    {
-        commandBuffer->AddCommand([pipeline, material, this]()
-        {
-            RenderFullscreenQuad(pipeline, material);
-        });
-    }
-
     void OpenGLRenderAPI::SubmitFullscreenBox(Ref<RenderCommandBuffer> commandBuffer, Ref<Pipeline> pipeline, Ref<Material> material)
     {
-        commandBuffer->AddCommand([pipeline, material, this]()
+        Ref<OpenGLMaterialState> state = material ? material.As<OpenGLMaterial>()->Capture() : nullptr;
+        commandBuffer->AddCommand([pipeline, state, this]()
         {
             pipeline.As<OpenGLPipeline>()->BindUniformBlock();
             
-            if (material) { material.As<OpenGLMaterial>()->Bind(); }
+            if (state) { state->Bind(); }
 
             PrepareGLContext(pipeline);
             DrawIndexed(Renderer::GetRendererData().BoxMesh->GetVertexArray(), 0);
@@ -295,40 +414,81 @@ namespace Chozo {
         });
     }
 
-    void OpenGLRenderAPI::SubmitMeshWithMaterial(Ref<RenderCommandBuffer> commandBuffer, Ref<Pipeline> pipeline, Ref<DynamicMesh> mesh, uint32_t submeshIndex, Ref<Material> material, glm::mat4 transform, int id)
+    void OpenGLRenderAPI::SubmitMeshWithMaterial(const Ref<RenderCommandBuffer>& commandBuffer, const Ref<Pipeline>& pipeline, DynamicMesh* mesh, uint32_t submeshIndex, uint32_t lod, const IndexRange* ranges, uint32_t rangeCount, Material* material, const glm::mat4& transform, int id)
     {
-        commandBuffer->AddCommand([pipeline, mesh, submeshIndex, material, transform, id, this]()
+        // Pipelines live as long as their render pass, only the raw pointer is captured to keep draws free of ref counting.
+        auto* glPipeline = static_cast<OpenGLPipeline*>(const_cast<Pipeline*>(pipeline.Raw()));
+        // Captured now, a pass may record the same pipeline with another depth state later in the frame.
+        const auto& spec = glPipeline->GetSpecification();
+        const bool depthWrite = spec.DepthWrite, colorWrite = spec.ColorWrite, positionOnly = spec.PositionOnly;
+        const GLenum depthFunc = Utils::GetGLCompareOperator(spec.DepthOperator);
+        const bool additive = spec.Blending == BlendMode::Additive;
+        // The material as recorded, pinned for the frame like the mesh.
+        const OpenGLMaterialState* state = material ? Renderer::GetFrameAllocator().Pin(static_cast<OpenGLMaterial*>(material)->Capture()) : nullptr;
+        commandBuffer->AddCommand([glPipeline, mesh, submeshIndex, lod, ranges, rangeCount, state, transform, id, depthWrite, colorWrite, positionOnly, depthFunc, additive, this]()
         {
-            auto shader = pipeline->GetShader();
+            auto shader = glPipeline->GetShader();
 
-            pipeline.As<OpenGLPipeline>()->BindUniformBlock();
+            glPipeline->BindUniformBlock();
 
-            if (material)
+            if (state)
             {
-                material.As<OpenGLMaterial>()->Bind();
+                Ref<OpenGLShader> variant = state->Bind();
+                // Draw with the keyword variant the material picked when it shares the pipeline's shader.
+                if (state->Shader.Raw() == shader.Raw())
+                    shader = variant;
             }
-            shader->Bind();
-            shader->SetUniform("u_VertUniforms.ModelMatrix", transform);
-            shader->SetUniform("u_Material.ID", id);
-
 			const auto& subMeshes = mesh->GetMeshSource()->GetSubmeshes();
 			const auto& subMesh = subMeshes[submeshIndex];
 
-            uint32_t indexOffset = subMesh.BaseIndex;
+            shader->Bind();
+            shader->SetUniform("u_VertUniforms.ModelMatrix", transform);
+            shader->SetUniform("u_VertUniforms.PositionOffset", glm::vec4(mesh->GetPositionOffset(), 0.0f));
+            shader->SetUniform("u_VertUniforms.PositionScale", glm::vec4(mesh->GetPositionScale(), 1.0f));
+            if (!positionOnly)
+                shader->SetUniform("u_Material.ID", id);
+            glPipeline->BindInputs(shader);
+
+            uint32_t indexOffset = subMesh.GetLODBaseIndex(lod);
             uint32_t vertexOffset = subMesh.BaseVertex;
-            uint32_t indexCount = subMesh.IndexCount;
+            uint32_t indexCount = subMesh.GetLODIndexCount(lod);
             uint32_t vertexCount = subMesh.VertexCount;
 
-            glDisable(GL_BLEND); GCE;
-            glEnable(GL_CULL_FACE); GCE;
-            DrawIndexed(mesh->GetVertexArray(), indexCount, indexOffset, vertexOffset);
-            glDisable(GL_CULL_FACE); GCE;
+            OpenGLStateCache::SetCapability(GL_BLEND, additive);
+            if (additive)
+                OpenGLStateCache::BlendFunc(GL_ONE, GL_ONE);
+            OpenGLStateCache::SetCapability(GL_CULL_FACE, true);
+            OpenGLStateCache::DepthFunc(depthFunc);
+            OpenGLStateCache::DepthMask(depthWrite);
+            OpenGLStateCache::ColorMask(colorWrite);
+
+            const auto& vertexArray = positionOnly ? mesh->GetPositionVertexArray() : mesh->GetVertexArray();
+            if (!ranges)
+            {
+                DrawIndexed(vertexArray, indexCount, indexOffset, vertexOffset);
+            }
+            else
+            {
+                // Only the meshlets that survived culling.
+                DrawIndexedRanges(vertexArray, ranges, rangeCount, vertexOffset);
+                indexCount = 0;
+                for (uint32_t i = 0; i < rangeCount; i++)
+                    indexCount += ranges[i].IndexCount;
+            }
+
+            // Everything else draws with the defaults, clears included.
+            OpenGLStateCache::SetCapability(GL_CULL_FACE, false);
+            OpenGLStateCache::DepthFunc(GL_LESS);
+            OpenGLStateCache::DepthMask(true);
+            OpenGLStateCache::ColorMask(true);
+            if (additive)
+                OpenGLStateCache::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-            auto rendererData = Renderer::GetRendererData();
+            auto& rendererData = Renderer::GetRendererData();
             rendererData.Stats.DrawCalls++;
             rendererData.IndexCount += indexCount;
             rendererData.Stats.VerticesCount += vertexCount;
-            rendererData.Stats.TriangleCount += indexCount;
+            rendererData.Stats.TriangleCount += indexCount / 3;
         });
     }
 
@@ -341,14 +501,70 @@ namespace Chozo {
         });
     }
 
+    void OpenGLRenderAPI::BeginFragmentQuery(Ref<RenderCommandBuffer> commandBuffer)
+    {
+        commandBuffer->AddCommand([this]()
+        {
+            auto& query = m_FragmentQueries[m_FragmentQueryIndex];
+            // Reusing a query drops its result, take it even if the GPU has to catch up first.
+            if (query.Pending)
+                ResolveFragmentQueries(true);
+            if (!query.RendererID)
+            {
+                glGenQueries(1, &query.RendererID); GCE;
+            }
+
+            glBeginQuery(GL_SAMPLES_PASSED, query.RendererID); GCE;
+        });
+    }
+
+    void OpenGLRenderAPI::EndFragmentQuery(Ref<RenderCommandBuffer> commandBuffer, const uint32_t pixelCount)
+    {
+        commandBuffer->AddCommand([pixelCount, this]()
+        {
+            auto& query = m_FragmentQueries[m_FragmentQueryIndex];
+            glEndQuery(GL_SAMPLES_PASSED); GCE;
+            query.PixelCount = pixelCount;
+            query.Pending = true;
+            m_FragmentQueryIndex = (m_FragmentQueryIndex + 1) % (uint32_t)std::size(m_FragmentQueries);
+        });
+    }
+
+    void OpenGLRenderAPI::ResolveFragmentQueries(const bool wait)
+    {
+        // Oldest first, so the newest available result ends up in the stats.
+        const uint32_t count = (uint32_t)std::size(m_FragmentQueries);
+        for (uint32_t i = 0; i < count; i++)
+        {
+            auto& query = m_FragmentQueries[(m_FragmentQueryIndex + i) % count];
+            if (!query.Pending)
+                continue;
+
+            GLuint available = GL_FALSE;
+            if (!wait)
+            {
+                glGetQueryObjectuiv(query.RendererID, GL_QUERY_RESULT_AVAILABLE, &available); GCE;
+                if (!available)
+                    continue;
+            }
+
+            GLuint samples = 0;
+            glGetQueryObjectuiv(query.RendererID, GL_QUERY_RESULT, &samples); GCE;
+            query.Pending = false;
+
+            m_ShadedFragments = samples;
+            m_Overdraw = query.PixelCount ? (float)samples / (float)query.PixelCount : 0.0f;
+        }
+    }
+
     void OpenGLRenderAPI::PrepareGLContext(Ref<Pipeline> pipeline)
     {
         if (pipeline->GetSpec().DepthWrite)
-            glDepthFunc(GL_LEQUAL); GCE;
+            OpenGLStateCache::DepthFunc(GL_LEQUAL);
     }
 
     void OpenGLRenderAPI::ResetGLContext()
     {
-        glDepthFunc(GL_LESS); GCE;
+        OpenGLStateCache::DepthFunc(GL_LESS);
     }
 }
@@ -5,17 +5,23 @@
 
 namespace Chozo {
     
+    struct OpenGLMaterialState;
+
     class OpenGLRenderAPI : public RenderAPI
     {
     public:
         virtual void Init() override;
+        virtual void Shutdown() override;
+        virtual void BeginFrame() override;
         
         virtual uint32_t GetMaxTextureSlots() override;
+        virtual bool IsCompressedFormatSupported(ImageFormat format) override;
 
         virtual void SetClearColor(const glm::vec4& color) override;
         virtual void Clear() override;
 
         virtual void DrawIndexed(const Ref<VertexArray>& vertexArray, uint32_t indexCount = 0, uint32_t indexOffset = 0, uint32_t vertexOffset = 0) override;
+        virtual void DrawIndexedRanges(const Ref<VertexArray>& vertexArray, const IndexRange* ranges, uint32_t rangeCount, uint32_t vertexOffset = 0) override;
         virtual void DrawLines(const Ref<VertexArray>& vertexArray, uint32_t vertexCount) override;
 
         virtual void RenderCubemap(Ref<Pipeline> pipeline, Ref<TextureCube> cubemap, const Ref<Texture2D> texture) override;
@@ -33,11 +39,29 @@ namespace Chozo {
         virtual void RenderFullscreenQuad(Ref<Pipeline> pipeline, Ref<Material> material = nullptr) override;
         virtual void SubmitFullscreenQuad(Ref<RenderCommandBuffer> commandBuffer, Ref<Pipeline> pipeline, Ref<Material> material = nullptr) override;
         virtual void SubmitFullscreenBox(Ref<RenderCommandBuffer> commandBuffer, Ref<Pipeline> pipeline, Ref<Material> material = nullptr) override;
-        virtual void SubmitMeshWithMaterial(Ref<RenderCommandBuffer> commandBuffer, Ref<Pipeline> pipeline, Ref<DynamicMesh> mesh, uint32_t submeshIndex, Ref<Material> material, glm::mat4 transform, int id) override;
+        virtual void SubmitMeshWithMaterial(const Ref<RenderCommandBuffer>& commandBuffer, const Ref<Pipeline>& pipeline, DynamicMesh* mesh, uint32_t submeshIndex, uint32_t lod, const IndexRange* ranges, uint32_t rangeCount, Material* material, const glm::mat4& transform, int id) override;
 
         virtual void CopyImage(Ref<RenderCommandBuffer> commandBuffer, Ref<Texture2D> source, SharedBuffer& dest) override;
+
+        virtual void BeginFragmentQuery(Ref<RenderCommandBuffer> commandBuffer) override;
+        virtual void EndFragmentQuery(Ref<RenderCommandBuffer> commandBuffer, uint32_t pixelCount) override;
     private:
+        void DrawFullscreenQuad(const Ref<Pipeline>& pipeline, const OpenGLMaterialState* state);
         void PrepareGLContext(Ref<Pipeline> pipeline);
         void ResetGLContext();
+        void ResolveFragmentQueries(bool wait);
+    private:
+        struct FragmentQuery
+        {
+            uint32_t RendererID = 0;
+            uint32_t PixelCount = 0;
+            bool Pending = false;
+        };
+
+        // One more than the frames in flight, the oldest query is normally done when it gets reused.
+        FragmentQuery m_FragmentQueries[3];
+        uint32_t m_FragmentQueryIndex = 0;
+        uint32_t m_ShadedFragments = 0;
+        float m_Overdraw = 0.0f;
     };
 }
\ No newline at end of file
@@ -14,7 +14,7 @@ namespace Chozo {
 
     void OpenGLRenderCommandBuffer::Begin()
     {
-        m_Commands.clear();
+        m_CommandQueue.Reset();
     }
 
     void OpenGLRenderCommandBuffer::End()
@@ -24,12 +24,6 @@ namespace Chozo {
 
     void OpenGLRenderCommandBuffer::Submit()
     {
-        for (auto& cmd : m_Commands)
-            Renderer::Submit(std::move(cmd));
-    }
-
-    void OpenGLRenderCommandBuffer::AddCommand(std::function<void()> &&func)
-    {
-        m_Commands.push_back([func = std::forward<std::function<void()>>(func)]() mutable { func(); });
+        Renderer::SubmitCommandQueue(m_CommandQueue);
     }
 }
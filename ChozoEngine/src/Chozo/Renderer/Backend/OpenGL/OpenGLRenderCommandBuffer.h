@@ -16,10 +16,10 @@ namespace Chozo {
         virtual void Begin() override;
         virtual void End() override;
         
-        virtual void AddCommand(std::function<void()>&& func) override;
+        virtual RenderCommandQueue& GetCommandQueue() override { return m_CommandQueue; }
     private:
         virtual void Submit() override;
     private:
-        std::vector<std::function<void()>> m_Commands;
+        RenderCommandQueue m_CommandQueue{ 64 * 1024 };
     };
 }
@@ -1,6 +1,7 @@
 #include "OpenGLRenderPass.h"
 
 #include "OpenGLPipeline.h"
+#include "OpenGLTexture.h"
 #include "Chozo/Renderer/RenderCommand.h"
 
 #include <glad/glad.h>
@@ -22,11 +23,26 @@ namespace Chozo {
     {
     }
 
+    void OpenGLRenderPass::SetInput(std::string_view name, Ref<StorageBuffer> storageBuffer)
+    {
+        m_Specification.Pipeline.As<OpenGLPipeline>()->m_SBs[std::string(name)] = storageBuffer.As<OpenGLStorageBuffer>();
+    }
+
+    void OpenGLRenderPass::SetInput(std::string_view name, Ref<Texture2D> texture)
+    {
+        m_Specification.Pipeline.As<OpenGLPipeline>()->m_Textures[std::string(name)] = texture.As<OpenGLTexture2D>();
+    }
+
     Ref<Texture2D> OpenGLRenderPass::GetOutput(uint32_t index)
     {
         return GetTargetFramebuffer()->GetImage(index);
     }
 
+    Ref<Texture2D> OpenGLRenderPass::GetDepthOutput()
+    {
+        return GetTargetFramebuffer()->GetDepthImage();
+    }
+
     Ref<Pipeline> OpenGLRenderPass::GetPipeline() const
     {
         return m_Specification.Pipeline;
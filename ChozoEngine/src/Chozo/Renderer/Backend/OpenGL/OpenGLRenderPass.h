@@ -15,8 +15,11 @@ namespace Chozo {
 
 		virtual void SetInput(std::string_view name, Ref<UniformBuffer> uniformBuffer) override;
         virtual void SetInput(std::string_view name, Ref<TextureCube> textureCube) override;
+        virtual void SetInput(std::string_view name, Ref<StorageBuffer> storageBuffer) override;
+        virtual void SetInput(std::string_view name, Ref<Texture2D> texture) override;
 
 		virtual Ref<Texture2D> GetOutput(uint32_t index) override;
+		virtual Ref<Texture2D> GetDepthOutput() override;
         
         virtual Ref<Pipeline> GetPipeline() const override;
         virtual Ref<Framebuffer> GetTargetFramebuffer() const override;
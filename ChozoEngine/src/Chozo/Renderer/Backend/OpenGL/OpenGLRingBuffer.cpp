@@ -0,0 +1,84 @@
+#include "OpenGLRingBuffer.h"
+
+#include "OpenGLUtils.h"
+
+namespace Chozo {
+
+    namespace Utils {
+
+        static uint32_t AlignUp(const uint32_t value, const uint32_t alignment)
+        {
+            return (value + alignment - 1) / alignment * alignment;
+        }
+    }
+
+    OpenGLRingBuffer::OpenGLRingBuffer(const GLenum target, const uint32_t segmentSize, const uint32_t alignment)
+        : m_Target(target), m_Alignment(std::max(alignment, 1u))
+    {
+        // Segments start aligned so every write offset is.
+        m_SegmentSize = Utils::AlignUp(segmentSize, m_Alignment);
+
+        glGenBuffers(1, &m_RendererID); GCE;
+        glBindBuffer(m_Target, m_RendererID); GCE;
+        glBufferData(m_Target, (GLsizeiptr)m_SegmentSize * SegmentCount, nullptr, GL_STREAM_DRAW); GCE;
+        glBindBuffer(m_Target, 0); GCE;
+    }
+
+    OpenGLRingBuffer::~OpenGLRingBuffer()
+    {
+        for (auto& fence : m_Fences)
+        {
+            if (fence)
+            {
+                glDeleteSync(fence); GCE;
+            }
+        }
+        glDeleteBuffers(1, &m_RendererID); GCE;
+    }
+
+    void OpenGLRingBuffer::NextFrame()
+    {
+        if (m_Fences[m_Segment])
+        {
+            glDeleteSync(m_Fences[m_Segment]); GCE;
+        }
+        m_Fences[m_Segment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0); GCE;
+
+        m_Segment = (m_Segment + 1) % SegmentCount;
+        m_Head = 0;
+
+        GLsync fence = m_Fences[m_Segment];
+        if (!fence)
+            return;
+
+        while (glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000) == GL_TIMEOUT_EXPIRED) {}
+        glDeleteSync(fence); GCE;
+        m_Fences[m_Segment] = nullptr;
+    }
+
+    bool OpenGLRingBuffer::Write(const void* data, const uint32_t dataSize, const uint32_t size, uint32_t& offset)
+    {
+        CZ_CORE_ASSERT(dataSize <= size, "Ring buffer write is larger than its reservation!");
+
+        const uint32_t head = Utils::AlignUp(m_Head, m_Alignment);
+        if (head + size > m_SegmentSize)
+            return false;
+
+        offset = m_Segment * m_SegmentSize + head;
+        m_Head = head + size;
+        if (dataSize == 0)
+            return true;
+
+        // The fence in NextFrame guarantees the GPU is done with this range.
+        glBindBuffer(m_Target, m_RendererID); GCE;
+        void* mapped = glMapBufferRange(m_Target, offset, dataSize, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT); GCE;
+        if (mapped)
+        {
+            memcpy(mapped, data, dataSize);
+            glUnmapBuffer(m_Target); GCE;
+        }
+        glBindBuffer(m_Target, 0); GCE;
+
+        return mapped != nullptr;
+    }
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "czpch.h"
+
+#include <glad/glad.h>
+
+namespace Chozo {
+
+    // Streaming buffer split into one segment per frame. A fence is placed when a frame's segment is done,
+    // so writes go through unsynchronized maps and the CPU only waits when the GPU is SegmentCount frames behind.
+    class OpenGLRingBuffer
+    {
+    public:
+        static constexpr uint32_t SegmentCount = 3;
+
+        OpenGLRingBuffer(GLenum target, uint32_t segmentSize, uint32_t alignment);
+        ~OpenGLRingBuffer();
+
+        OpenGLRingBuffer(const OpenGLRingBuffer&) = delete;
+        OpenGLRingBuffer& operator=(const OpenGLRingBuffer&) = delete;
+
+        // Fences the current segment and moves to the next one, waiting for the frame that last used it.
+        void NextFrame();
+        // Reserves size bytes in the current segment and copies dataSize bytes of data to its start.
+        // Returns false when the segment is full, offset is relative to the start of the buffer.
+        bool Write(const void* data, uint32_t dataSize, uint32_t size, uint32_t& offset);
+
+        uint32_t GetRendererID() const { return m_RendererID; }
+    private:
+        GLenum m_Target;
+        uint32_t m_RendererID = 0;
+        uint32_t m_SegmentSize;
+        uint32_t m_Alignment;
+
+        uint32_t m_Segment = 0;
+        uint32_t m_Head = 0;
+        GLsync m_Fences[SegmentCount] = {};
+    };
+}
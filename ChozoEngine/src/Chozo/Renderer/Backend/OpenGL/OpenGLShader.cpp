@@ -10,25 +10,32 @@
 #include <spirv_cross/spirv_glsl.hpp>
 #include <utility>
 
+#include "OpenGLStateCache.h"
+#include "OpenGLShaderCompiler.h"
+
 #include "Chozo/Renderer/RenderCommand.h"
+#include "Chozo/Renderer/Renderer.h"
 #include "Chozo/FileSystem/FileStream.h"
 
 #include "Chozo/Renderer/Shader/ShaderCompiler.h"
 
 #include "Chozo/Core/Application.h"
+#include "Chozo/Core/Pool.h"
 #include <GLFW/glfw3.h>
 
 namespace Chozo {
 
-    OpenGLShader::OpenGLShader(std::string name, const std::vector<std::string>& filePaths)
-        : m_FilePaths(filePaths), m_Name(std::move(name))
+    OpenGLShader::OpenGLShader(std::string name, const std::vector<std::string>& filePaths, const std::vector<std::string>& defines)
+        : m_FilePaths(filePaths), m_Defines(defines), m_Name(std::move(name))
     {
-        OpenGLShader::Compile();
     }
 
     OpenGLShader::~OpenGLShader()
     {
-        glDeleteProgram(m_RendererID);
+        Renderer::SubmitResourceFree([rendererID = m_RendererID]() {
+            OpenGLStateCache::OnProgramDeleted(rendererID);
+            glDeleteProgram(rendererID);
+        });
     }
 
     // std::string OpenGLShader::PreProcess(const std::string &source)
@@ -72,12 +79,12 @@ namespace Chozo {
 
     void OpenGLShader::Bind() const
     {
-        glUseProgram(m_RendererID);
+        OpenGLStateCache::UseProgram(m_RendererID);
     }
 
     void OpenGLShader::Unbind() const
     {
-        glUseProgram(0);
+        OpenGLStateCache::UseProgram(0);
     }
 
     void OpenGLShader::SetUniform(const std::string &name, const UniformValue &value, const uint32_t count) const
@@ -129,32 +136,118 @@ namespace Chozo {
 
     void OpenGLShader::ClearCache()
     {
-        fs::path cacheDirectory = Utils::File::GetShaderCacheDirectory();
+        for (auto&& cachePath : m_CachePaths)
+            Utils::File::DeleteFile(cachePath);
+    }
+
+    void OpenGLShader::Compile()
+    {
+        CompileSources();
+        Link();
+    }
+
+    void OpenGLShader::CompileSources()
+    {
+        m_PendingCompiler = ShaderCompiler::Create(m_Name);
+        m_PendingCompiler->SetDefines(m_Defines);
+        m_PendingCompiler->CompileSources(m_FilePaths);
+        m_PendingReflection = m_PendingCompiler->Reflect();
+    }
+
+    void OpenGLShader::Link()
+    {
+        CZ_CORE_ASSERT(m_PendingCompiler, "Shader sources must be compiled before linking!");
+
+        // Draws already recorded this frame may still use the previous program.
+        if (m_RendererID)
+        {
+            Renderer::SubmitResourceFree([rendererID = m_RendererID]() {
+                OpenGLStateCache::OnProgramDeleted(rendererID);
+                glDeleteProgram(rendererID);
+            });
+        }
 
-        for (auto&& filepath : m_FilePaths)
+        m_RendererID = m_PendingCompiler->Link();
+        m_UniformLocationCache.clear();
+        m_Reflection = m_PendingReflection;
+        m_Dependencies = m_PendingCompiler->GetDependencies();
         {
-            fs::path shaderFilepath(filepath);
-            auto stage = ShaderUtils::GetShaderStageFromExtension(shaderFilepath.extension().string());
-            fs::path cachePath = ShaderUtils::GetCachePathByNameAndStage(shaderFilepath.filename().stem().string(), stage);
+            // Variants still compiling keep their own references, dropping them doesn't wait.
+            std::lock_guard<std::mutex> lock(m_VariantMutex);
+            m_Keywords = m_PendingCompiler->GetKeywords();
+            m_Variants.clear();
+            m_LinkCount++;
+        }
 
-            Utils::File::DeleteFile(cachePath);
+        std::vector<fs::path> cachePaths;
+        for (auto&& [stage, cachePath] : m_PendingCompiler->GetCachePaths())
+            cachePaths.push_back(cachePath);
+        const auto& programCachePath = m_PendingCompiler.As<OpenGLShaderCompiler>()->GetProgramCachePath();
+        if (!programCachePath.empty())
+            cachePaths.push_back(programCachePath);
+
+        // Cache files are keyed by source hash, the ones of the previous sources are never read again.
+        for (const auto& cachePath : m_CachePaths)
+        {
+            if (std::find(cachePaths.begin(), cachePaths.end(), cachePath) == cachePaths.end())
+                Utils::File::DeleteFile(cachePath);
         }
+        m_CachePaths = std::move(cachePaths);
+
+        m_PendingCompiler = nullptr;
     }
 
-    void OpenGLShader::Compile()
+    std::vector<std::string> OpenGLShader::GetKeywords() const
     {
-        auto compiler = ShaderCompiler::Create(m_Name);
-        m_RendererID = compiler->Compile(m_FilePaths);
-        m_Reflection = compiler->Reflect();
+        std::lock_guard<std::mutex> lock(m_VariantMutex);
+        return m_Keywords;
     }
 
-    void OpenGLShader::AsyncCompile()
+    Ref<Shader> OpenGLShader::GetVariant(const uint32_t keywordMask)
     {
-        auto sharedContext = Application::Get().GetWindow().GetSharedWindow();
+        Ref<OpenGLShader> shader;
+        {
+            std::lock_guard<std::mutex> lock(m_VariantMutex);
+
+            // Bits of keywords the shader doesn't declare (anymore) select nothing.
+            const uint32_t validMask = m_Keywords.size() < 32 ? (1u << m_Keywords.size()) - 1 : ~0u;
+            const uint32_t mask = keywordMask & validMask;
+            if (mask == 0)
+                return this;
+
+            auto it = m_Variants.find(mask);
+            if (it == m_Variants.end())
+            {
+                std::vector<std::string> defines = m_Defines;
+                for (uint32_t i = 0; i < m_Keywords.size(); i++)
+                {
+                    if (mask & (1u << i))
+                        defines.push_back(m_Keywords[i]);
+                }
+
+                ShaderVariant variant;
+                variant.Shader = Ref<OpenGLShader>::Create(fmt::format("{}_{:x}", m_Name, mask), m_FilePaths, defines);
+                variant.Compiled = std::make_shared<std::atomic<bool>>(false);
+                Pool::Dispatch([shader = variant.Shader, compiled = variant.Compiled]() mutable {
+                    shader->CompileSources();
+                    *compiled = true;
+                });
+                it = m_Variants.emplace(mask, std::move(variant)).first;
+            }
+
+            auto& variant = it->second;
+            if (variant.Linked)
+                return variant.Shader;
+            if (!*variant.Compiled)
+                return this;
+
+            variant.Linked = true;
+            shader = variant.Shader;
+        }
 
-        glfwMakeContextCurrent(sharedContext);
-        Compile();
-        glfwMakeContextCurrent(nullptr);
+        // Only the render thread gets here, the lock isn't held while linking.
+        shader->Link();
+        return shader;
     }
 
     void OpenGLShader::SetUniformBool(const std::string &name, const bool value) const
@@ -227,13 +320,13 @@ namespace Chozo {
         glUniformMatrix4fv(GetUniformLocation(name), count, GL_FALSE, &value[0][0][0]);
     }
 
-    int OpenGLShader::GetUniformLocation(const std::string& name) const
+    int OpenGLShader::GetUniformLocation(const std::string& name, const bool required) const
     {
         if (m_UniformLocationCache.find(name) != m_UniformLocationCache.end())
             return m_UniformLocationCache[name];
 
         int location = glGetUniformLocation(m_RendererID, name.c_str());
-        if (location == -1)
+        if (location == -1 && required)
             CZ_CORE_ERROR("Uniform '{}' doesn't exist!", name);
 
         m_UniformLocationCache[name] = location;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Chozo/Renderer/Shader.h"
+#include "Chozo/Renderer/Shader/ShaderCompiler.h"
 #include "OpenGLUniformBuffer.h"
 
 typedef unsigned int GLenum; // TODO: remove!
@@ -10,7 +11,7 @@ namespace Chozo {
     class OpenGLShader final : public Shader
     {
     public:
-        OpenGLShader(std::string  name, const std::vector<std::string>& filePaths);
+        OpenGLShader(std::string  name, const std::vector<std::string>& filePaths, const std::vector<std::string>& defines = {});
         ~OpenGLShader() override;
 
         void Bind() const override;
@@ -19,13 +20,20 @@ namespace Chozo {
         const std::string& GetName() const override { return m_Name; }
         const RendererID& GetRendererID() const override { return m_RendererID; }
         ShaderReflection GetReflection() const override { return m_Reflection; }
+        const std::unordered_set<std::string>& GetDependencies() const override { return m_Dependencies; }
+        std::vector<std::string> GetKeywords() const override;
+        // Bumped by every Link, the keyword layout may have changed.
+        uint32_t GetLinkCount() const { return m_LinkCount; }
+        Ref<Shader> GetVariant(uint32_t keywordMask) override;
+        bool HasUniform(const std::string& name) const override { return GetUniformLocation(name, false) != -1; }
 
         void SetUniform(const std::string& name, const UniformValue& value, uint32_t count) const override;
     public:
         void SetUniformBlockBinding(const std::string& name, uint32_t bindingPoint) const;
         void ClearCache() override;
         void Compile() override;
-        void AsyncCompile() override;
+        void CompileSources() override;
+        void Link() override;
     private:
         void SetUniformBool(const std::string& name, bool value) const;
         void SetUniform1i(const std::string& name, int value) const;
@@ -41,10 +49,28 @@ namespace Chozo {
         void SetUniformMat3(const std::string& name, const glm::mat3& matrix) const;
         void SetUniformMat4(const std::string& name, const glm::mat4& matrix) const;
         void SetUniformMat4V(const std::string& name, const std::vector<glm::mat4>& array, uint32_t count) const;
-        int GetUniformLocation(const std::string& name) const;
+        int GetUniformLocation(const std::string& name, bool required = true) const;
     private:
+        struct ShaderVariant
+        {
+            Ref<OpenGLShader> Shader;
+            // Set by the pool worker once the sources are compiled.
+            std::shared_ptr<std::atomic<bool>> Compiled;
+            bool Linked = false;
+        };
+
         uint32_t m_RendererID{};
         std::vector<std::string> m_FilePaths;
+        std::vector<std::string> m_Defines;
+        // Guards the keyword layout and the variants built from it, Link replaces both.
+        mutable std::mutex m_VariantMutex;
+        std::vector<std::string> m_Keywords;
+        std::unordered_map<uint32_t, ShaderVariant> m_Variants;
+        std::atomic<uint32_t> m_LinkCount = 0;
+        Ref<ShaderCompiler> m_PendingCompiler;
+        ShaderReflection m_PendingReflection;
+        std::vector<fs::path> m_CachePaths;
+        std::unordered_set<std::string> m_Dependencies;
         std::string m_Name;
         mutable std::unordered_map<std::string, int> m_UniformLocationCache;
     };
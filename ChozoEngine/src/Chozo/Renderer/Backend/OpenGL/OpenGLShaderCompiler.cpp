@@ -1,6 +1,7 @@
 #include "OpenGLShaderCompiler.h"
 
 #include "Chozo/Renderer/Shader/GlslIncluder.h"
+#include "Chozo/Renderer/Shader/ShaderIncludeCache.h"
 
 #include "Chozo/Core/Timer.h"
 #include "Chozo/Utilities/FileUtils.h"
@@ -9,6 +10,8 @@
 #include <shaderc/shaderc.hpp>
 #include <spirv_cross/spirv_cross.hpp>
 #include <spirv_cross/spirv_glsl.hpp>
+#include <map>
+#include <thread>
 
 namespace Chozo {
 
@@ -25,6 +28,23 @@ namespace Chozo {
         }
     }
 
+    // Driver vendor/renderer/version, program binaries are only valid for the driver that produced them.
+    static std::string s_DriverKey;
+    static bool s_ProgramBinarySupported = false;
+
+    void OpenGLShaderCompiler::InitProgramBinaryCache()
+    {
+        s_DriverKey = fmt::format("{};{};{}",
+            (const char*)glGetString(GL_VENDOR), (const char*)glGetString(GL_RENDERER), (const char*)glGetString(GL_VERSION));
+
+        GLint formatCount = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+        s_ProgramBinarySupported = formatCount > 0;
+
+        if (!s_ProgramBinarySupported)
+            CZ_CORE_WARN("Driver exposes no program binary formats, program binary cache disabled.");
+    }
+
     OpenGLShaderCompiler::OpenGLShaderCompiler(std::string &name)
     {
         m_Name = name;
@@ -34,42 +54,157 @@ namespace Chozo {
     {
         const Timer timer;
 
+        CompileSources(filePaths);
+        const RendererID program = Link();
+
+        CZ_CORE_TRACE("Shader compiler took {0} ms", timer.ElapsedMillis());
+
+        return program;
+    }
+
+    void OpenGLShaderCompiler::CompileSources(const std::vector<std::string>& filePaths)
+    {
         for (const auto& pathString : filePaths)
         {
             fs::path path(pathString);
             auto stage = ShaderUtils::GetShaderStageFromExtension(path.extension().string());
-            const std::string source = Utils::File::ReadTextFile(pathString);
+            const std::string source = ShaderIncludeCache::Read(pathString);
 
             m_Sources[stage] = source;
             m_Paths[stage] = path;
         }
 
         CompileToOrGetVulkanBinaries(m_Sources, m_Paths);
-        DecompileVulkanBinaries();
+
+        // A cached program binary makes the GLSL cross-compilation unnecessary.
+        if (!LoadProgramBinary())
+            DecompileVulkanBinaries();
+    }
+
+    RendererID OpenGLShaderCompiler::Link()
+    {
+        if (!m_ProgramBinary.empty())
+        {
+            if (const RendererID program = CreateProgramFromBinary())
+                return program;
+
+            // Drivers may reject binaries after an update without changing their version string.
+            CZ_CORE_WARN("Cached program binary for shader '{}' was rejected, recompiling.", m_Name);
+            Utils::File::DeleteFile(m_ProgramCachePath);
+            m_ProgramBinary.clear();
+            DecompileVulkanBinaries();
+        }
+
         const RendererID program = CompileToProgram();
+        SaveProgramBinary(program);
+        return program;
+    }
 
-        CZ_CORE_TRACE("Shader compiler took {0} ms", timer.ElapsedMillis());
+    uint64_t OpenGLShaderCompiler::GetProgramHash() const
+    {
+        // Ordered by stage so the hash doesn't depend on unordered_map iteration.
+        const std::map<ShaderStage, uint64_t> sourceHashes(m_SourceHashes.begin(), m_SourceHashes.end());
+
+        uint64_t hash = Utils::Hash::FNV1a(s_DriverKey);
+        for (auto&& [stage, sourceHash] : sourceHashes)
+        {
+            hash = Utils::Hash::FNV1a(&stage, sizeof(stage), hash);
+            hash = Utils::Hash::FNV1a(&sourceHash, sizeof(sourceHash), hash);
+        }
+        return hash;
+    }
+
+    bool OpenGLShaderCompiler::LoadProgramBinary()
+    {
+        m_ProgramBinary.clear();
+        if (!s_ProgramBinarySupported)
+            return false;
+
+        m_ProgramCachePath = ShaderUtils::GetProgramCachePath(m_Name, ".cache_opengl", GetProgramHash());
+
+        FileStreamReader stream(m_ProgramCachePath);
+        if (!stream.IsStreamGood())
+            return false;
+
+        const uint64_t fileSize = stream.GetFileSize();
+        if (fileSize <= sizeof(uint32_t))
+            return false;
+
+        uint32_t format;
+        stream.ReadRaw<uint32_t>(format);
+        m_ProgramBinaryFormat = format;
+
+        m_ProgramBinary.resize(fileSize - sizeof(uint32_t));
+        if (!stream.ReadData(m_ProgramBinary.data(), m_ProgramBinary.size()))
+        {
+            m_ProgramBinary.clear();
+            return false;
+        }
+
+        return true;
+    }
+
+    RendererID OpenGLShaderCompiler::CreateProgramFromBinary()
+    {
+        GLuint program = glCreateProgram();
+        glProgramBinary(program, m_ProgramBinaryFormat, m_ProgramBinary.data(), (GLsizei)m_ProgramBinary.size());
+
+        GLint isLinked = 0;
+        glGetProgramiv(program, GL_LINK_STATUS, &isLinked);
+        if (isLinked == GL_FALSE)
+        {
+            glDeleteProgram(program);
+            return 0;
+        }
 
         return program;
     }
 
+    void OpenGLShaderCompiler::SaveProgramBinary(const RendererID program) const
+    {
+        if (!s_ProgramBinarySupported || m_ProgramCachePath.empty())
+            return;
+
+        GLint length = 0;
+        glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+        if (length <= 0)
+            return;
+
+        std::vector<char> binary(length);
+        GLenum format = 0;
+        glGetProgramBinary(program, length, nullptr, &format, binary.data());
+
+        // Compilers of the same program on other threads read and write this path too, write to a per-thread
+        // file and rename it like the SPIR-V cache so a reader never links from a partial binary.
+        fs::path tempPath = m_ProgramCachePath;
+        tempPath += fmt::format(".{}.tmp", std::hash<std::thread::id>()(std::this_thread::get_id()));
+        bool written = false;
+        {
+            FileStreamWriter writer(tempPath);
+            if (writer.IsStreamGood())
+            {
+                writer.WriteRaw<uint32_t>(format);
+                writer.WriteData(binary.data(), binary.size());
+                written = writer.IsStreamGood();
+            }
+        }
+
+        std::error_code error;
+        if (written)
+            fs::rename(tempPath, m_ProgramCachePath, error);
+        if (!written || error)
+            fs::remove(tempPath, error);
+    }
+
     void OpenGLShaderCompiler::Release()
     {
         m_OpenGLSPIRV.clear();
         m_OpenGLSourceCode.clear();
+        m_ProgramBinary.clear();
     }
 
     void OpenGLShaderCompiler::DecompileVulkanBinaries()
     {
-        // Set compile options
-        shaderc::Compiler compiler;
-        shaderc::CompileOptions options;
-        options.SetTargetEnvironment(shaderc_target_env_opengl, shaderc_env_version_opengl_4_5);
-
-        const bool optimize = false;
-        if (optimize)
-            options.SetOptimizationLevel(shaderc_optimization_level_performance);
-        
         for (auto&& [stage, spirv] : m_VulkanSpirV)
         {
             spirv_cross::CompilerGLSL glslCompiler(spirv);
@@ -125,6 +260,9 @@ namespace Chozo {
             glShaderIDs[glShaderIDIndex++] = shader;
         }
 
+        if (s_ProgramBinarySupported)
+            glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+
         // Link our program
         glLinkProgram(program);
 
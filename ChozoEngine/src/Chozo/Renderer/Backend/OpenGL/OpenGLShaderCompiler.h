@@ -11,12 +11,30 @@ namespace Chozo {
         OpenGLShaderCompiler(std::string& name);
 
         virtual RendererID Compile(const std::vector<std::string> filePaths) override;
+        virtual void CompileSources(const std::vector<std::string>& filePaths) override;
+        virtual RendererID Link() override;
         virtual void Release() override;
+
+        const fs::path& GetProgramCachePath() const { return m_ProgramCachePath; }
+        // True after CompileSources found a program binary for this driver and sources, Link then skips the GLSL.
+        bool HasProgramBinary() const { return !m_ProgramBinary.empty(); }
+
+        // Records the driver identity program binaries are keyed by, must run on the GL thread before any shader compiles.
+        static void InitProgramBinaryCache();
     private:
         void DecompileVulkanBinaries();
         RendererID CompileToProgram();
+
+        uint64_t GetProgramHash() const;
+        bool LoadProgramBinary();
+        RendererID CreateProgramFromBinary();
+        void SaveProgramBinary(RendererID program) const;
     private:
         ShaderBinaries m_OpenGLSPIRV;
         ShaderSources m_OpenGLSourceCode;
+
+        fs::path m_ProgramCachePath;
+        GLenum m_ProgramBinaryFormat = 0;
+        std::vector<char> m_ProgramBinary;
     };
 } // namespace Chozo
@@ -0,0 +1,293 @@
+#include "OpenGLStateCache.h"
+
+#include "OpenGLUtils.h"
+
+namespace Chozo {
+
+    namespace Utils {
+
+        // Value no binding can have, so the first call after an invalidation always goes through.
+        static constexpr uint32_t UnknownState = ~0u;
+
+        static constexpr uint32_t CachedTextureUnits = 32;
+        static constexpr GLenum CachedTextureTargets[] = { GL_TEXTURE_2D, GL_TEXTURE_2D_MULTISAMPLE, GL_TEXTURE_CUBE_MAP, GL_TEXTURE_BUFFER };
+        static constexpr GLenum CachedCapabilities[] = { GL_BLEND, GL_DEPTH_TEST, GL_STENCIL_TEST, GL_CULL_FACE, GL_TEXTURE_CUBE_MAP_SEAMLESS };
+
+        static constexpr uint32_t TextureTargetCount = sizeof(CachedTextureTargets) / sizeof(GLenum);
+        static constexpr uint32_t CapabilityCount = sizeof(CachedCapabilities) / sizeof(GLenum);
+
+        static int GetTextureTargetIndex(const GLenum target)
+        {
+            for (uint32_t i = 0; i < TextureTargetCount; i++)
+                if (CachedTextureTargets[i] == target)
+                    return (int)i;
+            return -1;
+        }
+
+        static int GetCapabilityIndex(const GLenum capability)
+        {
+            for (uint32_t i = 0; i < CapabilityCount; i++)
+                if (CachedCapabilities[i] == capability)
+                    return (int)i;
+            return -1;
+        }
+
+        struct GLState
+        {
+            uint32_t Program;
+            uint32_t VertexArray;
+            uint32_t Framebuffer;
+            uint32_t ActiveTextureUnit;
+            uint32_t Textures[CachedTextureUnits][TextureTargetCount];
+            uint32_t Capabilities[CapabilityCount];
+            uint32_t BlendSource, BlendDestination;
+            uint32_t DepthFunc;
+            uint32_t DepthMask, ColorMask;
+            int Viewport[4];
+
+            uint32_t FilteredCalls = 0, IssuedCalls = 0;
+            bool Enabled = true;
+
+            GLState() { Reset(); }
+
+            void Reset()
+            {
+                Program = VertexArray = Framebuffer = ActiveTextureUnit = UnknownState;
+                for (auto& unit : Textures)
+                    std::fill(std::begin(unit), std::end(unit), UnknownState);
+                std::fill(std::begin(Capabilities), std::end(Capabilities), UnknownState);
+                BlendSource = BlendDestination = DepthFunc = UnknownState;
+                DepthMask = ColorMask = UnknownState;
+                Viewport[0] = Viewport[1] = Viewport[2] = Viewport[3] = -1;
+            }
+        };
+
+        static thread_local GLState s_GLState;
+
+        // Counts the call as dropped when it wouldn't change the shadow and the cache is enabled, as issued otherwise.
+        static bool IsFiltered(const bool redundant)
+        {
+            if (redundant && s_GLState.Enabled)
+            {
+                s_GLState.FilteredCalls++;
+                return true;
+            }
+
+            s_GLState.IssuedCalls++;
+            return false;
+        }
+
+        static void ActiveTexture(const uint32_t slot)
+        {
+            if (IsFiltered(s_GLState.ActiveTextureUnit == slot))
+                return;
+
+            s_GLState.ActiveTextureUnit = slot;
+            glActiveTexture(GL_TEXTURE0 + slot); GCE;
+        }
+    }
+
+    void OpenGLStateCache::UseProgram(const uint32_t program)
+    {
+        auto& state = Utils::s_GLState;
+        if (Utils::IsFiltered(state.Program == program))
+            return;
+
+        state.Program = program;
+        glUseProgram(program); GCE;
+    }
+
+    void OpenGLStateCache::BindVertexArray(const uint32_t vertexArray)
+    {
+        auto& state = Utils::s_GLState;
+        if (Utils::IsFiltered(state.VertexArray == vertexArray))
+            return;
+
+        state.VertexArray = vertexArray;
+        glBindVertexArray(vertexArray); GCE;
+    }
+
+    void OpenGLStateCache::BindFramebuffer(const uint32_t framebuffer)
+    {
+        auto& state = Utils::s_GLState;
+        if (Utils::IsFiltered(state.Framebuffer == framebuffer))
+            return;
+
+        state.Framebuffer = framebuffer;
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffer); GCE;
+    }
+
+    void OpenGLStateCache::BindTexture(const GLenum target, const uint32_t texture)
+    {
+        auto& state = Utils::s_GLState;
+        const int targetIndex = Utils::GetTextureTargetIndex(target);
+        if (targetIndex < 0 || state.ActiveTextureUnit >= Utils::CachedTextureUnits)
+        {
+            state.IssuedCalls++;
+            glBindTexture(target, texture); GCE;
+            return;
+        }
+
+        uint32_t& binding = state.Textures[state.ActiveTextureUnit][targetIndex];
+        if (Utils::IsFiltered(binding == texture))
+            return;
+
+        binding = texture;
+        glBindTexture(target, texture); GCE;
+    }
+
+    void OpenGLStateCache::BindTextureUnit(const uint32_t slot, const GLenum target, const uint32_t texture)
+    {
+        auto& state = Utils::s_GLState;
+        const int targetIndex = Utils::GetTextureTargetIndex(target);
+        // Checked before touching the active unit, a filtered bind leaves it alone as well. The calls below count themselves.
+        if (state.Enabled && targetIndex >= 0 && slot < Utils::CachedTextureUnits && state.Textures[slot][targetIndex] == texture)
+        {
+            state.FilteredCalls++;
+            return;
+        }
+
+        Utils::ActiveTexture(slot);
+        BindTexture(target, texture);
+    }
+
+    void OpenGLStateCache::SetCapability(const GLenum capability, const bool enabled)
+    {
+        auto& state = Utils::s_GLState;
+        const int index = Utils::GetCapabilityIndex(capability);
+        if (index >= 0)
+        {
+            if (Utils::IsFiltered(state.Capabilities[index] == (uint32_t)enabled))
+                return;
+            state.Capabilities[index] = (uint32_t)enabled;
+        }
+        else
+        {
+            state.IssuedCalls++;
+        }
+
+        if (enabled)
+        {
+            glEnable(capability); GCE;
+        }
+        else
+        {
+            glDisable(capability); GCE;
+        }
+    }
+
+    void OpenGLStateCache::BlendFunc(const GLenum source, const GLenum destination)
+    {
+        auto& state = Utils::s_GLState;
+        if (Utils::IsFiltered(state.BlendSource == source && state.BlendDestination == destination))
+            return;
+
+        state.BlendSource = source;
+        state.BlendDestination = destination;
+        glBlendFunc(source, destination); GCE;
+    }
+
+    void OpenGLStateCache::DepthFunc(const GLenum func)
+    {
+        auto& state = Utils::s_GLState;
+        if (Utils::IsFiltered(state.DepthFunc == func))
+            return;
+
+        state.DepthFunc = func;
+        glDepthFunc(func); GCE;
+    }
+
+    void OpenGLStateCache::DepthMask(const bool enabled)
+    {
+        auto& state = Utils::s_GLState;
+        if (Utils::IsFiltered(state.DepthMask == (uint32_t)enabled))
+            return;
+
+        state.DepthMask = (uint32_t)enabled;
+        glDepthMask(enabled ? GL_TRUE : GL_FALSE); GCE;
+    }
+
+    void OpenGLStateCache::ColorMask(const bool enabled)
+    {
+        auto& state = Utils::s_GLState;
+        if (Utils::IsFiltered(state.ColorMask == (uint32_t)enabled))
+            return;
+
+        state.ColorMask = (uint32_t)enabled;
+        const GLboolean mask = enabled ? GL_TRUE : GL_FALSE;
+        glColorMask(mask, mask, mask, mask); GCE;
+    }
+
+    void OpenGLStateCache::Viewport(const int x, const int y, const int width, const int height)
+    {
+        auto& state = Utils::s_GLState;
+        if (Utils::IsFiltered(state.Viewport[0] == x && state.Viewport[1] == y && state.Viewport[2] == width && state.Viewport[3] == height))
+            return;
+
+        state.Viewport[0] = x;
+        state.Viewport[1] = y;
+        state.Viewport[2] = width;
+        state.Viewport[3] = height;
+        glViewport(x, y, width, height); GCE;
+    }
+
+    void OpenGLStateCache::OnProgramDeleted(const uint32_t program)
+    {
+        auto& state = Utils::s_GLState;
+        if (state.Program == program)
+            state.Program = Utils::UnknownState;
+    }
+
+    void OpenGLStateCache::OnVertexArrayDeleted(const uint32_t vertexArray)
+    {
+        auto& state = Utils::s_GLState;
+        if (state.VertexArray == vertexArray)
+            state.VertexArray = Utils::UnknownState;
+    }
+
+    void OpenGLStateCache::OnFramebufferDeleted(const uint32_t framebuffer)
+    {
+        auto& state = Utils::s_GLState;
+        if (state.Framebuffer == framebuffer)
+            state.Framebuffer = Utils::UnknownState;
+    }
+
+    void OpenGLStateCache::OnTextureDeleted(const uint32_t texture)
+    {
+        for (auto& unit : Utils::s_GLState.Textures)
+            for (auto& binding : unit)
+                if (binding == texture)
+                    binding = Utils::UnknownState;
+    }
+
+    void OpenGLStateCache::Invalidate()
+    {
+        Utils::s_GLState.Reset();
+    }
+
+    void OpenGLStateCache::SetEnabled(const bool enabled)
+    {
+        Utils::s_GLState.Enabled = enabled;
+    }
+
+    bool OpenGLStateCache::IsEnabled()
+    {
+        return Utils::s_GLState.Enabled;
+    }
+
+    uint32_t OpenGLStateCache::GetFilteredCallCount()
+    {
+        return Utils::s_GLState.FilteredCalls;
+    }
+
+    uint32_t OpenGLStateCache::GetIssuedCallCount()
+    {
+        return Utils::s_GLState.IssuedCalls;
+    }
+
+    void OpenGLStateCache::ResetCallCounts()
+    {
+        Utils::s_GLState.FilteredCalls = 0;
+        Utils::s_GLState.IssuedCalls = 0;
+    }
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "czpch.h"
+
+#include <glad/glad.h>
+
+namespace Chozo {
+
+    // Shadow of the GL state the backend changes, calls that would leave it as it is are dropped.
+    // The shadow is per thread since every thread drives its own context. Code issuing the raw calls
+    // (like the ImGui backend) has to restore what it changed, or call Invalidate afterwards.
+    class OpenGLStateCache
+    {
+    public:
+        static void UseProgram(uint32_t program);
+        static void BindVertexArray(uint32_t vertexArray);
+        static void BindFramebuffer(uint32_t framebuffer);
+
+        // Binds on the active unit, for creating and uploading textures.
+        static void BindTexture(GLenum target, uint32_t texture);
+        static void BindTextureUnit(uint32_t slot, GLenum target, uint32_t texture);
+
+        static void SetCapability(GLenum capability, bool enabled);
+        static void BlendFunc(GLenum source, GLenum destination);
+        static void DepthFunc(GLenum func);
+        static void DepthMask(bool enabled);
+        // All channels of all draw buffers.
+        static void ColorMask(bool enabled);
+        static void Viewport(int x, int y, int width, int height);
+
+        // GL resets the bindings of deleted objects to zero, and names get reused afterwards.
+        static void OnProgramDeleted(uint32_t program);
+        static void OnVertexArrayDeleted(uint32_t vertexArray);
+        static void OnFramebufferDeleted(uint32_t framebuffer);
+        static void OnTextureDeleted(uint32_t texture);
+
+        // Forgets everything, the next call of each kind always reaches GL.
+        static void Invalidate();
+
+        // Disabled, every call reaches GL while the shadow keeps tracking, for measuring what the cache saves.
+        static void SetEnabled(bool enabled);
+        static bool IsEnabled();
+
+        // Calls dropped and calls that reached GL on this thread since the last reset.
+        static uint32_t GetFilteredCallCount();
+        static uint32_t GetIssuedCallCount();
+        static void ResetCallCounts();
+    };
+}
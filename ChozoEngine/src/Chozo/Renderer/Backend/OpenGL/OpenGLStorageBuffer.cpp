@@ -0,0 +1,62 @@
+#include "OpenGLStorageBuffer.h"
+
+#include "OpenGLUtils.h"
+#include "OpenGLStateCache.h"
+#include "Chozo/Renderer/Renderer.h"
+#include <glad/glad.h>
+
+namespace Chozo {
+
+    OpenGLStorageBuffer::OpenGLStorageBuffer(uint32_t size)
+        : m_Size(size)
+    {
+        Renderer::SubmitAndWait([&]() {
+            glGenBuffers(1, &m_RendererID); GCE;
+            glBindBuffer(GL_TEXTURE_BUFFER, m_RendererID); GCE;
+            glBufferData(GL_TEXTURE_BUFFER, size, nullptr, GL_DYNAMIC_DRAW); GCE;
+            glBindBuffer(GL_TEXTURE_BUFFER, 0); GCE;
+
+            glGenTextures(1, &m_TextureID); GCE;
+            OpenGLStateCache::BindTexture(GL_TEXTURE_BUFFER, m_TextureID);
+            glTexBuffer(GL_TEXTURE_BUFFER, GL_R32UI, m_RendererID); GCE;
+            OpenGLStateCache::BindTexture(GL_TEXTURE_BUFFER, 0);
+        });
+    }
+
+    OpenGLStorageBuffer::~OpenGLStorageBuffer()
+    {
+        Renderer::SubmitResourceFree([rendererID = m_RendererID, textureID = m_TextureID]() {
+            OpenGLStateCache::OnTextureDeleted(textureID);
+            glDeleteTextures(1, &textureID); GCE;
+            glDeleteBuffers(1, &rendererID); GCE;
+        });
+    }
+
+    void OpenGLStorageBuffer::SetData(const void* data, uint32_t size, uint32_t offset)
+    {
+        CZ_CORE_ASSERT(offset + size <= m_Size, "StorageBuffer write out of range!");
+
+        Renderer::SubmitAndWait([&]() {
+            glBindBuffer(GL_TEXTURE_BUFFER, m_RendererID); GCE;
+            glBufferSubData(GL_TEXTURE_BUFFER, offset, size, data); GCE;
+            glBindBuffer(GL_TEXTURE_BUFFER, 0); GCE;
+        });
+    }
+
+    void OpenGLStorageBuffer::Resize(uint32_t size)
+    {
+        Renderer::SubmitAndWait([&]() {
+            m_Size = size;
+
+            // The texture keeps referencing the buffer object, only its data store is replaced.
+            glBindBuffer(GL_TEXTURE_BUFFER, m_RendererID); GCE;
+            glBufferData(GL_TEXTURE_BUFFER, size, nullptr, GL_DYNAMIC_DRAW); GCE;
+            glBindBuffer(GL_TEXTURE_BUFFER, 0); GCE;
+        });
+    }
+
+    void OpenGLStorageBuffer::Bind(uint32_t slot) const
+    {
+        OpenGLStateCache::BindTextureUnit(slot, GL_TEXTURE_BUFFER, m_TextureID);
+    }
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "Chozo/Renderer/StorageBuffer.h"
+
+namespace Chozo {
+
+    // OpenGL 4.1 has no shader storage buffers, the words live in a buffer texture with an R32UI view.
+    class OpenGLStorageBuffer : public StorageBuffer
+    {
+    public:
+        OpenGLStorageBuffer(uint32_t size);
+        virtual ~OpenGLStorageBuffer() override;
+
+        virtual void SetData(const void* data, uint32_t size, uint32_t offset = 0) override;
+        virtual void Resize(uint32_t size) override;
+
+        virtual uint32_t GetSize() const override { return m_Size; }
+
+        void Bind(uint32_t slot) const;
+    private:
+        uint32_t m_RendererID;
+        uint32_t m_TextureID;
+        uint32_t m_Size;
+    };
+}
@@ -1,6 +1,10 @@
 #include "OpenGLTexture.h"
 
 #include "OpenGLUtils.h"
+#include "OpenGLStateCache.h"
+#include "OpenGLTextureUploader.h"
+#include "Chozo/Renderer/Renderer.h"
+#include "Chozo/Renderer/TextureStreamer.h"
 #include "Chozo/FileSystem/TextureImporter.h"
 
 #include "stb_image.h"
@@ -8,6 +12,38 @@
 namespace Chozo
 {
 
+    namespace Utils {
+
+        static void UploadLevel(const ImageFormat format, const uint32_t level, const uint32_t width, const uint32_t height, const void* data)
+        {
+            if (Image::IsCompressedFormat(format))
+            {
+                glCompressedTexImage2D(GL_TEXTURE_2D, level, GetGLFormat(format), width, height, 0, (GLsizei)Image::GetImageSize(format, width, height), data); GCE;
+            }
+            else
+            {
+                glTexImage2D(GL_TEXTURE_2D, level, GetGLFormat(format), width, height, 0, GetGLDataFormat(format), GetGLDataType(format), data); GCE;
+            }
+        }
+
+        // Levels firstLevel and up of the bound 2D texture from a buffer laid out like Image::GetMipChainSize
+        // from firstLevel on, compressed formats take the blocks as they are. The larger levels stay undefined,
+        // sampling starts at the base level.
+        static void UploadTexture2D(const ImageFormat format, const uint32_t width, const uint32_t height, const uint32_t firstLevel, const uint32_t levels, const void* data)
+        {
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, (GLint)firstLevel); GCE;
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, (GLint)levels - 1); GCE;
+
+            const uint64_t firstOffset = Image::GetMipChainSize(format, width, height, firstLevel);
+            for (uint32_t level = firstLevel; level < levels; level++)
+            {
+                const uint32_t levelWidth = std::max(width >> level, 1u), levelHeight = std::max(height >> level, 1u);
+                const void* levelData = data ? static_cast<const uint8_t*>(data) + Image::GetMipChainSize(format, width, height, level) - firstOffset : nullptr;
+                UploadLevel(format, level, levelWidth, levelHeight, levelData);
+            }
+        }
+    }
+
     //==============================================================================
 	// OpenGLTexture2D
     OpenGLTexture2D::OpenGLTexture2D(const Texture2DSpecification &spec)
@@ -26,7 +62,7 @@ namespace Chozo
     OpenGLTexture2D::OpenGLTexture2D(const std::string &path, const Texture2DSpecification &spec)
         : m_Spec(spec), m_Path(path)
     {
-        m_Buffer = TextureImporter::ToBufferFromFile(path, m_Spec.Format, m_Width, m_Height, spec.FlipY);
+        m_Buffer = TextureImporter::ToBufferFromFile(path, m_Spec.Format, m_Width, m_Height, spec.FlipY, spec.Usage, &m_Spec.MipLevels, spec.WrapS, spec.WrapT);
         Invalidate();
     }
 
@@ -50,11 +86,21 @@ namespace Chozo
 
     OpenGLTexture2D::~OpenGLTexture2D()
     {
-        glDeleteTextures(1, &m_RendererID); GCE;
+        TextureStreamer::Unregister(this);
+        Renderer::SubmitResourceFree([rendererID = m_RendererID]() {
+            OpenGLTextureUploader::Cancel(rendererID);
+            OpenGLStateCache::OnTextureDeleted(rendererID);
+            glDeleteTextures(1, &rendererID); GCE;
+        });
         if (m_Buffer.Size != 0)
             m_Buffer.Release();
     }
 
+    RendererID OpenGLTexture2D::GetRendererID() const
+    {
+        return *m_PendingUploads != 0 ? OpenGLTextureUploader::GetPlaceholderID() : m_RendererID;
+    }
+
     void OpenGLTexture2D::Resize(uint32_t width, uint32_t height)
     {
         if (m_Width != width || m_Height != height)
@@ -62,43 +108,151 @@ namespace Chozo
             // int channel = GetChannelCount(m_Spec.Format);
 
             // m_DataBuffer = new unsigned char[m_Spec.Width * m_Spec.Height * channel * sizeof(float)];
-            m_Spec.Width = width;
-            m_Spec.Height = height;
-            m_Width = width;
-            m_Height = height;
-            glBindTexture(GL_TEXTURE_2D, m_RendererID); GCE;
-            glTexImage2D(GL_TEXTURE_2D, 0, m_InternalFormat, width, height, 0, m_DataFormat, m_DataType, m_Buffer.Data); GCE;
+            Renderer::SubmitAndWait([&]() {
+                m_Spec.Width = width;
+                m_Spec.Height = height;
+                m_Width = width;
+                m_Height = height;
+                OpenGLTextureUploader::Cancel(m_RendererID);
+                OpenGLStateCache::BindTexture(GL_TEXTURE_2D, m_RendererID);
+                Upload();
+            });
         }
     }
 
     void OpenGLTexture2D::Bind(uint32_t slot) const
     {
-        glActiveTexture(GL_TEXTURE0 + slot); GCE;
-        glBindTexture(GL_TEXTURE_2D, m_RendererID); GCE;
+        OpenGLStateCache::BindTextureUnit(slot, GL_TEXTURE_2D, GetRendererID());
     }
 
     void OpenGLTexture2D::Unbind() const
     {
-        glBindTexture(GL_TEXTURE_2D, 0); GCE;
+        OpenGLStateCache::BindTexture(GL_TEXTURE_2D, 0);
     }
 
     void OpenGLTexture2D::SetData(const void *data, const uint32_t size)
     {
         m_Buffer.Allocate(size);
         m_Buffer.Write(data, size);
-        glBindTexture(GL_TEXTURE_2D, m_RendererID); GCE;
-        glTexImage2D(GL_TEXTURE_2D, 0, GetGLFormat(m_Spec.Format), m_Width, m_Height, 0, GetGLDataFormat(m_Spec.Format), GetGLDataType(m_Spec.Format), m_Buffer.Data); GCE;
+        // The data is a single level.
+        m_Spec.MipLevels = 1;
+        m_Spec.ResidentMip = 0;
+        Renderer::SubmitAndWait([&]() {
+            OpenGLTextureUploader::Cancel(m_RendererID);
+            OpenGLStateCache::BindTexture(GL_TEXTURE_2D, m_RendererID);
+            Upload();
+        });
+    }
+
+    void OpenGLTexture2D::StreamIn(const uint32_t mip, const Buffer& levels)
+    {
+        const uint32_t resident = m_Spec.ResidentMip;
+        const uint64_t offset = Image::GetMipChainSize(m_Spec.Format, m_Width, m_Height, mip);
+        const uint64_t size = Image::GetMipChainSize(m_Spec.Format, m_Width, m_Height, resident) - offset;
+        CZ_CORE_ASSERT(mip < resident && levels.Size == size, "Streamed levels don't continue the resident chain!");
+
+        Buffer buffer;
+        buffer.Allocate(size + m_Buffer.Size);
+        memcpy(buffer.Data, levels.Data, size);
+        if (m_Buffer.Size != 0)
+        {
+            memcpy(static_cast<uint8_t*>(buffer.Data) + size, m_Buffer.Data, m_Buffer.Size);
+            m_Buffer.Release();
+        }
+        m_Buffer = buffer;
+        m_Spec.ResidentMip = mip;
+
+        // The levels are filled before sampling moves to them, once their upload completes when it goes through the uploader.
+        Renderer::Submit([rendererID = m_RendererID, format = m_Spec.Format, width = m_Width, height = m_Height, mip, resident, offset,
+            pixels = SharedBuffer(levels.Data, size)]() {
+            const bool async = Renderer::GetConfig().EnableAsyncTextureUploads && pixels.Size >= OpenGLTextureUploader::MinAsyncUploadSize;
+
+            OpenGLStateCache::BindTexture(GL_TEXTURE_2D, rendererID);
+            for (uint32_t level = mip; level < resident; level++)
+            {
+                const uint32_t levelWidth = std::max(width >> level, 1u), levelHeight = std::max(height >> level, 1u);
+                Utils::UploadLevel(format, level, levelWidth, levelHeight, async ? nullptr : pixels.As<uint8_t>() + Image::GetMipChainSize(format, width, height, level) - offset);
+            }
+            if (!async)
+            {
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, (GLint)mip); GCE;
+                return;
+            }
+
+            TextureUpload upload;
+            upload.Texture = rendererID;
+            upload.Format = format;
+            upload.Width = width;
+            upload.Height = height;
+            upload.FirstLevel = mip;
+            upload.LastLevel = resident;
+            upload.Pixels = pixels;
+            // An evict that dropped these levels already moved the base level past them.
+            upload.OnComplete = [](const TextureUpload& streamed, const bool cancelled) {
+                if (cancelled)
+                    return;
+
+                OpenGLStateCache::BindTexture(GL_TEXTURE_2D, streamed.Texture);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, (GLint)streamed.FirstLevel); GCE;
+            };
+            OpenGLTextureUploader::Enqueue(std::move(upload));
+        });
+    }
+
+    void OpenGLTexture2D::Evict(const uint32_t mip)
+    {
+        const uint32_t resident = m_Spec.ResidentMip;
+        CZ_CORE_ASSERT(mip > resident && mip < m_Spec.MipLevels, "Evicting past the resident chain!");
+
+        const uint64_t size = Image::GetMipChainSize(m_Spec.Format, m_Width, m_Height, mip) - Image::GetMipChainSize(m_Spec.Format, m_Width, m_Height, resident);
+        Buffer buffer;
+        buffer.Allocate(m_Buffer.Size - size);
+        memcpy(buffer.Data, static_cast<uint8_t*>(m_Buffer.Data) + size, buffer.Size);
+        m_Buffer.Release();
+        m_Buffer = buffer;
+        m_Spec.ResidentMip = mip;
+
+        // Sampling moves off the levels before they are redefined empty, which frees their memory. When a stream in
+        // still fills the levels from mip on, sampling stays above them and its completion moves it down to mip.
+        Renderer::Submit([rendererID = m_RendererID, format = m_Spec.Format, mip, resident]() {
+            const bool uploading = OpenGLTextureUploader::Cancel(rendererID, mip);
+            OpenGLStateCache::BindTexture(GL_TEXTURE_2D, rendererID);
+            GLint baseLevel = 0;
+            if (uploading)
+            {
+                glGetTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, &baseLevel); GCE;
+            }
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, std::max(baseLevel, (GLint)mip)); GCE;
+            for (uint32_t level = resident; level < mip; level++)
+                Utils::UploadLevel(format, level, 0, 0, nullptr);
+        });
     }
 
     void OpenGLTexture2D::ExtractBuffer()
     {
-        uint64_t size = m_Width * m_Height * Image::GetBytesPerPixel(m_Spec.Format);
+        const uint64_t offset = Image::GetMipChainSize(m_Spec.Format, m_Width, m_Height, m_Spec.ResidentMip);
+        uint64_t size = Image::GetMipChainSize(m_Spec.Format, m_Width, m_Height, m_Spec.MipLevels) - offset;
         m_Buffer.Allocate(size);
 
-        glBindTexture(GL_TEXTURE_2D, m_RendererID);
-        glPixelStorei(GL_PACK_ALIGNMENT, 1);
-        glGetTexImage(GL_TEXTURE_2D, 0, m_DataFormat, m_DataType, m_Buffer.Data);
-        glBindTexture(GL_TEXTURE_2D, 0);
+        Renderer::SubmitAndWait([&]() {
+            // Pending uploads land before the readback.
+            OpenGLTextureUploader::Flush();
+            OpenGLStateCache::BindTexture(GL_TEXTURE_2D, m_RendererID);
+            glPixelStorei(GL_PACK_ALIGNMENT, 1);
+            for (uint32_t level = m_Spec.ResidentMip; level < m_Spec.MipLevels; level++)
+            {
+                auto* bytes = static_cast<uint8_t*>(m_Buffer.Data) + Image::GetMipChainSize(m_Spec.Format, m_Width, m_Height, level) - offset;
+                if (Image::IsCompressedFormat(m_Spec.Format))
+                {
+                    glGetCompressedTexImage(GL_TEXTURE_2D, level, bytes); GCE;
+                }
+                else
+                {
+                    glGetTexImage(GL_TEXTURE_2D, level, m_DataFormat, m_DataType, bytes);
+                }
+            }
+            OpenGLStateCache::BindTexture(GL_TEXTURE_2D, 0);
+        });
     }
 
     void OpenGLTexture2D::CopyToHostBuffer(Buffer& buffer) const
@@ -124,16 +278,48 @@ namespace Chozo
 
         CZ_CORE_ASSERT(m_InternalFormat & m_DataFormat, "Format not supported!");
 
-        glGenTextures(1, &m_RendererID); GCE;
-        glBindTexture(GL_TEXTURE_2D, m_RendererID); GCE;
+        Renderer::SubmitAndWait([&]() {
+            glGenTextures(1, &m_RendererID); GCE;
+            OpenGLStateCache::BindTexture(GL_TEXTURE_2D, m_RendererID);
 
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GetGLParameter(m_Spec.MinFilter)); GCE;
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GetGLParameter(m_Spec.MagFilter)); GCE;
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GetGLParameter(m_Spec.WrapS)); GCE;
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GetGLParameter(m_Spec.WrapT)); GCE;
+            // Linear filtering of a texture that comes with its mips samples between them.
+            GLenum minFilter = GetGLParameter(m_Spec.MinFilter);
+            if (m_Spec.MipLevels > 1 && minFilter == GL_LINEAR)
+                minFilter = GL_LINEAR_MIPMAP_LINEAR;
 
-        glTexImage2D(GL_TEXTURE_2D, 0, m_InternalFormat, m_Width, m_Height, 0, m_DataFormat, m_DataType, m_Buffer.Data); GCE;
-        glBindTexture(GL_TEXTURE_2D, 0); GCE;
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, minFilter); GCE;
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GetGLParameter(m_Spec.MagFilter)); GCE;
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GetGLParameter(m_Spec.WrapS)); GCE;
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GetGLParameter(m_Spec.WrapT)); GCE;
+
+            Upload();
+            OpenGLStateCache::BindTexture(GL_TEXTURE_2D, 0);
+        });
+    }
+
+    void OpenGLTexture2D::Upload()
+    {
+        const uint64_t size = Image::GetMipChainSize(m_Spec.Format, m_Width, m_Height, m_Spec.MipLevels)
+            - Image::GetMipChainSize(m_Spec.Format, m_Width, m_Height, m_Spec.ResidentMip);
+        const bool async = m_Buffer.Data && m_Buffer.Size == size
+            && Renderer::GetConfig().EnableAsyncTextureUploads && size >= OpenGLTextureUploader::MinAsyncUploadSize;
+
+        Utils::UploadTexture2D(m_Spec.Format, m_Width, m_Height, m_Spec.ResidentMip, m_Spec.MipLevels, async ? nullptr : m_Buffer.Data);
+        if (!async)
+            return;
+
+        // Bound as the placeholder until the pixels are in.
+        TextureUpload upload;
+        upload.Texture = m_RendererID;
+        upload.Format = m_Spec.Format;
+        upload.Width = m_Width;
+        upload.Height = m_Height;
+        upload.FirstLevel = m_Spec.ResidentMip;
+        upload.LastLevel = m_Spec.MipLevels;
+        upload.Pixels = SharedBuffer(m_Buffer.Data, size);
+        upload.OnComplete = [pending = m_PendingUploads](const TextureUpload&, bool) { (*pending)--; };
+        (*m_PendingUploads)++;
+        OpenGLTextureUploader::Enqueue(std::move(upload));
     }
 
     //==============================================================================
@@ -146,60 +332,142 @@ namespace Chozo
 
     OpenGLTextureCube::~OpenGLTextureCube()
     {
+        Renderer::SubmitResourceFree([rendererID = m_RendererID]() {
+            OpenGLStateCache::OnTextureDeleted(rendererID);
+            glDeleteTextures(1, &rendererID); GCE;
+        });
+        if (m_Buffer.Size != 0)
+            m_Buffer.Release();
     }
 
     void OpenGLTextureCube::Invalidate()
     {
-        glEnable(GL_TEXTURE_CUBE_MAP_SEAMLESS); GCE;
-
-        if (m_RendererID)
-        {
-            glDeleteTextures(1, &m_RendererID); GCE;
-        }
-
-        glGenTextures(1, &m_RendererID); GCE;
-        glBindTexture(GL_TEXTURE_CUBE_MAP, m_RendererID); GCE;
-        for (unsigned int i = 0; i < 6; ++i)
-        {
-            glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GetGLFormat(m_Spec.Format), m_Spec.Width, m_Spec.Height, 0, GetGLDataFormat(m_Spec.Format), GetGLDataType(m_Spec.Format), nullptr); GCE;
-        }
-        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GetGLParameter(m_Spec.WrapS)); GCE;
-        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GetGLParameter(m_Spec.WrapT)); GCE;
-        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GetGLParameter(m_Spec.WrapR)); GCE;
-        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GetGLParameter(m_Spec.MinFilter)); GCE;
-        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GetGLParameter(m_Spec.MagFilter)); GCE;
-
-        if (m_Spec.Mipmap)
-            glGenerateMipmap(GL_TEXTURE_CUBE_MAP); GCE;
+        Renderer::SubmitAndWait([&]() {
+            OpenGLStateCache::SetCapability(GL_TEXTURE_CUBE_MAP_SEAMLESS, true);
+
+            if (m_RendererID)
+            {
+                OpenGLStateCache::OnTextureDeleted(m_RendererID);
+                glDeleteTextures(1, &m_RendererID); GCE;
+            }
+
+            glGenTextures(1, &m_RendererID); GCE;
+            OpenGLStateCache::BindTexture(GL_TEXTURE_CUBE_MAP, m_RendererID);
+            for (unsigned int i = 0; i < 6; ++i)
+            {
+                glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GetGLFormat(m_Spec.Format), m_Spec.Width, m_Spec.Height, 0, GetGLDataFormat(m_Spec.Format), GetGLDataType(m_Spec.Format), nullptr); GCE;
+            }
+            glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GetGLParameter(m_Spec.WrapS)); GCE;
+            glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GetGLParameter(m_Spec.WrapT)); GCE;
+            glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GetGLParameter(m_Spec.WrapR)); GCE;
+            glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GetGLParameter(m_Spec.MinFilter)); GCE;
+            glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GetGLParameter(m_Spec.MagFilter)); GCE;
+
+            if (m_Spec.Mipmap)
+                glGenerateMipmap(GL_TEXTURE_CUBE_MAP); GCE;
+        });
     }
 
     void OpenGLTextureCube::Bind(uint32_t slot) const
     {
-        glActiveTexture(GL_TEXTURE0 + slot); GCE;
-        glBindTexture(GL_TEXTURE_CUBE_MAP, m_RendererID); GCE;
+        OpenGLStateCache::BindTextureUnit(slot, GL_TEXTURE_CUBE_MAP, m_RendererID);
     }
 
     void OpenGLTextureCube::Unbind() const
     {
-        glBindTexture(GL_TEXTURE_CUBE_MAP, 0); GCE;
+        OpenGLStateCache::BindTexture(GL_TEXTURE_CUBE_MAP, 0);
     }
 
     void OpenGLTextureCube::SetData(void* data, uint32_t size)
     {
         m_LocalBuffer = data;
 
-        glBindTexture(GL_TEXTURE_CUBE_MAP, m_RendererID); GCE;
-        for (unsigned int i = 0; i < 6; ++i)
-        {
-            glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GetGLFormat(m_Spec.Format), m_Spec.Width, m_Spec.Height, 0, GetGLDataFormat(m_Spec.Format), GL_FLOAT, static_cast<float*>(data) + (size / 6) * i); GCE;
-        }
+        const uint32_t faceSize = size / 6;
+        Renderer::SubmitAndWait([&]() {
+            OpenGLStateCache::BindTexture(GL_TEXTURE_CUBE_MAP, m_RendererID);
+            for (unsigned int i = 0; i < 6; ++i)
+            {
+                glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GetGLFormat(m_Spec.Format), m_Spec.Width, m_Spec.Height, 0, GetGLDataFormat(m_Spec.Format), GetGLDataType(m_Spec.Format), static_cast<uint8_t*>(data) + faceSize * i); GCE;
+            }
+        });
+    }
+
+    uint32_t OpenGLTextureCube::GetMipLevelCount() const
+    {
+        if (!m_Spec.Mipmap)
+            return 1;
+
+        return (uint32_t)std::floor(std::log2(std::max(m_Width, m_Height))) + 1;
+    }
+
+    uint64_t OpenGLTextureCube::GetFaceSize(const uint32_t mip) const
+    {
+        const uint64_t width = std::max(m_Width >> mip, 1u);
+        const uint64_t height = std::max(m_Height >> mip, 1u);
+        return width * height * Image::GetBytesPerPixel(m_Spec.Format);
+    }
+
+    uint64_t OpenGLTextureCube::GetMipChainSize() const
+    {
+        uint64_t size = 0;
+        for (uint32_t mip = 0; mip < GetMipLevelCount(); mip++)
+            size += GetFaceSize(mip) * 6;
+        return size;
+    }
+
+    void OpenGLTextureCube::SetMipChainData(const void* data, const uint64_t size)
+    {
+        CZ_CORE_ASSERT(size == GetMipChainSize(), "Cubemap data doesn't match the mip chain!");
+
+        Renderer::SubmitAndWait([&]() {
+            const auto* bytes = static_cast<const uint8_t*>(data);
+            OpenGLStateCache::BindTexture(GL_TEXTURE_CUBE_MAP, m_RendererID);
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 1); GCE;
+            for (uint32_t mip = 0; mip < GetMipLevelCount(); mip++)
+            {
+                const uint32_t width = std::max(m_Width >> mip, 1u);
+                const uint32_t height = std::max(m_Height >> mip, 1u);
+                for (uint32_t face = 0; face < 6; face++)
+                {
+                    glTexSubImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + face, mip, 0, 0, width, height, GetGLDataFormat(m_Spec.Format), GetGLDataType(m_Spec.Format), bytes); GCE;
+                    bytes += GetFaceSize(mip);
+                }
+            }
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 4); GCE;
+        });
     }
 
     void OpenGLTextureCube::ExtractBuffer()
     {
+        m_Buffer.Allocate(GetMipChainSize());
+
+        Renderer::SubmitAndWait([&]() {
+            auto* bytes = m_Buffer.As<uint8_t>();
+            OpenGLStateCache::BindTexture(GL_TEXTURE_CUBE_MAP, m_RendererID);
+            glPixelStorei(GL_PACK_ALIGNMENT, 1); GCE;
+            for (uint32_t mip = 0; mip < GetMipLevelCount(); mip++)
+            {
+                for (uint32_t face = 0; face < 6; face++)
+                {
+                    glGetTexImage(GL_TEXTURE_CUBE_MAP_POSITIVE_X + face, mip, GetGLDataFormat(m_Spec.Format), GetGLDataType(m_Spec.Format), bytes); GCE;
+                    bytes += GetFaceSize(mip);
+                }
+            }
+        });
     }
 
     void OpenGLTextureCube::CopyToHostBuffer(Buffer& buffer) const
     {
+        auto sharedBuffer = dynamic_cast<SharedBuffer*>(&buffer);
+
+        if (m_Buffer.Size != 0)
+        {
+            if (sharedBuffer)
+                sharedBuffer->Copy(m_Buffer);
+            else
+                m_Buffer.CopyTo(buffer);
+        }
+        else
+            CZ_CORE_WARN("Texture buffer data is empty.");
     }
 }
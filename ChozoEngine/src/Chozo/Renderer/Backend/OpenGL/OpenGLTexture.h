@@ -20,11 +20,15 @@ namespace Chozo {
 
         virtual uint32_t GetWidth() const override { return m_Width; };
         virtual uint32_t GetHeight() const override { return m_Height; };
-		virtual RendererID GetRendererID() const override { return m_RendererID; };
+		virtual RendererID GetRendererID() const override;
         virtual Texture2DSpecification GetSpecification() const override { return m_Spec; };
 
         virtual void Resize(uint32_t width, uint32_t height) override;
 
+        virtual uint32_t GetResidentMip() const override { return m_Spec.ResidentMip; }
+        virtual void StreamIn(uint32_t mip, const Buffer& levels) override;
+        virtual void Evict(uint32_t mip) override;
+
         virtual void SetData(const void* data, const uint32_t size) override;
         virtual void ExtractBuffer() override;
         virtual void CopyToHostBuffer(Buffer& buffer) const override;
@@ -33,6 +37,8 @@ namespace Chozo {
         void Unbind() const;
     private:
         void Invalidate();
+        // Defines the storage of the resident levels and fills it from m_Buffer, large buffers through the uploader.
+        void Upload();
     private:
         Texture2DSpecification m_Spec;
         std::string m_Path;
@@ -40,6 +46,8 @@ namespace Chozo {
         RendererID m_RendererID{};
         GLenum m_InternalFormat = GL_RGBA8, m_DataFormat = GL_RGBA, m_DataType = GL_UNSIGNED_BYTE;
         Buffer m_Buffer;
+        // Uploads still filling the texture, shared with their completion callbacks which can outlive it.
+        std::shared_ptr<std::atomic<uint32_t>> m_PendingUploads = std::make_shared<std::atomic<uint32_t>>(0);
     };
 
     class OpenGLTextureCube : public TextureCube
@@ -58,12 +66,19 @@ namespace Chozo {
         virtual void ExtractBuffer() override;
         virtual void CopyToHostBuffer(Buffer& buffer) const override;
 
+        virtual uint32_t GetMipLevelCount() const override;
+        virtual uint64_t GetMipChainSize() const override;
+        virtual void SetMipChainData(const void* data, uint64_t size) override;
+
         void Bind(uint32_t slot = 0) const;
         void Unbind() const;
+    private:
+        uint64_t GetFaceSize(uint32_t mip) const;
     private:
         TextureCubeSpecification m_Spec;
         uint32_t m_Width, m_Height;
         RendererID m_RendererID{};
         void* m_LocalBuffer;
+        Buffer m_Buffer;
     };
 }
\ No newline at end of file
@@ -0,0 +1,393 @@
+#include "OpenGLTextureUploader.h"
+
+#include "OpenGLUtils.h"
+#include "OpenGLStateCache.h"
+#include "Chozo/Core/Pool.h"
+#include "Chozo/Renderer/Renderer.h"
+
+#include <atomic>
+#include <deque>
+#include <future>
+#include <mutex>
+
+namespace Chozo {
+
+    enum class PixelBufferState
+    {
+        Free = 0,
+        Copying,    // Mapped, a worker fills it
+        Filled,     // Unmapped, levels left to issue
+        Uploading   // Every level issued, waiting for the fence
+    };
+
+    // Copy of an upload's pixels into its mapped buffer, made by a pool worker or by the render thread
+    // when it needs the buffer before a worker got to it. Workers may be blocked on the render thread.
+    struct PixelCopy
+    {
+        void* Destination = nullptr;
+        SharedBuffer Pixels;
+        std::atomic<bool> Claimed = false;
+        std::promise<void> Done;
+    };
+
+    struct PixelBuffer
+    {
+        RendererID BufferID = 0;
+        uint64_t Capacity = 0;
+        void* Mapped = nullptr;
+        PixelBufferState State = PixelBufferState::Free;
+        std::shared_ptr<PixelCopy> Copy;
+        std::future<void> CopyDone;
+        TextureUpload Upload;
+        // Where Upload.FirstLevel starts in the buffer, past the levels a cancel trimmed off.
+        uint64_t BaseOffset = 0;
+        uint32_t NextLevel = 0;
+        GLsync Fence = nullptr;
+    };
+
+    static std::array<PixelBuffer, OpenGLTextureUploader::PixelBufferCount> s_PixelBuffers;
+    // Next buffer to map and next one to issue from, both go around the ring in submission order.
+    static uint32_t s_MapIndex = 0, s_IssueIndex = 0;
+    static std::deque<TextureUpload> s_Requests;
+    static std::mutex s_RequestMutex;
+    static RendererID s_PlaceholderID = 0;
+
+    namespace Utils {
+
+        // Whichever thread claims the copy first makes it.
+        static void RunCopy(PixelCopy& copy)
+        {
+            if (copy.Claimed.exchange(true))
+                return;
+
+            memcpy(copy.Destination, copy.Pixels.Data, copy.Pixels.Size);
+            copy.Done.set_value();
+        }
+
+        static uint64_t GetLevelOffset(const TextureUpload& upload, const uint32_t level)
+        {
+            return Image::GetMipChainSize(upload.Format, upload.Width, upload.Height, level)
+                - Image::GetMipChainSize(upload.Format, upload.Width, upload.Height, upload.FirstLevel);
+        }
+
+        static uint64_t GetLevelSize(const TextureUpload& upload, const uint32_t level)
+        {
+            return Image::GetImageSize(upload.Format, std::max(upload.Width >> level, 1u), std::max(upload.Height >> level, 1u));
+        }
+
+        // From client memory, or from the bound pixel unpack buffer when data is an offset into it.
+        static void SubImageLevel(const TextureUpload& upload, const uint32_t level, const void* data)
+        {
+            const uint32_t width = std::max(upload.Width >> level, 1u), height = std::max(upload.Height >> level, 1u);
+            if (Image::IsCompressedFormat(upload.Format))
+            {
+                glCompressedTexSubImage2D(GL_TEXTURE_2D, level, 0, 0, width, height, GetGLFormat(upload.Format), (GLsizei)GetLevelSize(upload, level), data); GCE;
+            }
+            else
+            {
+                glTexSubImage2D(GL_TEXTURE_2D, level, 0, 0, width, height, GetGLDataFormat(upload.Format), GetGLDataType(upload.Format), data); GCE;
+            }
+        }
+
+        static void Complete(TextureUpload& upload, const bool cancelled = false)
+        {
+            if (upload.OnComplete)
+                upload.OnComplete(upload, cancelled);
+            upload = {};
+        }
+
+        // Fallback when a buffer can't be mapped.
+        static void UploadDirect(TextureUpload& upload)
+        {
+            OpenGLStateCache::BindTexture(GL_TEXTURE_2D, upload.Texture);
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 1); GCE;
+            for (uint32_t level = upload.FirstLevel; level < upload.LastLevel; level++)
+                SubImageLevel(upload, level, upload.Pixels.As<uint8_t>() + GetLevelOffset(upload, level));
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 4); GCE;
+            Complete(upload);
+        }
+
+        static void Retire(const bool wait)
+        {
+            for (auto& buffer : s_PixelBuffers)
+            {
+                if (buffer.State != PixelBufferState::Uploading)
+                    continue;
+
+                if (wait)
+                {
+                    while (glClientWaitSync(buffer.Fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000) == GL_TIMEOUT_EXPIRED) {}
+                }
+                else
+                {
+                    const GLenum result = glClientWaitSync(buffer.Fence, 0, 0);
+                    if (result != GL_ALREADY_SIGNALED && result != GL_CONDITION_SATISFIED)
+                        continue;
+                }
+
+                glDeleteSync(buffer.Fence); GCE;
+                buffer.Fence = nullptr;
+                buffer.State = PixelBufferState::Free;
+                Complete(buffer.Upload);
+            }
+        }
+
+        // Issues levels in submission order until budget bytes went out, always at least one level.
+        static uint64_t Issue(const uint64_t budget, const bool wait)
+        {
+            uint64_t issued = 0;
+            bool bound = false;
+            while (true)
+            {
+                auto& buffer = s_PixelBuffers[s_IssueIndex];
+                if (buffer.State == PixelBufferState::Copying && !wait && buffer.CopyDone.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+                    break;
+                if (buffer.State != PixelBufferState::Copying && buffer.State != PixelBufferState::Filled)
+                    break;
+
+                if (!bound)
+                {
+                    glPixelStorei(GL_UNPACK_ALIGNMENT, 1); GCE;
+                    bound = true;
+                }
+                glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer.BufferID); GCE;
+                if (buffer.State == PixelBufferState::Copying)
+                {
+                    RunCopy(*buffer.Copy);
+                    buffer.CopyDone.get();
+                    buffer.Copy = nullptr;
+                    glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER); GCE;
+                    buffer.Mapped = nullptr;
+                    buffer.State = PixelBufferState::Filled;
+                }
+
+                auto& upload = buffer.Upload;
+                if (buffer.NextLevel < upload.LastLevel)
+                    OpenGLStateCache::BindTexture(GL_TEXTURE_2D, upload.Texture);
+                while (buffer.NextLevel < upload.LastLevel)
+                {
+                    const uint64_t size = GetLevelSize(upload, buffer.NextLevel);
+                    if (issued != 0 && issued + size > budget)
+                        break;
+
+                    SubImageLevel(upload, buffer.NextLevel, reinterpret_cast<const void*>((uintptr_t)(buffer.BaseOffset + GetLevelOffset(upload, buffer.NextLevel))));
+                    issued += size;
+                    buffer.NextLevel++;
+                }
+                if (buffer.NextLevel < upload.LastLevel)
+                    break;
+
+                // The buffer can be reused, and the texture sampled, once the GPU got past this.
+                buffer.Fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0); GCE;
+                buffer.State = PixelBufferState::Uploading;
+                s_IssueIndex = (s_IssueIndex + 1) % OpenGLTextureUploader::PixelBufferCount;
+            }
+
+            if (bound)
+            {
+                glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0); GCE;
+                glPixelStorei(GL_UNPACK_ALIGNMENT, 4); GCE;
+            }
+            return issued;
+        }
+
+        // Maps the free buffers for the queued requests and hands the copies to the pool.
+        static void Map()
+        {
+            while (true)
+            {
+                auto& buffer = s_PixelBuffers[s_MapIndex];
+                if (buffer.State != PixelBufferState::Free)
+                    return;
+
+                TextureUpload upload;
+                {
+                    std::lock_guard<std::mutex> lock(s_RequestMutex);
+                    if (s_Requests.empty())
+                        return;
+
+                    upload = std::move(s_Requests.front());
+                    s_Requests.pop_front();
+                }
+
+                const uint64_t size = upload.Pixels.Size;
+                glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer.BufferID); GCE;
+                if (buffer.Capacity < size)
+                {
+                    glBufferData(GL_PIXEL_UNPACK_BUFFER, (GLsizeiptr)size, nullptr, GL_STREAM_DRAW); GCE;
+                    buffer.Capacity = size;
+                }
+                // The buffer is free, its last fence signaled.
+                buffer.Mapped = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, (GLsizeiptr)size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT | GL_MAP_UNSYNCHRONIZED_BIT); GCE;
+                glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0); GCE;
+
+                if (!buffer.Mapped)
+                {
+                    CZ_CORE_WARN("Failed to map texture upload buffer, uploading directly.");
+                    UploadDirect(upload);
+                    continue;
+                }
+
+                buffer.Upload = std::move(upload);
+                buffer.BaseOffset = 0;
+                buffer.NextLevel = buffer.Upload.FirstLevel;
+                buffer.State = PixelBufferState::Copying;
+                buffer.Copy = std::make_shared<PixelCopy>();
+                buffer.Copy->Destination = buffer.Mapped;
+                buffer.Copy->Pixels = buffer.Upload.Pixels;
+                buffer.CopyDone = buffer.Copy->Done.get_future();
+                Pool::Dispatch([copy = buffer.Copy]() { Utils::RunCopy(*copy); });
+                s_MapIndex = (s_MapIndex + 1) % OpenGLTextureUploader::PixelBufferCount;
+            }
+        }
+
+        static uint32_t GetPendingCount()
+        {
+            uint32_t count = 0;
+            for (const auto& buffer : s_PixelBuffers)
+            {
+                if (buffer.State != PixelBufferState::Free)
+                    count++;
+            }
+
+            std::lock_guard<std::mutex> lock(s_RequestMutex);
+            return count + (uint32_t)s_Requests.size();
+        }
+    }
+
+    void OpenGLTextureUploader::Init()
+    {
+        for (auto& buffer : s_PixelBuffers)
+        {
+            glGenBuffers(1, &buffer.BufferID); GCE;
+        }
+
+        const uint8_t gray[4] = { 128, 128, 128, 255 };
+        glGenTextures(1, &s_PlaceholderID); GCE;
+        OpenGLStateCache::BindTexture(GL_TEXTURE_2D, s_PlaceholderID);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST); GCE;
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST); GCE;
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, gray); GCE;
+        OpenGLStateCache::BindTexture(GL_TEXTURE_2D, 0);
+    }
+
+    void OpenGLTextureUploader::Shutdown()
+    {
+        for (auto& buffer : s_PixelBuffers)
+        {
+            if (buffer.Copy)
+            {
+                Utils::RunCopy(*buffer.Copy);
+                buffer.CopyDone.wait();
+            }
+            if (buffer.Mapped)
+            {
+                glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer.BufferID); GCE;
+                glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER); GCE;
+                glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0); GCE;
+            }
+            if (buffer.Fence)
+            {
+                glDeleteSync(buffer.Fence); GCE;
+            }
+            glDeleteBuffers(1, &buffer.BufferID); GCE;
+            buffer = {};
+        }
+        s_MapIndex = s_IssueIndex = 0;
+
+        OpenGLStateCache::OnTextureDeleted(s_PlaceholderID);
+        glDeleteTextures(1, &s_PlaceholderID); GCE;
+        s_PlaceholderID = 0;
+
+        std::lock_guard<std::mutex> lock(s_RequestMutex);
+        s_Requests.clear();
+    }
+
+    void OpenGLTextureUploader::NextFrame()
+    {
+        Utils::Retire(false);
+        const uint64_t issued = Utils::Issue(Renderer::GetConfig().TextureUploadBudget, false);
+        Utils::Map();
+
+        // Stats were just reset.
+        Renderer::GetRendererData().Stats.UploadedTextureBytes = issued;
+        Renderer::GetRendererData().Stats.PendingTextureUploads = Utils::GetPendingCount();
+    }
+
+    void OpenGLTextureUploader::Flush()
+    {
+        do
+        {
+            Utils::Retire(true);
+            Utils::Issue(UINT64_MAX, true);
+            Utils::Map();
+        } while (Utils::GetPendingCount() != 0);
+    }
+
+    void OpenGLTextureUploader::Enqueue(TextureUpload&& upload)
+    {
+        CZ_CORE_ASSERT(upload.Pixels.Size == Utils::GetLevelOffset(upload, upload.LastLevel), "Upload pixels don't match its levels!");
+
+        std::lock_guard<std::mutex> lock(s_RequestMutex);
+        s_Requests.push_back(std::move(upload));
+    }
+
+    bool OpenGLTextureUploader::Cancel(const RendererID texture, const uint32_t endLevel)
+    {
+        std::vector<TextureUpload> cancelled;
+        bool trimmed = false;
+        {
+            std::lock_guard<std::mutex> lock(s_RequestMutex);
+            for (auto it = s_Requests.begin(); it != s_Requests.end();)
+            {
+                if (it->Texture != texture || it->FirstLevel >= endLevel)
+                {
+                    it++;
+                }
+                else if (it->LastLevel <= endLevel)
+                {
+                    cancelled.push_back(std::move(*it));
+                    it = s_Requests.erase(it);
+                }
+                else
+                {
+                    const uint64_t offset = Utils::GetLevelOffset(*it, endLevel);
+                    it->Pixels = SharedBuffer(it->Pixels.As<uint8_t>() + offset, it->Pixels.Size - offset);
+                    it->FirstLevel = endLevel;
+                    trimmed = true;
+                    it++;
+                }
+            }
+        }
+
+        // Buffers in flight still go through the ring, without issuing the cancelled levels.
+        for (auto& buffer : s_PixelBuffers)
+        {
+            auto& upload = buffer.Upload;
+            if (buffer.State == PixelBufferState::Free || upload.Texture != texture || upload.FirstLevel >= endLevel)
+                continue;
+
+            if (upload.LastLevel > endLevel)
+            {
+                buffer.BaseOffset += Utils::GetLevelOffset(upload, endLevel);
+                buffer.NextLevel = std::max(buffer.NextLevel, endLevel);
+                upload.FirstLevel = endLevel;
+                trimmed = true;
+                continue;
+            }
+
+            cancelled.push_back(std::move(upload));
+            upload = {};
+            buffer.NextLevel = upload.LastLevel;
+        }
+
+        for (auto& upload : cancelled)
+            Utils::Complete(upload, true);
+        return trimmed;
+    }
+
+    RendererID OpenGLTextureUploader::GetPlaceholderID()
+    {
+        return s_PlaceholderID;
+    }
+}
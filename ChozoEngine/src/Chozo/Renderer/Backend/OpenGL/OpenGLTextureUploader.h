@@ -0,0 +1,55 @@
+#pragma once
+
+#include "czpch.h"
+
+#include "Chozo/Core/Buffer.h"
+#include "Chozo/Renderer/RendererTypes.h"
+#include "Chozo/Renderer/Image.h"
+
+#include <glad/glad.h>
+
+namespace Chozo {
+
+    // Levels of a 2D texture whose storage is already defined, filled from pixel buffer objects.
+    struct TextureUpload
+    {
+        RendererID Texture = 0;
+        ImageFormat Format = ImageFormat::RGBA;
+        uint32_t Width = 1, Height = 1;
+        // Levels [FirstLevel, LastLevel), Pixels holds them laid out like the chain from FirstLevel on.
+        uint32_t FirstLevel = 0, LastLevel = 1;
+        SharedBuffer Pixels;
+        // Called on the render thread once the GPU is done reading the pixel buffer, or with cancelled set when
+        // Cancel dropped the upload. Gets the upload as it ended, FirstLevel moves up when a cancel trimmed it.
+        std::function<void(const TextureUpload& upload, bool cancelled)> OnComplete;
+    };
+
+    // Texture uploads through a ring of pixel buffer objects. The render thread maps the next free buffer and a
+    // worker copies the pixels into it, the levels are then issued with glTexSubImage2D in submission order, at most
+    // RendererConfig::TextureUploadBudget bytes per frame (at least one level). A fence after the last level tells
+    // when the buffer can be reused and the upload is complete.
+    class OpenGLTextureUploader
+    {
+    public:
+        static constexpr uint32_t PixelBufferCount = 4;
+        // Smaller uploads don't gain from the round trip and go straight from client memory.
+        static constexpr uint64_t MinAsyncUploadSize = 64 * 1024;
+
+        static void Init();
+        static void Shutdown();
+        // Render thread, once per frame.
+        static void NextFrame();
+        // Render thread, issues and completes every queued upload before returning.
+        static void Flush();
+
+        // Any thread, the upload starts on the render thread.
+        static void Enqueue(TextureUpload&& upload);
+        // Render thread, drops the levels below endLevel from the uploads of texture before their storage is
+        // redefined or deleted. Uploads left without levels complete right away as cancelled, the others go on
+        // from endLevel. Returns whether any upload goes on.
+        static bool Cancel(RendererID texture, uint32_t endLevel = UINT32_MAX);
+
+        // Bound in place of textures whose pixels are still on their way, a flat mid gray.
+        static RendererID GetPlaceholderID();
+    };
+}
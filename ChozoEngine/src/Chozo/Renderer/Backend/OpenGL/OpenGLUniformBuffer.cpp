@@ -1,4 +1,6 @@
 #include "OpenGLUniformBuffer.h"
+#include "OpenGLUtils.h"
+#include "Chozo/Renderer/Renderer.h"
 #include "Chozo/Renderer/Renderer2D.h"
 
 #include <glad/glad.h>
@@ -6,23 +8,64 @@
 namespace Chozo {
     
     unsigned int OpenGLUniformBuffer::s_UniformBindingPoint = -1;
+    Scope<OpenGLRingBuffer> OpenGLUniformBuffer::s_RingBuffer;
 
     OpenGLUniformBuffer::OpenGLUniformBuffer(uint32_t size)
+        : m_Size(size)
     {
-        glGenBuffers(1, &m_RendererID);
+        Renderer::SubmitAndWait([&]() {
+            glGenBuffers(1, &m_RendererID);
 
-        glBindBuffer(GL_UNIFORM_BUFFER, m_RendererID);
-        glBufferData(GL_UNIFORM_BUFFER, size, NULL, GL_STATIC_DRAW);
-        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+            glBindBuffer(GL_UNIFORM_BUFFER, m_RendererID);
+            glBufferData(GL_UNIFORM_BUFFER, size, NULL, GL_STATIC_DRAW);
+            glBindBuffer(GL_UNIFORM_BUFFER, 0);
 
-        m_BindingPoint = ++s_UniformBindingPoint;
-        glBindBufferRange(GL_UNIFORM_BUFFER, m_BindingPoint, m_RendererID, 0, size);
+            m_BindingPoint = ++s_UniformBindingPoint;
+            glBindBufferRange(GL_UNIFORM_BUFFER, m_BindingPoint, m_RendererID, 0, size);
+        });
+    }
+
+    OpenGLUniformBuffer::~OpenGLUniformBuffer()
+    {
+        Renderer::SubmitResourceFree([rendererID = m_RendererID]() {
+            glDeleteBuffers(1, &rendererID); GCE;
+        });
     }
 
     void OpenGLUniformBuffer::SetData(const void* data, uint32_t size, uint32_t offset)
     {
-        glBindBuffer(GL_UNIFORM_BUFFER, m_RendererID);
-        glBufferSubData(GL_UNIFORM_BUFFER, offset, size, data);
-        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+        Renderer::SubmitAndWait([&]() {
+            // A write from the start is a new version of the block, it goes to the ring and only the written bytes are copied.
+            // The whole block is still reserved and bound, shaders may declare more than was written.
+            uint32_t ringOffset;
+            if (s_RingBuffer && offset == 0 && s_RingBuffer->Write(data, size, m_Size, ringOffset))
+            {
+                glBindBufferRange(GL_UNIFORM_BUFFER, m_BindingPoint, s_RingBuffer->GetRendererID(), ringOffset, m_Size); GCE;
+                return;
+            }
+
+            glBindBuffer(GL_UNIFORM_BUFFER, m_RendererID);
+            glBufferSubData(GL_UNIFORM_BUFFER, offset, size, data);
+            glBindBuffer(GL_UNIFORM_BUFFER, 0);
+            glBindBufferRange(GL_UNIFORM_BUFFER, m_BindingPoint, m_RendererID, 0, m_Size); GCE;
+        });
+    }
+
+    void OpenGLUniformBuffer::InitRingBuffer()
+    {
+        int alignment;
+        glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment); GCE;
+        s_RingBuffer = CreateScope<OpenGLRingBuffer>(GL_UNIFORM_BUFFER, 4 * 1024 * 1024, (uint32_t)alignment);
+    }
+
+    void OpenGLUniformBuffer::ShutdownRingBuffer()
+    {
+        s_RingBuffer.reset();
+    }
+
+    void OpenGLUniformBuffer::NextFrame()
+    {
+        if (s_RingBuffer)
+            s_RingBuffer->NextFrame();
     }
 }
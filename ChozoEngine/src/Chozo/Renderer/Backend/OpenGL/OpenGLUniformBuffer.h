@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Chozo/Renderer/UniformBuffer.h"
+#include "OpenGLRingBuffer.h"
 
 namespace Chozo {
 
@@ -8,13 +9,20 @@ namespace Chozo {
     {
     public:
         OpenGLUniformBuffer(uint32_t size);
-        virtual ~OpenGLUniformBuffer() override {}
+        virtual ~OpenGLUniformBuffer() override;
 
         virtual void SetData(const void* data, uint32_t size, uint32_t offset = 0) override;
         virtual unsigned int GetBindingPoint() override { return m_BindingPoint; }
+
+        // Every uniform buffer streams its per-frame versions through one shared ring.
+        static void InitRingBuffer();
+        static void ShutdownRingBuffer();
+        static void NextFrame();
     private:
         static unsigned int s_UniformBindingPoint;
+        static Scope<OpenGLRingBuffer> s_RingBuffer;
         unsigned int m_BindingPoint;
         uint32_t m_RendererID;
+        uint32_t m_Size;
     };
-}
\ No newline at end of file
+}
@@ -2,6 +2,17 @@
 
 #include "Chozo/Debug/Log.h"
 
+// Extension enums the loader may not have been generated with.
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+#ifndef GL_COMPRESSED_RGBA_BPTC_UNORM
+#define GL_COMPRESSED_RGBA_BPTC_UNORM 0x8E8C
+#endif
+
 namespace Chozo {
 
     int GetChannelCount(const ImageFormat& format)
@@ -16,6 +27,7 @@ namespace Chozo {
             case ImageFormat::RED32UI: return 1;
             case ImageFormat::RED32F: return 1;
             case ImageFormat::RG8: return 2;
+            case ImageFormat::RG16: return 2;
             case ImageFormat::RG16F: return 2;
             case ImageFormat::RG32F: return 2;
             case ImageFormat::RGB: return 3;
@@ -28,6 +40,11 @@ namespace Chozo {
             case ImageFormat::RGBA32F: return 4;
             case ImageFormat::B10R11G11UF: return 3;
             case ImageFormat::SRGB: return 3;
+            case ImageFormat::RGB9E5: return 3;
+            case ImageFormat::BC1: return 3;
+            case ImageFormat::BC3: return 4;
+            case ImageFormat::BC5: return 2;
+            case ImageFormat::BC7: return 4;
             case ImageFormat::DEPTH32FSTENCIL8UINT: return 2;
             case ImageFormat::DEPTH24STENCIL8: return 2;
             default: return 4;
@@ -46,6 +63,7 @@ namespace Chozo {
             case ImageFormat::RED32UI: return GL_R32UI;
             case ImageFormat::RED32F: return GL_R32F;
             case ImageFormat::RG8: return GL_RG8;
+            case ImageFormat::RG16: return GL_RG16;
             case ImageFormat::RG16F: return GL_RG16F;
             case ImageFormat::RG32F: return GL_RG32F;
             case ImageFormat::RGB: return GL_RGB;
@@ -58,6 +76,11 @@ namespace Chozo {
             case ImageFormat::RGBA32F: return GL_RGBA32F;
             case ImageFormat::B10R11G11UF: return GL_R11F_G11F_B10F;
             case ImageFormat::SRGB: return GL_SRGB;
+            case ImageFormat::RGB9E5: return GL_RGB9_E5;
+            case ImageFormat::BC1: return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+            case ImageFormat::BC3: return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+            case ImageFormat::BC5: return GL_COMPRESSED_RG_RGTC2;
+            case ImageFormat::BC7: return GL_COMPRESSED_RGBA_BPTC_UNORM;
             case ImageFormat::DEPTH32FSTENCIL8UINT: return GL_DEPTH32F_STENCIL8;
             case ImageFormat::DEPTH24STENCIL8: return GL_DEPTH24_STENCIL8;
             default: return GL_NONE;
@@ -75,6 +98,7 @@ namespace Chozo {
             case ImageFormat::RED32UI: return GL_RED_INTEGER;
             case ImageFormat::RED32F: return GL_RED;  // This is a floating-point format
             case ImageFormat::RG8: return GL_RG;
+            case ImageFormat::RG16: return GL_RG;
             case ImageFormat::RG16F: return GL_RG;
             case ImageFormat::RG32F: return GL_RG;
             case ImageFormat::RGB: return GL_RGB;
@@ -85,8 +109,13 @@ namespace Chozo {
             case ImageFormat::RGBA8: return GL_RGBA;
             case ImageFormat::RGBA16F: return GL_RGBA;
             case ImageFormat::RGBA32F: return GL_RGBA;
-            case ImageFormat::B10R11G11UF: return GL_R11F_G11F_B10F; // Fine if using this format
+            case ImageFormat::B10R11G11UF: return GL_RGB;  // Packed internally, uploaded as three channels
             case ImageFormat::SRGB: return GL_SRGB_ALPHA;  // Use GL_SRGB_ALPHA for SRGB with alpha
+            case ImageFormat::RGB9E5: return GL_RGB;  // Shared exponent, uploaded as three channels
+            case ImageFormat::BC1: return GL_RGB;  // Block compressed formats upload blocks, these describe the decoded pixels
+            case ImageFormat::BC3: return GL_RGBA;
+            case ImageFormat::BC5: return GL_RG;
+            case ImageFormat::BC7: return GL_RGBA;
             case ImageFormat::DEPTH32FSTENCIL8UINT: return GL_DEPTH_STENCIL;
             case ImageFormat::DEPTH24STENCIL8: return GL_DEPTH_STENCIL;
             default: return GL_NONE;
@@ -104,11 +133,12 @@ namespace Chozo {
             case ImageFormat::RED32UI: return GL_UNSIGNED_INT;  // Unsigned 32-bit integer
             case ImageFormat::RED32F: return GL_FLOAT;  // 32-bit float
             case ImageFormat::RG8: return GL_UNSIGNED_BYTE;  // Unsigned 8-bit for two channels
-            case ImageFormat::RG16F: return GL_FLOAT;  // 16-bit float (half float)
+            case ImageFormat::RG16: return GL_UNSIGNED_SHORT;  // Unsigned normalized 16-bit for two channels
+            case ImageFormat::RG16F: return GL_HALF_FLOAT;  // 16-bit float (half float)
             case ImageFormat::RG32F: return GL_FLOAT;  // 32-bit float
             case ImageFormat::RGB: return GL_UNSIGNED_BYTE;  // Unsigned 8-bit
             case ImageFormat::RGB8: return GL_UNSIGNED_BYTE;  // Unsigned 8-bit
-            case ImageFormat::RGB16F: return GL_FLOAT;  // 16-bit float
+            case ImageFormat::RGB16F: return GL_HALF_FLOAT;  // 16-bit float
             case ImageFormat::RGB32F: return GL_FLOAT;  // 32-bit float
             case ImageFormat::RGBA: return GL_UNSIGNED_BYTE;  // Unsigned 8-bit for 4 channels
             case ImageFormat::RGBA8: return GL_UNSIGNED_BYTE;  // Unsigned 8-bit for 4 channels
@@ -116,6 +146,11 @@ namespace Chozo {
             case ImageFormat::RGBA32F: return GL_FLOAT;  // 32-bit float for 4 channels
             case ImageFormat::B10R11G11UF: return GL_UNSIGNED_INT_10F_11F_11F_REV;  // Special packed float format
             case ImageFormat::SRGB: return GL_UNSIGNED_BYTE;  // Unsigned 8-bit with sRGB
+            case ImageFormat::RGB9E5: return GL_UNSIGNED_INT_5_9_9_9_REV;  // 9-bit mantissas, 5-bit shared exponent
+            case ImageFormat::BC1: return GL_UNSIGNED_BYTE;  // Decoded pixels, see GetGLDataFormat
+            case ImageFormat::BC3: return GL_UNSIGNED_BYTE;
+            case ImageFormat::BC5: return GL_UNSIGNED_BYTE;
+            case ImageFormat::BC7: return GL_UNSIGNED_BYTE;
             case ImageFormat::DEPTH32FSTENCIL8UINT: return GL_FLOAT_32_UNSIGNED_INT_24_8_REV;  // Depth + stencil combined
             case ImageFormat::DEPTH24STENCIL8: return GL_UNSIGNED_INT_24_8;  // 24-bit depth, 8-bit stencil
             default: return GL_NONE;
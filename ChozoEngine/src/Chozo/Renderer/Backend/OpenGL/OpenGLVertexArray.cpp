@@ -1,6 +1,8 @@
 #include "OpenGLVertexArray.h"
 
 #include "OpenGLUtils.h"
+#include "OpenGLStateCache.h"
+#include "Chozo/Renderer/Renderer.h"
 #include <glad/glad.h>
 
 namespace Chozo {
@@ -21,6 +23,9 @@ namespace Chozo {
             case Chozo::ShaderDataType::Int3:    return GL_INT;
             case Chozo::ShaderDataType::Int4:    return GL_INT;
             case Chozo::ShaderDataType::Bool:    return GL_BOOL;
+            case Chozo::ShaderDataType::Half2:   return GL_HALF_FLOAT;
+            case Chozo::ShaderDataType::Short4:  return GL_SHORT;
+            case Chozo::ShaderDataType::UShort4: return GL_UNSIGNED_SHORT;
         }
 
         CZ_CORE_ASSERT(false, "Unknown ShaderDataType!");
@@ -29,52 +34,61 @@ namespace Chozo {
 
     OpenGLVertexArray::OpenGLVertexArray()
     {
-        glGenVertexArrays(1, &m_RendererID); GCE;
+        Renderer::SubmitAndWait([&]() {
+            glGenVertexArrays(1, &m_RendererID); GCE;
+        });
     }
 
     OpenGLVertexArray::~OpenGLVertexArray()
     {
-        glDeleteVertexArrays(1, &m_RendererID); GCE;
+        Renderer::SubmitResourceFree([rendererID = m_RendererID]() {
+            OpenGLStateCache::OnVertexArrayDeleted(rendererID);
+            glDeleteVertexArrays(1, &rendererID); GCE;
+        });
     }
 
     void OpenGLVertexArray::Bind() const
     {
-        glBindVertexArray(m_RendererID); GCE;
+        OpenGLStateCache::BindVertexArray(m_RendererID);
     }
 
     void OpenGLVertexArray::Unbind() const
     {
-        glBindVertexArray(0); GCE;
+        OpenGLStateCache::BindVertexArray(0);
     }
 
     void OpenGLVertexArray::AddVertexBuffer(const Ref<VertexBuffer>& vertexBuffer)
     {
         CZ_CORE_ASSERT(vertexBuffer->GetLayout().GetElements().size(), "Vertex Buffer has no layout!");
 
-        glBindVertexArray(m_RendererID); GCE;
-        vertexBuffer->Bind();
+        Renderer::SubmitAndWait([&]() {
+            OpenGLStateCache::BindVertexArray(m_RendererID);
+            vertexBuffer->Bind();
 
-        uint32_t index = 0;
-        for (const auto& element : vertexBuffer->GetLayout())
-        {
-            glEnableVertexAttribArray(index); GCE;
-            glVertexAttribPointer(index,
-                element.GetComponentCount(),
-                ShaderDataTypeToOpenGLBaseType(element.Type),
-                element.Normalized ? GL_TRUE : GL_FALSE,
-                vertexBuffer->GetLayout().GetStride(),
-                reinterpret_cast<const void*>(static_cast<uintptr_t>(element.Offset))
-            ); GCE;
-            index++;
-        }
+            uint32_t index = 0;
+            for (const auto& element : vertexBuffer->GetLayout())
+            {
+                glEnableVertexAttribArray(index); GCE;
+                glVertexAttribPointer(index,
+                    element.GetComponentCount(),
+                    ShaderDataTypeToOpenGLBaseType(element.Type),
+                    element.Normalized ? GL_TRUE : GL_FALSE,
+                    vertexBuffer->GetLayout().GetStride(),
+                    reinterpret_cast<const void*>(static_cast<uintptr_t>(element.Offset))
+                ); GCE;
+                index++;
+            }
+        });
 
         m_VertexBuffers.push_back(vertexBuffer);
     }
 
     void OpenGLVertexArray::SetIndexBuffer(const Ref<IndexBuffer>& indexBuffer)
     {
-        glBindVertexArray(m_RendererID); GCE;
-        indexBuffer->Bind();
+        Renderer::SubmitAndWait([&]() {
+            OpenGLStateCache::BindVertexArray(m_RendererID);
+            indexBuffer->Bind();
+        });
 
         m_IndexBuffer = indexBuffer;
     }
@@ -1,27 +1,34 @@
 #include "OpenGLVertexBuffer.h"
 
 #include "OpenGLUtils.h"
+#include "Chozo/Renderer/Renderer.h"
 #include <glad/glad.h>
 
 namespace Chozo {
 
     OpenGLVertexBuffer::OpenGLVertexBuffer(uint32_t size)
     {
-        glGenBuffers(1, &m_RendererID); GCE;
-        glBindBuffer(GL_ARRAY_BUFFER, m_RendererID); GCE;
-        glBufferData(GL_ARRAY_BUFFER, size, nullptr, GL_DYNAMIC_DRAW); GCE;
+        Renderer::SubmitAndWait([&]() {
+            glGenBuffers(1, &m_RendererID); GCE;
+            glBindBuffer(GL_ARRAY_BUFFER, m_RendererID); GCE;
+            glBufferData(GL_ARRAY_BUFFER, size, nullptr, GL_DYNAMIC_DRAW); GCE;
+        });
     }
 
     OpenGLVertexBuffer::OpenGLVertexBuffer(void* vertices, uint32_t size)
     {
-        glGenBuffers(1, &m_RendererID); GCE;
-        glBindBuffer(GL_ARRAY_BUFFER, m_RendererID); GCE;
-        glBufferData(GL_ARRAY_BUFFER, size, vertices, GL_STATIC_DRAW); GCE;
+        Renderer::SubmitAndWait([&]() {
+            glGenBuffers(1, &m_RendererID); GCE;
+            glBindBuffer(GL_ARRAY_BUFFER, m_RendererID); GCE;
+            glBufferData(GL_ARRAY_BUFFER, size, vertices, GL_STATIC_DRAW); GCE;
+        });
     }
 
     OpenGLVertexBuffer::~OpenGLVertexBuffer()
     {
-        glDeleteBuffers(1, &m_RendererID); GCE;
+        Renderer::SubmitResourceFree([rendererID = m_RendererID]() {
+            glDeleteBuffers(1, &rendererID); GCE;
+        });
     }
 
     void OpenGLVertexBuffer::GetData(uint32_t offset, uint32_t size)
@@ -34,23 +41,29 @@ namespace Chozo {
 
     void OpenGLVertexBuffer::SetData(uint32_t offset, uint32_t size, void* vertices)
     {
-        Bind();
-        glBufferSubData(GL_ARRAY_BUFFER, offset, size, vertices); GCE;
+        Renderer::SubmitAndWait([&]() {
+            Bind();
+            glBufferSubData(GL_ARRAY_BUFFER, offset, size, vertices); GCE;
+        });
         m_End = std::max(size, m_End);
     }
 
     void OpenGLVertexBuffer::ClearData()
     {
-        Bind();
-        std::vector<float> zeroData(m_End / sizeof(float), 0.0f);
-        glBufferSubData(GL_ARRAY_BUFFER, 0, m_End, zeroData.data()); GCE;
+        Renderer::SubmitAndWait([&]() {
+            Bind();
+            std::vector<float> zeroData(m_End / sizeof(float), 0.0f);
+            glBufferSubData(GL_ARRAY_BUFFER, 0, m_End, zeroData.data()); GCE;
+        });
     }
 
     void OpenGLVertexBuffer::Resize(uint32_t size)
     {
-        Bind();
-        std::vector<float> zeroData(size, 0.0f);
-        glBufferData(GL_ARRAY_BUFFER, size, zeroData.data(), GL_STATIC_DRAW); GCE;
+        Renderer::SubmitAndWait([&]() {
+            Bind();
+            std::vector<float> zeroData(size, 0.0f);
+            glBufferData(GL_ARRAY_BUFFER, size, zeroData.data(), GL_STATIC_DRAW); GCE;
+        });
     }
 
     void OpenGLVertexBuffer::Bind() const
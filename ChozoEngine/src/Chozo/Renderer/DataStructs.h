@@ -18,6 +18,28 @@ namespace Chozo
 		uint32_t V1, V2, V3;
 	};
 
+	// GPU vertex layouts, see MeshPacker. Normal and tangent are octahedral encoded snorm16 pairs,
+	// the binormal is rebuilt from them with the sign stored in Position.w (0 or 1).
+	enum class VertexFormat : uint8_t
+	{
+		Compact = 0,	// Float position, 28 bytes.
+		Quantized		// Unorm16 position relative to the mesh bounding box, 20 bytes.
+	};
+
+	struct CompactVertex
+	{
+		glm::vec4 Position;
+		int16_t NormalTangent[4];
+		uint16_t TexCoord[2];
+	};
+
+	struct QuantizedVertex
+	{
+		uint16_t Position[4];
+		int16_t NormalTangent[4];
+		uint16_t TexCoord[2];
+	};
+
     struct Triangle
 	{
 		Vertex V0, V1, V2;
@@ -51,6 +73,8 @@ namespace Chozo
         Ref<VertexArray> VAO;
         Ref<VertexBuffer> VBO;
         Ref<IndexBuffer> IBO;
+        Ref<VertexArray> PositionVAO;
+        Ref<VertexBuffer> PositionVBO;
 
 		RenderSource() = default;
         RenderSource(const RenderSource& other) = delete;
@@ -74,5 +98,26 @@ namespace Chozo
             VAO->AddVertexBuffer(VBO);
             VAO->SetIndexBuffer(IBO);
 		};
+		RenderSource(void* vertices, uint32_t vertexSize, const VertexBufferLayout& layout, void* indices, uint32_t indicesCount, IndexFormat indexFormat)
+		{
+			VAO = VertexArray::Create();
+			VBO = VertexBuffer::Create(vertices, vertexSize);
+			VBO->SetLayout(layout);
+			IBO = IndexBuffer::Create(indices, indicesCount, indexFormat);
+
+			VAO->AddVertexBuffer(VBO);
+			VAO->SetIndexBuffer(IBO);
+		}
+
+		// Second vertex array over the same indices, fetching positions only.
+		void CreatePositionStream(void* positions, uint32_t positionSize, const VertexBufferLayout& layout)
+		{
+			PositionVAO = VertexArray::Create();
+			PositionVBO = VertexBuffer::Create(positions, positionSize);
+			PositionVBO->SetLayout(layout);
+
+			PositionVAO->AddVertexBuffer(PositionVBO);
+			PositionVAO->SetIndexBuffer(IBO);
+		}
     };
 }
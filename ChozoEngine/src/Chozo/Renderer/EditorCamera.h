@@ -31,6 +31,9 @@ namespace Chozo {
         const glm::vec3& GetPosition() const { return m_Position; }
         glm::quat GetOrientation() const;
 
+        float GetNearClip() const { return m_NearClip; }
+        float GetFarClip() const { return m_FarClip; }
+
         float GetPitch() const { return m_Pitch; }
         float GetYaw() const { return m_Yaw; }
     private:
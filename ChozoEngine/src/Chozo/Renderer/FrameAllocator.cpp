@@ -0,0 +1,90 @@
+#include "FrameAllocator.h"
+
+namespace Chozo {
+
+    namespace Utils {
+
+        static size_t AlignUp(const size_t value, const size_t alignment)
+        {
+            return (value + alignment - 1) & ~(alignment - 1);
+        }
+    }
+
+    FrameAllocator::FrameAllocator(const size_t blockSize)
+        : m_BlockSize(blockSize)
+    {
+    }
+
+    FrameAllocator::~FrameAllocator()
+    {
+        for (auto& block : m_Blocks)
+            ::operator delete(block.Data, std::align_val_t(DefaultAlignment));
+    }
+
+    void* FrameAllocator::Allocate(const size_t size, size_t alignment)
+    {
+        alignment = std::max(alignment, alignof(std::max_align_t));
+
+        while (true)
+        {
+            if (m_CurrentBlock < m_Blocks.size())
+            {
+                const auto& block = m_Blocks[m_CurrentBlock];
+                // Blocks are DefaultAlignment aligned, larger alignments are resolved against the address.
+                const auto base = reinterpret_cast<uintptr_t>(block.Data);
+                const size_t offset = Utils::AlignUp(base + m_Offset, alignment) - base;
+                if (offset + size <= block.Size)
+                {
+                    m_Offset = offset + size;
+                    m_UsedSize += size;
+                    return block.Data + offset;
+                }
+
+                if (m_CurrentBlock + 1 < m_Blocks.size())
+                {
+                    m_CurrentBlock++;
+                    m_Offset = 0;
+                    continue;
+                }
+            }
+
+            AddBlock(size + alignment);
+            m_CurrentBlock = m_Blocks.size() - 1;
+            m_Offset = 0;
+        }
+    }
+
+    void FrameAllocator::Reset()
+    {
+        m_Pins.clear();
+        m_PinnedObjects.clear();
+
+        if (m_Blocks.size() > 1)
+        {
+            const size_t capacity = GetCapacity();
+            for (auto& block : m_Blocks)
+                ::operator delete(block.Data, std::align_val_t(DefaultAlignment));
+            m_Blocks.clear();
+            AddBlock(capacity);
+        }
+
+        m_CurrentBlock = 0;
+        m_Offset = 0;
+        m_UsedSize = 0;
+    }
+
+    size_t FrameAllocator::GetCapacity() const
+    {
+        size_t capacity = 0;
+        for (const auto& block : m_Blocks)
+            capacity += block.Size;
+        return capacity;
+    }
+
+    void FrameAllocator::AddBlock(const size_t minSize)
+    {
+        const size_t size = Utils::AlignUp(std::max(m_BlockSize, minSize), DefaultAlignment);
+        auto* data = static_cast<uint8_t*>(::operator new(size, std::align_val_t(DefaultAlignment)));
+        m_Blocks.push_back({ data, size });
+    }
+}
@@ -0,0 +1,136 @@
+#pragma once
+
+#include "czpch.h"
+
+#include "Chozo/Core/Ref.h"
+
+namespace Chozo {
+
+    // Linear allocator for render data extracted from the scene each frame, released all at once by Reset.
+    // Anything placed here must be trivially destructible, objects it points at are kept alive with Pin.
+    class FrameAllocator
+    {
+    public:
+        static constexpr size_t DefaultAlignment = 16;
+
+        explicit FrameAllocator(size_t blockSize = 1024 * 1024);
+        ~FrameAllocator();
+
+        FrameAllocator(const FrameAllocator&) = delete;
+        FrameAllocator& operator=(const FrameAllocator&) = delete;
+
+        void* Allocate(size_t size, size_t alignment = DefaultAlignment);
+
+        template<typename T, typename... Args>
+        T* New(Args&&... args)
+        {
+            static_assert(std::is_trivially_destructible_v<T>, "Frame allocations are never destroyed!");
+            return new (Allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+        }
+
+        template<typename T>
+        T* AllocateArray(size_t count)
+        {
+            static_assert(std::is_trivially_destructible_v<T>, "Frame allocations are never destroyed!");
+            return static_cast<T*>(Allocate(sizeof(T) * count, alignof(T)));
+        }
+
+        template<typename T>
+        T* Copy(const T* data, size_t count)
+        {
+            static_assert(std::is_trivially_copyable_v<T>, "Frame copies are raw memory copies!");
+            T* copy = AllocateArray<T>(count);
+            memcpy(copy, data, sizeof(T) * count);
+            return copy;
+        }
+
+        // Holds a reference until the next Reset, so draw packets can store the raw pointer.
+        // Only the first pin of an object in a frame touches its reference count.
+        template<typename T>
+        T* Pin(const Ref<T>& ref)
+        {
+            T* object = const_cast<T*>(ref.Raw());
+            if (object && m_PinnedObjects.insert(object).second)
+                m_Pins.emplace_back(Ref<RefCounted>(object));
+            return object;
+        }
+
+        // Releases the pins and rewinds. Blocks added during the frame are merged so the next one fits in one block.
+        void Reset();
+
+        size_t GetUsedSize() const { return m_UsedSize; }
+        size_t GetCapacity() const;
+    private:
+        struct Block
+        {
+            uint8_t* Data;
+            size_t Size;
+        };
+
+        void AddBlock(size_t minSize);
+    private:
+        size_t m_BlockSize;
+        std::vector<Block> m_Blocks;
+        size_t m_CurrentBlock = 0;
+        size_t m_Offset = 0;
+        size_t m_UsedSize = 0;
+
+        std::vector<Ref<RefCounted>> m_Pins;
+        std::unordered_set<const RefCounted*> m_PinnedObjects;
+    };
+
+    // Growable array backed by a FrameAllocator. Growing copies into a larger allocation of the same frame,
+    // the old storage is reclaimed by the next Reset.
+    template<typename T>
+    class FrameVector
+    {
+    public:
+        static_assert(std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>, "FrameVector only holds plain data!");
+
+        FrameVector() = default;
+        explicit FrameVector(FrameAllocator& allocator, uint32_t capacity = 0)
+            : m_Allocator(&allocator)
+        {
+            if (capacity > 0)
+                Reserve(capacity);
+        }
+
+        void PushBack(const T& value)
+        {
+            if (m_Size == m_Capacity)
+                Reserve(std::max<uint32_t>(m_Capacity * 2, 64));
+            m_Data[m_Size++] = value;
+        }
+
+        void Reserve(uint32_t capacity)
+        {
+            if (capacity <= m_Capacity)
+                return;
+
+            CZ_CORE_ASSERT(m_Allocator, "FrameVector has no allocator!");
+            T* data = m_Allocator->AllocateArray<T>(capacity);
+            if (m_Size > 0)
+                memcpy(data, m_Data, sizeof(T) * m_Size);
+            m_Data = data;
+            m_Capacity = capacity;
+        }
+
+        void Clear() { m_Size = 0; }
+
+        T* begin() { return m_Data; }
+        T* end() { return m_Data + m_Size; }
+        const T* begin() const { return m_Data; }
+        const T* end() const { return m_Data + m_Size; }
+
+        T& operator[](uint32_t index) { return m_Data[index]; }
+        const T& operator[](uint32_t index) const { return m_Data[index]; }
+
+        uint32_t Size() const { return m_Size; }
+        bool Empty() const { return m_Size == 0; }
+    private:
+        FrameAllocator* m_Allocator = nullptr;
+        T* m_Data = nullptr;
+        uint32_t m_Size = 0;
+        uint32_t m_Capacity = 0;
+    };
+}
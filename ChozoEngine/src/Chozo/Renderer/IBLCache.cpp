@@ -0,0 +1,75 @@
+#include "IBLCache.h"
+
+#include "Renderer.h"
+
+#include "Chozo/FileSystem/FileStream.h"
+#include "Chozo/Utilities/HashUtils.h"
+
+namespace Chozo {
+
+    namespace Utils {
+
+        // Bump when the layout of the baked data changes.
+        static constexpr uint32_t IBLCacheVersion = 1;
+
+        static fs::path GetIBLCachePath(const std::string& name, const uint64_t key)
+        {
+            const fs::path cacheDirectory = Utils::File::GetIBLCacheDirectory();
+            Utils::File::CreateDirectoryIfNeeded(cacheDirectory);
+
+            return cacheDirectory / (name + "." + Utils::Hash::ToHexString(key) + ".cache_ibl");
+        }
+    }
+
+    uint64_t IBLCache::GetKey(const uint64_t sourceHash)
+    {
+        const uint32_t layout[] = {
+            Utils::IBLCacheVersion,
+            Renderer::GetConfig().EnvironmentMapResolution,
+            Renderer::PrefilteredMapResolution,
+            Renderer::PrefilteredMapMipLevels,
+        };
+        return Utils::Hash::FNV1a(layout, sizeof(layout), sourceHash);
+    }
+
+    bool IBLCache::Load(const std::string& name, const uint64_t key, SharedBuffer& buffer)
+    {
+        FileStreamReader stream(Utils::GetIBLCachePath(name, key));
+        if (!stream.IsStreamGood())
+            return false;
+
+        const uint64_t fileSize = stream.GetFileSize();
+        if (fileSize <= sizeof(uint64_t))
+            return false;
+
+        uint64_t size;
+        stream.ReadRaw<uint64_t>(size);
+        if (size != fileSize - sizeof(uint64_t))
+        {
+            CZ_CORE_WARN("IBL cache file '{}' is truncated, baking again.", name);
+            return false;
+        }
+
+        buffer.Allocate(size);
+        if (!stream.ReadData(buffer.As<char>(), size))
+        {
+            buffer.Release();
+            return false;
+        }
+
+        return true;
+    }
+
+    void IBLCache::Save(const std::string& name, const uint64_t key, const Buffer& buffer)
+    {
+        if (!buffer)
+            return;
+
+        FileStreamWriter writer(Utils::GetIBLCachePath(name, key));
+        if (writer.IsStreamGood())
+        {
+            writer.WriteRaw<uint64_t>(buffer.Size);
+            writer.WriteData(buffer.As<char>(), buffer.Size);
+        }
+    }
+}
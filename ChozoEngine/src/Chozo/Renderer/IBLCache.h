@@ -0,0 +1,20 @@
+#pragma once
+
+#include "czpch.h"
+
+#include "Chozo/Core/Buffer.h"
+
+namespace Chozo {
+
+    // Baked image based lighting data on disk, one file per map and key. Keys hash the source
+    // together with everything that changes the bake, so a stale file is never read back.
+    class IBLCache
+    {
+    public:
+        // Mixes the environment map resolution and the prefiltered layout into sourceHash.
+        static uint64_t GetKey(uint64_t sourceHash);
+
+        static bool Load(const std::string& name, uint64_t key, SharedBuffer& buffer);
+        static void Save(const std::string& name, uint64_t key, const Buffer& buffer);
+    };
+}
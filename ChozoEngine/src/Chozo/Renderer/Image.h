@@ -27,6 +27,12 @@ namespace Chozo
         RED_INTEGER,
 		B10R11G11UF,
 		SRGB,
+		RG16, // Appended, texture metadata stores the formats by value
+		RGB9E5,
+		BC1, // Block compressed, 4x4 pixel blocks, see TextureCompressor
+		BC3,
+		BC5,
+		BC7,
 
 		// Depth/Stencil
 		DEPTH32FSTENCIL8UINT,
@@ -66,6 +72,43 @@ namespace Chozo
 			return false;
 		}
 
+		// Float formats textures loaded from .hdr files are stored in.
+		static bool IsHDRFormat(ImageFormat format)
+		{
+			switch (format)
+			{
+				case ImageFormat::RGBA32F: return true;
+				case ImageFormat::RGBA16F: return true;
+				case ImageFormat::RGB9E5: return true;
+				default: return false;
+			}
+		}
+
+		static bool IsCompressedFormat(ImageFormat format)
+		{
+			switch (format)
+			{
+				case ImageFormat::BC1: return true;
+				case ImageFormat::BC3: return true;
+				case ImageFormat::BC5: return true;
+				case ImageFormat::BC7: return true;
+				default: return false;
+			}
+		}
+
+		// Bytes of one 4x4 block of a compressed format.
+		static uint32_t GetBlockSize(ImageFormat format)
+		{
+			switch (format)
+			{
+				case ImageFormat::BC1: return 8;
+				case ImageFormat::BC3: return 16;
+				case ImageFormat::BC5: return 16;
+				case ImageFormat::BC7: return 16;
+				default: return 0;
+			}
+		}
+
 		static uint32_t GetBytesPerPixel(ImageFormat format)
 		{
 			switch (format)
@@ -79,6 +122,7 @@ namespace Chozo
 				case ImageFormat::RED32UI:        return 4;
 				case ImageFormat::RED32F:         return 4;
 				case ImageFormat::RG8:            return 2;
+				case ImageFormat::RG16:           return 4;  // 16-bit normalized, 2 components (RG) = 2 * 2
 				case ImageFormat::RG16F:          return 4;  // 16-bit float, 2 components (RG) = 2 * 2
 				case ImageFormat::RG32F:          return 8;  // 32-bit float, 2 components (RG) = 2 * 4
 				case ImageFormat::RGB:            return 3;  // 8-bit per component, 3 components
@@ -92,11 +136,43 @@ namespace Chozo
 				case ImageFormat::RED_INTEGER:    return 4;  // Assuming 32-bit integer
 				case ImageFormat::B10R11G11UF:    return 4;  // 10-bit R, 11-bit G, 11-bit B packed into 4 bytes
 				case ImageFormat::SRGB:           return 3;  // SRGB, typically 8-bit per channel, 3 components
+				case ImageFormat::RGB9E5:         return 4;  // 9-bit mantissa per component, 5-bit shared exponent
+				case ImageFormat::BC1:            return 0;  // Block compressed, see GetImageSize
+				case ImageFormat::BC3:            return 0;
+				case ImageFormat::BC5:            return 0;
+				case ImageFormat::BC7:            return 0;
 				case ImageFormat::DEPTH32FSTENCIL8UINT: return 5; // 32-bit float depth + 8-bit stencil = 4 + 1 bytes
 				case ImageFormat::DEPTH32F:       return 4;  // 32-bit float for depth
 				case ImageFormat::DEPTH24STENCIL8:return 4;  // 24-bit depth + 8-bit stencil packed into 4 bytes
 			}
 			return 0;
 		}
+
+		// Size of a width x height image, compressed formats are stored in whole blocks.
+		static uint64_t GetImageSize(ImageFormat format, uint32_t width, uint32_t height)
+		{
+			if (IsCompressedFormat(format))
+				return (uint64_t)((width + 3) / 4) * ((height + 3) / 4) * GetBlockSize(format);
+
+			return (uint64_t)width * height * GetBytesPerPixel(format);
+		}
+
+		// Levels of a full chain down to 1x1.
+		static uint32_t GetMipLevelCount(uint32_t width, uint32_t height)
+		{
+			uint32_t levels = 1;
+			while (std::max(width, height) >> levels)
+				levels++;
+			return levels;
+		}
+
+		// Bytes of the first levelCount levels stored one after the other, the offset of level levelCount.
+		static uint64_t GetMipChainSize(ImageFormat format, uint32_t width, uint32_t height, uint32_t levelCount)
+		{
+			uint64_t size = 0;
+			for (uint32_t level = 0; level < levelCount; level++)
+				size += GetImageSize(format, std::max(width >> level, 1u), std::max(height >> level, 1u));
+			return size;
+		}
 	}
 }
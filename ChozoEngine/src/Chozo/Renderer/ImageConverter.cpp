@@ -0,0 +1,276 @@
+#include "ImageConverter.h"
+
+#include <cmath>
+#include <cstring>
+
+// The F16C paths are compiled for that target alone and only taken when the CPU reports it.
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+    #include <cpuid.h>
+    #include <immintrin.h>
+    #define CZ_HALF_F16C
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    #include <arm_neon.h>
+    #define CZ_HALF_NEON
+#endif
+
+namespace Chozo {
+
+    namespace Utils {
+
+        // EXT_texture_shared_exponent: 9 mantissa bits per channel, exponent bias 15, at most 31.
+        static constexpr int RGB9E5MantissaBits = 9;
+        static constexpr int RGB9E5ExponentBias = 15;
+        static constexpr int RGB9E5MaxExponent = 31;
+        static constexpr float RGB9E5MaxValue = (float)((1 << RGB9E5MantissaBits) - 1) / (float)(1 << RGB9E5MantissaBits)
+            * (float)(1 << (RGB9E5MaxExponent - RGB9E5ExponentBias));
+
+        static uint32_t FloatBits(const float value)
+        {
+            uint32_t bits;
+            memcpy(&bits, &value, sizeof(bits));
+            return bits;
+        }
+
+        static float BitsToFloat(const uint32_t bits)
+        {
+            float value;
+            memcpy(&value, &bits, sizeof(value));
+            return value;
+        }
+
+#if defined(CZ_HALF_F16C)
+        // AVX for the 256-bit loads and stores, which also needs the OS to save the YMM registers.
+        static bool HasF16C()
+        {
+            static const bool supported = []() {
+                unsigned int eax, ebx, ecx, edx;
+                if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+                    return false;
+                if (!(ecx & bit_OSXSAVE) || !(ecx & bit_AVX) || !(ecx & bit_F16C))
+                    return false;
+
+                uint32_t xcr0, xcr0High;
+                __asm__("xgetbv" : "=a"(xcr0), "=d"(xcr0High) : "c"(0));
+                return (xcr0 & 0x6u) == 0x6u;
+            }();
+            return supported;
+        }
+
+        // Both convert whole groups of 8 and return how many values they did.
+        __attribute__((target("avx,f16c")))
+        static uint64_t FloatToHalfF16C(const float* source, uint16_t* destination, const uint64_t count)
+        {
+            uint64_t i = 0;
+            for (; i + 8 <= count; i += 8)
+            {
+                const __m256 values = _mm256_loadu_ps(source + i);
+                _mm_storeu_si128((__m128i*)(destination + i), _mm256_cvtps_ph(values, _MM_FROUND_TO_NEAREST_INT));
+            }
+            return i;
+        }
+
+        __attribute__((target("avx,f16c")))
+        static uint64_t HalfToFloatF16C(const uint16_t* source, float* destination, const uint64_t count)
+        {
+            uint64_t i = 0;
+            for (; i + 8 <= count; i += 8)
+                _mm256_storeu_ps(destination + i, _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*)(source + i))));
+            return i;
+        }
+#endif
+    }
+
+    uint16_t ImageConverter::FloatToHalf(const float value)
+    {
+        // Round to nearest even, overflow goes to infinity and NaN stays NaN.
+        const uint32_t bits = Utils::FloatBits(value);
+        const uint32_t sign = (bits >> 16) & 0x8000u;
+        const uint32_t absolute = bits & 0x7fffffffu;
+
+        if (absolute >= 0x7f800000u)
+            return (uint16_t)(sign | 0x7c00u | (absolute > 0x7f800000u ? 0x200u : 0u));
+        if (absolute >= 0x477ff000u)
+            return (uint16_t)(sign | 0x7c00u);
+
+        if (absolute < 0x38800000u)
+        {
+            // Subnormal half, adding 0.5 lets the float hardware do the rounding.
+            const float subnormal = Utils::BitsToFloat(absolute) + 0.5f;
+            return (uint16_t)(sign | (Utils::FloatBits(subnormal) - Utils::FloatBits(0.5f)));
+        }
+
+        const uint32_t mantissaOdd = (absolute >> 13) & 1u;
+        const uint32_t rounded = absolute + 0xc8000fffu + mantissaOdd;
+        return (uint16_t)(sign | (rounded >> 13));
+    }
+
+    float ImageConverter::HalfToFloat(const uint16_t value)
+    {
+        const uint32_t sign = (uint32_t)(value & 0x8000u) << 16;
+        const uint32_t exponent = (value >> 10) & 0x1fu;
+        const uint32_t mantissa = value & 0x3ffu;
+
+        if (exponent == 0)
+        {
+            // Zero or subnormal, mantissa * 2^-24.
+            const float magnitude = (float)mantissa * 5.9604644775390625e-8f;
+            return Utils::BitsToFloat(sign | Utils::FloatBits(magnitude));
+        }
+        if (exponent == 31)
+            return Utils::BitsToFloat(sign | 0x7f800000u | (mantissa << 13));
+
+        return Utils::BitsToFloat(sign | ((exponent + 112) << 23) | (mantissa << 13));
+    }
+
+    void ImageConverter::FloatToHalf(const float* source, uint16_t* destination, const uint64_t count)
+    {
+        uint64_t i = 0;
+#if defined(CZ_HALF_F16C)
+        if (Utils::HasF16C())
+            i = Utils::FloatToHalfF16C(source, destination, count);
+#elif defined(CZ_HALF_NEON)
+        for (; i + 4 <= count; i += 4)
+            vst1_u16(destination + i, vreinterpret_u16_f16(vcvt_f16_f32(vld1q_f32(source + i))));
+#endif
+        for (; i < count; i++)
+            destination[i] = FloatToHalf(source[i]);
+    }
+
+    void ImageConverter::HalfToFloat(const uint16_t* source, float* destination, const uint64_t count)
+    {
+        uint64_t i = 0;
+#if defined(CZ_HALF_F16C)
+        if (Utils::HasF16C())
+            i = Utils::HalfToFloatF16C(source, destination, count);
+#elif defined(CZ_HALF_NEON)
+        for (; i + 4 <= count; i += 4)
+            vst1q_f32(destination + i, vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(source + i))));
+#endif
+        for (; i < count; i++)
+            destination[i] = HalfToFloat(source[i]);
+    }
+
+    uint32_t ImageConverter::PackRGB9E5(const glm::vec3& color)
+    {
+        using namespace Utils;
+
+        // NaN fails both comparisons and ends up as zero.
+        const glm::vec3 c = glm::vec3(
+            color.r > 0.0f ? std::min(color.r, RGB9E5MaxValue) : 0.0f,
+            color.g > 0.0f ? std::min(color.g, RGB9E5MaxValue) : 0.0f,
+            color.b > 0.0f ? std::min(color.b, RGB9E5MaxValue) : 0.0f);
+        const float maxChannel = std::max(c.r, std::max(c.g, c.b));
+        if (maxChannel <= 0.0f)
+            return 0;
+
+        int exponent = std::max(-RGB9E5ExponentBias - 1, (int)std::floor(std::log2(maxChannel))) + 1 + RGB9E5ExponentBias;
+        float scale = std::ldexp(1.0f, RGB9E5ExponentBias + RGB9E5MantissaBits - exponent);
+        // Rounding the largest channel up may need one more exponent step.
+        if ((int)std::floor(maxChannel * scale + 0.5f) == (1 << RGB9E5MantissaBits))
+        {
+            exponent++;
+            scale *= 0.5f;
+        }
+
+        const auto r = (uint32_t)std::floor(c.r * scale + 0.5f);
+        const auto g = (uint32_t)std::floor(c.g * scale + 0.5f);
+        const auto b = (uint32_t)std::floor(c.b * scale + 0.5f);
+        return r | (g << 9) | (b << 18) | ((uint32_t)exponent << 27);
+    }
+
+    glm::vec3 ImageConverter::UnpackRGB9E5(const uint32_t packed)
+    {
+        using namespace Utils;
+
+        const int exponent = (int)(packed >> 27);
+        const float scale = std::ldexp(1.0f, exponent - RGB9E5ExponentBias - RGB9E5MantissaBits);
+        return glm::vec3((float)(packed & 0x1ffu), (float)((packed >> 9) & 0x1ffu), (float)((packed >> 18) & 0x1ffu)) * scale;
+    }
+
+    glm::vec4 ImageConverter::ReadPixel(const void* pixels, const uint64_t index, const ImageFormat format)
+    {
+        switch (format)
+        {
+            case ImageFormat::RGBA32F:
+            {
+                const float* texel = static_cast<const float*>(pixels) + index * 4;
+                return { texel[0], texel[1], texel[2], texel[3] };
+            }
+            case ImageFormat::RGBA16F:
+            {
+                const uint16_t* texel = static_cast<const uint16_t*>(pixels) + index * 4;
+                return { HalfToFloat(texel[0]), HalfToFloat(texel[1]), HalfToFloat(texel[2]), HalfToFloat(texel[3]) };
+            }
+            case ImageFormat::RGB9E5:
+                return glm::vec4(UnpackRGB9E5(static_cast<const uint32_t*>(pixels)[index]), 1.0f);
+            default:
+                CZ_CORE_ASSERT(false, "Not an HDR format!");
+                return glm::vec4(0.0f);
+        }
+    }
+
+    Buffer ImageConverter::FromRGBA32F(const float* pixels, const uint64_t pixelCount, const ImageFormat format)
+    {
+        Buffer buffer;
+        buffer.Allocate(pixelCount * Image::GetBytesPerPixel(format));
+
+        switch (format)
+        {
+            case ImageFormat::RGBA32F:
+                memcpy(buffer.Data, pixels, buffer.Size);
+                break;
+            case ImageFormat::RGBA16F:
+                FloatToHalf(pixels, buffer.As<uint16_t>(), pixelCount * 4);
+                break;
+            case ImageFormat::RGB9E5:
+            {
+                auto* packed = buffer.As<uint32_t>();
+                for (uint64_t i = 0; i < pixelCount; i++)
+                    packed[i] = PackRGB9E5(glm::vec3(pixels[i * 4], pixels[i * 4 + 1], pixels[i * 4 + 2]));
+                break;
+            }
+            default:
+                CZ_CORE_ASSERT(false, "Not an HDR format!");
+                buffer.Release();
+                break;
+        }
+
+        return buffer;
+    }
+
+    Buffer ImageConverter::ToRGBA32F(const void* pixels, const uint64_t pixelCount, const ImageFormat format)
+    {
+        Buffer buffer;
+        buffer.Allocate(pixelCount * 4 * sizeof(float));
+        auto* destination = buffer.As<float>();
+
+        switch (format)
+        {
+            case ImageFormat::RGBA32F:
+                memcpy(destination, pixels, buffer.Size);
+                break;
+            case ImageFormat::RGBA16F:
+                HalfToFloat(static_cast<const uint16_t*>(pixels), destination, pixelCount * 4);
+                break;
+            case ImageFormat::RGB9E5:
+            {
+                const auto* packed = static_cast<const uint32_t*>(pixels);
+                for (uint64_t i = 0; i < pixelCount; i++)
+                {
+                    const glm::vec3 color = UnpackRGB9E5(packed[i]);
+                    destination[i * 4] = color.r;
+                    destination[i * 4 + 1] = color.g;
+                    destination[i * 4 + 2] = color.b;
+                    destination[i * 4 + 3] = 1.0f;
+                }
+                break;
+            }
+            default:
+                CZ_CORE_ASSERT(false, "Not an HDR format!");
+                buffer.Release();
+                break;
+        }
+
+        return buffer;
+    }
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "czpch.h"
+
+#include "Image.h"
+#include "Chozo/Core/Buffer.h"
+
+#include <glm/glm.hpp>
+
+namespace Chozo {
+
+    // Conversions between RGBA32F pixels and the compact HDR formats, RGBA16F and RGB9E5.
+    class ImageConverter
+    {
+    public:
+        // Packs RGBA32F pixels into format, the alpha channel is dropped by RGB9E5.
+        // The returned buffer is owned by the caller.
+        static Buffer FromRGBA32F(const float* pixels, uint64_t pixelCount, ImageFormat format);
+        // Unpacks any HDR format (see Image::IsHDRFormat) into RGBA32F, alpha is 1 where the format has none.
+        static Buffer ToRGBA32F(const void* pixels, uint64_t pixelCount, ImageFormat format);
+
+        // Batches of floats, F16C when the CPU has it, NEON on arm64.
+        static void FloatToHalf(const float* source, uint16_t* destination, uint64_t count);
+        static void HalfToFloat(const uint16_t* source, float* destination, uint64_t count);
+
+        static uint16_t FloatToHalf(float value);
+        static float HalfToFloat(uint16_t value);
+        static uint32_t PackRGB9E5(const glm::vec3& color);
+        static glm::vec3 UnpackRGB9E5(uint32_t packed);
+
+        // Color of a single pixel of an HDR format.
+        static glm::vec4 ReadPixel(const void* pixels, uint64_t index, ImageFormat format);
+    };
+}
@@ -5,12 +5,12 @@
 
 namespace Chozo {
 
-    Ref<IndexBuffer> IndexBuffer::Create(void *indices, uint32_t count)
+    Ref<IndexBuffer> IndexBuffer::Create(void *indices, uint32_t count, IndexFormat format)
     {
         switch (RenderCommand::GetType())
         {
             case RenderAPI::Type::None:     CZ_CORE_ASSERT(false, "RenderAPI::None is currently not supported!"); return nullptr;
-            case RenderAPI::Type::OpenGL:   return Ref<OpenGLIndexBuffer>::Create(indices, count);
+            case RenderAPI::Type::OpenGL:   return Ref<OpenGLIndexBuffer>::Create(indices, count, format);
         }
 
         CZ_CORE_ASSERT(false, "Unknown RenderAPI!");
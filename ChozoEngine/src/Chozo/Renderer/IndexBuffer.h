@@ -5,6 +5,16 @@
 #include "RendererTypes.h"
 namespace Chozo {
 
+    enum class IndexFormat : uint8_t
+    {
+        UInt32 = 0, UInt16
+    };
+
+    static uint32_t IndexFormatSize(IndexFormat format)
+    {
+        return format == IndexFormat::UInt16 ? 2 : 4;
+    }
+
     class IndexBuffer : public RefCounted
     {
     public:
@@ -18,8 +28,9 @@ namespace Chozo {
         virtual void Unbind() const = 0;
 
         virtual uint32_t GetCount() const = 0;
+        virtual IndexFormat GetFormat() const = 0;
         virtual const RendererID GetRendererID() const = 0;
 
-        static Ref<IndexBuffer> Create(void* indices, uint32_t count);
+        static Ref<IndexBuffer> Create(void* indices, uint32_t count, IndexFormat format = IndexFormat::UInt32);
     };
 }
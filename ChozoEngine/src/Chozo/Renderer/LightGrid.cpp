@@ -0,0 +1,269 @@
+#include "LightGrid.h"
+
+#include "Chozo/Core/Pool.h"
+
+#include <cmath>
+#include <limits>
+
+namespace Chozo {
+
+    namespace Utils {
+
+        // Below this many lights the slices are culled on the calling thread, waking the workers costs more.
+        static constexpr uint32_t LightGridParallelThreshold = 64;
+
+        static glm::uvec2 GetSliceRange(const float depth, const float radius, const float nearClip, const float farClip, const float scale, const float bias)
+        {
+            const float minDepth = std::max(depth - radius, nearClip);
+            const float maxDepth = std::min(depth + radius, farClip);
+            const auto toSlice = [&](const float d) {
+                return (uint32_t)glm::clamp(std::log(d) * scale + bias, 0.0f, (float)(LightGrid::SliceCount - 1));
+            };
+            return { toSlice(minDepth), toSlice(maxDepth) };
+        }
+
+        // Squared distance from four spheres to the box, compared against their squared radii.
+        static glm::bvec4 SpheresIntersectBox(const glm::vec4& x, const glm::vec4& y, const glm::vec4& z, const glm::vec4& radiusSq, const glm::vec3& min, const glm::vec3& max)
+        {
+            const glm::vec4 dx = glm::max(glm::vec4(min.x) - x, 0.0f) + glm::max(x - glm::vec4(max.x), 0.0f);
+            const glm::vec4 dy = glm::max(glm::vec4(min.y) - y, 0.0f) + glm::max(y - glm::vec4(max.y), 0.0f);
+            const glm::vec4 dz = glm::max(glm::vec4(min.z) - z, 0.0f) + glm::max(z - glm::vec4(max.z), 0.0f);
+            return glm::lessThanEqual(dx * dx + dy * dy + dz * dz, radiusSq);
+        }
+    }
+
+    void LightGrid::Build(const glm::mat4& view, const glm::mat4& projection, const float nearClip, const float farClip,
+        const PointLightBounds* pointLights, const uint32_t pointLightCount,
+        const SpotLightBounds* spotLights, const uint32_t spotLightCount)
+    {
+        if (projection != m_Projection || nearClip != m_NearClip || farClip != m_FarClip)
+            UpdateClusterBounds(projection, nearClip, farClip);
+
+        m_PointLights.resize(pointLightCount);
+        m_PointLightSlices.resize(pointLightCount);
+        for (uint32_t i = 0; i < pointLightCount; i++)
+        {
+            auto& light = m_PointLights[i];
+            light.Position = glm::vec3(view * glm::vec4(pointLights[i].Position, 1.0f));
+            light.Radius = pointLights[i].Radius;
+
+            const float depth = -light.Position.z;
+            m_PointLightSlices[i] = depth + light.Radius < m_NearClip || depth - light.Radius > m_FarClip
+                ? glm::uvec2(1, 0) // Outside the depth range, overlaps no slice.
+                : Utils::GetSliceRange(depth, light.Radius, m_NearClip, m_FarClip, m_SliceScale, m_SliceBias);
+        }
+
+        m_SpotLights.resize(spotLightCount);
+        m_SpotLightSlices.resize(spotLightCount);
+        for (uint32_t i = 0; i < spotLightCount; i++)
+        {
+            auto& light = m_SpotLights[i];
+            light.Position = glm::vec3(view * glm::vec4(spotLights[i].Position, 1.0f));
+            light.Radius = spotLights[i].Radius;
+            light.Direction = glm::normalize(glm::mat3(view) * spotLights[i].Direction);
+            light.Angle = spotLights[i].Angle;
+
+            const float depth = -light.Position.z;
+            m_SpotLightSlices[i] = depth + light.Radius < m_NearClip || depth - light.Radius > m_FarClip
+                ? glm::uvec2(1, 0) // Outside the depth range, overlaps no slice.
+                : Utils::GetSliceRange(depth, light.Radius, m_NearClip, m_FarClip, m_SliceScale, m_SliceBias);
+        }
+
+        if (pointLightCount + spotLightCount < Utils::LightGridParallelThreshold)
+        {
+            for (uint32_t slice = 0; slice < SliceCount; slice++)
+                CullSlice(slice);
+        }
+        else
+        {
+            Pool::ParallelFor(SliceCount, [this](const uint32_t slice) { CullSlice(slice); });
+        }
+
+        uint32_t indexCount = 0;
+        for (const auto& slice : m_Slices)
+            indexCount += (uint32_t)slice.Indices.size();
+
+        m_Data.resize(ClusterCount * 2 + indexCount);
+        uint32_t offset = ClusterCount * 2;
+        for (uint32_t slice = 0; slice < SliceCount; slice++)
+        {
+            const auto& result = m_Slices[slice];
+            uint32_t* headers = m_Data.data() + slice * TileCount * 2;
+            for (uint32_t tile = 0; tile < TileCount; tile++)
+            {
+                headers[tile * 2] = result.Headers[tile * 2] + offset;
+                headers[tile * 2 + 1] = result.Headers[tile * 2 + 1];
+            }
+
+            std::copy(result.Indices.begin(), result.Indices.end(), m_Data.begin() + offset);
+            offset += (uint32_t)result.Indices.size();
+        }
+    }
+
+    void LightGrid::UpdateClusterBounds(const glm::mat4& projection, const float nearClip, const float farClip)
+    {
+        m_Projection = projection;
+        m_NearClip = nearClip;
+        m_FarClip = farClip;
+
+        const float logRatio = std::log(farClip / nearClip);
+        m_SliceScale = (float)SliceCount / logRatio;
+        m_SliceBias = -(float)SliceCount * std::log(nearClip) / logRatio;
+
+        // Corners of the tiles on the near plane, the cluster corners lie on the rays through them.
+        const glm::mat4 inverseProjection = glm::inverse(projection);
+        std::vector<glm::vec3> corners((TileCountX + 1) * (TileCountY + 1));
+        for (uint32_t y = 0; y <= TileCountY; y++)
+        {
+            for (uint32_t x = 0; x <= TileCountX; x++)
+            {
+                const glm::vec2 ndc = glm::vec2(x, y) / glm::vec2(TileCountX, TileCountY) * 2.0f - 1.0f;
+                const glm::vec4 corner = inverseProjection * glm::vec4(ndc, -1.0f, 1.0f);
+                corners[y * (TileCountX + 1) + x] = glm::vec3(corner) / corner.w;
+            }
+        }
+
+        m_ClusterBounds.resize(ClusterCount);
+        for (uint32_t slice = 0; slice < SliceCount; slice++)
+        {
+            const float sliceNear = nearClip * std::pow(farClip / nearClip, (float)slice / SliceCount);
+            const float sliceFar = nearClip * std::pow(farClip / nearClip, (float)(slice + 1) / SliceCount);
+
+            for (uint32_t y = 0; y < TileCountY; y++)
+            {
+                for (uint32_t x = 0; x < TileCountX; x++)
+                {
+                    glm::vec3 min(std::numeric_limits<float>::max());
+                    glm::vec3 max(std::numeric_limits<float>::lowest());
+                    for (uint32_t i = 0; i < 4; i++)
+                    {
+                        const glm::vec3& corner = corners[(y + i / 2) * (TileCountX + 1) + x + i % 2];
+                        for (const float depth : { sliceNear, sliceFar })
+                        {
+                            const glm::vec3 point = corner * (depth / -corner.z);
+                            min = glm::min(min, point);
+                            max = glm::max(max, point);
+                        }
+                    }
+
+                    auto& bounds = m_ClusterBounds[slice * TileCount + y * TileCountX + x];
+                    bounds.Min = min;
+                    bounds.Max = max;
+                    bounds.Center = (min + max) * 0.5f;
+                    bounds.Radius = glm::length(max - min) * 0.5f;
+                }
+            }
+        }
+    }
+
+    void LightGrid::CullSlice(const uint32_t slice)
+    {
+        auto& result = m_Slices[slice];
+
+        // Gather the lights reaching into this slice into groups of four.
+        result.PointGroups.clear();
+        for (uint32_t i = 0, lane = 4; i < (uint32_t)m_PointLights.size(); i++)
+        {
+            if (slice < m_PointLightSlices[i].x || slice > m_PointLightSlices[i].y)
+                continue;
+
+            if (lane == 4)
+            {
+                result.PointGroups.push_back({ glm::vec4(0.0f), glm::vec4(0.0f), glm::vec4(0.0f), glm::vec4(-1.0f), {} });
+                lane = 0;
+            }
+
+            const auto& light = m_PointLights[i];
+            auto& group = result.PointGroups.back();
+            group.X[lane] = light.Position.x;
+            group.Y[lane] = light.Position.y;
+            group.Z[lane] = light.Position.z;
+            group.RadiusSq[lane] = light.Radius * light.Radius;
+            group.Index[lane] = i;
+            lane++;
+        }
+
+        result.SpotGroups.clear();
+        for (uint32_t i = 0, lane = 4; i < (uint32_t)m_SpotLights.size(); i++)
+        {
+            if (slice < m_SpotLightSlices[i].x || slice > m_SpotLightSlices[i].y)
+                continue;
+
+            if (lane == 4)
+            {
+                SpotLightGroup group{};
+                group.RadiusSq = glm::vec4(-1.0f);
+                result.SpotGroups.push_back(group);
+                lane = 0;
+            }
+
+            const auto& light = m_SpotLights[i];
+            auto& group = result.SpotGroups.back();
+            group.X[lane] = light.Position.x;
+            group.Y[lane] = light.Position.y;
+            group.Z[lane] = light.Position.z;
+            group.RadiusSq[lane] = light.Radius * light.Radius;
+            group.DirX[lane] = light.Direction.x;
+            group.DirY[lane] = light.Direction.y;
+            group.DirZ[lane] = light.Direction.z;
+            group.CosAngle[lane] = std::cos(light.Angle);
+            group.SinAngle[lane] = std::sin(light.Angle);
+            group.Range[lane] = light.Radius;
+            group.Index[lane] = i;
+            lane++;
+        }
+
+        result.Indices.clear();
+        for (uint32_t tile = 0; tile < TileCount; tile++)
+        {
+            const auto& bounds = m_ClusterBounds[slice * TileCount + tile];
+            const uint32_t offset = (uint32_t)result.Indices.size();
+
+            uint32_t pointCount = 0;
+            for (const auto& group : result.PointGroups)
+            {
+                const glm::bvec4 hit = Utils::SpheresIntersectBox(group.X, group.Y, group.Z, group.RadiusSq, bounds.Min, bounds.Max);
+                for (uint32_t lane = 0; lane < 4; lane++)
+                {
+                    if (hit[lane])
+                    {
+                        result.Indices.push_back(group.Index[lane]);
+                        pointCount++;
+                    }
+                }
+            }
+
+            uint32_t spotCount = 0;
+            for (const auto& group : result.SpotGroups)
+            {
+                glm::bvec4 hit = Utils::SpheresIntersectBox(group.X, group.Y, group.Z, group.RadiusSq, bounds.Min, bounds.Max);
+                if (!glm::any(hit))
+                    continue;
+
+                // Cone against the bounding sphere of the cluster (Wronski, "Cull that cone").
+                const glm::vec4 vx = glm::vec4(bounds.Center.x) - group.X;
+                const glm::vec4 vy = glm::vec4(bounds.Center.y) - group.Y;
+                const glm::vec4 vz = glm::vec4(bounds.Center.z) - group.Z;
+                const glm::vec4 lengthSq = vx * vx + vy * vy + vz * vz;
+                const glm::vec4 axial = vx * group.DirX + vy * group.DirY + vz * group.DirZ;
+                const glm::vec4 closest = group.CosAngle * glm::sqrt(glm::max(lengthSq - axial * axial, 0.0f)) - axial * group.SinAngle;
+                const glm::vec4 radius(bounds.Radius);
+
+                const glm::bvec4 angleCull = glm::greaterThan(closest, radius);
+                const glm::bvec4 frontCull = glm::greaterThan(axial, radius + group.Range);
+                const glm::bvec4 backCull = glm::lessThan(axial, -radius);
+                for (uint32_t lane = 0; lane < 4; lane++)
+                {
+                    if (hit[lane] && !angleCull[lane] && !frontCull[lane] && !backCull[lane])
+                    {
+                        result.Indices.push_back(group.Index[lane]);
+                        spotCount++;
+                    }
+                }
+            }
+
+            result.Headers[tile * 2] = offset;
+            result.Headers[tile * 2 + 1] = pointCount | (spotCount << 16);
+        }
+    }
+}
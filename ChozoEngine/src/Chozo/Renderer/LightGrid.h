@@ -0,0 +1,95 @@
+#pragma once
+
+#include "czpch.h"
+
+#include <glm/glm.hpp>
+
+namespace Chozo {
+
+    // Clustered light grid, the view frustum is split into screen tiles and exponential depth slices (froxels).
+    // Each cluster lists the point and spot lights whose bounds reach into it, shading only visits those.
+    class LightGrid
+    {
+    public:
+        static constexpr uint32_t TileCountX = 16;
+        static constexpr uint32_t TileCountY = 9;
+        static constexpr uint32_t SliceCount = 24;
+        static constexpr uint32_t TileCount = TileCountX * TileCountY;
+        static constexpr uint32_t ClusterCount = TileCount * SliceCount;
+
+        struct PointLightBounds
+        {
+            glm::vec3 Position;
+            float Radius;
+        };
+
+        struct SpotLightBounds
+        {
+            glm::vec3 Position;
+            float Radius;
+            glm::vec3 Direction;
+            float Angle; // Outer half angle in radians.
+        };
+
+        // Positions and directions are in world space, indices in the grid refer to the order of the arrays.
+        // Slices are culled on worker threads once there are enough lights to pay for them.
+        void Build(const glm::mat4& view, const glm::mat4& projection, float nearClip, float farClip,
+            const PointLightBounds* pointLights, uint32_t pointLightCount,
+            const SpotLightBounds* spotLights, uint32_t spotLightCount);
+
+        // ClusterCount pairs of (offset, pointCount | spotCount << 16) followed by the light index lists.
+        // Offsets are in words from the start, a cluster's point indices come first, then its spot indices.
+        const std::vector<uint32_t>& GetData() const { return m_Data; }
+
+        // slice = log(viewDepth) * SliceScale + SliceBias
+        float GetSliceScale() const { return m_SliceScale; }
+        float GetSliceBias() const { return m_SliceBias; }
+    private:
+        struct ClusterBounds
+        {
+            glm::vec3 Min;
+            glm::vec3 Max;
+            glm::vec3 Center;
+            float Radius;
+        };
+
+        // Four lights per group in structure of arrays layout, so one test covers a group. Unused lanes never hit.
+        struct PointLightGroup
+        {
+            glm::vec4 X, Y, Z, RadiusSq;
+            uint32_t Index[4];
+        };
+
+        struct SpotLightGroup
+        {
+            glm::vec4 X, Y, Z, RadiusSq;
+            glm::vec4 DirX, DirY, DirZ;
+            glm::vec4 CosAngle, SinAngle, Range;
+            uint32_t Index[4];
+        };
+
+        struct SliceResult
+        {
+            std::vector<PointLightGroup> PointGroups;
+            std::vector<SpotLightGroup> SpotGroups;
+            uint32_t Headers[TileCount * 2];
+            std::vector<uint32_t> Indices;
+        };
+
+        void UpdateClusterBounds(const glm::mat4& projection, float nearClip, float farClip);
+        void CullSlice(uint32_t slice);
+    private:
+        glm::mat4 m_Projection = glm::mat4(0.0f);
+        float m_NearClip = 0.0f, m_FarClip = 0.0f;
+        float m_SliceScale = 0.0f, m_SliceBias = 0.0f;
+        std::vector<ClusterBounds> m_ClusterBounds;
+
+        // View space lights of the current build with the slices they overlap.
+        std::vector<PointLightBounds> m_PointLights;
+        std::vector<SpotLightBounds> m_SpotLights;
+        std::vector<glm::uvec2> m_PointLightSlices, m_SpotLightSlices;
+
+        std::array<SliceResult, SliceCount> m_Slices;
+        std::vector<uint32_t> m_Data;
+    };
+}
@@ -1,6 +1,7 @@
 #include "Mesh.h"
 
 #include "Renderer.h"
+#include "MeshPacker.h"
 #include "Chozo/FileSystem/MeshImporter.h"
 
 #include "Chozo/Core/Application.h"
@@ -8,6 +9,30 @@
 namespace Chozo
 {
 
+    namespace Utils {
+
+        // From the ratio of the UV and object space areas, the 1/2 of both triangle areas cancels out.
+        static float ComputeUVDensity(const MeshBuffer& buffer, const Submesh& submesh)
+        {
+            double area = 0.0, uvArea = 0.0;
+            const size_t firstTriangle = submesh.BaseIndex / 3;
+            const size_t lastTriangle = std::min(firstTriangle + submesh.IndexCount / 3, buffer.Indexs.size());
+            for (size_t triangle = firstTriangle; triangle < lastTriangle; triangle++)
+            {
+                const Index& index = buffer.Indexs[triangle];
+                const Vertex& v0 = buffer.Vertexs[submesh.BaseVertex + index.V1];
+                const Vertex& v1 = buffer.Vertexs[submesh.BaseVertex + index.V2];
+                const Vertex& v2 = buffer.Vertexs[submesh.BaseVertex + index.V3];
+
+                area += glm::length(glm::cross(v1.Position - v0.Position, v2.Position - v0.Position));
+                const glm::vec2 uv1 = v1.TexCoord - v0.TexCoord, uv2 = v2.TexCoord - v0.TexCoord;
+                uvArea += std::abs(uv1.x * uv2.y - uv1.y * uv2.x);
+            }
+
+            return area > 0.0 ? (float)std::sqrt(uvArea / area) : 0.0f;
+        }
+    }
+
     //////////////////////////////////////////////////////////////////////////////////
 	// MeshSource
 	//////////////////////////////////////////////////////////////////////////////////
@@ -34,11 +59,36 @@ namespace Chozo
 
     void Mesh::Invalidate()
     {
-        if (!m_RenderSource)
-            m_RenderSource = Ref<RenderSource>::Create(GetMaxCount<Vertex>(), GetMaxCount<Index>());
-        
-        m_RenderSource->VBO->SetData(0, m_MeshSource->GetVertexs().size() * sizeof(Vertex), m_MeshSource->GetVertexs().data());
-        m_RenderSource->IBO->SetData(0, m_MeshSource->GetIndexs().size() * 3, m_MeshSource->GetIndexs().data());
+        const auto* buffer = m_MeshSource->GetBuffer();
+        VertexFormat vertexFormat = m_MeshSource->GetVertexFormat();
+        IndexFormat indexFormat = MeshPacker::ChooseIndexFormat(buffer->Indexs);
+
+        auto vertices = MeshPacker::PackVertices(buffer->Vertexs, m_MeshSource->GetSubmeshes(), vertexFormat);
+        auto indices = MeshPacker::PackIndices(buffer->Indexs, indexFormat);
+        auto positions = MeshPacker::PackPositions(vertices, vertexFormat);
+        MeshPacker::GetPositionTransform(m_MeshSource->GetSubmeshes(), vertexFormat, m_PositionOffset, m_PositionScale);
+
+        // Geometry edits that keep the vertex and index counts refill the buffers they already have.
+        const PackedLayout layout{ vertexFormat, indexFormat, (uint32_t)vertices.size(), (uint32_t)buffer->Indexs.size() * 3, (uint32_t)positions.size() };
+        if (m_RenderSource && layout == m_PackedLayout)
+        {
+            m_RenderSource->VBO->SetData(0, layout.VertexSize, vertices.data());
+            m_RenderSource->IBO->SetData(0, layout.IndexCount, indices.data());
+            m_RenderSource->PositionVBO->SetData(0, layout.PositionSize, positions.data());
+        }
+        else
+        {
+            m_RenderSource = Ref<RenderSource>::Create(vertices.data(), layout.VertexSize, MeshPacker::GetVertexLayout(vertexFormat),
+                indices.data(), layout.IndexCount, indexFormat);
+            m_RenderSource->CreatePositionStream(positions.data(), layout.PositionSize, MeshPacker::GetPositionLayout(vertexFormat));
+            m_PackedLayout = layout;
+        }
+
+        // Texture streaming picks mips from the texel density on screen.
+        const auto& submeshes = m_MeshSource->GetSubmeshes();
+        m_UVDensities.resize(submeshes.size());
+        for (size_t i = 0; i < submeshes.size(); i++)
+            m_UVDensities[i] = Utils::ComputeUVDensity(*buffer, submeshes[i]);
 
 		const auto& meshMaterials = m_MeshSource->GetMaterials();
         m_Materials = Ref<MaterialTable>::Create((uint32_t)meshMaterials.size());
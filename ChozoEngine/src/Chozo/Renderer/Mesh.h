@@ -33,6 +33,34 @@ namespace Chozo
 
     class Mesh;
 
+    struct SubmeshLOD
+    {
+        uint32_t BaseIndex;
+        uint32_t IndexCount;
+        float Error; // Simplification error relative to the submesh extent.
+    };
+
+    // A contiguous run of at most 64 vertices / 124 triangles of the submesh LOD 0 range.
+    struct Meshlet
+    {
+        uint32_t BaseIndex;
+        uint32_t IndexCount;
+
+        glm::vec3 Center;
+        float Radius;
+
+        // Every triangle faces away from viewers with dot(normalize(center - eye), ConeAxis) >= ConeCutoff.
+        // A cutoff of 1 means the normals are too spread out to be culled.
+        glm::vec3 ConeAxis;
+        float ConeCutoff;
+    };
+
+    struct IndexRange
+    {
+        uint32_t BaseIndex;
+        uint32_t IndexCount;
+    };
+
     class Submesh
 	{
 	public:
@@ -49,6 +77,15 @@ namespace Chozo
 		std::string NodeName, MeshName;
 		bool IsRigged = false;
 
+		// Simplified index ranges for LOD 1..n, LOD 0 is BaseIndex/IndexCount.
+		std::vector<SubmeshLOD> LODs;
+		// Partition of the LOD 0 range, in index buffer order.
+		std::vector<Meshlet> Meshlets;
+
+		uint32_t GetLODCount() const { return (uint32_t)LODs.size() + 1; }
+		uint32_t GetLODBaseIndex(uint32_t lod) const { return lod == 0 || lod > LODs.size() ? BaseIndex : LODs[lod - 1].BaseIndex; }
+		uint32_t GetLODIndexCount(uint32_t lod) const { return lod == 0 || lod > LODs.size() ? IndexCount : LODs[lod - 1].IndexCount; }
+
         static void Serialize(StreamWriter* serializer, const Submesh& instance)
 		{
 			serializer->WriteRaw(instance.BaseVertex);
@@ -62,6 +99,8 @@ namespace Chozo
 			serializer->WriteString(instance.NodeName);
 			serializer->WriteString(instance.MeshName);
 			serializer->WriteRaw(instance.IsRigged);
+			serializer->WriteArray(instance.LODs);
+			serializer->WriteArray(instance.Meshlets);
 		}
 
 		static void Deserialize(StreamReader* deserializer, Submesh& instance)
@@ -77,6 +116,8 @@ namespace Chozo
 			deserializer->ReadString(instance.NodeName);
 			deserializer->ReadString(instance.MeshName);
 			deserializer->ReadRaw(instance.IsRigged);
+			deserializer->ReadArray(instance.LODs);
+			deserializer->ReadArray(instance.Meshlets);
 		}
 	};
 
@@ -131,6 +172,9 @@ namespace Chozo
 
         inline MeshBuffer* GetBuffer() { return &m_Buffer; }
 
+        VertexFormat GetVertexFormat() const { return m_VertexFormat; }
+        void SetVertexFormat(VertexFormat format) { m_VertexFormat = format; }
+
         std::vector<Submesh>& GetSubmeshes() { return m_Submeshes; }
 		const std::vector<Submesh>& GetSubmeshes() const { return m_Submeshes; }
 
@@ -142,6 +186,7 @@ namespace Chozo
         MeshBuffer m_Buffer;
     private:
         AABB m_BoundingBox;
+        VertexFormat m_VertexFormat = VertexFormat::Compact;
 		std::vector<Submesh> m_Submeshes;
 		std::unordered_map<uint32_t, std::vector<Triangle>> m_TriangleCache;
 		std::vector<MeshNode> m_Nodes;
@@ -171,8 +216,14 @@ namespace Chozo
         Ref<VertexArray> GetVertexArray() const { return m_RenderSource->VAO; }
         Ref<VertexBuffer> GetVertexBuffer() const { return m_RenderSource->VBO; }
         Ref<IndexBuffer> GetIndexBuffer() const { return m_RenderSource->IBO; }
+        Ref<VertexArray> GetPositionVertexArray() const { return m_RenderSource->PositionVAO; }
 
         Ref<MeshSource> GetMeshSource() const { return m_MeshSource; }
+        // UV units per object space unit across the LOD 0 triangles of a submesh, 0 without UVs.
+        float GetUVDensity(const uint32_t submeshIndex) const { return submeshIndex < m_UVDensities.size() ? m_UVDensities[submeshIndex] : 0.0f; }
+        // See MeshPacker::GetPositionTransform, shared by every submesh.
+        const glm::vec3& GetPositionOffset() const { return m_PositionOffset; }
+        const glm::vec3& GetPositionScale() const { return m_PositionScale; }
 
         void SetMaterial(uint32_t submeshIndex, const AssetHandle handle)
         {
@@ -191,9 +242,26 @@ namespace Chozo
         	}
         }
     protected:
+        // What the render source's buffers were sized for.
+        struct PackedLayout
+        {
+            VertexFormat Vertex = VertexFormat::Compact;
+            IndexFormat Index = IndexFormat::UInt32;
+            uint32_t VertexSize = 0, IndexCount = 0, PositionSize = 0;
+
+            bool operator==(const PackedLayout& other) const
+            {
+                return Vertex == other.Vertex && Index == other.Index && VertexSize == other.VertexSize
+                    && IndexCount == other.IndexCount && PositionSize == other.PositionSize;
+            }
+        };
+
         Ref<MeshSource> m_MeshSource;
         Ref<RenderSource> m_RenderSource;
+        PackedLayout m_PackedLayout;
         Ref<MaterialTable> m_Materials;
+        std::vector<float> m_UVDensities;
+        glm::vec3 m_PositionOffset{ 0.0f }, m_PositionScale{ 1.0f };
     	std::vector<OnChangeFunc> m_OnChangeCbs;
     };
 
@@ -0,0 +1,710 @@
+#include "MeshOptimizer.h"
+
+#include <numeric>
+
+namespace Chozo {
+
+    namespace Utils {
+
+        constexpr uint32_t ForsythCacheSize = 32;
+        constexpr float ForsythCacheDecayPower = 1.5f;
+        constexpr float ForsythLastTriScore = 0.75f;
+        constexpr float ForsythValenceBoostScale = 2.0f;
+        constexpr float ForsythValenceBoostPower = 0.5f;
+
+        static float ForsythVertexScore(int cachePosition, uint32_t remainingValence)
+        {
+            // No triangle needs this vertex anymore.
+            if (remainingValence == 0)
+                return -1.0f;
+
+            float score = 0.0f;
+            if (cachePosition >= 0)
+            {
+                if (cachePosition < 3)
+                {
+                    // Used by the last triangle, a fixed score discourages using it again straight away.
+                    score = ForsythLastTriScore;
+                }
+                else
+                {
+                    const float scaler = 1.0f / (float)(ForsythCacheSize - 3);
+                    score = std::pow(1.0f - (float)(cachePosition - 3) * scaler, ForsythCacheDecayPower);
+                }
+            }
+
+            // Boost vertices with few triangles left so that lone triangles get picked up early.
+            score += ForsythValenceBoostScale * std::pow((float)remainingValence, -ForsythValenceBoostPower);
+            return score;
+        }
+
+        static glm::vec3 TriangleNormal(const std::vector<Vertex>& vertexs, const Index& index)
+        {
+            const glm::vec3& p0 = vertexs[index.V1].Position;
+            const glm::vec3& p1 = vertexs[index.V2].Position;
+            const glm::vec3& p2 = vertexs[index.V3].Position;
+            return glm::cross(p1 - p0, p2 - p0);
+        }
+
+        struct Quadric
+        {
+            double A2 = 0, B2 = 0, C2 = 0, D2 = 0;
+            double AB = 0, AC = 0, AD = 0, BC = 0, BD = 0, CD = 0;
+            double Weight = 0;
+
+            Quadric() = default;
+            Quadric(const glm::vec3& normal, const float distance, const float weight)
+            {
+                const double a = normal.x, b = normal.y, c = normal.z, d = distance;
+                A2 = a * a * weight; B2 = b * b * weight; C2 = c * c * weight; D2 = d * d * weight;
+                AB = a * b * weight; AC = a * c * weight; AD = a * d * weight;
+                BC = b * c * weight; BD = b * d * weight; CD = c * d * weight;
+                Weight = weight;
+            }
+
+            Quadric& operator+=(const Quadric& other)
+            {
+                A2 += other.A2; B2 += other.B2; C2 += other.C2; D2 += other.D2;
+                AB += other.AB; AC += other.AC; AD += other.AD;
+                BC += other.BC; BD += other.BD; CD += other.CD;
+                Weight += other.Weight;
+                return *this;
+            }
+
+            // Weighted squared distance of the point to all accumulated planes.
+            double Error(const glm::vec3& p) const
+            {
+                const double x = p.x, y = p.y, z = p.z;
+                const double r = A2 * x * x + B2 * y * y + C2 * z * z
+                    + 2.0 * (AB * x * y + AC * x * z + BC * y * z)
+                    + 2.0 * (AD * x + BD * y + CD * z)
+                    + D2;
+                return r > 0.0 ? r : 0.0;
+            }
+        };
+
+        static bool IsDegenerate(const Index& index)
+        {
+            return index.V1 == index.V2 || index.V2 == index.V3 || index.V1 == index.V3;
+        }
+    }
+
+    void MeshOptimizer::OptimizeSubmesh(std::vector<Vertex>& vertexs, std::vector<Index>& indexs)
+    {
+        if (indexs.empty() || vertexs.empty())
+            return;
+
+        OptimizeVertexCache(indexs, (uint32_t)vertexs.size());
+        OptimizeOverdraw(indexs, vertexs);
+        OptimizeVertexFetch(vertexs, indexs);
+    }
+
+    void MeshOptimizer::OptimizeVertexCache(std::vector<Index>& indexs, const uint32_t vertexCount)
+    {
+        const size_t triangleCount = indexs.size();
+        if (triangleCount == 0)
+            return;
+
+        // Vertex -> triangle adjacency, stored as one flat array.
+        std::vector<uint32_t> valence(vertexCount, 0);
+        for (const auto& index : indexs)
+        {
+            valence[index.V1]++;
+            valence[index.V2]++;
+            valence[index.V3]++;
+        }
+
+        std::vector<uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+        for (uint32_t v = 0; v < vertexCount; v++)
+            adjacencyOffsets[v + 1] = adjacencyOffsets[v] + valence[v];
+
+        std::vector<uint32_t> adjacency(triangleCount * 3);
+        {
+            std::vector<uint32_t> cursor(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+            for (uint32_t t = 0; t < triangleCount; t++)
+            {
+                adjacency[cursor[indexs[t].V1]++] = t;
+                adjacency[cursor[indexs[t].V2]++] = t;
+                adjacency[cursor[indexs[t].V3]++] = t;
+            }
+        }
+
+        // valence now counts the triangles of each vertex that are yet to be emitted.
+        std::vector<int> cachePositions(vertexCount, -1);
+        std::vector<float> vertexScores(vertexCount);
+        for (uint32_t v = 0; v < vertexCount; v++)
+            vertexScores[v] = Utils::ForsythVertexScore(-1, valence[v]);
+
+        std::vector<float> triangleScores(triangleCount);
+        std::vector<bool> emitted(triangleCount, false);
+        int64_t bestTriangle = -1;
+        float bestScore = -1.0f;
+        for (uint32_t t = 0; t < triangleCount; t++)
+        {
+            const auto& index = indexs[t];
+            triangleScores[t] = vertexScores[index.V1] + vertexScores[index.V2] + vertexScores[index.V3];
+            if (triangleScores[t] > bestScore)
+            {
+                bestScore = triangleScores[t];
+                bestTriangle = t;
+            }
+        }
+
+        std::vector<Index> result;
+        result.reserve(triangleCount);
+
+        uint32_t cache[Utils::ForsythCacheSize + 3];
+        uint32_t cacheCount = 0;
+        size_t scanCursor = 0;
+
+        while (result.size() < triangleCount)
+        {
+            // Nothing in the cache touches a pending triangle, continue with the next one in input order.
+            if (bestTriangle < 0)
+            {
+                while (emitted[scanCursor])
+                    scanCursor++;
+                bestTriangle = (int64_t)scanCursor;
+            }
+
+            const Index triangle = indexs[bestTriangle];
+            result.push_back(triangle);
+            emitted[bestTriangle] = true;
+
+            const uint32_t triangleVertices[3] = { triangle.V1, triangle.V2, triangle.V3 };
+            for (uint32_t v : triangleVertices)
+            {
+                // Swap the emitted triangle out of the live part of the adjacency list.
+                uint32_t* begin = &adjacency[adjacencyOffsets[v]];
+                uint32_t* end = begin + valence[v];
+                uint32_t* it = std::find(begin, end, (uint32_t)bestTriangle);
+                if (it != end)
+                {
+                    std::swap(*it, *(end - 1));
+                    valence[v]--;
+                }
+            }
+
+            // Push the triangle vertices to the front of the LRU cache.
+            uint32_t newCache[Utils::ForsythCacheSize + 3];
+            uint32_t newCacheCount = 0;
+            for (uint32_t v : triangleVertices)
+                newCache[newCacheCount++] = v;
+            for (uint32_t i = 0; i < cacheCount; i++)
+            {
+                uint32_t v = cache[i];
+                if (v != triangle.V1 && v != triangle.V2 && v != triangle.V3)
+                    newCache[newCacheCount++] = v;
+            }
+
+            for (uint32_t i = 0; i < newCacheCount; i++)
+            {
+                uint32_t v = newCache[i];
+                cachePositions[v] = i < Utils::ForsythCacheSize ? (int)i : -1;
+                vertexScores[v] = Utils::ForsythVertexScore(cachePositions[v], valence[v]);
+            }
+
+            cacheCount = std::min(newCacheCount, Utils::ForsythCacheSize);
+            std::copy(newCache, newCache + cacheCount, cache);
+
+            // Only triangles touching the cache had their score changed, so the next best is among them.
+            bestTriangle = -1;
+            bestScore = -1.0f;
+            for (uint32_t i = 0; i < newCacheCount; i++)
+            {
+                uint32_t v = newCache[i];
+                for (uint32_t a = adjacencyOffsets[v]; a < adjacencyOffsets[v] + valence[v]; a++)
+                {
+                    uint32_t t = adjacency[a];
+                    const auto& index = indexs[t];
+                    triangleScores[t] = vertexScores[index.V1] + vertexScores[index.V2] + vertexScores[index.V3];
+                    if (triangleScores[t] > bestScore)
+                    {
+                        bestScore = triangleScores[t];
+                        bestTriangle = t;
+                    }
+                }
+            }
+        }
+
+        indexs = std::move(result);
+    }
+
+    void MeshOptimizer::OptimizeOverdraw(std::vector<Index>& indexs, const std::vector<Vertex>& vertexs, const float threshold)
+    {
+        const size_t triangleCount = indexs.size();
+        if (triangleCount == 0)
+            return;
+
+        constexpr uint32_t cacheSize = 16;
+        const auto vertexCount = (uint32_t)vertexs.size();
+
+        // FIFO cache simulation with timestamps, a vertex is cached while it is younger than the cache size.
+        std::vector<uint32_t> cacheTimestamps(vertexCount, 0);
+        uint32_t timestamp = cacheSize + 1;
+        auto countMisses = [&](const Index& index) -> uint32_t {
+            uint32_t misses = 0;
+            for (uint32_t v : { index.V1, index.V2, index.V3 })
+            {
+                if (timestamp - cacheTimestamps[v] > cacheSize)
+                {
+                    cacheTimestamps[v] = timestamp++;
+                    misses++;
+                }
+            }
+            return misses;
+        };
+        auto resetCache = [&]() {
+            timestamp += cacheSize + 1;
+        };
+
+        // Hard boundaries: the cache was fully flushed, so a cluster can start here for free.
+        std::vector<uint32_t> hardClusters;
+        for (uint32_t t = 0; t < triangleCount; t++)
+        {
+            if (countMisses(indexs[t]) == 3)
+                hardClusters.push_back(t);
+        }
+        if (hardClusters.empty() || hardClusters[0] != 0)
+            hardClusters.insert(hardClusters.begin(), 0);
+
+        // Soft boundaries: split further wherever the running ACMR is already within the threshold.
+        std::vector<uint32_t> clusters;
+        for (size_t c = 0; c < hardClusters.size(); c++)
+        {
+            const uint32_t start = hardClusters[c];
+            const uint32_t end = c + 1 < hardClusters.size() ? hardClusters[c + 1] : (uint32_t)triangleCount;
+
+            resetCache();
+            uint32_t clusterMisses = 0;
+            for (uint32_t t = start; t < end; t++)
+                clusterMisses += countMisses(indexs[t]);
+            const float clusterThreshold = threshold * ((float)clusterMisses / (float)(end - start));
+
+            clusters.push_back(start);
+            resetCache();
+            uint32_t runningMisses = 0, runningStart = start;
+            for (uint32_t t = start; t < end; t++)
+            {
+                runningMisses += countMisses(indexs[t]);
+                if (t + 1 < end && (float)runningMisses / (float)(t + 1 - runningStart) <= clusterThreshold)
+                {
+                    clusters.push_back(t + 1);
+                    resetCache();
+                    runningMisses = 0;
+                    runningStart = t + 1;
+                }
+            }
+        }
+
+        // Sort clusters by how far they face away from the mesh centre, outward facing clusters occlude the most.
+        glm::vec3 meshCentroid(0.0f);
+        float meshArea = 0.0f;
+        for (const auto& index : indexs)
+        {
+            const float area = glm::length(Utils::TriangleNormal(vertexs, index));
+            meshCentroid += (vertexs[index.V1].Position + vertexs[index.V2].Position + vertexs[index.V3].Position) * (area / 3.0f);
+            meshArea += area;
+        }
+        meshCentroid = meshArea > 0.0f ? meshCentroid / meshArea : glm::vec3(0.0f);
+
+        struct ClusterSortKey
+        {
+            uint32_t Cluster;
+            float Occlusion;
+        };
+        std::vector<ClusterSortKey> sortKeys(clusters.size());
+        for (uint32_t c = 0; c < clusters.size(); c++)
+        {
+            const uint32_t start = clusters[c];
+            const uint32_t end = c + 1 < clusters.size() ? clusters[c + 1] : (uint32_t)triangleCount;
+
+            glm::vec3 centroid(0.0f), normal(0.0f);
+            float area = 0.0f;
+            for (uint32_t t = start; t < end; t++)
+            {
+                const auto& index = indexs[t];
+                const glm::vec3 faceNormal = Utils::TriangleNormal(vertexs, index);
+                const float faceArea = glm::length(faceNormal);
+                centroid += (vertexs[index.V1].Position + vertexs[index.V2].Position + vertexs[index.V3].Position) * (faceArea / 3.0f);
+                normal += faceNormal;
+                area += faceArea;
+            }
+
+            centroid = area > 0.0f ? centroid / area : centroid;
+            const float normalLength = glm::length(normal);
+            normal = normalLength > 0.0f ? normal / normalLength : normal;
+
+            sortKeys[c] = { c, glm::dot(centroid - meshCentroid, normal) };
+        }
+
+        std::stable_sort(sortKeys.begin(), sortKeys.end(), [](const ClusterSortKey& lhs, const ClusterSortKey& rhs) {
+            return lhs.Occlusion > rhs.Occlusion;
+        });
+
+        std::vector<Index> result;
+        result.reserve(triangleCount);
+        for (const auto& key : sortKeys)
+        {
+            const uint32_t start = clusters[key.Cluster];
+            const uint32_t end = key.Cluster + 1 < clusters.size() ? clusters[key.Cluster + 1] : (uint32_t)triangleCount;
+            result.insert(result.end(), indexs.begin() + start, indexs.begin() + end);
+        }
+
+        indexs = std::move(result);
+    }
+
+    std::vector<uint32_t> MeshOptimizer::OptimizeVertexFetch(std::vector<Vertex>& vertexs, std::vector<Index>& indexs)
+    {
+        constexpr uint32_t unused = 0xffffffff;
+        std::vector<uint32_t> remap(vertexs.size(), unused);
+
+        std::vector<Vertex> result;
+        result.reserve(vertexs.size());
+        for (auto& index : indexs)
+        {
+            for (uint32_t* v : { &index.V1, &index.V2, &index.V3 })
+            {
+                if (remap[*v] == unused)
+                {
+                    remap[*v] = (uint32_t)result.size();
+                    result.push_back(vertexs[*v]);
+                }
+                *v = remap[*v];
+            }
+        }
+
+        // Keep unreferenced vertices at the end so the submesh vertex count stays valid.
+        for (uint32_t v = 0; v < vertexs.size(); v++)
+        {
+            if (remap[v] == unused)
+            {
+                remap[v] = (uint32_t)result.size();
+                result.push_back(vertexs[v]);
+            }
+        }
+
+        vertexs = std::move(result);
+        return remap;
+    }
+
+    std::vector<Index> MeshOptimizer::Simplify(const std::vector<Vertex>& vertexs, const std::vector<Index>& indexs, const size_t targetTriangleCount, const float targetError, float* resultError)
+    {
+        std::vector<Index> result = indexs;
+        if (resultError)
+            *resultError = 0.0f;
+        if (result.size() <= targetTriangleCount || vertexs.empty())
+            return result;
+
+        const auto vertexCount = (uint32_t)vertexs.size();
+
+        // Work in positions normalised to the mesh extent so the error is scale independent.
+        glm::vec3 min(FLT_MAX), max(-FLT_MAX);
+        for (const auto& vertex : vertexs)
+        {
+            min = glm::min(min, vertex.Position);
+            max = glm::max(max, vertex.Position);
+        }
+        const glm::vec3 size = max - min;
+        const float extent = std::max(size.x, std::max(size.y, size.z));
+        const float scale = extent > 0.0f ? 1.0f / extent : 1.0f;
+
+        std::vector<glm::vec3> positions(vertexCount);
+        for (uint32_t v = 0; v < vertexCount; v++)
+            positions[v] = (vertexs[v].Position - min) * scale;
+
+        // Lock attribute seams, i.e. several vertices sharing one position.
+        std::vector<bool> locked(vertexCount, false);
+        {
+            std::vector<uint32_t> sorted(vertexCount);
+            std::iota(sorted.begin(), sorted.end(), 0);
+            auto less = [&](uint32_t lhs, uint32_t rhs) {
+                const glm::vec3& a = positions[lhs];
+                const glm::vec3& b = positions[rhs];
+                return a.x != b.x ? a.x < b.x : (a.y != b.y ? a.y < b.y : a.z < b.z);
+            };
+            std::sort(sorted.begin(), sorted.end(), less);
+            for (uint32_t i = 1; i < vertexCount; i++)
+            {
+                if (!less(sorted[i - 1], sorted[i]))
+                    locked[sorted[i - 1]] = locked[sorted[i]] = true;
+            }
+        }
+
+        // Lock open borders, i.e. edges used by a single triangle.
+        {
+            std::unordered_map<uint64_t, uint32_t> edgeUses;
+            auto edgeKey = [](uint32_t a, uint32_t b) { return ((uint64_t)std::min(a, b) << 32) | std::max(a, b); };
+            for (const auto& index : result)
+            {
+                edgeUses[edgeKey(index.V1, index.V2)]++;
+                edgeUses[edgeKey(index.V2, index.V3)]++;
+                edgeUses[edgeKey(index.V3, index.V1)]++;
+            }
+            for (const auto& [key, uses] : edgeUses)
+            {
+                if (uses == 1)
+                    locked[key >> 32] = locked[key & 0xffffffff] = true;
+            }
+        }
+
+        // Area weighted plane quadrics.
+        std::vector<Utils::Quadric> quadrics(vertexCount);
+        for (const auto& index : result)
+        {
+            const glm::vec3& p0 = positions[index.V1];
+            glm::vec3 normal = glm::cross(positions[index.V2] - p0, positions[index.V3] - p0);
+            const float area = glm::length(normal);
+            if (area == 0.0f)
+                continue;
+
+            normal /= area;
+            const Utils::Quadric quadric(normal, -glm::dot(normal, p0), area);
+            quadrics[index.V1] += quadric;
+            quadrics[index.V2] += quadric;
+            quadrics[index.V3] += quadric;
+        }
+
+        auto collapseError = [&](uint32_t from, uint32_t to) -> float {
+            Utils::Quadric quadric = quadrics[from];
+            quadric += quadrics[to];
+            return quadric.Weight > 0.0 ? (float)(quadric.Error(positions[to]) / quadric.Weight) : 0.0f;
+        };
+
+        struct Collapse
+        {
+            uint32_t From, To;
+            float Error;
+        };
+
+        const float errorLimit = targetError * targetError;
+        float maxError = 0.0f;
+        std::vector<std::vector<uint32_t>> vertexTriangles(vertexCount);
+
+        while (result.size() > targetTriangleCount)
+        {
+            for (auto& triangles : vertexTriangles)
+                triangles.clear();
+            for (uint32_t t = 0; t < result.size(); t++)
+            {
+                vertexTriangles[result[t].V1].push_back(t);
+                vertexTriangles[result[t].V2].push_back(t);
+                vertexTriangles[result[t].V3].push_back(t);
+            }
+
+            std::vector<Collapse> collapses;
+            collapses.reserve(result.size() * 6);
+            for (const auto& index : result)
+            {
+                const uint32_t edges[3][2] = { { index.V1, index.V2 }, { index.V2, index.V3 }, { index.V3, index.V1 } };
+                for (const auto& edge : edges)
+                {
+                    if (!locked[edge[0]])
+                        collapses.push_back({ edge[0], edge[1], collapseError(edge[0], edge[1]) });
+                    if (!locked[edge[1]])
+                        collapses.push_back({ edge[1], edge[0], collapseError(edge[1], edge[0]) });
+                }
+            }
+            std::sort(collapses.begin(), collapses.end(), [](const Collapse& lhs, const Collapse& rhs) {
+                return lhs.Error < rhs.Error;
+            });
+
+            // Rejects collapses that would flip any remaining triangle around the removed vertex.
+            auto flips = [&](uint32_t from, uint32_t to) {
+                for (uint32_t t : vertexTriangles[from])
+                {
+                    const Index& index = result[t];
+                    if (Utils::IsDegenerate(index) || index.V1 == to || index.V2 == to || index.V3 == to)
+                        continue;
+
+                    glm::vec3 p[3] = { positions[index.V1], positions[index.V2], positions[index.V3] };
+                    const glm::vec3 before = glm::cross(p[1] - p[0], p[2] - p[0]);
+                    for (uint32_t k = 0; k < 3; k++)
+                    {
+                        if ((&index.V1)[k] == from)
+                            p[k] = positions[to];
+                    }
+                    const glm::vec3 after = glm::cross(p[1] - p[0], p[2] - p[0]);
+                    if (glm::dot(before, after) <= 0.0f)
+                        return true;
+                }
+                return false;
+            };
+
+            const size_t trianglesToRemove = result.size() - targetTriangleCount;
+            size_t trianglesRemoved = 0;
+            uint32_t collapsed = 0;
+            std::vector<bool> touched(vertexCount, false);
+            for (const auto& collapse : collapses)
+            {
+                if (collapse.Error > errorLimit || trianglesRemoved >= trianglesToRemove)
+                    break;
+                if (touched[collapse.From] || touched[collapse.To] || flips(collapse.From, collapse.To))
+                    continue;
+
+                for (uint32_t t : vertexTriangles[collapse.From])
+                {
+                    Index& index = result[t];
+                    if (Utils::IsDegenerate(index))
+                        continue;
+
+                    for (uint32_t k = 0; k < 3; k++)
+                    {
+                        uint32_t& v = (&index.V1)[k];
+                        if (v == collapse.From)
+                            v = collapse.To;
+                        touched[v] = true;
+                    }
+                    if (Utils::IsDegenerate(index))
+                        trianglesRemoved++;
+                }
+
+                quadrics[collapse.To] += quadrics[collapse.From];
+                touched[collapse.From] = touched[collapse.To] = true;
+                maxError = std::max(maxError, collapse.Error);
+                collapsed++;
+            }
+
+            result.erase(std::remove_if(result.begin(), result.end(), Utils::IsDegenerate), result.end());
+
+            if (collapsed == 0)
+                break;
+        }
+
+        if (resultError)
+            *resultError = std::sqrt(maxError);
+
+        return result;
+    }
+
+    std::vector<Meshlet> MeshOptimizer::BuildMeshlets(const std::vector<Vertex>& vertexs, const std::vector<Index>& indexs, const uint32_t maxVertices, const uint32_t maxTriangles)
+    {
+        std::vector<Meshlet> meshlets;
+
+        // Stamp of the meshlet that last used each vertex, avoids clearing a set per meshlet.
+        std::vector<uint32_t> vertexStamps(vertexs.size(), UINT32_MAX);
+        uint32_t meshletVertexCount = 0;
+        size_t firstTriangle = 0;
+
+        auto finishMeshlet = [&](size_t endTriangle)
+        {
+            Meshlet& meshlet = meshlets.emplace_back();
+            meshlet.BaseIndex = (uint32_t)firstTriangle * 3;
+            meshlet.IndexCount = (uint32_t)(endTriangle - firstTriangle) * 3;
+
+            // Bounding sphere around the centre of the bounds.
+            glm::vec3 min(FLT_MAX), max(-FLT_MAX);
+            for (size_t t = firstTriangle; t < endTriangle; t++)
+            {
+                for (uint32_t k = 0; k < 3; k++)
+                {
+                    const glm::vec3& p = vertexs[(&indexs[t].V1)[k]].Position;
+                    min = glm::min(min, p);
+                    max = glm::max(max, p);
+                }
+            }
+            meshlet.Center = (min + max) * 0.5f;
+            meshlet.Radius = 0.0f;
+            for (size_t t = firstTriangle; t < endTriangle; t++)
+            {
+                for (uint32_t k = 0; k < 3; k++)
+                    meshlet.Radius = glm::max(meshlet.Radius, glm::distance(meshlet.Center, vertexs[(&indexs[t].V1)[k]].Position));
+            }
+
+            // Normal cone, the axis is the average normal and the cutoff comes from the widest normal.
+            glm::vec3 axis(0.0f);
+            for (size_t t = firstTriangle; t < endTriangle; t++)
+            {
+                glm::vec3 normal = Utils::TriangleNormal(vertexs, indexs[t]);
+                float length = glm::length(normal);
+                if (length > 0.0f)
+                    axis += normal / length;
+            }
+
+            meshlet.ConeAxis = glm::vec3(0.0f);
+            meshlet.ConeCutoff = 1.0f;
+            if (glm::length(axis) > 0.0f)
+            {
+                axis = glm::normalize(axis);
+                float minDot = 1.0f;
+                for (size_t t = firstTriangle; t < endTriangle; t++)
+                {
+                    glm::vec3 normal = Utils::TriangleNormal(vertexs, indexs[t]);
+                    float length = glm::length(normal);
+                    if (length > 0.0f)
+                        minDot = glm::min(minDot, glm::dot(normal / length, axis));
+                }
+
+                // Cones wider than ~85 degrees reject almost nothing, skip testing them.
+                if (minDot > 0.1f)
+                {
+                    meshlet.ConeAxis = axis;
+                    meshlet.ConeCutoff = glm::sqrt(1.0f - minDot * minDot);
+                }
+            }
+
+            firstTriangle = endTriangle;
+            meshletVertexCount = 0;
+        };
+
+        for (size_t t = 0; t < indexs.size(); t++)
+        {
+            const Index& index = indexs[t];
+            const uint32_t stamp = (uint32_t)meshlets.size();
+
+            uint32_t newVertices = 0;
+            for (uint32_t k = 0; k < 3; k++)
+            {
+                uint32_t v = (&index.V1)[k];
+                bool duplicate = (k > 0 && v == index.V1) || (k > 1 && v == index.V2);
+                newVertices += vertexStamps[v] != stamp && !duplicate;
+            }
+
+            if (meshletVertexCount + newVertices > maxVertices || t - firstTriangle >= maxTriangles)
+            {
+                finishMeshlet(t);
+                newVertices = 0;
+                for (uint32_t k = 0; k < 3; k++)
+                {
+                    uint32_t v = (&index.V1)[k];
+                    bool duplicate = (k > 0 && v == index.V1) || (k > 1 && v == index.V2);
+                    newVertices += !duplicate;
+                }
+            }
+
+            for (uint32_t k = 0; k < 3; k++)
+                vertexStamps[(&index.V1)[k]] = (uint32_t)meshlets.size();
+            meshletVertexCount += newVertices;
+        }
+
+        if (firstTriangle < indexs.size())
+            finishMeshlet(indexs.size());
+
+        return meshlets;
+    }
+
+    VertexCacheStatistics MeshOptimizer::AnalyzeVertexCache(const std::vector<Index>& indexs, const uint32_t vertexCount, const uint32_t cacheSize)
+    {
+        VertexCacheStatistics stats;
+        if (indexs.empty() || vertexCount == 0)
+            return stats;
+
+        std::vector<uint32_t> cacheTimestamps(vertexCount, 0);
+        uint32_t timestamp = cacheSize + 1;
+        for (const auto& index : indexs)
+        {
+            for (uint32_t v : { index.V1, index.V2, index.V3 })
+            {
+                if (timestamp - cacheTimestamps[v] > cacheSize)
+                {
+                    cacheTimestamps[v] = timestamp++;
+                    stats.VerticesTransformed++;
+                }
+            }
+        }
+
+        stats.ACMR = (float)stats.VerticesTransformed / (float)indexs.size();
+        stats.ATVR = (float)stats.VerticesTransformed / (float)vertexCount;
+        return stats;
+    }
+}
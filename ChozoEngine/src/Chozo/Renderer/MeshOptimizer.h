@@ -0,0 +1,41 @@
+#pragma once
+
+#include "czpch.h"
+
+#include "Mesh.h"
+
+namespace Chozo {
+
+    struct VertexCacheStatistics
+    {
+        uint32_t VerticesTransformed = 0;
+        float ACMR = 0.0f; // Average cache miss ratio: transformed vertices per triangle.
+        float ATVR = 0.0f; // Average transformed vertex ratio: transformed vertices per vertex.
+    };
+
+    class MeshOptimizer
+    {
+    public:
+        // Runs every stage below on a single submesh. Indices are local to the submesh vertices.
+        static void OptimizeSubmesh(std::vector<Vertex>& vertexs, std::vector<Index>& indexs);
+
+        // Forsyth's linear-speed vertex cache optimisation.
+        static void OptimizeVertexCache(std::vector<Index>& indexs, uint32_t vertexCount);
+        // Splits the cache optimised order into clusters and sorts them front-to-back by occlusion potential.
+        // A threshold of 1.05 allows ACMR to degrade by at most 5%.
+        static void OptimizeOverdraw(std::vector<Index>& indexs, const std::vector<Vertex>& vertexs, float threshold = 1.05f);
+        // Reorders vertices by first use. Returns the old-to-new vertex remap table.
+        static std::vector<uint32_t> OptimizeVertexFetch(std::vector<Vertex>& vertexs, std::vector<Index>& indexs);
+
+        // Quadric error metric edge collapse. Only existing vertices are kept, so the result indexes the same vertex range.
+        // Border and attribute seam vertices are locked. targetError is relative to the mesh extent.
+        static std::vector<Index> Simplify(const std::vector<Vertex>& vertexs, const std::vector<Index>& indexs, size_t targetTriangleCount, float targetError, float* resultError = nullptr);
+
+        // Greedily splits the triangles into meshlets without reordering them, so each meshlet is a contiguous index range.
+        // BaseIndex is relative to the start of indexs.
+        static std::vector<Meshlet> BuildMeshlets(const std::vector<Vertex>& vertexs, const std::vector<Index>& indexs, uint32_t maxVertices = 64, uint32_t maxTriangles = 124);
+
+        // Simulates a FIFO post-transform cache of the given size.
+        static VertexCacheStatistics AnalyzeVertexCache(const std::vector<Index>& indexs, uint32_t vertexCount, uint32_t cacheSize = 16);
+    };
+}
@@ -0,0 +1,320 @@
+#include "MeshPacker.h"
+
+#include <glm/gtc/packing.hpp>
+
+namespace Chozo {
+
+    namespace Utils {
+
+        static glm::vec2 SignNotZero(const glm::vec2& v)
+        {
+            return { v.x >= 0.0f ? 1.0f : -1.0f, v.y >= 0.0f ? 1.0f : -1.0f };
+        }
+
+        static glm::vec2 OctEncode(glm::vec3 n)
+        {
+            n /= glm::abs(n.x) + glm::abs(n.y) + glm::abs(n.z);
+            glm::vec2 e(n.x, n.y);
+            if (n.z < 0.0f)
+                e = (1.0f - glm::abs(glm::vec2(n.y, n.x))) * SignNotZero(e);
+            return e;
+        }
+
+        static glm::vec3 OctDecode(const glm::vec2& e)
+        {
+            glm::vec3 n(e.x, e.y, 1.0f - glm::abs(e.x) - glm::abs(e.y));
+            float t = glm::max(-n.z, 0.0f);
+            n.x += n.x >= 0.0f ? -t : t;
+            n.y += n.y >= 0.0f ? -t : t;
+            return glm::normalize(n);
+        }
+
+        static int16_t PackSnorm16(float v)
+        {
+            return (int16_t)glm::round(glm::clamp(v, -1.0f, 1.0f) * 32767.0f);
+        }
+
+        static float UnpackSnorm16(int16_t v)
+        {
+            return glm::max((float)v / 32767.0f, -1.0f);
+        }
+
+        static uint16_t PackUnorm16(float v)
+        {
+            return (uint16_t)glm::round(glm::clamp(v, 0.0f, 1.0f) * 65535.0f);
+        }
+
+        static bool IsValidDirection(const glm::vec3& v)
+        {
+            float length = glm::length(v);
+            return length > 1e-6f && !glm::isnan(length);
+        }
+
+        // Any unit vector perpendicular to n, used when the source has no tangents.
+        static glm::vec3 Perpendicular(const glm::vec3& n)
+        {
+            glm::vec3 axis = glm::abs(n.x) < 0.9f ? glm::vec3(1.0f, 0.0f, 0.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+            return glm::normalize(glm::cross(n, axis));
+        }
+
+        template<typename T>
+        static void EncodeShared(const Vertex& vertex, T& packed, float& bitangentSign)
+        {
+            glm::vec3 normal = IsValidDirection(vertex.Normal) ? glm::normalize(vertex.Normal) : glm::vec3(0.0f, 0.0f, 1.0f);
+            glm::vec3 tangent = IsValidDirection(vertex.Tangent) ? glm::normalize(vertex.Tangent) : Perpendicular(normal);
+
+            glm::vec2 n = OctEncode(normal);
+            glm::vec2 t = OctEncode(tangent);
+            packed.NormalTangent[0] = PackSnorm16(n.x);
+            packed.NormalTangent[1] = PackSnorm16(n.y);
+            packed.NormalTangent[2] = PackSnorm16(t.x);
+            packed.NormalTangent[3] = PackSnorm16(t.y);
+
+            packed.TexCoord[0] = glm::packHalf1x16(vertex.TexCoord.x);
+            packed.TexCoord[1] = glm::packHalf1x16(vertex.TexCoord.y);
+
+            bitangentSign = glm::dot(glm::cross(normal, tangent), vertex.Binormal) < 0.0f ? 0.0f : 1.0f;
+        }
+
+        template<typename T>
+        static void DecodeShared(const T& packed, float bitangentSign, Vertex& vertex)
+        {
+            vertex.Normal = OctDecode({ UnpackSnorm16(packed.NormalTangent[0]), UnpackSnorm16(packed.NormalTangent[1]) });
+            vertex.Tangent = OctDecode({ UnpackSnorm16(packed.NormalTangent[2]), UnpackSnorm16(packed.NormalTangent[3]) });
+            vertex.Binormal = glm::cross(vertex.Normal, vertex.Tangent) * (bitangentSign * 2.0f - 1.0f);
+            vertex.TexCoord = { glm::unpackHalf1x16(packed.TexCoord[0]), glm::unpackHalf1x16(packed.TexCoord[1]) };
+        }
+
+        // Union of the submesh bounding boxes, in the space of the vertices.
+        static AABB GetQuantizationBounds(const std::vector<Submesh>& submeshes)
+        {
+            AABB bounds;
+            bounds.Min = glm::vec3(FLT_MAX);
+            bounds.Max = glm::vec3(-FLT_MAX);
+            for (const auto& submesh : submeshes)
+            {
+                bounds.Min = glm::min(bounds.Min, submesh.BoundingBox.Min);
+                bounds.Max = glm::max(bounds.Max, submesh.BoundingBox.Max);
+            }
+            return bounds;
+        }
+    }
+
+    VertexFormat MeshPacker::ChooseVertexFormat(const std::vector<Vertex>& vertexs, const std::vector<Submesh>& submeshes)
+    {
+        if (vertexs.empty() || submeshes.empty())
+            return VertexFormat::Compact;
+
+        const AABB bounds = Utils::GetQuantizationBounds(submeshes);
+        for (const auto& vertex : vertexs)
+        {
+            const auto& p = vertex.Position;
+            if (glm::any(glm::lessThan(p, bounds.Min)) || glm::any(glm::greaterThan(p, bounds.Max)))
+                return VertexFormat::Compact;
+        }
+
+        return VertexFormat::Quantized;
+    }
+
+    IndexFormat MeshPacker::ChooseIndexFormat(const std::vector<Index>& indexs)
+    {
+        for (const auto& index : indexs)
+        {
+            if (glm::max(index.V1, glm::max(index.V2, index.V3)) > 0xffff)
+                return IndexFormat::UInt32;
+        }
+        return IndexFormat::UInt16;
+    }
+
+    std::vector<uint8_t> MeshPacker::PackVertices(const std::vector<Vertex>& vertexs, const std::vector<Submesh>& submeshes, VertexFormat format)
+    {
+        std::vector<uint8_t> data(vertexs.size() * GetVertexSize(format));
+
+        switch (format)
+        {
+            case VertexFormat::Compact:
+            {
+                auto* packed = reinterpret_cast<CompactVertex*>(data.data());
+                for (size_t v = 0; v < vertexs.size(); v++)
+                {
+                    float sign;
+                    Utils::EncodeShared(vertexs[v], packed[v], sign);
+                    packed[v].Position = glm::vec4(vertexs[v].Position, sign);
+                }
+                break;
+            }
+            case VertexFormat::Quantized:
+            {
+                glm::vec3 offset, scale;
+                GetPositionTransform(submeshes, format, offset, scale);
+
+                auto* packed = reinterpret_cast<QuantizedVertex*>(data.data());
+                for (size_t v = 0; v < vertexs.size(); v++)
+                {
+                    glm::vec3 p = (vertexs[v].Position - offset) / glm::max(scale, glm::vec3(FLT_MIN));
+
+                    float sign;
+                    Utils::EncodeShared(vertexs[v], packed[v], sign);
+                    packed[v].Position[0] = Utils::PackUnorm16(p.x);
+                    packed[v].Position[1] = Utils::PackUnorm16(p.y);
+                    packed[v].Position[2] = Utils::PackUnorm16(p.z);
+                    packed[v].Position[3] = Utils::PackUnorm16(sign);
+                }
+                break;
+            }
+        }
+
+        return data;
+    }
+
+    std::vector<Vertex> MeshPacker::UnpackVertices(const std::vector<uint8_t>& data, const std::vector<Submesh>& submeshes, VertexFormat format)
+    {
+        size_t vertexCount = data.size() / GetVertexSize(format);
+        std::vector<Vertex> vertexs(vertexCount);
+
+        switch (format)
+        {
+            case VertexFormat::Compact:
+            {
+                auto* packed = reinterpret_cast<const CompactVertex*>(data.data());
+                for (size_t v = 0; v < vertexCount; v++)
+                {
+                    vertexs[v].Position = glm::vec3(packed[v].Position);
+                    Utils::DecodeShared(packed[v], packed[v].Position.w, vertexs[v]);
+                }
+                break;
+            }
+            case VertexFormat::Quantized:
+            {
+                glm::vec3 offset, scale;
+                GetPositionTransform(submeshes, format, offset, scale);
+
+                auto* packed = reinterpret_cast<const QuantizedVertex*>(data.data());
+                for (size_t v = 0; v < vertexCount; v++)
+                {
+                    glm::vec3 p = glm::vec3(packed[v].Position[0], packed[v].Position[1], packed[v].Position[2]) / 65535.0f;
+                    vertexs[v].Position = p * scale + offset;
+                    Utils::DecodeShared(packed[v], packed[v].Position[3] / 65535.0f, vertexs[v]);
+                }
+                break;
+            }
+        }
+
+        return vertexs;
+    }
+
+    std::vector<uint8_t> MeshPacker::PackIndices(const std::vector<Index>& indexs, IndexFormat format)
+    {
+        std::vector<uint8_t> data(indexs.size() * 3 * IndexFormatSize(format));
+
+        if (format == IndexFormat::UInt16)
+        {
+            auto* packed = reinterpret_cast<uint16_t*>(data.data());
+            for (size_t i = 0; i < indexs.size(); i++)
+            {
+                packed[i * 3 + 0] = (uint16_t)indexs[i].V1;
+                packed[i * 3 + 1] = (uint16_t)indexs[i].V2;
+                packed[i * 3 + 2] = (uint16_t)indexs[i].V3;
+            }
+        }
+        else
+        {
+            memcpy(data.data(), indexs.data(), data.size());
+        }
+
+        return data;
+    }
+
+    std::vector<Index> MeshPacker::UnpackIndices(const std::vector<uint8_t>& data, IndexFormat format)
+    {
+        std::vector<Index> indexs(data.size() / (3 * IndexFormatSize(format)));
+
+        if (format == IndexFormat::UInt16)
+        {
+            auto* packed = reinterpret_cast<const uint16_t*>(data.data());
+            for (size_t i = 0; i < indexs.size(); i++)
+                indexs[i] = { packed[i * 3 + 0], packed[i * 3 + 1], packed[i * 3 + 2] };
+        }
+        else
+        {
+            memcpy(indexs.data(), data.data(), indexs.size() * sizeof(Index));
+        }
+
+        return indexs;
+    }
+
+    void MeshPacker::GetPositionTransform(const std::vector<Submesh>& submeshes, VertexFormat format, glm::vec3& offset, glm::vec3& scale)
+    {
+        if (format == VertexFormat::Quantized && !submeshes.empty())
+        {
+            const AABB bounds = Utils::GetQuantizationBounds(submeshes);
+            offset = bounds.Min;
+            scale = bounds.Max - bounds.Min;
+        }
+        else
+        {
+            offset = glm::vec3(0.0f);
+            scale = glm::vec3(1.0f);
+        }
+    }
+
+    uint32_t MeshPacker::GetVertexSize(VertexFormat format)
+    {
+        switch (format)
+        {
+            case VertexFormat::Compact:     return sizeof(CompactVertex);
+            case VertexFormat::Quantized:   return sizeof(QuantizedVertex);
+        }
+
+        CZ_CORE_ASSERT(false, "Unknown VertexFormat!");
+        return 0;
+    }
+
+    std::vector<uint8_t> MeshPacker::PackPositions(const std::vector<uint8_t>& vertices, VertexFormat format)
+    {
+        // Position is the first field of both packed vertices.
+        const uint32_t vertexSize = GetVertexSize(format);
+        const uint32_t positionSize = format == VertexFormat::Compact ? sizeof(CompactVertex::Position) : sizeof(QuantizedVertex::Position);
+        const size_t vertexCount = vertices.size() / vertexSize;
+
+        std::vector<uint8_t> positions(vertexCount * positionSize);
+        for (size_t v = 0; v < vertexCount; v++)
+            memcpy(positions.data() + v * positionSize, vertices.data() + v * vertexSize, positionSize);
+
+        return positions;
+    }
+
+    VertexBufferLayout MeshPacker::GetVertexLayout(VertexFormat format)
+    {
+        switch (format)
+        {
+            case VertexFormat::Compact:
+                return {
+                    { ShaderDataType::Float4,   "a_Position"             },
+                    { ShaderDataType::Short4,   "a_NormalTangent", true  },
+                    { ShaderDataType::Half2,    "a_TexCoord"             },
+                };
+            case VertexFormat::Quantized:
+                return {
+                    { ShaderDataType::UShort4,  "a_Position",      true  },
+                    { ShaderDataType::Short4,   "a_NormalTangent", true  },
+                    { ShaderDataType::Half2,    "a_TexCoord"             },
+                };
+        }
+
+        CZ_CORE_ASSERT(false, "Unknown VertexFormat!");
+        return {};
+    }
+
+    VertexBufferLayout MeshPacker::GetPositionLayout(VertexFormat format)
+    {
+        switch (format)
+        {
+            case VertexFormat::Compact:     return { { ShaderDataType::Float4,  "a_Position"       } };
+            case VertexFormat::Quantized:   return { { ShaderDataType::UShort4, "a_Position", true } };
+        }
+
+        CZ_CORE_ASSERT(false, "Unknown VertexFormat!");
+        return {};
+    }
+}
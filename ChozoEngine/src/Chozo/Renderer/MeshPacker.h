@@ -0,0 +1,34 @@
+#pragma once
+
+#include "czpch.h"
+
+#include "Mesh.h"
+
+namespace Chozo {
+
+    class MeshPacker
+    {
+    public:
+        // Quantized positions share one grid over the union of the submesh bounding boxes, so vertices on the
+        // border of two submeshes land on the same point. Meshes with vertices outside it (e.g. generated geometry)
+        // fall back to Compact.
+        static VertexFormat ChooseVertexFormat(const std::vector<Vertex>& vertexs, const std::vector<Submesh>& submeshes);
+        // Indices are local to their submesh, so UInt16 is used when every submesh has fewer than 65,536 vertices.
+        static IndexFormat ChooseIndexFormat(const std::vector<Index>& indexs);
+
+        static std::vector<uint8_t> PackVertices(const std::vector<Vertex>& vertexs, const std::vector<Submesh>& submeshes, VertexFormat format);
+        static std::vector<Vertex> UnpackVertices(const std::vector<uint8_t>& data, const std::vector<Submesh>& submeshes, VertexFormat format);
+        // The a_Position field of packed vertices in a tight stream, depth only draws fetch nothing else.
+        static std::vector<uint8_t> PackPositions(const std::vector<uint8_t>& vertices, VertexFormat format);
+
+        static std::vector<uint8_t> PackIndices(const std::vector<Index>& indexs, IndexFormat format);
+        static std::vector<Index> UnpackIndices(const std::vector<uint8_t>& data, IndexFormat format);
+
+        // Scale and offset the shader applies to a_Position.xyz to get the mesh local position, the same for every submesh.
+        static void GetPositionTransform(const std::vector<Submesh>& submeshes, VertexFormat format, glm::vec3& offset, glm::vec3& scale);
+
+        static uint32_t GetVertexSize(VertexFormat format);
+        static VertexBufferLayout GetVertexLayout(VertexFormat format);
+        static VertexBufferLayout GetPositionLayout(VertexFormat format);
+    };
+}
@@ -0,0 +1,74 @@
+#include "MeshletCuller.h"
+
+namespace Chozo {
+
+    namespace Utils {
+
+        // Gribb-Hartmann plane extraction, normals point inside.
+        static std::array<glm::vec4, 6> ExtractFrustumPlanes(const glm::mat4& m)
+        {
+            glm::vec4 row0(m[0][0], m[1][0], m[2][0], m[3][0]);
+            glm::vec4 row1(m[0][1], m[1][1], m[2][1], m[3][1]);
+            glm::vec4 row2(m[0][2], m[1][2], m[2][2], m[3][2]);
+            glm::vec4 row3(m[0][3], m[1][3], m[2][3], m[3][3]);
+
+            std::array<glm::vec4, 6> planes = {
+                row3 + row0, row3 - row0,
+                row3 + row1, row3 - row1,
+                row3 + row2, row3 - row2,
+            };
+            for (auto& plane : planes)
+                plane /= glm::length(glm::vec3(plane));
+
+            return planes;
+        }
+    }
+
+    uint32_t MeshletCuller::Cull(const Submesh& submesh, const glm::mat4& transform, const glm::mat4& viewProjection, const glm::vec3& cameraPosition, std::vector<IndexRange>& ranges)
+    {
+        ranges.clear();
+
+        const auto planes = Utils::ExtractFrustumPlanes(viewProjection);
+        const glm::mat3 rotation(transform);
+        const float scale = glm::max(glm::length(rotation[0]), glm::max(glm::length(rotation[1]), glm::length(rotation[2])));
+        // Mirrored transforms flip the winding, the cones no longer describe the back faces.
+        const bool coneCulling = glm::determinant(rotation) > 0.0f;
+
+        uint32_t culled = 0;
+        for (const auto& meshlet : submesh.Meshlets)
+        {
+            glm::vec3 center = glm::vec3(transform * glm::vec4(meshlet.Center, 1.0f));
+            float radius = meshlet.Radius * scale;
+
+            bool visible = true;
+            for (const auto& plane : planes)
+            {
+                if (glm::dot(glm::vec3(plane), center) + plane.w < -radius)
+                {
+                    visible = false;
+                    break;
+                }
+            }
+
+            if (visible && coneCulling && meshlet.ConeCutoff < 1.0f)
+            {
+                glm::vec3 axis = glm::normalize(rotation * meshlet.ConeAxis);
+                glm::vec3 view = center - cameraPosition;
+                visible = glm::dot(view, axis) < meshlet.ConeCutoff * glm::length(view) + radius;
+            }
+
+            if (!visible)
+            {
+                culled++;
+                continue;
+            }
+
+            if (!ranges.empty() && ranges.back().BaseIndex + ranges.back().IndexCount == meshlet.BaseIndex)
+                ranges.back().IndexCount += meshlet.IndexCount;
+            else
+                ranges.push_back({ meshlet.BaseIndex, meshlet.IndexCount });
+        }
+
+        return culled;
+    }
+}
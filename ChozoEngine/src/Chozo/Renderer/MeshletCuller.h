@@ -0,0 +1,16 @@
+#pragma once
+
+#include "czpch.h"
+
+#include "Mesh.h"
+
+namespace Chozo {
+
+    class MeshletCuller
+    {
+    public:
+        // Frustum and normal cone culling of the submesh meshlets, visible neighbours are merged into one range.
+        // Returns the number of culled meshlets, ranges is left empty when everything was culled.
+        static uint32_t Cull(const Submesh& submesh, const glm::mat4& transform, const glm::mat4& viewProjection, const glm::vec3& cameraPosition, std::vector<IndexRange>& ranges);
+    };
+}
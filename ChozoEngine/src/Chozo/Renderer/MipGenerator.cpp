@@ -0,0 +1,224 @@
+#include "MipGenerator.h"
+
+#include "Chozo/Core/Pool.h"
+
+#include <glm/glm.hpp>
+
+#include <cmath>
+
+namespace Chozo {
+
+    namespace Utils {
+
+        // Half width of the Kaiser filter in destination texels, and the shape of its window.
+        static constexpr float KaiserWidth = 3.0f;
+        static constexpr float KaiserAlpha = 4.0f;
+
+        struct FilterTap
+        {
+            uint32_t Index;
+            float Weight;
+        };
+
+        // Modified Bessel function of the first kind, order 0.
+        static float BesselI0(const float x)
+        {
+            float sum = 1.0f, term = 1.0f;
+            for (uint32_t k = 1; k < 16; k++)
+            {
+                term *= (x * 0.5f / (float)k) * (x * 0.5f / (float)k);
+                sum += term;
+            }
+            return sum;
+        }
+
+        // u is the distance to the destination texel center in destination texels.
+        static float GetFilterWeight(const MipFilter filter, const float u)
+        {
+            if (filter == MipFilter::Box)
+                return std::abs(u) <= 0.5f ? 1.0f : 0.0f;
+
+            if (std::abs(u) >= KaiserWidth)
+                return 0.0f;
+
+            const float x = u * 3.14159265f;
+            const float sinc = std::abs(u) < 1e-4f ? 1.0f : std::sin(x) / x;
+            const float t = u / KaiserWidth;
+            return sinc * BesselI0(KaiserAlpha * std::sqrt(1.0f - t * t)) / BesselI0(KaiserAlpha);
+        }
+
+        // Source texel a tap outside [0, size) reads, the way the sampler addresses it.
+        static uint32_t WrapIndex(const int index, const uint32_t size, const ImageParameter wrap)
+        {
+            const int n = (int)size;
+            if (wrap == ImageParameter::REPEAT)
+                return (uint32_t)(((index % n) + n) % n);
+
+            if (wrap == ImageParameter::MIRRORED_REPEAT)
+            {
+                const int m = ((index % (2 * n)) + 2 * n) % (2 * n);
+                return (uint32_t)(m < n ? m : 2 * n - 1 - m);
+            }
+
+            return (uint32_t)std::clamp(index, 0, n - 1);
+        }
+
+        // Source texels contributing to each destination texel along one axis.
+        static std::vector<std::vector<FilterTap>> ComputeTaps(const uint32_t sourceSize, const uint32_t destinationSize, const MipFilter filter, const ImageParameter wrap)
+        {
+            const float ratio = (float)sourceSize / (float)destinationSize;
+            const float radius = (filter == MipFilter::Box ? 0.5f : KaiserWidth) * ratio;
+
+            std::vector<std::vector<FilterTap>> taps(destinationSize);
+            for (uint32_t d = 0; d < destinationSize; d++)
+            {
+                const float center = ((float)d + 0.5f) * ratio;
+                const int first = (int)std::floor(center - radius);
+                const int last = (int)std::ceil(center + radius);
+
+                float sum = 0.0f;
+                for (int i = first; i <= last; i++)
+                {
+                    const float weight = GetFilterWeight(filter, ((float)i + 0.5f - center) / ratio);
+                    if (weight == 0.0f)
+                        continue;
+
+                    taps[d].push_back({ WrapIndex(i, sourceSize, wrap), weight });
+                    sum += weight;
+                }
+
+                if (taps[d].empty() || std::abs(sum) < 1e-6f)
+                {
+                    taps[d] = { { std::min((uint32_t)center, sourceSize - 1), 1.0f } };
+                    continue;
+                }
+
+                for (auto& tap : taps[d])
+                    tap.Weight /= sum;
+            }
+            return taps;
+        }
+
+        static float SRGBToLinear(const uint8_t value)
+        {
+            static const auto table = []() {
+                std::array<float, 256> values{};
+                for (uint32_t i = 0; i < 256; i++)
+                {
+                    const float c = (float)i / 255.0f;
+                    values[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+                }
+                return values;
+            }();
+            return table[value];
+        }
+
+        static float LinearToSRGB(const float value)
+        {
+            const float c = std::clamp(value, 0.0f, 1.0f);
+            return c <= 0.0031308f ? c * 12.92f : 1.055f * std::pow(c, 1.0f / 2.4f) - 0.055f;
+        }
+
+        static uint8_t ToUnorm8(const float value)
+        {
+            return (uint8_t)std::lround(std::clamp(value, 0.0f, 1.0f) * 255.0f);
+        }
+
+        // Filters width x height down to the next level in two separable passes.
+        static std::vector<glm::vec4> Downsample(const std::vector<glm::vec4>& source, const uint32_t width, const uint32_t height, const MipFilter filter,
+            const ImageParameter wrapS, const ImageParameter wrapT)
+        {
+            const uint32_t nextWidth = std::max(width / 2, 1u), nextHeight = std::max(height / 2, 1u);
+            const auto horizontalTaps = ComputeTaps(width, nextWidth, filter, wrapS);
+            const auto verticalTaps = ComputeTaps(height, nextHeight, filter, wrapT);
+
+            std::vector<glm::vec4> horizontal((size_t)nextWidth * height);
+            Pool::ParallelFor(height, [&](const uint32_t y) {
+                const glm::vec4* row = source.data() + (size_t)y * width;
+                for (uint32_t x = 0; x < nextWidth; x++)
+                {
+                    glm::vec4 sum(0.0f);
+                    for (const auto& tap : horizontalTaps[x])
+                        sum += row[tap.Index] * tap.Weight;
+                    horizontal[(size_t)y * nextWidth + x] = sum;
+                }
+            });
+
+            std::vector<glm::vec4> destination((size_t)nextWidth * nextHeight);
+            Pool::ParallelFor(nextHeight, [&](const uint32_t y) {
+                for (uint32_t x = 0; x < nextWidth; x++)
+                {
+                    glm::vec4 sum(0.0f);
+                    for (const auto& tap : verticalTaps[y])
+                        sum += horizontal[(size_t)tap.Index * nextWidth + x] * tap.Weight;
+                    destination[(size_t)y * nextWidth + x] = sum;
+                }
+            });
+
+            return destination;
+        }
+
+        static void StoreLevel(const std::vector<glm::vec4>& texels, const TextureUsage usage, uint8_t* out)
+        {
+            Pool::ParallelFor((uint32_t)((texels.size() + 1023) / 1024), [&](const uint32_t chunk) {
+                const size_t end = std::min(texels.size(), ((size_t)chunk + 1) * 1024);
+                for (size_t i = (size_t)chunk * 1024; i < end; i++)
+                {
+                    glm::vec4 texel = texels[i];
+                    if (usage == TextureUsage::Color)
+                    {
+                        texel.r = LinearToSRGB(texel.r);
+                        texel.g = LinearToSRGB(texel.g);
+                        texel.b = LinearToSRGB(texel.b);
+                    }
+                    else if (usage == TextureUsage::Normal)
+                    {
+                        // Averaged normals get shorter, stored at unit length again.
+                        glm::vec3 normal = glm::vec3(texel) * 2.0f - 1.0f;
+                        const float length = glm::length(normal);
+                        normal = length > 1e-6f ? normal / length : glm::vec3(0.0f, 0.0f, 1.0f);
+                        texel = glm::vec4(normal * 0.5f + 0.5f, texel.a);
+                    }
+
+                    for (uint32_t c = 0; c < 4; c++)
+                        out[i * 4 + c] = ToUnorm8(texel[c]);
+                }
+            });
+        }
+    }
+
+    Buffer MipGenerator::Generate(const uint8_t* pixels, const uint32_t width, const uint32_t height, const TextureUsage usage, const MipFilter filter,
+        const ImageParameter wrapS, const ImageParameter wrapT, uint32_t& outLevels)
+    {
+        outLevels = filter == MipFilter::None ? 1 : Image::GetMipLevelCount(width, height);
+
+        Buffer chain;
+        chain.Allocate(Image::GetMipChainSize(ImageFormat::RGBA, width, height, outLevels));
+        auto* out = static_cast<uint8_t*>(chain.Data);
+        memcpy(out, pixels, (size_t)width * height * 4);
+        if (outLevels == 1)
+            return chain;
+
+        std::vector<glm::vec4> level((size_t)width * height);
+        for (size_t i = 0; i < level.size(); i++)
+        {
+            const uint8_t* texel = pixels + i * 4;
+            if (usage == TextureUsage::Color)
+                level[i] = glm::vec4(Utils::SRGBToLinear(texel[0]), Utils::SRGBToLinear(texel[1]), Utils::SRGBToLinear(texel[2]), (float)texel[3] / 255.0f);
+            else
+                level[i] = glm::vec4(texel[0], texel[1], texel[2], texel[3]) / 255.0f;
+        }
+
+        uint32_t levelWidth = width, levelHeight = height;
+        for (uint32_t mip = 1; mip < outLevels; mip++)
+        {
+            level = Utils::Downsample(level, levelWidth, levelHeight, filter, wrapS, wrapT);
+            levelWidth = std::max(levelWidth / 2, 1u);
+            levelHeight = std::max(levelHeight / 2, 1u);
+
+            Utils::StoreLevel(level, usage, out + Image::GetMipChainSize(ImageFormat::RGBA, width, height, mip));
+        }
+
+        return chain;
+    }
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "czpch.h"
+
+#include "Chozo/Core/Buffer.h"
+#include "Texture.h"
+
+namespace Chozo {
+
+    // Builds mip chains of 8-bit RGBA images on the CPU, so textures load with every level instead of
+    // generating them on the GPU after the upload. Levels are filtered from the float result of the
+    // previous one, rows of each level are split over worker threads.
+    class MipGenerator
+    {
+    public:
+        // Chain down to 1x1 with level 0 copied as it is, laid out like Image::GetMipChainSize.
+        // Color textures are filtered in linear space, normal maps are renormalized on every level. Taps past the
+        // edges are addressed like the sampler's wrap mode does, anything but (mirrored) repeat clamps.
+        static Buffer Generate(const uint8_t* pixels, uint32_t width, uint32_t height, TextureUsage usage, MipFilter filter,
+            ImageParameter wrapS, ImageParameter wrapT, uint32_t& outLevels);
+    };
+}
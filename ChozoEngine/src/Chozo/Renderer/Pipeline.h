@@ -8,6 +8,16 @@
 
 namespace Chozo {
 
+    enum class DepthCompareOperator
+    {
+        Less = 0, LessOrEqual, Equal, Always
+    };
+
+    enum class BlendMode
+    {
+        None = 0, Additive
+    };
+
     struct PipelineSpecification
     {
         Ref<Shader> Shader;
@@ -19,6 +29,13 @@ namespace Chozo {
 		bool Wireframe = false;
 		float LineWidth = 1.0f;
 
+		// Mesh draws only, fullscreen draws keep their fixed state.
+		DepthCompareOperator DepthOperator = DepthCompareOperator::Less;
+		bool ColorWrite = true;
+		BlendMode Blending = BlendMode::None;
+		// Draws meshes from their position stream, for shaders that only read a_Position.
+		bool PositionOnly = false;
+
 		std::string DebugName;
     };
 
@@ -28,8 +45,12 @@ namespace Chozo {
         ~Pipeline() = default;
 
         virtual PipelineSpecification GetSpec() const = 0;
+        // Mesh draws read the state when they are submitted.
+        virtual PipelineSpecification& GetSpecification() = 0;
         virtual Ref<Shader> GetShader() const = 0;
         virtual Ref<Framebuffer> GetTargetFramebuffer() const = 0;
+        // Render graphs point transient passes at a pooled target each frame.
+        virtual void SetTargetFramebuffer(const Ref<Framebuffer>& framebuffer) = 0;
 
         static Ref<Pipeline> Create(PipelineSpecification& spec);
     };
@@ -23,13 +23,19 @@ namespace Chozo {
     public:
         virtual ~RenderAPI() = default;
         virtual void Init() = 0;
+        virtual void Shutdown() = 0;
+        // Runs on the render thread before the first command of every frame.
+        virtual void BeginFrame() = 0;
         
         virtual uint32_t GetMaxTextureSlots() = 0;
+        // Whether textures of a block compressed format can be created.
+        virtual bool IsCompressedFormatSupported(ImageFormat format) = 0;
 
         virtual void SetClearColor(const glm::vec4& color) = 0;
         virtual void Clear() = 0;
 
         virtual void DrawIndexed(const Ref<VertexArray>& vertexArray, uint32_t indexCount, uint32_t indexOffset, uint32_t vertexOffset) = 0;
+        virtual void DrawIndexedRanges(const Ref<VertexArray>& vertexArray, const IndexRange* ranges, uint32_t rangeCount, uint32_t vertexOffset) = 0;
         virtual void DrawLines(const Ref<VertexArray>& vertexArray, uint32_t vertexCount) = 0;
 
         virtual void RenderCubemap(Ref<Pipeline> pipeline, Ref<TextureCube> cubemap, const Ref<Texture2D> texture) = 0;
@@ -47,24 +53,34 @@ namespace Chozo {
         virtual void RenderFullscreenQuad(Ref<Pipeline> pipeline, Ref<Material> material = nullptr) = 0;
         virtual void SubmitFullscreenQuad(Ref<RenderCommandBuffer> commandBuffer, Ref<Pipeline> pipeline, Ref<Material> material = nullptr) = 0;
         virtual void SubmitFullscreenBox(Ref<RenderCommandBuffer> commandBuffer, Ref<Pipeline> pipeline, Ref<Material> material = nullptr) = 0;
-        virtual void SubmitMeshWithMaterial(Ref<RenderCommandBuffer> commandBuffer, Ref<Pipeline> pipeline, Ref<DynamicMesh> mesh, uint32_t submeshIndex, Ref<Material> material, glm::mat4 transform, int id) = 0;
+        // The mesh and material are not retained, the caller keeps them alive until the command has executed.
+        virtual void SubmitMeshWithMaterial(const Ref<RenderCommandBuffer>& commandBuffer, const Ref<Pipeline>& pipeline, DynamicMesh* mesh, uint32_t submeshIndex, uint32_t lod, const IndexRange* ranges, uint32_t rangeCount, Material* material, const glm::mat4& transform, int id) = 0;
 
         virtual void CopyImage(Ref<RenderCommandBuffer> commandBuffer, Ref<Texture2D> source, SharedBuffer& dest) = 0;
+
+        // Counts the fragments passing the depth test in between, over pixelCount pixels. The result reaches
+        // Statistics a few frames later, once the GPU caught up.
+        virtual void BeginFragmentQuery(Ref<RenderCommandBuffer> commandBuffer) = 0;
+        virtual void EndFragmentQuery(Ref<RenderCommandBuffer> commandBuffer, uint32_t pixelCount) = 0;
     };
 
         class RenderCommand
     {
     public:
         static void Init() { s_API->Init(); }
+        static void Shutdown() { s_API->Shutdown(); }
+        static void BeginFrame() { s_API->BeginFrame(); }
         static void SwitchAPI(RenderAPI::Type api);
         inline static RenderAPI::Type GetType() { return s_Type; }
 
         inline static uint32_t GetMaxTextureSlots()  { return s_API->GetMaxTextureSlots(); }
+        inline static bool IsCompressedFormatSupported(ImageFormat format) { return s_API->IsCompressedFormatSupported(format); }
 
         inline static void SetClearColor(const glm::vec4& color) { s_API->SetClearColor(color); }
         inline static void Clear() { s_API->Clear(); }
 
         inline static void DrawIndexed(const Ref<VertexArray>& vertexArray, uint32_t indexCount, uint32_t indexOffset = 0, uint32_t vertexOffset = 0) { s_API->DrawIndexed(vertexArray, indexCount, indexOffset, vertexOffset); }
+        inline static void DrawIndexedRanges(const Ref<VertexArray>& vertexArray, const IndexRange* ranges, uint32_t rangeCount, uint32_t vertexOffset = 0) { s_API->DrawIndexedRanges(vertexArray, ranges, rangeCount, vertexOffset); }
         inline static void DrawLines(const Ref<VertexArray>& vertexArray, uint32_t vertexCount) { s_API->DrawLines(vertexArray, vertexCount); }
 
         inline static void RenderCubemap(Ref<Pipeline> pipeline, Ref<TextureCube> cubemap, const Ref<Texture2D> texture) { s_API->RenderCubemap(pipeline, cubemap, texture); }
@@ -82,9 +98,12 @@ namespace Chozo {
         inline static void RenderFullscreenQuad(Ref<Pipeline> pipeline, Ref<Material> material = nullptr) { s_API->RenderFullscreenQuad(pipeline, material); }
         inline static void SubmitFullscreenQuad(Ref<RenderCommandBuffer> commandBuffer, Ref<Pipeline> pipeline, Ref<Material> material = nullptr) { s_API->SubmitFullscreenQuad(commandBuffer, pipeline, material); }
         inline static void SubmitFullscreenBox(Ref<RenderCommandBuffer> commandBuffer, Ref<Pipeline> pipeline, Ref<Material> material = nullptr) { s_API->SubmitFullscreenBox(commandBuffer, pipeline, material); }
-        inline static void SubmitMeshWithMaterial(Ref<RenderCommandBuffer> commandBuffer, Ref<Pipeline> pipeline, Ref<DynamicMesh> mesh, uint32_t submeshIndex, Ref<Material> material, glm::mat4 transform, int id) { s_API->SubmitMeshWithMaterial(commandBuffer, pipeline, mesh, submeshIndex, material, transform, id); }
+        inline static void SubmitMeshWithMaterial(const Ref<RenderCommandBuffer>& commandBuffer, const Ref<Pipeline>& pipeline, DynamicMesh* mesh, uint32_t submeshIndex, uint32_t lod, const IndexRange* ranges, uint32_t rangeCount, Material* material, const glm::mat4& transform, int id) { s_API->SubmitMeshWithMaterial(commandBuffer, pipeline, mesh, submeshIndex, lod, ranges, rangeCount, material, transform, id); }
 
         inline static void CopyImage(Ref<RenderCommandBuffer> commandBuffer, Ref<Texture2D> source, SharedBuffer& dest){ s_API->CopyImage(commandBuffer, source, dest); }
+
+        inline static void BeginFragmentQuery(Ref<RenderCommandBuffer> commandBuffer) { s_API->BeginFragmentQuery(commandBuffer); }
+        inline static void EndFragmentQuery(Ref<RenderCommandBuffer> commandBuffer, uint32_t pixelCount) { s_API->EndFragmentQuery(commandBuffer, pixelCount); }
     private:
         static RenderAPI::Type s_Type;
         static RenderAPI* s_API;
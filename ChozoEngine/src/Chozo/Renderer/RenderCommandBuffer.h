@@ -2,6 +2,8 @@
 
 #include "czpch.h"
 
+#include "RenderCommandQueue.h"
+
 namespace Chozo {
 
     class RenderCommandBuffer : public RefCounted
@@ -14,7 +16,13 @@ namespace Chozo {
 
         virtual void Submit() = 0;
 
-        virtual void AddCommand(std::function<void()>&& func) = 0;
+        template<typename FuncT>
+        void AddCommand(FuncT&& func)
+        {
+            GetCommandQueue().Submit(std::forward<FuncT>(func));
+        }
+
+        virtual RenderCommandQueue& GetCommandQueue() = 0;
 
         static Ref<RenderCommandBuffer> Create();
     };
@@ -0,0 +1,299 @@
+#include "RenderCommandQueue.h"
+
+namespace Chozo {
+
+    namespace Utils {
+
+        static uint32_t AlignUp(const uint32_t size, const uint32_t alignment)
+        {
+            return (size + alignment - 1) & ~(alignment - 1);
+        }
+
+        static uint8_t* AllocateCommandBuffer(const uint32_t capacity)
+        {
+            return static_cast<uint8_t*>(::operator new(capacity, std::align_val_t(RenderCommandQueue::PayloadAlignment)));
+        }
+
+        static void FreeCommandBuffer(uint8_t* buffer)
+        {
+            ::operator delete(buffer, std::align_val_t(RenderCommandQueue::PayloadAlignment));
+        }
+
+        // Runs of commands smaller than this share a chunk with the other nodes of their thread.
+        static constexpr uint32_t CommandChunkCapacity = 64 * 1024;
+    }
+
+    RenderCommandQueue::RenderCommandQueue(const uint32_t capacity)
+        : m_Capacity(Utils::AlignUp(capacity, PayloadAlignment))
+    {
+        m_CommandBuffer = Utils::AllocateCommandBuffer(m_Capacity);
+    }
+
+    RenderCommandQueue::~RenderCommandQueue()
+    {
+        Reset();
+        Utils::FreeCommandBuffer(m_CommandBuffer);
+    }
+
+    void* RenderCommandQueue::Allocate(const RenderCommandFn func, const RenderCommandMoveFn move, const uint32_t size)
+    {
+        const uint32_t payloadSize = Utils::AlignUp(size, PayloadAlignment);
+        if (m_Size + HeaderSize + payloadSize > m_Capacity)
+            Grow(m_Size + HeaderSize + payloadSize);
+
+        auto* header = reinterpret_cast<CommandHeader*>(m_CommandBuffer + m_Size);
+        header->Execute = func;
+        header->Move = move;
+        header->Size = payloadSize;
+
+        void* payload = m_CommandBuffer + m_Size + HeaderSize;
+        m_Size += HeaderSize + payloadSize;
+        m_CommandCount++;
+        return payload;
+    }
+
+    void RenderCommandQueue::Execute()
+    {
+        // Commands must not submit to the queue that is executing them, Renderer routes those to the other queue.
+        uint32_t offset = 0;
+        while (offset < m_Size)
+        {
+            auto* header = reinterpret_cast<CommandHeader*>(m_CommandBuffer + offset);
+            header->Execute(m_CommandBuffer + offset + HeaderSize);
+            offset += HeaderSize + header->Size;
+        }
+
+        m_Size = 0;
+        m_CommandCount = 0;
+    }
+
+    void RenderCommandQueue::Reset()
+    {
+        uint32_t offset = 0;
+        while (offset < m_Size)
+        {
+            auto* header = reinterpret_cast<CommandHeader*>(m_CommandBuffer + offset);
+            header->Move(nullptr, m_CommandBuffer + offset + HeaderSize);
+            offset += HeaderSize + header->Size;
+        }
+
+        m_Size = 0;
+        m_CommandCount = 0;
+    }
+
+    void RenderCommandQueue::Append(RenderCommandQueue& other)
+    {
+        if (other.m_Size == 0)
+            return;
+
+        AppendCommands(other.m_CommandBuffer, other.m_Size, other.m_CommandCount);
+        other.m_Size = 0;
+        other.m_CommandCount = 0;
+    }
+
+    void RenderCommandQueue::MoveCommands(uint8_t* dst, uint8_t* src, const uint32_t size)
+    {
+        // Payloads are not trivially relocatable in general, move them one by one.
+        uint32_t offset = 0;
+        while (offset < size)
+        {
+            auto* header = reinterpret_cast<CommandHeader*>(src + offset);
+            memcpy(dst + offset, header, sizeof(CommandHeader));
+            header->Move(dst + offset + HeaderSize, src + offset + HeaderSize);
+            offset += HeaderSize + header->Size;
+        }
+    }
+
+    void RenderCommandQueue::AppendCommands(uint8_t* commands, const uint32_t size, const uint32_t count)
+    {
+        if (m_Size + size > m_Capacity)
+            Grow(m_Size + size);
+
+        MoveCommands(m_CommandBuffer + m_Size, commands, size);
+        m_Size += size;
+        m_CommandCount += count;
+    }
+
+    void RenderCommandQueue::Grow(const uint32_t required)
+    {
+        uint32_t capacity = std::max(m_Capacity, PayloadAlignment);
+        while (capacity < required)
+            capacity *= 2;
+
+        uint8_t* buffer = Utils::AllocateCommandBuffer(capacity);
+        MoveCommands(buffer, m_CommandBuffer, m_Size);
+
+        Utils::FreeCommandBuffer(m_CommandBuffer);
+        m_CommandBuffer = buffer;
+        m_Capacity = capacity;
+    }
+
+    // Linear block the nodes of one producer thread are carved from. Every node holds a reference, and so
+    // does the thread until the chunk is full.
+    struct MPSCCommandQueue::Chunk
+    {
+        std::atomic<uint32_t> References = 1;
+        uint32_t Size = 0;
+        uint32_t Capacity = 0;
+
+        uint8_t* GetData() { return reinterpret_cast<uint8_t*>(this) + Utils::AlignUp(sizeof(Chunk), RenderCommandQueue::PayloadAlignment); }
+
+        static Chunk* Create(const uint32_t capacity)
+        {
+            auto* chunk = new (Utils::AllocateCommandBuffer(Utils::AlignUp(sizeof(Chunk), RenderCommandQueue::PayloadAlignment) + capacity)) Chunk();
+            chunk->Capacity = capacity;
+            return chunk;
+        }
+
+        static void Release(Chunk* chunk)
+        {
+            if (chunk->References.fetch_sub(1, std::memory_order_acq_rel) != 1)
+                return;
+
+            chunk->~Chunk();
+            Utils::FreeCommandBuffer(reinterpret_cast<uint8_t*>(chunk));
+        }
+    };
+
+    MPSCCommandQueue::MPSCCommandQueue()
+        : m_Head(&m_Stub), m_Tail(&m_Stub)
+    {
+    }
+
+    MPSCCommandQueue::~MPSCCommandQueue()
+    {
+        while (Node* node = Pop())
+        {
+            uint8_t* commands = GetCommands(node);
+            uint32_t offset = 0;
+            while (offset < node->Size)
+            {
+                auto* header = reinterpret_cast<RenderCommandQueue::CommandHeader*>(commands + offset);
+                header->Move(nullptr, commands + offset + RenderCommandQueue::HeaderSize);
+                offset += RenderCommandQueue::HeaderSize + header->Size;
+            }
+            FreeNode(node);
+        }
+    }
+
+    void MPSCCommandQueue::Append(RenderCommandQueue& queue)
+    {
+        if (queue.m_Size == 0)
+            return;
+
+        Node* node = AllocateNode(queue.m_Size, queue.m_CommandCount);
+        RenderCommandQueue::MoveCommands(GetCommands(node), queue.m_CommandBuffer, queue.m_Size);
+        Push(node);
+
+        queue.m_Size = 0;
+        queue.m_CommandCount = 0;
+    }
+
+    void MPSCCommandQueue::Drain(RenderCommandQueue& queue)
+    {
+        while (Node* node = Pop())
+        {
+            queue.AppendCommands(GetCommands(node), node->Size, node->CommandCount);
+            FreeNode(node);
+        }
+    }
+
+    MPSCCommandQueue::Node* MPSCCommandQueue::AllocateNode(const uint32_t size, const uint32_t commandCount)
+    {
+        const uint32_t required = NodeSize + size;
+        Chunk*& chunk = GetLocalChunk();
+        if (!chunk || chunk->Size + required > chunk->Capacity)
+        {
+            if (chunk)
+                Chunk::Release(chunk);
+            chunk = Chunk::Create(std::max(Utils::CommandChunkCapacity, required));
+        }
+
+        auto* node = new (chunk->GetData() + chunk->Size) Node();
+        node->Owner = chunk;
+        node->Size = size;
+        node->CommandCount = commandCount;
+        chunk->Size += required;
+        chunk->References.fetch_add(1, std::memory_order_relaxed);
+        return node;
+    }
+
+    MPSCCommandQueue::Node* MPSCCommandQueue::AllocateNode(const RenderCommandQueue::RenderCommandFn func, const RenderCommandQueue::RenderCommandMoveFn move, const uint32_t size)
+    {
+        const uint32_t payloadSize = Utils::AlignUp(size, RenderCommandQueue::PayloadAlignment);
+        Node* node = AllocateNode(RenderCommandQueue::HeaderSize + payloadSize, 1);
+
+        auto* header = reinterpret_cast<RenderCommandQueue::CommandHeader*>(GetCommands(node));
+        header->Execute = func;
+        header->Move = move;
+        header->Size = payloadSize;
+        return node;
+    }
+
+    MPSCCommandQueue::Chunk*& MPSCCommandQueue::GetLocalChunk()
+    {
+        // Released when the thread exits, the chunk itself stays until its last node is drained.
+        struct LocalChunk
+        {
+            Chunk* Current = nullptr;
+
+            ~LocalChunk()
+            {
+                if (Current)
+                    Chunk::Release(Current);
+            }
+        };
+
+        static thread_local LocalChunk s_LocalChunk;
+        return s_LocalChunk.Current;
+    }
+
+    void MPSCCommandQueue::FreeNode(Node* node)
+    {
+        Chunk* chunk = node->Owner;
+        node->~Node();
+        Chunk::Release(chunk);
+    }
+
+    void MPSCCommandQueue::Push(Node* node)
+    {
+        node->Next.store(nullptr, std::memory_order_relaxed);
+        Node* prev = m_Head.exchange(node, std::memory_order_acq_rel);
+        prev->Next.store(node, std::memory_order_release);
+    }
+
+    MPSCCommandQueue::Node* MPSCCommandQueue::Pop()
+    {
+        Node* tail = m_Tail;
+        Node* next = tail->Next.load(std::memory_order_acquire);
+        if (tail == &m_Stub)
+        {
+            if (!next)
+                return nullptr;
+
+            m_Tail = next;
+            tail = next;
+            next = next->Next.load(std::memory_order_acquire);
+        }
+
+        if (next)
+        {
+            m_Tail = next;
+            return tail;
+        }
+
+        // A producer has swapped the head but not linked its node yet.
+        if (tail != m_Head.load(std::memory_order_acquire))
+            return nullptr;
+
+        Push(&m_Stub);
+        next = tail->Next.load(std::memory_order_acquire);
+        if (next)
+        {
+            m_Tail = next;
+            return tail;
+        }
+
+        return nullptr;
+    }
+}
@@ -0,0 +1,148 @@
+#pragma once
+
+#include "czpch.h"
+
+#include <atomic>
+
+namespace Chozo {
+
+    // Linear command buffer, each command is a function pointer followed by its payload constructed in place.
+    // Memory is kept between frames, so recording does not allocate once the buffer has grown to fit a frame.
+    class RenderCommandQueue
+    {
+    public:
+        typedef void(*RenderCommandFn)(void*);
+        // Move constructs the payload at dst and destroys src, dst is null when the payload is only destroyed.
+        typedef void(*RenderCommandMoveFn)(void* dst, void* src);
+
+        static constexpr uint32_t PayloadAlignment = 16;
+
+        explicit RenderCommandQueue(uint32_t capacity = 1024 * 1024);
+        ~RenderCommandQueue();
+
+        RenderCommandQueue(const RenderCommandQueue&) = delete;
+        RenderCommandQueue& operator=(const RenderCommandQueue&) = delete;
+
+        template<typename FuncT>
+        void Submit(FuncT&& func)
+        {
+            using Fn = std::decay_t<FuncT>;
+            static_assert(alignof(Fn) <= PayloadAlignment, "Render command payload is over-aligned!");
+
+            void* storageBuffer = Allocate(&ExecuteCommand<Fn>, &MoveCommand<Fn>, sizeof(Fn));
+            new (storageBuffer) Fn(std::forward<FuncT>(func));
+        }
+
+        template<typename Fn>
+        static void ExecuteCommand(void* ptr)
+        {
+            auto pFunc = static_cast<Fn*>(ptr);
+            (*pFunc)();
+            pFunc->~Fn();
+        }
+
+        template<typename Fn>
+        static void MoveCommand(void* dst, void* src)
+        {
+            auto pFunc = static_cast<Fn*>(src);
+            if (dst)
+                new (dst) Fn(std::move(*pFunc));
+            pFunc->~Fn();
+        }
+
+        void* Allocate(RenderCommandFn func, RenderCommandMoveFn move, uint32_t size);
+
+        // Runs every command in submission order, then resets.
+        void Execute();
+        // Destroys pending payloads without running them.
+        void Reset();
+        // Moves the commands of other to the end of this queue in order, leaving other empty.
+        void Append(RenderCommandQueue& other);
+
+        uint32_t GetCommandCount() const { return m_CommandCount; }
+        uint32_t GetSize() const { return m_Size; }
+        uint32_t GetCapacity() const { return m_Capacity; }
+
+    private:
+        friend class MPSCCommandQueue;
+
+        struct CommandHeader
+        {
+            RenderCommandFn Execute;
+            RenderCommandMoveFn Move;
+            uint32_t Size; // Payload size padded to PayloadAlignment.
+        };
+
+        static constexpr uint32_t HeaderSize = (sizeof(CommandHeader) + PayloadAlignment - 1) & ~(PayloadAlignment - 1);
+
+        // Moves the size bytes of commands at src to dst, which has room for them, in the same layout.
+        static void MoveCommands(uint8_t* dst, uint8_t* src, uint32_t size);
+        // Moves count commands laid out over size bytes at commands to the end of the queue.
+        void AppendCommands(uint8_t* commands, uint32_t size, uint32_t count);
+        void Grow(uint32_t required);
+    private:
+        uint8_t* m_CommandBuffer = nullptr;
+        uint32_t m_Size = 0;
+        uint32_t m_Capacity = 0;
+        uint32_t m_CommandCount = 0;
+    };
+
+    // Vyukov's intrusive multi-producer/single-consumer queue, producers never block each other or the consumer.
+    // Each node is a block of commands in the RenderCommandQueue layout, a single submit or a whole appended queue,
+    // moved into the linear queue in one go when drained. Producers carve the nodes out of a thread local chunk,
+    // which goes back to the heap once the producer moved on and its nodes were drained.
+    class MPSCCommandQueue
+    {
+    public:
+        MPSCCommandQueue();
+        ~MPSCCommandQueue();
+
+        MPSCCommandQueue(const MPSCCommandQueue&) = delete;
+        MPSCCommandQueue& operator=(const MPSCCommandQueue&) = delete;
+
+        template<typename FuncT>
+        void Submit(FuncT&& func)
+        {
+            using Fn = std::decay_t<FuncT>;
+            static_assert(alignof(Fn) <= RenderCommandQueue::PayloadAlignment, "Render command payload is over-aligned!");
+
+            Node* node = AllocateNode(&RenderCommandQueue::ExecuteCommand<Fn>, &RenderCommandQueue::MoveCommand<Fn>, sizeof(Fn));
+            new (GetCommands(node) + RenderCommandQueue::HeaderSize) Fn(std::forward<FuncT>(func));
+            Push(node);
+        }
+
+        // Moves the commands of queue in order as a single block, leaving it empty. Safe from any producer thread.
+        void Append(RenderCommandQueue& queue);
+        // Moves every queued command to the end of queue, preserving the order of each producer.
+        // A push still in flight is picked up by the next drain. Consumer thread only.
+        void Drain(RenderCommandQueue& queue);
+    private:
+        struct Chunk;
+
+        struct Node
+        {
+            std::atomic<Node*> Next = nullptr;
+            Chunk* Owner = nullptr;
+            uint32_t Size = 0; // Bytes of the commands following the node.
+            uint32_t CommandCount = 0;
+        };
+
+        static constexpr uint32_t NodeSize = (sizeof(Node) + RenderCommandQueue::PayloadAlignment - 1) & ~(RenderCommandQueue::PayloadAlignment - 1);
+
+        // Node with room for size bytes of commands, from the calling thread's chunk.
+        static Node* AllocateNode(uint32_t size, uint32_t commandCount);
+        // Node holding a single command with a payload of size bytes, its header filled in.
+        static Node* AllocateNode(RenderCommandQueue::RenderCommandFn func, RenderCommandQueue::RenderCommandMoveFn move, uint32_t size);
+        static void FreeNode(Node* node);
+        // The calling thread's chunk, null until it submits.
+        static Chunk*& GetLocalChunk();
+        static uint8_t* GetCommands(Node* node) { return reinterpret_cast<uint8_t*>(node) + NodeSize; }
+
+        void Push(Node* node);
+        Node* Pop();
+    private:
+        Node m_Stub;
+        std::atomic<Node*> m_Head;
+        Node* m_Tail;
+    };
+}
@@ -0,0 +1,233 @@
+#include "RenderGraph.h"
+
+namespace Chozo {
+
+    namespace Utils {
+
+        // Roughly a second at 60 fps, on demand renderers (thumbnails) keep their targets between renders.
+        static constexpr uint64_t RenderTargetMaxIdleFrames = 60;
+
+        static bool IsTargetCompatible(const FramebufferSpecification& a, const FramebufferSpecification& b)
+        {
+            if (a.Width != b.Width || a.Height != b.Height || a.Samples != b.Samples || a.DepthRenderbuffer != b.DepthRenderbuffer)
+                return false;
+
+            const auto& attachmentsA = a.Attachments.Attachments;
+            const auto& attachmentsB = b.Attachments.Attachments;
+            if (attachmentsA.size() != attachmentsB.size())
+                return false;
+
+            for (size_t i = 0; i < attachmentsA.size(); i++)
+            {
+                if (attachmentsA[i].TextureFormat != attachmentsB[i].TextureFormat)
+                    return false;
+            }
+
+            return true;
+        }
+    }
+
+    struct PooledRenderTarget
+    {
+        Ref<Framebuffer> Framebuffer;
+        bool InUse = false;
+        uint64_t LastUsedFrame = 0;
+    };
+
+    static std::vector<PooledRenderTarget> s_RenderTargets;
+    static uint64_t s_RenderTargetFrame = 0;
+
+    Ref<Framebuffer> RenderTargetPool::Acquire(const FramebufferSpecification& spec)
+    {
+        CZ_CORE_ASSERT(spec.ExistingImages.empty(), "Pooled render targets can't wrap existing images!");
+
+        for (auto& target : s_RenderTargets)
+        {
+            if (target.InUse || !Utils::IsTargetCompatible(target.Framebuffer->GetSpecification(), spec))
+                continue;
+
+            target.InUse = true;
+            target.LastUsedFrame = s_RenderTargetFrame;
+            // The clear color is not part of the memory, the previous user may have cleared to another one.
+            target.Framebuffer->GetSpecification().ClearColor = spec.ClearColor;
+            return target.Framebuffer;
+        }
+
+        PooledRenderTarget target;
+        target.Framebuffer = Framebuffer::Create(spec);
+        target.InUse = true;
+        target.LastUsedFrame = s_RenderTargetFrame;
+        s_RenderTargets.push_back(target);
+        return target.Framebuffer;
+    }
+
+    void RenderTargetPool::Release(const Ref<Framebuffer>& framebuffer)
+    {
+        for (auto& target : s_RenderTargets)
+        {
+            if (target.Framebuffer == framebuffer)
+            {
+                target.InUse = false;
+                return;
+            }
+        }
+
+        CZ_CORE_WARN("Released a render target that is not from the pool.");
+    }
+
+    void RenderTargetPool::NextFrame()
+    {
+        s_RenderTargetFrame++;
+
+        // Framebuffers free their GL objects through the renderer, after the frames that may still use them.
+        s_RenderTargets.erase(std::remove_if(s_RenderTargets.begin(), s_RenderTargets.end(), [](const PooledRenderTarget& target) {
+            return !target.InUse && s_RenderTargetFrame - target.LastUsedFrame > Utils::RenderTargetMaxIdleFrames;
+        }), s_RenderTargets.end());
+    }
+
+    void RenderTargetPool::Shutdown()
+    {
+        s_RenderTargets.clear();
+    }
+
+    uint32_t RenderTargetPool::GetTargetCount()
+    {
+        return (uint32_t)s_RenderTargets.size();
+    }
+
+    RenderGraph::PassHandle RenderGraph::AddPass(const RenderGraphPassSpecification& spec)
+    {
+        CZ_CORE_ASSERT(spec.Pass && spec.Execute, "Render graph pass needs a render pass and an execute function!");
+
+        PassNode node;
+        node.Spec = spec;
+        m_Passes.push_back(node);
+        m_Compiled = false;
+        return (PassHandle)m_Passes.size() - 1;
+    }
+
+    void RenderGraph::Read(const PassHandle pass, const PassHandle source, const uint32_t attachment, const std::string& name)
+    {
+        CZ_CORE_ASSERT(source < pass && pass < m_Passes.size(), "Passes can only read passes added before them!");
+
+        m_Passes[pass].Reads.push_back({ source, attachment, name });
+        m_Compiled = false;
+    }
+
+    void RenderGraph::SetOutput(const PassHandle pass)
+    {
+        CZ_CORE_ASSERT(pass < m_Passes.size(), "Invalid render graph pass!");
+        CZ_CORE_ASSERT(m_Passes[pass].Spec.Pass->GetTargetFramebuffer(), "Render graph outputs need their own framebuffer!");
+
+        m_Passes[pass].Output = true;
+        m_Compiled = false;
+    }
+
+    void RenderGraph::SetEnabled(const PassHandle pass, const bool enabled)
+    {
+        CZ_CORE_ASSERT(pass < m_Passes.size() && m_Passes[pass].Output, "Only render graph outputs can be disabled!");
+
+        auto& node = m_Passes[pass];
+        if (node.Enabled == enabled)
+            return;
+
+        node.Enabled = enabled;
+        m_Compiled = false;
+
+        auto framebuffer = node.Spec.Pass->GetTargetFramebuffer();
+        if (enabled)
+            framebuffer->Resize(m_Width, m_Height);
+        else
+            framebuffer->Resize(1, 1);
+    }
+
+    void RenderGraph::SetExtent(const uint32_t width, const uint32_t height)
+    {
+        if (width == 0 || height == 0 || (width == m_Width && height == m_Height))
+            return;
+
+        m_Width = width;
+        m_Height = height;
+
+        // Transient targets of the new extent are picked from the pool on the next Execute.
+        for (auto& node : m_Passes)
+        {
+            if (node.Output && node.Enabled)
+                node.Spec.Pass->GetTargetFramebuffer()->Resize(width, height);
+        }
+    }
+
+    void RenderGraph::Execute()
+    {
+        if (!m_Compiled)
+            Compile();
+
+        for (auto& node : m_Passes)
+        {
+            if (node.Culled)
+                continue;
+
+            if (!node.Output)
+            {
+                FramebufferSpecification spec = node.Spec.Target;
+                spec.Width = m_Width;
+                spec.Height = m_Height;
+                node.Spec.Pass->GetPipeline()->SetTargetFramebuffer(RenderTargetPool::Acquire(spec));
+            }
+
+            for (const auto& read : node.Reads)
+            {
+                const auto& source = m_Passes[read.Source].Spec.Pass;
+                node.Spec.Pass->SetInput(read.Name, read.Attachment == DepthAttachment ? source->GetDepthOutput() : source->GetOutput(read.Attachment));
+            }
+
+            node.Spec.Execute();
+
+            for (const PassHandle released : node.Releases)
+                RenderTargetPool::Release(m_Passes[released].Spec.Pass->GetTargetFramebuffer());
+        }
+    }
+
+    void RenderGraph::Compile()
+    {
+        // Reads only point backwards, so one sweep from the end reaches everything the outputs depend on.
+        for (auto& node : m_Passes)
+        {
+            node.Culled = !node.Output || !node.Enabled;
+            node.Releases.clear();
+        }
+
+        for (size_t i = m_Passes.size(); i-- > 0;)
+        {
+            if (m_Passes[i].Culled)
+                continue;
+
+            for (const auto& read : m_Passes[i].Reads)
+                m_Passes[read.Source].Culled = false;
+        }
+
+        // A transient target lives from its pass to the last pass reading it.
+        std::vector<PassHandle> lastUse(m_Passes.size());
+        for (PassHandle i = 0; i < (PassHandle)m_Passes.size(); i++)
+        {
+            lastUse[i] = i;
+            if (m_Passes[i].Culled)
+                continue;
+
+            for (const auto& read : m_Passes[i].Reads)
+                lastUse[read.Source] = std::max(lastUse[read.Source], i);
+        }
+
+        for (PassHandle i = 0; i < (PassHandle)m_Passes.size(); i++)
+        {
+            const auto& node = m_Passes[i];
+            if (!node.Culled && !node.Output)
+                m_Passes[lastUse[i]].Releases.push_back(i);
+
+            if (node.Culled)
+                CZ_CORE_TRACE("Render graph culled pass {0}.", node.Spec.DebugName);
+        }
+
+        m_Compiled = true;
+    }
+}
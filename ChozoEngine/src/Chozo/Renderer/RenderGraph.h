@@ -0,0 +1,82 @@
+#pragma once
+
+#include "czpch.h"
+
+#include "RenderPass.h"
+
+namespace Chozo {
+
+    // Framebuffers for the transient targets of every render graph. A target released by one graph goes to
+    // the next request with the same attachments and extent, so graphs of the same size share their memory.
+    class RenderTargetPool
+    {
+    public:
+        static Ref<Framebuffer> Acquire(const FramebufferSpecification& spec);
+        static void Release(const Ref<Framebuffer>& framebuffer);
+
+        // Drops targets that were not acquired for a while, like the ones sized for a viewport before its resize.
+        static void NextFrame();
+        static void Shutdown();
+
+        static uint32_t GetTargetCount();
+    };
+
+    struct RenderGraphPassSpecification
+    {
+        std::string DebugName;
+        Ref<RenderPass> Pass;
+        // Attachments and clear color of a transient target, its extent follows the graph.
+        // Ignored for outputs, those keep the framebuffer of their pipeline.
+        FramebufferSpecification Target;
+        std::function<void()> Execute;
+    };
+
+    // Passes run in the order they were added and declare which attachments of earlier passes they sample.
+    // Only the outputs and the passes they depend on run, the others never get a target.
+    // Outputs keep their own framebuffer. Every other target is taken from the RenderTargetPool before its
+    // pass runs and given back after its last reader, commands execute in recording order so the next
+    // user of the memory only writes once the reads recorded before it are done.
+    class RenderGraph
+    {
+    public:
+        using PassHandle = uint32_t;
+        // Attachment index of the depth image, for Read.
+        static constexpr uint32_t DepthAttachment = ~0u;
+
+        PassHandle AddPass(const RenderGraphPassSpecification& spec);
+        // The pass samples attachment of source through the sampler uniform name.
+        void Read(PassHandle pass, PassHandle source, uint32_t attachment, const std::string& name);
+        // Outputs are read after the graph ran (viewport image, picking), they are never culled or pooled.
+        void SetOutput(PassHandle pass);
+        // Disabled outputs are culled along with what only they read (debug views), and shrink to a pixel.
+        void SetEnabled(PassHandle pass, bool enabled);
+
+        // Outputs are resized here, only when the extent changes.
+        void SetExtent(uint32_t width, uint32_t height);
+        void Execute();
+    private:
+        void Compile();
+    private:
+        struct PassRead
+        {
+            PassHandle Source;
+            uint32_t Attachment;
+            std::string Name;
+        };
+
+        struct PassNode
+        {
+            RenderGraphPassSpecification Spec;
+            std::vector<PassRead> Reads;
+            bool Output = false;
+            bool Enabled = true;
+            bool Culled = false;
+            // Transient targets handed back to the pool once this pass ran.
+            std::vector<PassHandle> Releases;
+        };
+
+        std::vector<PassNode> m_Passes;
+        uint32_t m_Width = 1, m_Height = 1;
+        bool m_Compiled = false;
+    };
+}
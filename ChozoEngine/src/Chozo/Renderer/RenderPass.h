@@ -5,6 +5,7 @@
 #include "Shader.h"
 #include "Framebuffer.h"
 #include "UniformBuffer.h"
+#include "StorageBuffer.h"
 #include "Pipeline.h"
 #include "Texture.h"
 
@@ -24,8 +25,11 @@ namespace Chozo {
 
 		virtual void SetInput(std::string_view name, Ref<UniformBuffer> uniformBuffer) = 0;
 		virtual void SetInput(std::string_view name, Ref<TextureCube> textureCube) = 0;
+		virtual void SetInput(std::string_view name, Ref<StorageBuffer> storageBuffer) = 0;
+		virtual void SetInput(std::string_view name, Ref<Texture2D> texture) = 0;
 
 		virtual Ref<Texture2D> GetOutput(uint32_t index) = 0;
+		virtual Ref<Texture2D> GetDepthOutput() = 0;
 
         virtual Ref<Pipeline> GetPipeline() const = 0;
         virtual Ref<Framebuffer> GetTargetFramebuffer() const = 0;
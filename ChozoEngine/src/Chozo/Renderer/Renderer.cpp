@@ -1,25 +1,158 @@
 #include "Renderer.h"
 
 #include "RenderCommand.h"
+#include "RenderGraph.h"
+#include "IBLCache.h"
+#include "SphericalHarmonics.h"
+#include "TextureCompressor.h"
+#include "TextureStreamer.h"
 #include "Geometry/BoxGeometry.h"
 #include "Geometry/QuadGeometry.h"
 
+#include "Chozo/Core/Application.h"
+#include "Chozo/Core/Pool.h"
+#include "Chozo/Core/RenderThread.h"
+#include "Chozo/Utilities/HashUtils.h"
+
 namespace Chozo {
 
     static Renderer::RendererConfig s_Config;
     static Renderer::RendererData* s_Data = nullptr;
-    static std::vector<std::function<void()>> s_RenderCommandQueue;
-    static std::atomic<std::chrono::steady_clock::time_point> s_LastSubmitTime = std::chrono::steady_clock::now();
-    static std::future<void> s_DebounceTask;
+
+    // Commands are recorded into one queue while the render thread executes the other.
+    static RenderCommandQueue s_CommandQueue[2];
+    static uint32_t s_CommandQueueSubmissionIndex = 0;
+    static std::thread::id s_RecordingThreadID;
+
+    static MPSCCommandQueue s_WorkerCommandQueue;
+
+    static std::vector<std::function<void()>> s_ResourceFreeQueue[Renderer::FramesInFlight];
+    static uint32_t s_FrameIndex = 0;
+    static std::mutex s_ResourceFreeMutex;
+
+    static FrameAllocator s_FrameAllocators[Renderer::FramesInFlight];
+
+    // Sky jobs submit to the renderer when done, shutdown waits for the ones still on the pool.
+    static uint32_t s_SkyJobsInFlight = 0;
+    static std::mutex s_SkyJobMutex;
+    static std::condition_variable s_SkyJobCondition;
+
+    namespace Utils {
+
+        static constexpr uint32_t IrradiancePreviewResolution = 32;
+
+        // Direction through texel (s, t) of a cubemap face, following the GL face selection rules.
+        static glm::vec3 GetCubemapDirection(const uint32_t face, const float s, const float t)
+        {
+            const float sc = s * 2.0f - 1.0f;
+            const float tc = t * 2.0f - 1.0f;
+            switch (face)
+            {
+                case 0: return glm::normalize(glm::vec3( 1.0f, -tc, -sc));
+                case 1: return glm::normalize(glm::vec3(-1.0f, -tc,  sc));
+                case 2: return glm::normalize(glm::vec3( sc,  1.0f,  tc));
+                case 3: return glm::normalize(glm::vec3( sc, -1.0f, -tc));
+                case 4: return glm::normalize(glm::vec3( sc, -tc,  1.0f));
+                default: return glm::normalize(glm::vec3(-sc, -tc, -1.0f));
+            }
+        }
+
+        static void FillIrradiancePreview(const Ref<TextureCube>& cubemap, const IrradianceSH& sh)
+        {
+            const uint32_t size = cubemap->GetWidth();
+            std::vector<glm::vec3> texels((size_t)size * size * 6);
+            for (uint32_t face = 0; face < 6; face++)
+            {
+                for (uint32_t y = 0; y < size; y++)
+                {
+                    for (uint32_t x = 0; x < size; x++)
+                    {
+                        const glm::vec3 direction = GetCubemapDirection(face, ((float)x + 0.5f) / (float)size, ((float)y + 0.5f) / (float)size);
+                        texels[((size_t)face * size + y) * size + x] = SphericalHarmonics::Evaluate(sh, direction);
+                    }
+                }
+            }
+            cubemap->SetData(texels.data(), (uint32_t)(texels.size() * sizeof(glm::vec3)));
+        }
+
+        // Runs on the render thread once a sky job is done. The prefiltered map comes from the cache when
+        // the job found it there, otherwise it's rendered from radiance and written back under key.
+        static void ApplySkyLighting(const uint32_t generation, const IrradianceSH& sh, const Ref<TextureCube>& radiance, const SharedBuffer& prefiltered, const uint64_t key)
+        {
+            if (generation != s_Data->SkyGeneration)
+                return;
+
+            s_Data->SkyIrradiance = sh;
+            FillIrradiancePreview(s_Data->IrradianceTextureCube, sh);
+
+            const Ref<TextureCube>& prefilteredMap = s_Data->PrefilteredTextureCube;
+            if (prefiltered && prefiltered.Size == prefilteredMap->GetMipChainSize())
+            {
+                prefilteredMap->SetMipChainData(prefiltered.Data, prefiltered.Size);
+                return;
+            }
+
+            s_Data->m_PrefilteredMaterial->Set("u_Texture", radiance);
+            RenderCommand::RenderPrefilteredCubemap(s_Data->m_PrefilteredPipeline, prefilteredMap, s_Data->m_PrefilteredMaterial);
+
+            if (key)
+            {
+                SharedBuffer data;
+                prefilteredMap->ExtractBuffer();
+                prefilteredMap->CopyToHostBuffer(data);
+                Pool::Dispatch([key, data]() { IBLCache::Save("Prefiltered", key, data); });
+            }
+        }
+
+        // Sky changes supersede each other, only the result of the latest job is applied. A throttled change
+        // starts its job at most once per throttleInterval ms, changes made meanwhile replace the pending one.
+        template<typename Func>
+        static void LaunchSkyJob(Func&& func, const uint32_t throttleInterval = 0)
+        {
+            const uint32_t generation = ++s_Data->SkyGeneration;
+            TimerWheel::Task job = [func = std::forward<Func>(func), generation]() {
+                if (generation != s_Data->SkyGeneration)
+                    return;
+
+                {
+                    std::lock_guard lock(s_SkyJobMutex);
+                    s_SkyJobsInFlight++;
+                }
+                Pool::Dispatch([func, generation]() {
+                    func(generation);
+
+                    std::lock_guard lock(s_SkyJobMutex);
+                    if (--s_SkyJobsInFlight == 0)
+                        s_SkyJobCondition.notify_all();
+                });
+            };
+
+            if (throttleInterval == 0)
+            {
+                job();
+                return;
+            }
+
+            static const uint64_t throttleKey = Utils::Hash::FNV1a("Renderer::SkyJob");
+            Application::Get().GetTimerWheel().Throttle(throttleKey, throttleInterval, std::move(job));
+        }
+    }
+
 
     void Renderer::Init()
     {
+        s_RecordingThreadID = std::this_thread::get_id();
         RenderCommand::Init();
         s_Data = new RendererData();
 
         // Textures
         s_Data->MaxTextureSlots = RenderCommand::GetMaxTextureSlots();
         s_Data->TextureSlots.resize(s_Data->MaxTextureSlots);
+        for (const ImageFormat format : { ImageFormat::BC1, ImageFormat::BC3, ImageFormat::BC5, ImageFormat::BC7 })
+        {
+            if (RenderCommand::IsCompressedFormatSupported(format))
+                s_Data->CompressedFormats.push_back(format);
+        }
         s_Data->WhiteTexture = Texture2D::Create();
         uint32_t whiteTextureData = 0xffffffff;
         s_Data->WhiteTexture->SetData(&whiteTextureData, sizeof(uint32_t));
@@ -41,17 +174,20 @@ namespace Chozo {
             s_Data->PreethamSkyTextureCube = TextureCube::Create(cubemapSpec);
             s_Data->StaticSkyTextureCube = TextureCube::Create(cubemapSpec);
 
-            cubemapSpec.Width = 32;
-            cubemapSpec.Height = 32;
-            s_Data->IrradianceTextureCube = TextureCube::Create(cubemapSpec);
-
-            cubemapSpec.Width = 128;
-            cubemapSpec.Height = 128;
+            cubemapSpec.Width = Renderer::PrefilteredMapResolution;
+            cubemapSpec.Height = Renderer::PrefilteredMapResolution;
             cubemapSpec.Mipmap = true;
             cubemapSpec.MinFilter = ImageParameter::LINEAR_MIPMAP_LINEAR;
             s_Data->PrefilteredTextureCube = TextureCube::Create(cubemapSpec);
+
+            // Written from the CPU, so in a format the evaluated coefficients can be uploaded as they are.
+            cubemapSpec.Format = ImageFormat::RGB32F;
+            cubemapSpec.Width = Utils::IrradiancePreviewResolution;
+            cubemapSpec.Height = Utils::IrradiancePreviewResolution;
+            cubemapSpec.Mipmap = false;
+            cubemapSpec.MinFilter = ImageParameter::LINEAR;
+            s_Data->IrradianceTextureCube = TextureCube::Create(cubemapSpec);
         }
-        s_Data->BrdfLUT = Texture2D::Create(std::string("../resources/textures/brdfLUT.png"));
 
         uint32_t samplers[s_Data->MaxTextureSlots];
         for (uint32_t i = 0; i < s_Data->MaxTextureSlots; i++)
@@ -68,21 +204,7 @@ namespace Chozo {
         std::vector<int> samplersVec(samplers, samplers + s_Data->MaxTextureSlots);
         s_Data->m_ShaderLibrary = ShaderLibrary::Create();
 
-        auto shaderDir = std::string(Utils::File::GetShaderSoureceDirectory());
-        s_Data->m_ShaderLibrary->Load("Solid", { shaderDir + "/Common/Model.glsl.vert",  shaderDir + "/Solid.glsl.frag" });
-        s_Data->m_ShaderLibrary->Load("ID", { shaderDir + "/Common/FullScreenQuad.glsl.vert",  shaderDir + "/ID.glsl.frag" });
-        s_Data->m_ShaderLibrary->Load("Geometry", { shaderDir + "/GBuffer.glsl.vert",  shaderDir + "/GBuffer.glsl.frag" });
-        s_Data->m_ShaderLibrary->Load("Depth", { shaderDir + "/Common/Model.glsl.vert",  shaderDir + "/Depth.glsl.frag" });
-        s_Data->m_ShaderLibrary->Load("Phong", { shaderDir + "/Common/FullScreenQuad.glsl.vert",  shaderDir + "/Phong.glsl.frag" });
-        s_Data->m_ShaderLibrary->Load("IrradianceConvolution", { shaderDir + "/Common/CubemapSampler.glsl.vert",  shaderDir + "/IrradianceConvolution.glsl.frag" });
-        s_Data->m_ShaderLibrary->Load("Prefiltered", { shaderDir + "/Common/CubemapSampler.glsl.vert",  shaderDir + "/Prefiltered.glsl.frag" });
-        s_Data->m_ShaderLibrary->Load("BrdfLUT", { shaderDir + "/Common/FullScreenQuad.glsl.vert",  shaderDir + "/BrdfLUT.glsl.frag" });
-        s_Data->m_ShaderLibrary->Load("PBR", { shaderDir + "/Common/FullScreenQuad.glsl.vert",  shaderDir + "/PBR.glsl.frag" });
-        s_Data->m_ShaderLibrary->Load("CubemapSampler", { shaderDir + "/Common/CubemapSampler.glsl.vert",  shaderDir + "/CubemapSampler.glsl.frag" });
-        s_Data->m_ShaderLibrary->Load("PreethamSky", { shaderDir + "/Common/CubemapSampler.glsl.vert",  shaderDir + "/PreethamSky.glsl.frag" });
-        s_Data->m_ShaderLibrary->Load("Skybox", { shaderDir + "/Skybox.glsl.vert",  shaderDir + "/Skybox.glsl.frag" });
-        s_Data->m_ShaderLibrary->Load("CubemapPreview", { shaderDir + "/Common/FullScreenQuad.glsl.vert",  shaderDir + "/CubemapPreview.glsl.frag" });
-        s_Data->m_ShaderLibrary->Load("SceneComposite", { shaderDir + "/Common/FullScreenQuad.glsl.vert",  shaderDir + "/SceneComposite.glsl.frag" });
+        s_Data->m_ShaderLibrary->Load(GetShaderSpecifications());
 
         // PreethamSky
         {
@@ -127,27 +249,11 @@ namespace Chozo {
 			pipelineSpec.TargetFramebuffer = framebuffer;
             s_Data->m_CubemapSamplerPipeline = Pipeline::Create(pipelineSpec);
         }
-        // Irradiance Map
-        {
-            FramebufferSpecification fbSpec;
-            fbSpec.Width = 32;
-            fbSpec.Height = 32;
-			fbSpec.Attachments = { ImageFormat::RGB16F };
-			Ref<Framebuffer> framebuffer = Framebuffer::Create(fbSpec);
-
-            PipelineSpecification irradiancePipelineSpec;
-			irradiancePipelineSpec.DebugName = "PBR-Irradiance";
-			irradiancePipelineSpec.TargetFramebuffer = framebuffer;
-            irradiancePipelineSpec.Shader = Renderer::GetShaderLibrary()->Get("IrradianceConvolution");
-			s_Data->m_IrradianceMaterial = Material::Create(irradiancePipelineSpec.Shader, irradiancePipelineSpec.DebugName);
-            // s_Data->m_IrradianceMaterial->Set("u_FragUniforms.Samples", GetConfig().IrradianceMapComputeSamples);
-			s_Data->m_IrradiancePipeline = Pipeline::Create(irradiancePipelineSpec);
-        }
         // Prefiltered Map
         {
             FramebufferSpecification fbSpec;
-            fbSpec.Width = 128;
-            fbSpec.Height = 128;
+            fbSpec.Width = Renderer::PrefilteredMapResolution;
+            fbSpec.Height = Renderer::PrefilteredMapResolution;
 			fbSpec.Attachments = { ImageFormat::RGB16F, ImageFormat::Depth };
             fbSpec.DepthRenderbuffer = true;
 			Ref<Framebuffer> framebuffer = Framebuffer::Create(fbSpec);
@@ -161,34 +267,108 @@ namespace Chozo {
         }
         // BrdfLUT-Texture
         {
-            Ref<Shader> shader = Renderer::GetRendererData().m_ShaderLibrary->Get("BrdfLUT");
-            FramebufferSpecification fbSpec;
-            fbSpec.Width = Renderer::GetConfig().IrradianceMapComputeSamples;
-            fbSpec.Height = Renderer::GetConfig().IrradianceMapComputeSamples;
-            fbSpec.Attachments = { ImageFormat::RG16F };
-            Ref<Framebuffer> framebuffer = Framebuffer::Create(fbSpec);
-
-            PipelineSpecification pipelineSpec;
-			pipelineSpec.DebugName = "BrdfLUT";
-			pipelineSpec.Shader = shader;
-            pipelineSpec.DepthWrite = false;
-			pipelineSpec.DepthTest = false;
-            pipelineSpec.Layout = {
-				{ ShaderDataType::Float3, "a_Position" },
-			};
-			pipelineSpec.TargetFramebuffer = framebuffer;
-            s_Data->m_BrdfLUTPipeline = Pipeline::Create(pipelineSpec);
-
-            framebuffer->Bind();
-            RenderCommand::RenderFullscreenQuad(s_Data->m_BrdfLUTPipeline);
-            framebuffer->Unbind();
+            Texture2DSpecification lutSpec;
+            lutSpec.Format = ImageFormat::RG16F;
+            lutSpec.Width = Renderer::GetConfig().IrradianceMapComputeSamples;
+            lutSpec.Height = Renderer::GetConfig().IrradianceMapComputeSamples;
+            lutSpec.MinFilter = ImageParameter::LINEAR;
+            lutSpec.WrapS = ImageParameter::CLAMP_TO_EDGE;
+            lutSpec.WrapT = ImageParameter::CLAMP_TO_EDGE;
+            lutSpec.DebugName = "BrdfLUT";
+
+            // The LUT only depends on its size and the shader, both go into the key.
+            const std::string source = Utils::File::ReadTextFile(shaderDir + "/BrdfLUT.glsl.frag");
+            const uint32_t lutLayout[] = { lutSpec.Width, lutSpec.Height, (uint32_t)lutSpec.Format };
+            const uint64_t lutKey = Utils::Hash::FNV1a(source, Utils::Hash::FNV1a(lutLayout, sizeof(lutLayout)));
+            const uint64_t lutSize = (uint64_t)lutSpec.Width * lutSpec.Height * Image::GetBytesPerPixel(lutSpec.Format);
+
+            SharedBuffer lutData;
+            if (IBLCache::Load("BrdfLUT", lutKey, lutData) && lutData.Size == lutSize)
+            {
+                s_Data->BrdfLUT = Texture2D::Create(lutData, lutSpec);
+            }
+            else
+            {
+                Ref<Shader> shader = Renderer::GetRendererData().m_ShaderLibrary->Get("BrdfLUT");
+                FramebufferSpecification fbSpec;
+                fbSpec.Width = lutSpec.Width;
+                fbSpec.Height = lutSpec.Height;
+                fbSpec.Attachments = { lutSpec.Format };
+                Ref<Framebuffer> framebuffer = Framebuffer::Create(fbSpec);
+
+                PipelineSpecification pipelineSpec;
+                pipelineSpec.DebugName = "BrdfLUT";
+                pipelineSpec.Shader = shader;
+                pipelineSpec.DepthWrite = false;
+                pipelineSpec.DepthTest = false;
+                pipelineSpec.Layout = {
+                    { ShaderDataType::Float3, "a_Position" },
+                };
+                pipelineSpec.TargetFramebuffer = framebuffer;
+                Ref<Pipeline> pipeline = Pipeline::Create(pipelineSpec);
+
+                framebuffer->Bind();
+                RenderCommand::RenderFullscreenQuad(pipeline);
+                framebuffer->Unbind();
+
+                // The framebuffer takes its attachments along when released, the LUT gets a texture of its own.
+                Ref<Texture2D> image = framebuffer->GetImage(0);
+                image->ExtractBuffer();
+                image->CopyToHostBuffer(lutData);
+                Pool::Dispatch([lutKey, lutData]() { IBLCache::Save("BrdfLUT", lutKey, lutData); });
+
+                s_Data->BrdfLUT = Texture2D::Create(lutData, lutSpec);
+            }
         }
-        
+    }
+
+    std::vector<ShaderSpecification> Renderer::GetShaderSpecifications()
+    {
+        auto shaderDir = std::string(Utils::File::GetShaderSoureceDirectory());
+        return {
+            { "Solid", { shaderDir + "/Common/Model.glsl.vert",  shaderDir + "/Solid.glsl.frag" } },
+            { "ID", { shaderDir + "/Common/FullScreenQuad.glsl.vert",  shaderDir + "/ID.glsl.frag" } },
+            { "Geometry", { shaderDir + "/GBuffer.glsl.vert",  shaderDir + "/GBuffer.glsl.frag" } },
+            { "Depth", { shaderDir + "/Common/Model.glsl.vert",  shaderDir + "/Depth.glsl.frag" } },
+            { "DepthPrePass", { shaderDir + "/DepthPrePass.glsl.vert",  shaderDir + "/DepthPrePass.glsl.frag" } },
+            { "Overdraw", { shaderDir + "/DepthPrePass.glsl.vert",  shaderDir + "/Overdraw.glsl.frag" } },
+            { "Phong", { shaderDir + "/Common/FullScreenQuad.glsl.vert",  shaderDir + "/Phong.glsl.frag" } },
+            { "Prefiltered", { shaderDir + "/Common/CubemapSampler.glsl.vert",  shaderDir + "/Prefiltered.glsl.frag" } },
+            { "BrdfLUT", { shaderDir + "/Common/FullScreenQuad.glsl.vert",  shaderDir + "/BrdfLUT.glsl.frag" } },
+            { "PBR", { shaderDir + "/Common/FullScreenQuad.glsl.vert",  shaderDir + "/PBR.glsl.frag" } },
+            { "CubemapSampler", { shaderDir + "/Common/CubemapSampler.glsl.vert",  shaderDir + "/CubemapSampler.glsl.frag" } },
+            { "PreethamSky", { shaderDir + "/Common/CubemapSampler.glsl.vert",  shaderDir + "/PreethamSky.glsl.frag" } },
+            { "Skybox", { shaderDir + "/Skybox.glsl.vert",  shaderDir + "/Skybox.glsl.frag" } },
+            { "CubemapPreview", { shaderDir + "/Common/FullScreenQuad.glsl.vert",  shaderDir + "/CubemapPreview.glsl.frag" } },
+            { "SceneComposite", { shaderDir + "/Common/FullScreenQuad.glsl.vert",  shaderDir + "/SceneComposite.glsl.frag" } },
+        };
     }
 
     void Renderer::Shutdown()
     {
+        for (auto& allocator : s_FrameAllocators)
+            allocator.Reset();
+        RenderTargetPool::Shutdown();
+        TextureStreamer::Shutdown();
+
+        {
+            std::unique_lock lock(s_SkyJobMutex);
+            s_SkyJobCondition.wait(lock, []() { return s_SkyJobsInFlight == 0; });
+        }
+
         delete s_Data;
+        s_Data = nullptr;
+
+        // Nothing renders anymore, release whatever is still waiting on a frame.
+        std::lock_guard lock(s_ResourceFreeMutex);
+        for (auto& queue : s_ResourceFreeQueue)
+        {
+            for (auto& func : queue)
+                func();
+            queue.clear();
+        }
+
+        RenderCommand::Shutdown();
     }
 
     void Renderer::DrawMesh(const glm::mat4 &transform, const DynamicMesh* mesh, Material* material, uint32_t entityID)
@@ -211,51 +391,99 @@ namespace Chozo {
 
     void Renderer::Begin()
     {
-        s_RenderCommandQueue.clear();
+        // Frees in the reused slot were queued FramesInFlight frames ago, every command that could
+        // reference them has executed by the time this frame's queue runs.
+        std::vector<std::function<void()>> resourceFrees;
+        {
+            std::lock_guard lock(s_ResourceFreeMutex);
+            s_FrameIndex = (s_FrameIndex + 1) % FramesInFlight;
+            resourceFrees.swap(s_ResourceFreeQueue[s_FrameIndex]);
+        }
+        s_FrameAllocators[s_FrameIndex].Reset();
+        RenderTargetPool::NextFrame();
+        TextureStreamer::NextFrame();
+
+        Submit([resourceFrees = std::move(resourceFrees)]() {
+            ResetStats();
+            RenderCommand::BeginFrame();
+            for (auto& func : resourceFrees)
+                func();
+        });
     }
 
-    void Renderer::End()
+    void Renderer::SubmitCommandQueue(RenderCommandQueue& queue)
     {
-        for (auto& cmd : s_RenderCommandQueue)
-            cmd();
+        if (IsRecordingThread())
+        {
+            GetRenderCommandQueue().Append(queue);
+            return;
+        }
+
+        GetWorkerCommandQueue().Append(queue);
     }
 
-    void Renderer::Submit(std::function<void()> &&func)
+    bool Renderer::IsRecordingThread()
     {
-        s_RenderCommandQueue.emplace_back([func = std::forward<std::function<void()>>(func)]() mutable { func(); });
+        return std::this_thread::get_id() == s_RecordingThreadID;
     }
 
-    void Renderer::DebouncedSubmit(std::function<void()> &&func, uint32_t delay)
+    RenderCommandQueue& Renderer::GetRenderCommandQueue()
     {
-        auto now = std::chrono::steady_clock::now();
-        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - s_LastSubmitTime.load()).count();
+        return s_CommandQueue[s_CommandQueueSubmissionIndex];
+    }
 
-        if (s_DebounceTask.valid())
-            s_DebounceTask.wait();
+    MPSCCommandQueue& Renderer::GetWorkerCommandQueue()
+    {
+        return s_WorkerCommandQueue;
+    }
 
-        if (elapsed < delay)
+    void Renderer::SubmitResourceFree(std::function<void()>&& func)
+    {
+        // Outside the renderer's lifetime there are no queued commands to wait for.
+        if (!s_Data)
         {
-            s_DebounceTask = std::async(std::launch::async, [func = std::move(func), delay]() mutable {
-                std::this_thread::sleep_for(std::chrono::milliseconds(delay));
-                Submit(std::move(func));
-            });
+            func();
+            return;
         }
-        else
-            Submit(std::move(func));
 
+        std::lock_guard lock(s_ResourceFreeMutex);
+        s_ResourceFreeQueue[s_FrameIndex].emplace_back(std::move(func));
+    }
 
-        s_LastSubmitTime.store(std::chrono::steady_clock::now());
+    FrameAllocator& Renderer::GetFrameAllocator()
+    {
+        return s_FrameAllocators[s_FrameIndex];
     }
 
-    Renderer::RendererData Renderer::GetRendererData()
+    void Renderer::WaitAndRender(RenderThread* renderThread)
+    {
+        renderThread->WaitForKick();
+
+        s_CommandQueue[(s_CommandQueueSubmissionIndex + 1) % 2].Execute();
+
+        renderThread->Set(RenderThread::State::Idle);
+    }
+
+    void Renderer::RenderThreadFunc(RenderThread* renderThread)
+    {
+        while (renderThread->IsRunning())
+            WaitAndRender(renderThread);
+    }
+
+    void Renderer::SwapQueues()
+    {
+        s_WorkerCommandQueue.Drain(GetRenderCommandQueue());
+        s_CommandQueueSubmissionIndex = (s_CommandQueueSubmissionIndex + 1) % 2;
+    }
+
+    Renderer::RendererData& Renderer::GetRendererData()
     {
         return *s_Data; 
     }
 
     Ref<Texture2D> Renderer::GetBrdfLUT()
     {
-        // return s_Data->BrdfLUT;
-        return s_Data->m_BrdfLUTPipeline->GetTargetFramebuffer()->GetImage(0);
+        return s_Data->BrdfLUT;
     }
 
     Ref<Texture2D> Renderer::GetCheckerboardTexture()
@@ -298,6 +526,7 @@ namespace Chozo {
         s_Data->Stats.VerticesCount = 0;
         s_Data->Stats.TriangleCount = 0;
         s_Data->Stats.DrawCalls = 0;
+        s_Data->Stats.CulledMeshlets = 0;
     }
 
     void Renderer::UpdateMaxTriangles(uint32_t count)
@@ -316,19 +545,65 @@ namespace Chozo {
 
     uint32_t Renderer::GetMaxTextureSlots()
     {
-        return RenderCommand::GetMaxTextureSlots();
+        // Cached at init so shader compiler threads without a GL context can query it.
+        if (s_Data)
+            return s_Data->MaxTextureSlots;
+
+        // Tools and tests that skip Init query it once, from a thread with a current context.
+        static std::atomic<uint32_t> s_MaxTextureSlots = 0;
+        if (s_MaxTextureSlots == 0)
+            s_MaxTextureSlots = RenderCommand::GetMaxTextureSlots();
+        return s_MaxTextureSlots;
+    }
+
+    bool Renderer::IsCompressedFormatSupported(const ImageFormat format)
+    {
+        // Cached at init as well, textures are imported on asset loading threads.
+        if (!s_Data)
+            return false;
+
+        const auto& formats = s_Data->CompressedFormats;
+        return std::find(formats.begin(), formats.end(), format) != formats.end();
     }
 
     void Renderer::CreateStaticSky(const Ref<Texture2D>& texture)
     {
         Submit([texture](){
             RenderCommand::RenderCubemap(s_Data->m_CubemapSamplerPipeline, s_Data->StaticSkyTextureCube, texture);
+        });
 
-            s_Data->m_IrradianceMaterial->Set("u_Texture", s_Data->StaticSkyTextureCube);
-            RenderCommand::RenderCubemap(s_Data->m_IrradiancePipeline, s_Data->IrradianceTextureCube, s_Data->m_IrradianceMaterial);
-
-            s_Data->m_PrefilteredMaterial->Set("u_Texture", s_Data->StaticSkyTextureCube);
-            RenderCommand::RenderPrefilteredCubemap(s_Data->m_PrefilteredPipeline, s_Data->PrefilteredTextureCube, s_Data->m_PrefilteredMaterial);
+        Utils::LaunchSkyJob([texture](const uint32_t generation) {
+            // A streamed texture holds its pixels from the resident mip on, irradiance doesn't need more.
+            SharedBuffer pixels;
+            const uint32_t mip = TextureStreamer::CopyToHostBuffer(texture, pixels);
+            const uint32_t width = std::max(texture->GetWidth() >> mip, 1u), height = std::max(texture->GetHeight() >> mip, 1u);
+
+            ImageFormat format = texture->GetSpecification().Format;
+            if (Image::IsCompressedFormat(format) && pixels)
+            {
+                Buffer decoded = TextureCompressor::Decompress(pixels.Data, width, height, format);
+                pixels = SharedBuffer(decoded.Data, decoded.Size);
+                decoded.Release();
+                format = ImageFormat::RGBA;
+            }
+
+            const bool supported = Image::IsHDRFormat(format) || format == ImageFormat::RGBA;
+            // The resident level leads the buffer, the mips after it are not needed.
+            if (!supported || pixels.Size < (uint64_t)width * height * Image::GetBytesPerPixel(format))
+            {
+                CZ_CORE_WARN("Sky texture pixels aren't on the host in a supported format, its irradiance is left black.");
+                pixels.Release();
+            }
+
+            const uint64_t key = pixels ? IBLCache::GetKey(Utils::Hash::FNV1a(pixels.Data, pixels.Size)) : 0;
+            SharedBuffer prefiltered;
+            if (key)
+                IBLCache::Load("Prefiltered", key, prefiltered);
+
+            const IrradianceSH sh = SphericalHarmonics::ProjectEquirectangular(pixels.Data, width, height, format);
+            Submit([generation, sh, prefiltered, key]() {
+                Utils::ApplySkyLighting(generation, sh, s_Data->StaticSkyTextureCube, prefiltered, key);
+            });
         });
     }
 
@@ -336,25 +611,32 @@ namespace Chozo {
     {
         RenderCommand::CreatePreethamSky(s_Data->m_PreethamSkyPipeline, turbidity, azimuth, inclination);
 
-        Submit([](){
-            s_Data->m_IrradianceMaterial->Set("u_Texture", s_Data->PreethamSkyTextureCube);
-            RenderCommand::RenderCubemap(s_Data->m_IrradiancePipeline, s_Data->IrradianceTextureCube, s_Data->m_IrradianceMaterial);
+        Utils::LaunchSkyJob([turbidity, azimuth, inclination](const uint32_t generation) {
+            const float parameters[] = { turbidity, azimuth, inclination };
+            const uint64_t key = IBLCache::GetKey(Utils::Hash::FNV1a(parameters, sizeof(parameters), Utils::Hash::FNV1a("PreethamSky")));
+            SharedBuffer prefiltered;
+            IBLCache::Load("Prefiltered", key, prefiltered);
 
-            s_Data->m_PrefilteredMaterial->Set("u_Texture", s_Data->PreethamSkyTextureCube);
-            RenderCommand::RenderPrefilteredCubemap(s_Data->m_PrefilteredPipeline, s_Data->PrefilteredTextureCube, s_Data->m_PrefilteredMaterial);
+            const IrradianceSH sh = SphericalHarmonics::ProjectPreethamSky(turbidity, azimuth, inclination);
+            Submit([generation, sh, prefiltered, key]() {
+                Utils::ApplySkyLighting(generation, sh, s_Data->PreethamSkyTextureCube, prefiltered, key);
+            });
         });
     }
 
     void Renderer::UpdatePreethamSky(const float turbidity, const float azimuth, const float inclination)
     {
-        RenderCommand::DrawPreethamSky(s_Data->m_PreethamSkyPipeline, turbidity, azimuth, inclination);
-
-        Submit([](){
-            s_Data->m_IrradianceMaterial->Set("u_Texture", s_Data->PreethamSkyTextureCube);
-            RenderCommand::RenderCubemap(s_Data->m_IrradiancePipeline, s_Data->IrradianceTextureCube, s_Data->m_IrradianceMaterial);
-
-            s_Data->m_PrefilteredMaterial->Set("u_Texture", s_Data->PreethamSkyTextureCube);
-            RenderCommand::RenderPrefilteredCubemap(s_Data->m_PrefilteredPipeline, s_Data->PrefilteredTextureCube, s_Data->m_PrefilteredMaterial);
+        Submit([turbidity, azimuth, inclination]() {
+            RenderCommand::DrawPreethamSky(s_Data->m_PreethamSkyPipeline, turbidity, azimuth, inclination);
         });
+
+        // Called while dragging the sky parameters, the in between values aren't worth a cache file
+        // and only a few of them are worth a projection.
+        Utils::LaunchSkyJob([turbidity, azimuth, inclination](const uint32_t generation) {
+            const IrradianceSH sh = SphericalHarmonics::ProjectPreethamSky(turbidity, azimuth, inclination);
+            Submit([generation, sh]() {
+                Utils::ApplySkyLighting(generation, sh, s_Data->PreethamSkyTextureCube, {}, 0);
+            });
+        }, 50);
     }
 }
\ No newline at end of file
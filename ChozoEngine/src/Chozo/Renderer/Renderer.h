@@ -1,7 +1,9 @@
 #pragma once
 
 #include "czpch.h"
+#include <atomic>
 #include <future>
+#include <mutex>
 
 #include "EditorCamera.h"
 #include "RenderCommand.h"
@@ -13,9 +15,14 @@
 #include "UniformBuffer.h"
 #include "RenderPass.h"
 #include "RenderCommandBuffer.h"
+#include "RenderCommandQueue.h"
+#include "FrameAllocator.h"
+#include "SphericalHarmonics.h"
 
 #include "Batch.h"
 
+#include "Chozo/Core/RenderThread.h"
+
 #include "Chozo/Scene/Components.h"
 
 namespace Chozo {
@@ -23,12 +30,44 @@ namespace Chozo {
     class Renderer
     {
     public:
+        // Frames a freed GL object has to wait before its deletion runs, matching the double-buffered command queues.
+        static constexpr uint32_t FramesInFlight = 2;
+        // Specular IBL cubemap, one mip level per roughness step.
+        static constexpr uint32_t PrefilteredMapResolution = 128;
+        static constexpr uint32_t PrefilteredMapMipLevels = 5;
 
         struct RendererConfig
         {
             // Tiering settings
             uint32_t EnvironmentMapResolution = 1024;
             uint32_t IrradianceMapComputeSamples = 512;
+            // Storage of textures imported from .hdr files: RGBA16F halves the memory of RGBA32F,
+            // RGB9E5 (shared exponent, no alpha) quarters it.
+            ImageFormat HDRTextureFormat = ImageFormat::RGBA16F;
+            // Block compression of imported 8-bit textures that declare a usage.
+            TextureCompressionQuality TextureCompression = TextureCompressionQuality::Fast;
+            // Mip chain of those textures, built on the CPU and stored in the asset.
+            MipFilter TextureMipFilter = MipFilter::Kaiser;
+            // Mip streaming of the textures loaded from asset files. Loading reads the levels up to
+            // StreamingMinResidentSize pixels, the larger ones follow what the meshes on screen need
+            // as long as all streamed levels fit in TextureStreamingBudget bytes.
+            bool EnableTextureStreaming = true;
+            uint64_t TextureStreamingBudget = 512ull << 20;
+            uint32_t StreamingMinResidentSize = 128;
+            // Texture pixels go through pixel buffer objects filled on worker threads, at most
+            // TextureUploadBudget bytes are handed to the GPU per frame. Textures show a placeholder until then.
+            bool EnableAsyncTextureUploads = true;
+            uint64_t TextureUploadBudget = 32ull << 20;
+
+            // Mesh LOD selection, a LOD is used once the projected bounds height drops below
+            // LODScreenSize * 0.5^(lod - 1) of the viewport. Hysteresis widens each threshold to avoid popping.
+            bool EnableMeshLOD = true;
+            float LODScreenSize = 0.25f;
+            float LODHysteresis = 0.1f;
+            // Frustum and backface cone culling of LOD 0 meshlets on the CPU.
+            bool EnableMeshletCulling = true;
+            // Depth only draw of the opaque meshes before the G-buffer, which then shades each pixel once.
+            bool EnableDepthPrePass = true;
 
             glm::vec4 ClearColor = { 0.105f, 0.110f, 0.110f, 1.0f };
         };
@@ -38,6 +77,16 @@ namespace Chozo {
             uint32_t DrawCalls = 0;
             uint32_t VerticesCount = 0;
             uint32_t TriangleCount = 0;
+            uint32_t CulledMeshlets = 0;
+            // GL state changes dropped by the state cache and the ones that reached GL, counted over the previous frame.
+            uint32_t FilteredStateCalls = 0;
+            uint32_t IssuedStateCalls = 0;
+            // Last resolved fragment query, the overdraw view of a scene renderer issues it.
+            uint32_t ShadedFragments = 0;
+            float Overdraw = 0.0f;
+            // Texture bytes issued from upload buffers this frame, and uploads still waiting or in flight.
+            uint64_t UploadedTextureBytes = 0;
+            uint32_t PendingTextureUploads = 0;
 
             uint32_t GetTotalVerticesCount() { return VerticesCount; }
             uint32_t GetTotalTrianglesCount() { return TriangleCount; }
@@ -62,6 +111,7 @@ namespace Chozo {
     		// Ref<MaterialLibrary> m_MaterialLibrary;
 
             uint32_t MaxTextureSlots = 0;
+            std::vector<ImageFormat> CompressedFormats;
             uint32_t TextureSlotIndex = 1; // 0 = white texture
             std::vector<Ref<Texture2D>> TextureSlots;
             Ref<Texture2D> WhiteTexture;
@@ -78,15 +128,18 @@ namespace Chozo {
 
             Ref<TextureCube> PreethamSkyTextureCube;
             Ref<TextureCube> StaticSkyTextureCube;
+            // Preview of SkyIrradiance, shading evaluates the coefficients directly.
             Ref<TextureCube> IrradianceTextureCube;
             Ref<TextureCube> PrefilteredTextureCube;
-            Ref<Material> m_IrradianceMaterial;
             Ref<Material> m_PrefilteredMaterial;
             Ref<Pipeline> m_PreethamSkyPipeline;
             Ref<Pipeline> m_CubemapSamplerPipeline;
-            Ref<Pipeline> m_IrradiancePipeline;
             Ref<Pipeline> m_PrefilteredPipeline;
-            Ref<Pipeline> m_BrdfLUTPipeline;
+
+            // Only touched on the render thread. Sky jobs project on pool workers and submit the result,
+            // results of a job superseded by a later sky change are dropped.
+            IrradianceSH SkyIrradiance;
+            std::atomic<uint32_t> SkyGeneration = 0;
         };
 
         static void Init();
@@ -95,7 +148,9 @@ namespace Chozo {
         static void DrawMesh(const glm::mat4 &transform, const DynamicMesh* mesh, Material* material, uint32_t entityID = -1); // TODO: Remove
 
         static Ref<ShaderLibrary> GetShaderLibrary() { return GetRendererData().m_ShaderLibrary; }
-        static RendererData GetRendererData();
+        // Every shader the renderer loads at startup.
+        static std::vector<ShaderSpecification> GetShaderSpecifications();
+        static RendererData& GetRendererData();
         static Ref<Texture2D> GetBrdfLUT();
         static Ref<Texture2D> GetCheckerboardTexture();
         static Ref<TextureCube> GetBlackTextureCube();
@@ -109,6 +164,7 @@ namespace Chozo {
 		static void SetConfig(const RendererConfig& config);
 
         static uint32_t GetMaxTextureSlots();
+        static bool IsCompressedFormatSupported(ImageFormat format);
 
         static Ref<TextureCube> CreateCubemap(const std::string& filePath);
 		static void CreateStaticSky( const Ref<Texture2D>& texture);
@@ -116,8 +172,47 @@ namespace Chozo {
 		static void UpdatePreethamSky(const float turbidity, const float azimuth, const float inclination);
 
 		static void Begin();
-		static void End();
-        static void Submit(std::function<void()>&& func);
-        static void DebouncedSubmit(std::function<void()>&& func, uint32_t delay = 100);
+        template<typename FuncT>
+        static void Submit(FuncT&& func)
+        {
+            if (IsRecordingThread())
+            {
+                GetRenderCommandQueue().Submit(std::forward<FuncT>(func));
+                return;
+            }
+
+            GetWorkerCommandQueue().Submit(std::forward<FuncT>(func));
+        }
+        // For GL work whose result is needed right away, resource creation and readbacks. Runs func on the render
+        // thread before the commands recorded so far in this frame and returns once it has, like a direct call
+        // does with the single threaded policy.
+        template<typename FuncT>
+        static void SubmitAndWait(FuncT&& func)
+        {
+            if (RenderThread::OwnsContext())
+            {
+                func();
+                return;
+            }
+
+            RenderThread::ExecuteBlocking(func);
+        }
+        // Moves the commands recorded in queue to the end of the calling thread's submission queue.
+        static void SubmitCommandQueue(RenderCommandQueue& queue);
+        // Deletion of GL objects released mid-frame, deferred until no queued command can still reference them.
+        static void SubmitResourceFree(std::function<void()>&& func);
+        // Scratch memory for data extracted this frame. Double-buffered, the render thread may still read last frame's.
+        static FrameAllocator& GetFrameAllocator();
+
+        // Frame fence: waits for the kick, executes the queue recorded last frame and marks the render thread idle.
+        static void WaitAndRender(RenderThread* renderThread);
+        static void RenderThreadFunc(RenderThread* renderThread);
+        static void SwapQueues();
+
+        // Commands submitted from threads other than the recording thread go through a lock-free queue,
+        // drained in order into the submission queue when the queues swap.
+        static bool IsRecordingThread();
+        static RenderCommandQueue& GetRenderCommandQueue();
+        static MPSCCommandQueue& GetWorkerCommandQueue();
     };
 }
\ No newline at end of file
@@ -217,9 +217,11 @@ namespace Chozo {
     void Renderer2D::EndScene()
     {
         Flush();
-        s_Data.QuadVertexBuffer->ClearData();
-        s_Data.CircleVertexBuffer->ClearData();
-        s_Data.LineVertexBuffer->ClearData();
+        Renderer::Submit([]() {
+            s_Data.QuadVertexBuffer->ClearData();
+            s_Data.CircleVertexBuffer->ClearData();
+            s_Data.LineVertexBuffer->ClearData();
+        });
     }
 
     void Renderer2D::BeginBatch()
@@ -2,6 +2,8 @@
 
 #include "Renderer.h"
 #include "RenderCommand.h"
+#include "MeshletCuller.h"
+#include "TextureStreamer.h"
 
 namespace Chozo
 {
@@ -27,6 +29,8 @@ namespace Chozo
         m_DirectionalLightsUB = UniformBuffer::Create(sizeof(DirectionalLightsData));
         m_PointLightsUB = UniformBuffer::Create(sizeof(PointLightsData));
         m_SpotLightsUB = UniformBuffer::Create(sizeof(SpotLightsData));
+        m_LightGridUB = UniformBuffer::Create(sizeof(LightGridData));
+        m_LightGridSB = StorageBuffer::Create(LightGrid::ClusterCount * 8 * sizeof(uint32_t));
 
         // Skybox
         {
@@ -45,7 +49,6 @@ namespace Chozo
             // pipelineSpec.Layout = {
 			// 	{ ShaderDataType::Float3, "a_Position" },
 			// };
-			pipelineSpec.TargetFramebuffer = Framebuffer::Create(fbSpec);
 			m_SkyboxMaterial = Material::Create(pipelineSpec.Shader, pipelineSpec.DebugName);
 
 			RenderPassSpecification renderPassSpec;
@@ -54,18 +57,35 @@ namespace Chozo
 			m_SkyboxPass = RenderPass::Create(renderPassSpec);
 			m_SkyboxPass->SetInput("CameraData", m_CameraUB);
 			// m_SkyboxPass->Bake();
+
+			m_SkyboxNode = m_RenderGraph.AddPass({ "Skybox", m_SkyboxPass, fbSpec, [this]() { SkyboxPass(); } });
+        }
+
+        // Depth pre-pass, drawn into the target of the pass that follows it
+        {
+			PipelineSpecification pipelineSpec;
+			pipelineSpec.DebugName = "DepthPrePass";
+			pipelineSpec.Shader = Renderer::GetShaderLibrary()->Get("DepthPrePass");
+			pipelineSpec.ColorWrite = false;
+			pipelineSpec.PositionOnly = true;
+
+			RenderPassSpecification renderPassSpec;
+			renderPassSpec.DebugName = "DepthPrePass";
+			renderPassSpec.Pipeline = Pipeline::Create(pipelineSpec);
+			m_DepthPrePass = RenderPass::Create(renderPassSpec);
+			m_DepthPrePass->SetInput("CameraData", m_CameraUB);
         }
 
         // G-Buffer
         {
 			FramebufferSpecification fbSpec;
             fbSpec.ClearColor = { 0.0f, 0.0f, 0.0f, 1.0f };
+			// Layout in GBufferPacking.glsl, positions are rebuilt from the depth.
 			fbSpec.Attachments = {
-                ImageFormat::RGB16F,
-                ImageFormat::RGB16F,
-                ImageFormat::RGB16F,
-                ImageFormat::RGB16F,
-                ImageFormat::RGB16F,
+                ImageFormat::RGBA8,
+                ImageFormat::RG16,
+                ImageFormat::RGBA8,
+                ImageFormat::B10R11G11UF,
                 ImageFormat::RED32I,
                 ImageFormat::Depth
             };
@@ -73,29 +93,27 @@ namespace Chozo
 
 			PipelineSpecification pipelineSpec;
 			pipelineSpec.DebugName = "Geometry";
-			// pipelineSpec.DepthOperator = DepthCompareOperator::Equal;
-            pipelineSpec.DepthWrite = false;
+			// Depth state is set per frame by SetOpaqueDepthState.
             pipelineSpec.Shader = Renderer::GetShaderLibrary()->Get("Geometry");
-			pipelineSpec.TargetFramebuffer = Framebuffer::Create(fbSpec);
 
 			RenderPassSpecification renderPassSpec;
 			renderPassSpec.DebugName = "Geometry";
 			renderPassSpec.Pipeline = Pipeline::Create(pipelineSpec);
 			m_GeometryPass = RenderPass::Create(renderPassSpec);
 			m_GeometryPass->SetInput("CameraData", m_CameraUB);
+
+			m_GeometryNode = m_RenderGraph.AddPass({ "Geometry", m_GeometryPass, fbSpec, [this]() { GeometryPass(); } });
         }
 
         // Solid
         {
             FramebufferSpecification fbSpec;
             fbSpec.ClearColor = { 0.0f, 0.0f, 0.0f, 1.0f };
-			fbSpec.Attachments = { ImageFormat::RGBA32F, ImageFormat::RGB16F, ImageFormat::RED32I, ImageFormat::Depth };
+			fbSpec.Attachments = { ImageFormat::RGBA32F, ImageFormat::RED32I, ImageFormat::Depth };
 
 			PipelineSpecification pipelineSpec;
 			pipelineSpec.DebugName = "Solid";
-            pipelineSpec.DepthWrite = false;
             pipelineSpec.Shader = Renderer::GetShaderLibrary()->Get("Solid");
-			pipelineSpec.TargetFramebuffer = Framebuffer::Create(fbSpec);
 			m_SolidMaterial = Material::Create(pipelineSpec.Shader, pipelineSpec.DebugName);
 
 			RenderPassSpecification renderPassSpec;
@@ -104,6 +122,8 @@ namespace Chozo
 			m_SolidPass = RenderPass::Create(renderPassSpec);
 			m_SolidPass->SetInput("CameraData", m_CameraUB);
 			m_SolidPass->SetInput("SceneData", m_SceneUB);
+
+			m_SolidNode = m_RenderGraph.AddPass({ "Solid", m_SolidPass, fbSpec, [this]() { SolidPass(); } });
         }
 
         // ID
@@ -121,19 +141,19 @@ namespace Chozo
 			pipelineSpec.TargetFramebuffer = Framebuffer::Create(fbSpec);
 
 			m_IDMaterial = Material::Create(pipelineSpec.Shader, pipelineSpec.DebugName);
-            Ref<Texture2D> solidIdTex = m_SolidPass->GetOutput(2);
-            Ref<Texture2D> solidDepthTex = m_SolidPass->GetOutput(1);
-            Ref<Texture2D> PBRIdTex = m_GeometryPass->GetOutput(5);
-            Ref<Texture2D> PBRDepthTex = m_GeometryPass->GetOutput(2);
-            m_IDMaterial->Set("u_SolidIdTex", solidIdTex);
-            m_IDMaterial->Set("u_SolidDepthTex", solidDepthTex);
-            m_IDMaterial->Set("u_PBRIdTex", PBRIdTex);
-            m_IDMaterial->Set("u_PBRDepthTex", PBRDepthTex);
 
 			RenderPassSpecification renderPassSpec;
 			renderPassSpec.DebugName = "ID";
 			renderPassSpec.Pipeline = Pipeline::Create(pipelineSpec);
 			m_IDPass = RenderPass::Create(renderPassSpec);
+
+			// Picking reads it back after the frame.
+			m_IDNode = m_RenderGraph.AddPass({ "ID", m_IDPass, {}, [this]() { IDPass(); } });
+			m_RenderGraph.Read(m_IDNode, m_SolidNode, 1, "u_SolidIdTex");
+			m_RenderGraph.Read(m_IDNode, m_SolidNode, RenderGraph::DepthAttachment, "u_SolidDepthTex");
+			m_RenderGraph.Read(m_IDNode, m_GeometryNode, 4, "u_PBRIdTex");
+			m_RenderGraph.Read(m_IDNode, m_GeometryNode, RenderGraph::DepthAttachment, "u_PBRDepthTex");
+			m_RenderGraph.SetOutput(m_IDNode);
         }
 
         // Phong-Light
@@ -145,26 +165,25 @@ namespace Chozo
 			PipelineSpecification pipelineSpec;
 			pipelineSpec.DebugName = "Phong";
             pipelineSpec.DepthWrite = false;
-			pipelineSpec.TargetFramebuffer = Framebuffer::Create(fbSpec);
             pipelineSpec.Shader = Renderer::GetShaderLibrary()->Get("Phong");
 			m_PhongMaterial = Material::Create(pipelineSpec.Shader, pipelineSpec.DebugName);
-            Ref<Texture2D> positionTex = m_GeometryPass->GetOutput(0);
-            Ref<Texture2D> normalTex = m_GeometryPass->GetOutput(1);
-            Ref<Texture2D> baseColorTex = m_GeometryPass->GetOutput(3);
-            Ref<Texture2D> materialPropTex = m_GeometryPass->GetOutput(4);
-            m_PhongMaterial->Set("u_PositionTex", positionTex);
-            m_PhongMaterial->Set("u_NormalTex", normalTex);
-            m_PhongMaterial->Set("u_BaseColorTex", baseColorTex);
-            m_PhongMaterial->Set("u_MaterialPropTex", materialPropTex);
 
 			RenderPassSpecification renderPassSpec;
 			renderPassSpec.DebugName = "Phong";
 			renderPassSpec.Pipeline = Pipeline::Create(pipelineSpec);
 			m_PhongPass = RenderPass::Create(renderPassSpec);
+			m_PhongPass->SetInput("CameraData", m_CameraUB);
 			m_PhongPass->SetInput("SceneData", m_SceneUB);
 			m_PhongPass->SetInput("DirectionalLightsData", m_DirectionalLightsUB);
 			m_PhongPass->SetInput("PointLightsData", m_PointLightsUB);
 			m_PhongPass->SetInput("SpotLightsData", m_SpotLightsUB);
+
+			// Nothing reads it while the composite only takes the PBR result, so the graph culls it.
+			m_PhongNode = m_RenderGraph.AddPass({ "Phong", m_PhongPass, fbSpec, [this]() { PhongPass(); } });
+			m_RenderGraph.Read(m_PhongNode, m_GeometryNode, RenderGraph::DepthAttachment, "u_DepthTex");
+			m_RenderGraph.Read(m_PhongNode, m_GeometryNode, 0, "u_BaseColorTex");
+			m_RenderGraph.Read(m_PhongNode, m_GeometryNode, 1, "u_NormalTex");
+			m_RenderGraph.Read(m_PhongNode, m_GeometryNode, 2, "u_MaterialPropTex");
         }
 
         // PBR
@@ -177,7 +196,6 @@ namespace Chozo
 			PipelineSpecification pipelineSpec;
 			pipelineSpec.DebugName = "PBR";
             pipelineSpec.DepthWrite = false;
-			pipelineSpec.TargetFramebuffer = Framebuffer::Create(fbSpec);
             pipelineSpec.Shader = Renderer::GetShaderLibrary()->Get("PBR");
 			m_PBRMaterial = Material::Create(pipelineSpec.Shader, pipelineSpec.DebugName);
 
@@ -185,10 +203,20 @@ namespace Chozo
 			renderPassSpec.DebugName = "PBR";
 			renderPassSpec.Pipeline = Pipeline::Create(pipelineSpec);
 			m_PBRPass = RenderPass::Create(renderPassSpec);
+			m_PBRPass->SetInput("CameraData", m_CameraUB);
 			m_PBRPass->SetInput("SceneData", m_SceneUB);
         	m_PBRPass->SetInput("DirectionalLightsData", m_DirectionalLightsUB);
 			m_PBRPass->SetInput("PointLightsData", m_PointLightsUB);
-			// m_PBRPass->SetInput("SpotLightData", m_SpotLightsUB);
+			m_PBRPass->SetInput("SpotLightsData", m_SpotLightsUB);
+			m_PBRPass->SetInput("LightGridData", m_LightGridUB);
+			m_PBRPass->SetInput("u_LightGrid", m_LightGridSB);
+
+			m_PBRNode = m_RenderGraph.AddPass({ "PBR", m_PBRPass, fbSpec, [this]() { PBRPass(); } });
+			m_RenderGraph.Read(m_PBRNode, m_GeometryNode, RenderGraph::DepthAttachment, "u_DepthTex");
+			m_RenderGraph.Read(m_PBRNode, m_GeometryNode, 0, "u_BaseColorTex");
+			m_RenderGraph.Read(m_PBRNode, m_GeometryNode, 1, "u_NormalTex");
+			m_RenderGraph.Read(m_PBRNode, m_GeometryNode, 2, "u_MaterialPropTex");
+			m_RenderGraph.Read(m_PBRNode, m_GeometryNode, 3, "u_EmissionTex");
 
             TextureCubeSpecification irrandianceMapSpec;
             irrandianceMapSpec.Width = 32;
@@ -219,22 +247,43 @@ namespace Chozo
             pipelineSpec.DepthTest = false;
 
 			m_CompositeMaterial = Material::Create(pipelineSpec.Shader, pipelineSpec.DebugName);
-            Ref<Texture2D> skyboxTex = m_SkyboxPass->GetOutput(0);
-            Ref<Texture2D> solidTex = m_SolidPass->GetOutput(0);
-            Ref<Texture2D> solidDepthTex = m_SolidPass->GetOutput(1);
-            Ref<Texture2D> PhongTex = m_PhongPass->GetOutput(0);
-            Ref<Texture2D> PBRTex = m_PBRPass->GetOutput(0);
-            Ref<Texture2D> PBRDepthTex = m_GeometryPass->GetOutput(2);
-            m_CompositeMaterial->Set("u_SkyboxTex", skyboxTex);
-            m_CompositeMaterial->Set("u_SolidTex", solidTex);
-            m_CompositeMaterial->Set("u_SolidDepthTex", solidDepthTex);
-            m_CompositeMaterial->Set("u_PBRTex", PBRTex);
-            m_CompositeMaterial->Set("u_PBRDepthTex", PBRDepthTex);
 
             RenderPassSpecification renderPassSpec;
             renderPassSpec.DebugName = "SceneComposite";
             renderPassSpec.Pipeline = Pipeline::Create(pipelineSpec);
             m_CompositePass = RenderPass::Create(renderPassSpec);
+
+            m_CompositeNode = m_RenderGraph.AddPass({ "SceneComposite", m_CompositePass, {}, [this]() { CompositePass(); } });
+            m_RenderGraph.Read(m_CompositeNode, m_SkyboxNode, 0, "u_SkyboxTex");
+            m_RenderGraph.Read(m_CompositeNode, m_SolidNode, 0, "u_SolidTex");
+            m_RenderGraph.Read(m_CompositeNode, m_SolidNode, RenderGraph::DepthAttachment, "u_SolidDepthTex");
+            m_RenderGraph.Read(m_CompositeNode, m_PBRNode, 0, "u_PBRTex");
+            m_RenderGraph.Read(m_CompositeNode, m_GeometryNode, RenderGraph::DepthAttachment, "u_PBRDepthTex");
+            m_RenderGraph.SetOutput(m_CompositeNode);
+        }
+
+        // Overdraw, debug view of the geometry pass
+        {
+            FramebufferSpecification fbSpec;
+            fbSpec.ClearColor = { 0.0f, 0.0f, 0.0f, 1.0f };
+            fbSpec.Attachments = { ImageFormat::RGBA16F, ImageFormat::Depth };
+
+			PipelineSpecification pipelineSpec;
+			pipelineSpec.DebugName = "Overdraw";
+			pipelineSpec.Shader = Renderer::GetShaderLibrary()->Get("Overdraw");
+			pipelineSpec.TargetFramebuffer = Framebuffer::Create(fbSpec);
+			pipelineSpec.Blending = BlendMode::Additive;
+			pipelineSpec.PositionOnly = true;
+
+			RenderPassSpecification renderPassSpec;
+			renderPassSpec.DebugName = "Overdraw";
+			renderPassSpec.Pipeline = Pipeline::Create(pipelineSpec);
+			m_OverdrawPass = RenderPass::Create(renderPassSpec);
+			m_OverdrawPass->SetInput("CameraData", m_CameraUB);
+
+			m_OverdrawNode = m_RenderGraph.AddPass({ "Overdraw", m_OverdrawPass, {}, [this]() { OverdrawPass(); } });
+			m_RenderGraph.SetOutput(m_OverdrawNode);
+			m_RenderGraph.SetEnabled(m_OverdrawNode, m_OverdrawVisualization);
         }
     }
 
@@ -249,13 +298,7 @@ namespace Chozo
 
     void SceneRenderer::BeginScene(EditorCamera& camera)
     {
-        m_CompositePass->GetTargetFramebuffer()->Resize(m_ViewportWidth, m_ViewportHeight);
-        m_SkyboxPass->GetTargetFramebuffer()->Resize(m_ViewportWidth, m_ViewportHeight);
-        m_GeometryPass->GetTargetFramebuffer()->Resize(m_ViewportWidth, m_ViewportHeight);
-        m_IDPass->GetTargetFramebuffer()->Resize(m_ViewportWidth, m_ViewportHeight);
-        m_SolidPass->GetTargetFramebuffer()->Resize(m_ViewportWidth, m_ViewportHeight);
-        m_PhongPass->GetTargetFramebuffer()->Resize(m_ViewportWidth, m_ViewportHeight);
-        m_PBRPass->GetTargetFramebuffer()->Resize(m_ViewportWidth, m_ViewportHeight);
+        m_RenderGraph.SetExtent((uint32_t)m_ViewportWidth, (uint32_t)m_ViewportHeight);
 
         m_SceneData.SceneCamera = camera;
 		m_SceneData.SceneEnvironment = m_Scene->m_Environment;
@@ -264,18 +307,19 @@ namespace Chozo
 
         CameraDataUB.ProjectionMatrix = camera.GetProjection();
         CameraDataUB.ViewMatrix = camera.GetViewMatrix();
+        CameraDataUB.InverseViewProjectionMatrix = glm::inverse(camera.GetViewProjectionMatrix());
 
         SceneDataUB.CameraPosition = camera.GetPosition();
         SceneDataUB.EnvironmentMapIntensity = m_Scene->m_EnvironmentIntensity;
 
-        m_CameraUB->SetData(&CameraDataUB, sizeof(CameraData));
-        m_SceneUB->SetData(&SceneDataUB, sizeof(SceneData));
-        m_DirectionalLightsUB->SetData(&DirectionalLightsDataUB, sizeof(DirectionalLightsData));
-        m_PointLightsUB->SetData(&PointLightsDataUB, sizeof(PointLightsData));
-        m_SpotLightsUB->SetData(&SpotLightsDataUB, sizeof(SpotLightsData));
-        DirectionalLightsDataUB.LightCount = 0;
-        PointLightsDataUB.LightCount = 0;
-        SpotLightsDataUB.LightCount = 0;
+        LightGridDataUB.ViewMatrix = camera.GetViewMatrix();
+        LightGridDataUB.ViewportSize = { m_ViewportWidth, m_ViewportHeight };
+
+        m_MeshDatas = FrameVector<MeshData>(Renderer::GetFrameAllocator());
+
+        // Entities that weren't submitted last scene drop out here.
+        m_PreviousLODs.swap(m_SubmittedLODs);
+        m_SubmittedLODs.clear();
     }
 
     void SceneRenderer::EndScene()
@@ -293,6 +337,12 @@ namespace Chozo
         m_ViewportHeight = height;
     }
 
+    void SceneRenderer::SetOverdrawVisualization(const bool enabled)
+    {
+        m_OverdrawVisualization = enabled;
+        m_RenderGraph.SetEnabled(m_OverdrawNode, enabled);
+    }
+
     void SceneRenderer::SetClearColor(const glm::vec4 color)
 	{
     	m_CompositePass->GetTargetFramebuffer()->GetSpecification().ClearColor = color;
@@ -328,6 +378,7 @@ namespace Chozo
         PointLightsDataUB.Lights[index].Position = position;
         PointLightsDataUB.Lights[index].Intensity = light->Intensity;
         PointLightsDataUB.Lights[index].Color = light->Color;
+        PointLightsDataUB.Lights[index].Radius = light->Radius;
 
         PointLightsDataUB.LightCount++;
 
@@ -349,21 +400,74 @@ namespace Chozo
         SpotLightsDataUB.Lights[index].AngleAttenuation = light->AngleAttenuation;
         SpotLightsDataUB.Lights[index].Color = light->Color;
         SpotLightsDataUB.Lights[index].Angle = light->Angle;
+        SpotLightsDataUB.Lights[index].Radius = light->Radius;
 
         SpotLightsDataUB.LightCount++;
 
         return true;
     }
 
-    void SceneRenderer::SubmitMesh(Ref<DynamicMesh> mesh, uint32_t submeshIndex, Ref<Material> material, const glm::mat4& transform, uint64_t entityID)
+    uint32_t SceneRenderer::GetSubmittedLOD(const uint64_t entityID) const
+    {
+        const auto it = m_PreviousLODs.find(entityID);
+        return it != m_PreviousLODs.end() ? it->second : 0;
+    }
+
+    void SceneRenderer::SubmitMesh(const Ref<DynamicMesh>& mesh, uint32_t submeshIndex, const Ref<Material>& material, const glm::mat4& transform, uint64_t entityID, uint32_t lod)
     {
-        MeshData meshData;
-        meshData.Mesh = mesh;
+        auto& allocator = Renderer::GetFrameAllocator();
+
+        MeshData meshData{};
+        meshData.Mesh = allocator.Pin(mesh);
         meshData.SubmeshIndex = submeshIndex;
-        meshData.Material = material;
+        meshData.LOD = lod;
+        meshData.Material = allocator.Pin(material);
         meshData.Transform = transform;
         meshData.ID = entityID;
-        m_MeshDatas.push_back(meshData);
+        m_SubmittedLODs[entityID] = lod;
+
+        // Meshlets partition LOD 0 only, simplified LODs are drawn whole.
+        const auto& submesh = mesh->GetMeshSource()->GetSubmeshes()[submeshIndex];
+        if (Renderer::GetConfig().EnableMeshletCulling && lod == 0 && !submesh.Meshlets.empty())
+        {
+            const auto& camera = m_SceneData.SceneCamera;
+            m_CulledRanges.clear();
+            uint32_t culled = MeshletCuller::Cull(submesh, transform, camera.GetViewProjectionMatrix(), camera.GetPosition(), m_CulledRanges);
+            Renderer::Submit([culled]() { Renderer::GetRendererData().Stats.CulledMeshlets += culled; });
+
+            if (m_CulledRanges.empty())
+                return;
+
+            meshData.Ranges = allocator.Copy(m_CulledRanges.data(), m_CulledRanges.size());
+            meshData.RangeCount = (uint32_t)m_CulledRanges.size();
+        }
+
+        if (Renderer::GetConfig().EnableTextureStreaming && material)
+            RequestTextureMips(mesh, submeshIndex, material, transform);
+
+        m_MeshDatas.PushBack(meshData);
+    }
+
+    void SceneRenderer::RequestTextureMips(const Ref<DynamicMesh>& mesh, const uint32_t submeshIndex, const Ref<Material>& material, const glm::mat4& transform) const
+    {
+        const auto& submesh = mesh->GetMeshSource()->GetSubmeshes()[submeshIndex];
+        const auto& camera = m_SceneData.SceneCamera;
+
+        // Texel density at the point of the bounding sphere nearest to the camera, clamped to the near plane.
+        glm::vec3 center = (submesh.BoundingBox.Min + submesh.BoundingBox.Max) * 0.5f;
+        float scale = glm::max(glm::length(glm::vec3(transform[0])), glm::max(glm::length(glm::vec3(transform[1])), glm::length(glm::vec3(transform[2]))));
+        float radius = glm::length(submesh.BoundingBox.Max - submesh.BoundingBox.Min) * 0.5f * scale;
+
+        glm::vec4 viewCenter = camera.GetViewMatrix() * transform * glm::vec4(center, 1.0f);
+        float depth = glm::max(-viewCenter.z - radius, camera.GetNearClip());
+
+        // Screen pixels per object space unit at that depth.
+        float pixelsPerUnit = camera.GetProjection()[1][1] * 0.5f * m_ViewportHeight * scale / depth;
+        float uvPerPixel = pixelsPerUnit > 0.0f ? mesh->GetUVDensity(submeshIndex) / pixelsPerUnit : 0.0f;
+
+        // Larger on screen streams first, the projected sphere height as a fraction of the viewport.
+        float coverage = radius * camera.GetProjection()[1][1] / glm::max(-viewCenter.z, camera.GetNearClip());
+        TextureStreamer::RequestMaterial(material, uvPerPixel, coverage);
     }
 
     void SceneRenderer::SkyboxPass()
@@ -382,22 +486,30 @@ namespace Chozo
 
     void SceneRenderer::GeometryPass()
     {
+        const bool depthPrePass = Renderer::GetConfig().EnableDepthPrePass;
+        SetOpaqueDepthState(m_GeometryPass, depthPrePass);
+
 		RenderCommand::BeginRenderPass(m_CommandBuffer, m_GeometryPass);
-        for (auto [Mesh, SubmeshIndex, Material, Transform, ID] : m_MeshDatas)
+        if (depthPrePass)
+            SubmitDepthPrePass();
+
+        for (const auto& meshData : m_MeshDatas)
         {
-            if (!Material)
+            if (!meshData.Material)
                 continue;
 
-            if (Mesh.As<DynamicMesh>())
-                RenderCommand::SubmitMeshWithMaterial(
-                	m_CommandBuffer,
-                	m_GeometryPass->GetPipeline(),
-                	Mesh.As<DynamicMesh>(),
-                	SubmeshIndex,
-                	Material,
-                	Transform,
-                	(int)ID
-                );
+            RenderCommand::SubmitMeshWithMaterial(
+                m_CommandBuffer,
+                m_GeometryPass->GetPipeline(),
+                meshData.Mesh,
+                meshData.SubmeshIndex,
+                meshData.LOD,
+                meshData.Ranges,
+                meshData.RangeCount,
+                meshData.Material,
+                meshData.Transform,
+                (int)meshData.ID
+            );
         }
 		RenderCommand::EndRenderPass(m_CommandBuffer, m_GeometryPass);
     }
@@ -412,20 +524,23 @@ namespace Chozo
     void SceneRenderer::SolidPass()
     {
 		RenderCommand::BeginRenderPass(m_CommandBuffer, m_SolidPass);
-        for (auto [Mesh, SubmeshIndex, Material, Transform, ID] : m_MeshDatas)
+        for (const auto& meshData : m_MeshDatas)
         {
-            if (!Material)
-            {
-                if (Mesh.As<DynamicMesh>())
-                    RenderCommand::SubmitMeshWithMaterial(m_CommandBuffer,
-	                    m_SolidPass->GetPipeline(),
-	                    Mesh.As<DynamicMesh>(),
-	                    SubmeshIndex,
-	                    m_SolidMaterial,
-	                    Transform,
-	                    (int)ID
-                    );
-            }
+            if (meshData.Material)
+                continue;
+
+            RenderCommand::SubmitMeshWithMaterial(
+                m_CommandBuffer,
+                m_SolidPass->GetPipeline(),
+                meshData.Mesh,
+                meshData.SubmeshIndex,
+                meshData.LOD,
+                meshData.Ranges,
+                meshData.RangeCount,
+                m_SolidMaterial.Raw(),
+                meshData.Transform,
+                (int)meshData.ID
+            );
         }
 		RenderCommand::EndRenderPass(m_CommandBuffer, m_SolidPass);
     }
@@ -452,19 +567,9 @@ namespace Chozo
     void SceneRenderer::PBRPass()
     {
         RenderCommand::BeginRenderPass(m_CommandBuffer, m_PBRPass);
-       
-        Ref<Texture2D> positionTex = m_GeometryPass->GetOutput(0);
-        Ref<Texture2D> normalTex = m_GeometryPass->GetOutput(1);
-        Ref<Texture2D> baseColorTex = m_GeometryPass->GetOutput(3);
-        Ref<Texture2D> materialPropTex = m_GeometryPass->GetOutput(4);
-        Ref<TextureCube> irradianceMap = Renderer::GetIrradianceTextureCube();
+
         Ref<TextureCube> prefilterMap = Renderer::GetPrefilteredTextureCube();
         Ref<Texture2D> brdfLUTTexture = Renderer::GetBrdfLUT();
-        m_PBRMaterial->Set("u_PositionTex", positionTex);
-        m_PBRMaterial->Set("u_NormalTex", normalTex);
-        m_PBRMaterial->Set("u_BaseColorTex", baseColorTex);
-        m_PBRMaterial->Set("u_MaterialPropTex", materialPropTex);
-        m_PBRMaterial->Set("u_IrradianceMap", irradianceMap);
         m_PBRMaterial->Set("u_PrefilterMap", prefilterMap);
         m_PBRMaterial->Set("u_BRDFLutTex", brdfLUTTexture);
 
@@ -481,24 +586,146 @@ namespace Chozo
 		RenderCommand::EndRenderPass(m_CommandBuffer, m_CompositePass);
     }
 
+    void SceneRenderer::OverdrawPass()
+    {
+        const bool depthPrePass = Renderer::GetConfig().EnableDepthPrePass;
+        SetOpaqueDepthState(m_OverdrawPass, depthPrePass);
+
+		RenderCommand::BeginRenderPass(m_CommandBuffer, m_OverdrawPass);
+        if (depthPrePass)
+            SubmitDepthPrePass();
+
+        // Fragments passing the depth test here are the ones the geometry pass shades.
+        RenderCommand::BeginFragmentQuery(m_CommandBuffer);
+        for (const auto& meshData : m_MeshDatas)
+        {
+            if (!meshData.Material)
+                continue;
+
+            RenderCommand::SubmitMeshWithMaterial(
+                m_CommandBuffer,
+                m_OverdrawPass->GetPipeline(),
+                meshData.Mesh,
+                meshData.SubmeshIndex,
+                meshData.LOD,
+                meshData.Ranges,
+                meshData.RangeCount,
+                nullptr,
+                meshData.Transform,
+                (int)meshData.ID
+            );
+        }
+        RenderCommand::EndFragmentQuery(m_CommandBuffer, (uint32_t)m_ViewportWidth * (uint32_t)m_ViewportHeight);
+		RenderCommand::EndRenderPass(m_CommandBuffer, m_OverdrawPass);
+    }
+
+    void SceneRenderer::SubmitDepthPrePass()
+    {
+        for (const auto& meshData : m_MeshDatas)
+        {
+            if (!meshData.Material)
+                continue;
+
+            RenderCommand::SubmitMeshWithMaterial(
+                m_CommandBuffer,
+                m_DepthPrePass->GetPipeline(),
+                meshData.Mesh,
+                meshData.SubmeshIndex,
+                meshData.LOD,
+                meshData.Ranges,
+                meshData.RangeCount,
+                nullptr,
+                meshData.Transform,
+                (int)meshData.ID
+            );
+        }
+    }
+
+    void SceneRenderer::SetOpaqueDepthState(const Ref<RenderPass>& renderPass, const bool depthPrePass)
+    {
+        // After a pre-pass only the closest surface passes, and the depth is already there.
+        auto& spec = renderPass->GetPipeline()->GetSpecification();
+        spec.DepthOperator = depthPrePass ? DepthCompareOperator::Equal : DepthCompareOperator::Less;
+        spec.DepthWrite = !depthPrePass;
+    }
+
     void SceneRenderer::Flush()
     {
         m_CommandBuffer->Begin();
 
-        SkyboxPass();
-        GeometryPass();
-        SolidPass();
-        IDPass();
-        // PhongPass();
-        PBRPass();
-        CompositePass();
+        UploadUniformBuffers();
+
+        m_RenderGraph.Execute();
 
         SceneRenderEvent event;
         m_EventBus.Dispatch(event);
 
         m_CommandBuffer->End();
 
-        m_MeshDatas.clear();
+        m_MeshDatas.Clear();
+    }
+
+    void SceneRenderer::UploadUniformBuffers()
+    {
+        auto& allocator = Renderer::GetFrameAllocator();
+        // Lights submitted this frame are uploaded before the passes, only the used part of each array is copied.
+        auto upload = [&](Ref<UniformBuffer>& uniformBuffer, const void* data, uint32_t size) {
+            void* copy = allocator.Copy(static_cast<const uint8_t*>(data), size);
+            m_CommandBuffer->AddCommand([uniformBuffer = uniformBuffer.Raw(), copy, size]() {
+                uniformBuffer->SetData(copy, size);
+            });
+        };
+
+        upload(m_CameraUB, &CameraDataUB, sizeof(CameraData));
+        {
+            SceneData* copy = allocator.Copy(&SceneDataUB, 1);
+            m_CommandBuffer->AddCommand([uniformBuffer = m_SceneUB.Raw(), copy]() {
+                copy->Irradiance = Renderer::GetRendererData().SkyIrradiance;
+                uniformBuffer->SetData(copy, sizeof(SceneData));
+            });
+        }
+        upload(m_DirectionalLightsUB, &DirectionalLightsDataUB, offsetof(DirectionalLightsData, Lights) + DirectionalLightsDataUB.LightCount * sizeof(DirLight));
+        upload(m_PointLightsUB, &PointLightsDataUB, offsetof(PointLightsData, Lights) + PointLightsDataUB.LightCount * sizeof(PointLight));
+        upload(m_SpotLightsUB, &SpotLightsDataUB, offsetof(SpotLightsData, Lights) + SpotLightsDataUB.LightCount * sizeof(SpotLight));
+
+        UploadLightGrid();
+        upload(m_LightGridUB, &LightGridDataUB, sizeof(LightGridData));
+
+        DirectionalLightsDataUB.LightCount = 0;
+        PointLightsDataUB.LightCount = 0;
+        SpotLightsDataUB.LightCount = 0;
+    }
+
+    void SceneRenderer::UploadLightGrid()
+    {
+        m_PointLightBounds.resize(PointLightsDataUB.LightCount);
+        for (uint32_t i = 0; i < PointLightsDataUB.LightCount; i++)
+            m_PointLightBounds[i] = { PointLightsDataUB.Lights[i].Position, PointLightsDataUB.Lights[i].Radius };
+
+        m_SpotLightBounds.resize(SpotLightsDataUB.LightCount);
+        for (uint32_t i = 0; i < SpotLightsDataUB.LightCount; i++)
+        {
+            const auto& light = SpotLightsDataUB.Lights[i];
+            // Same outer cone as the shading.
+            m_SpotLightBounds[i] = { light.Position, light.Radius, light.Direction, glm::radians(light.Angle + light.AngleAttenuation) };
+        }
+
+        const auto& camera = m_SceneData.SceneCamera;
+        m_LightGrid.Build(camera.GetViewMatrix(), camera.GetProjection(), camera.GetNearClip(), camera.GetFarClip(),
+            m_PointLightBounds.data(), (uint32_t)m_PointLightBounds.size(),
+            m_SpotLightBounds.data(), (uint32_t)m_SpotLightBounds.size());
+
+        LightGridDataUB.SliceScale = m_LightGrid.GetSliceScale();
+        LightGridDataUB.SliceBias = m_LightGrid.GetSliceBias();
+
+        const auto& data = m_LightGrid.GetData();
+        const auto size = (uint32_t)(data.size() * sizeof(uint32_t));
+        const uint32_t* copy = Renderer::GetFrameAllocator().Copy(data.data(), data.size());
+        m_CommandBuffer->AddCommand([storageBuffer = m_LightGridSB.Raw(), copy, size]() {
+            if (size > storageBuffer->GetSize())
+                storageBuffer->Resize(std::max(size, storageBuffer->GetSize() * 2));
+            storageBuffer->SetData(copy, size);
+        });
     }
 
     void SceneRenderer::CopyImage(Ref<Texture2D> source, SharedBuffer &dest)
@@ -4,9 +4,14 @@
 
 #include "Mesh.h"
 #include "UniformBuffer.h"
+#include "StorageBuffer.h"
 #include "RenderPass.h"
 #include "EditorCamera.h"
 #include "RenderCommandBuffer.h"
+#include "FrameAllocator.h"
+#include "LightGrid.h"
+#include "RenderGraph.h"
+#include "SphericalHarmonics.h"
 
 #include "Chozo/Scene/Scene.h"
 #include "Chozo/Scene/Components.h"
@@ -28,7 +33,7 @@ namespace Chozo
         glm::vec3 Position;
         float Intensity;
         glm::vec3 Color;
-        float Padding;
+        float Radius;
     };
     struct SpotLight
     {
@@ -38,6 +43,8 @@ namespace Chozo
         float AngleAttenuation = 5.0f;
         glm::vec3 Color = { 1.0f, 1.0f, 1.0f };;
         float Angle = 10.0f;
+        float Radius = 10.0f;
+        float Padding[3];
     };
 
     class SceneRenderer : public RefCounted
@@ -66,7 +73,11 @@ namespace Chozo
         bool SubmitPointLight(PointLightComponent* light, glm::vec3& position);
         bool SubmitSpotLight(SpotLightComponent* light, glm::vec3& position);
 
-        void SubmitMesh(Ref<DynamicMesh> mesh, uint32_t submeshIndex, Ref<Material> material, const glm::mat4& transform, uint64_t entityID);
+        void SubmitMesh(const Ref<DynamicMesh>& mesh, uint32_t submeshIndex, const Ref<Material>& material, const glm::mat4& transform, uint64_t entityID, uint32_t lod = 0);
+
+        const EditorCamera& GetSceneCamera() const { return m_SceneData.SceneCamera; }
+        // LOD the entity's mesh was submitted with in the previous scene of this renderer, 0 for new ones.
+        uint32_t GetSubmittedLOD(uint64_t entityID) const;
 
         Ref<RenderPass> GetSkyboxPass() { return m_SkyboxPass; }
         Ref<RenderPass> GetGeometryPass() { return m_GeometryPass; }
@@ -75,6 +86,11 @@ namespace Chozo
         Ref<RenderPass> GetPhongPass() { return m_PhongPass; }
         Ref<RenderPass> GetPBRPass() { return m_PBRPass; }
         Ref<RenderPass> GetCompositePass() { return m_CompositePass; }
+        Ref<RenderPass> GetOverdrawPass() { return m_OverdrawPass; }
+
+        // Renders how often each pixel of the G-buffer is shaded, and feeds the overdraw stats.
+        void SetOverdrawVisualization(bool enabled);
+        bool IsOverdrawVisualization() const { return m_OverdrawVisualization; }
 
         Ref<TextureCube> GetPBRIrradiance() { return m_PBRIrradiance; }
 
@@ -86,9 +102,19 @@ namespace Chozo
         void PBRPrePass();
         void PBRPass();
         void CompositePass();
+        void OverdrawPass();
 
         void Flush();
         void CopyImage(Ref<Texture2D> source, SharedBuffer& dest);
+    private:
+        void UploadUniformBuffers();
+        void UploadLightGrid();
+        // Depth of the opaque meshes into the bound target, for the passes drawing them with Equal afterwards.
+        void SubmitDepthPrePass();
+        // Depth state of a pass drawing the opaque meshes, depending on whether a pre-pass ran before it.
+        void SetOpaqueDepthState(const Ref<RenderPass>& renderPass, bool depthPrePass);
+        // Mips the streamed textures of material need for the submesh at its size on screen.
+        void RequestTextureMips(const Ref<DynamicMesh>& mesh, uint32_t submeshIndex, const Ref<Material>& material, const glm::mat4& transform) const;
     private:
 		Ref<Scene> m_Scene;
 		bool m_Active = false;
@@ -97,16 +123,23 @@ namespace Chozo
 
 		Ref<RenderCommandBuffer> m_CommandBuffer;
 
+        // Draw packet in the frame allocator, the mesh and material are pinned there for the frame.
         struct MeshData
         {
-            Ref<Mesh> Mesh;
-            uint32_t SubmeshIndex;
-            Ref<Material> Material;
+            DynamicMesh* Mesh;
+            Material* Material;
             glm::mat4 Transform;
+            const IndexRange* Ranges; // Visible meshlets, null draws the whole LOD.
+            uint32_t RangeCount;
+            uint32_t SubmeshIndex;
+            uint32_t LOD;
             uint64_t ID;
         };
 
-        std::vector<MeshData> m_MeshDatas;
+        FrameVector<MeshData> m_MeshDatas;
+        std::vector<IndexRange> m_CulledRanges;
+        // LOD hysteresis state, kept per renderer since each one sees the scene through its own camera.
+        std::unordered_map<uint64_t, uint32_t> m_SubmittedLODs, m_PreviousLODs;
 
         struct SceneInfo
 		{
@@ -122,6 +155,8 @@ namespace Chozo
 		{
 			glm::vec3 CameraPosition;
 			float EnvironmentMapIntensity = 1.0f;
+			// Filled in on the render thread, where the sky jobs publish their result.
+			IrradianceSH Irradiance;
 		} SceneDataUB;
 
         struct CameraData
@@ -158,9 +193,24 @@ namespace Chozo
         Ref<UniformBuffer> m_DirectionalLightsUB;
         Ref<UniformBuffer> m_SpotLightsUB;
 
+        struct LightGridData
+        {
+            glm::mat4 ViewMatrix;
+            glm::vec2 ViewportSize;
+            float SliceScale;
+            float SliceBias;
+        } LightGridDataUB;
+
+        LightGrid m_LightGrid;
+        std::vector<LightGrid::PointLightBounds> m_PointLightBounds;
+        std::vector<LightGrid::SpotLightBounds> m_SpotLightBounds;
+        Ref<UniformBuffer> m_LightGridUB;
+        Ref<StorageBuffer> m_LightGridSB;
+
 		Ref<Material> m_SkyboxMaterial;
 		Ref<RenderPass> m_SkyboxPass;
 
+		Ref<RenderPass> m_DepthPrePass;
 		Ref<RenderPass> m_GeometryPass;
         
 		Ref<Material> m_IDMaterial;
@@ -179,6 +229,12 @@ namespace Chozo
 		Ref<Material> m_CompositeMaterial;
         Ref<RenderPass> m_CompositePass;
 
+        Ref<RenderPass> m_OverdrawPass;
+        bool m_OverdrawVisualization = false;
+
+        RenderGraph m_RenderGraph;
+        RenderGraph::PassHandle m_SkyboxNode, m_GeometryNode, m_SolidNode, m_IDNode, m_PhongNode, m_PBRNode, m_CompositeNode, m_OverdrawNode;
+
 		float m_ViewportWidth = 0, m_ViewportHeight = 0;
     };
 }
@@ -1,10 +1,10 @@
 #include "Shader.h"
 
 #include "RenderCommand.h"
-#include "Chozo/Core/Application.h"
+#include "Renderer.h"
+#include "Chozo/Core/Pool.h"
 #include "Chozo/Renderer/Backend/OpenGL/OpenGLShader.h"
-
-#include <GLFW/glfw3.h>
+#include "Chozo/Renderer/Shader/ShaderCompiler.h"
 
 namespace Chozo {
 
@@ -22,8 +22,28 @@ namespace Chozo {
 
     void ShaderLibrary::Load(const std::string_view name, const std::vector<std::string> filePaths)
     {
-        Ref<Shader> shader = Shader::Create(std::string(name), filePaths);
-        m_Shaders.emplace(name, shader);
+        Load({ { std::string(name), filePaths } });
+    }
+
+    void ShaderLibrary::Load(const std::vector<ShaderSpecification>& specs)
+    {
+        std::vector<Ref<Shader>> shaders;
+        shaders.reserve(specs.size());
+        for (const auto& spec : specs)
+            shaders.push_back(Shader::Create(spec.Name, spec.FilePaths));
+
+        CompileSources(shaders);
+        Renderer::SubmitAndWait([&shaders]() {
+            for (auto& shader : shaders)
+                shader->Link();
+        });
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        for (size_t i = 0; i < specs.size(); i++)
+        {
+            m_Shaders.emplace(specs[i].Name, shaders[i]);
+            UpdateDependencies(specs[i].Name);
+        }
     }
 
     void ShaderLibrary::Recompile()
@@ -33,22 +53,116 @@ namespace Chozo {
             return;
         }
 
+        const auto modifiedFiles = GetModifiedFiles();
+        if (modifiedFiles.empty())
+        {
+            CZ_CORE_INFO("Shaders are up to date.");
+            return;
+        }
+
+        Recompile(modifiedFiles);
+    }
+
+    void ShaderLibrary::Recompile(const std::vector<std::string>& changedFiles)
+    {
+        if (m_IsCompiling) {
+            CZ_CORE_ERROR("Shaders are already compiling. Skipping new request.");
+            return;
+        }
+
+        const auto dependents = GetDependents(changedFiles);
+        if (dependents.empty())
+            return;
+
         m_IsCompiling = true;
         m_Thread.Join();
-        m_Thread.Dispatch([this]() {
-            for (auto& [name, shader] : m_Shaders)
+        m_Thread.Dispatch([this, dependents]() {
+            std::vector<Ref<Shader>> shaders;
+            for (const auto& name : dependents)
             {
-                // Clear caches
-                shader->ClearCache();
-                // Compile shaders
-                shader->AsyncCompile();
+                CZ_CORE_INFO("Recompiling shader '{}'", name);
+                shaders.push_back(Get(name));
             }
-            m_IsCompiling = false;
+
+            // Cache files are keyed by source hash, stale binaries are never picked up.
+            CompileSources(shaders);
+
+            // Linked on the render thread, the only one binding the programs.
+            Renderer::Submit([this, shaders, dependents]() {
+                for (Ref<Shader> shader : shaders)
+                    shader->Link();
+
+                {
+                    std::lock_guard<std::mutex> lock(m_Mutex);
+                    for (const auto& name : dependents)
+                        UpdateDependencies(name);
+                }
+                m_IsCompiling = false;
+            });
         });
     }
 
-    const Ref<Shader>& ShaderLibrary::Get(const std::string &name) const
+    void ShaderLibrary::CompileSources(const std::vector<Ref<Shader>>& shaders)
+    {
+        // The workers define MAX_TEXTURE_SLOTS without a context of their own, the count is cached here first.
+        Renderer::GetMaxTextureSlots();
+        Pool::ParallelFor((uint32_t)shaders.size(), [&shaders](const uint32_t index) { shaders[index]->CompileSources(); });
+    }
+
+    std::unordered_set<std::string> ShaderLibrary::GetDependents(const std::vector<std::string>& filePaths) const
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        std::unordered_set<std::string> dependents;
+        for (const auto& filePath : filePaths)
+        {
+            auto it = m_Dependents.find(ShaderUtils::NormalizePath(filePath));
+            if (it != m_Dependents.end())
+                dependents.insert(it->second.begin(), it->second.end());
+        }
+        return dependents;
+    }
+
+    // Called with m_Mutex held.
+    void ShaderLibrary::UpdateDependencies(const std::string& name)
+    {
+        for (auto it = m_Dependents.begin(); it != m_Dependents.end();)
+        {
+            it->second.erase(name);
+            it = it->second.empty() ? m_Dependents.erase(it) : std::next(it);
+        }
+
+        for (const auto& dependency : m_Shaders.at(name)->GetDependencies())
+        {
+            m_Dependents[dependency].insert(name);
+
+            std::error_code error;
+            const auto writeTime = fs::last_write_time(dependency, error);
+            if (!error)
+                m_FileWriteTimes[dependency] = writeTime;
+        }
+    }
+
+    std::vector<std::string> ShaderLibrary::GetModifiedFiles() const
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        std::vector<std::string> modifiedFiles;
+        for (const auto& [filePath, shaders] : m_Dependents)
+        {
+            std::error_code error;
+            const auto writeTime = fs::last_write_time(filePath, error);
+            if (error)
+                continue;
+
+            auto it = m_FileWriteTimes.find(filePath);
+            if (it == m_FileWriteTimes.end() || it->second != writeTime)
+                modifiedFiles.push_back(filePath);
+        }
+        return modifiedFiles;
+    }
+
+    Ref<Shader> ShaderLibrary::Get(const std::string &name) const
     {
+        std::lock_guard<std::mutex> lock(m_Mutex);
 		CZ_CORE_ASSERT(m_Shaders.find(name) != m_Shaders.end(), "");
         return m_Shaders.at(name);
     }
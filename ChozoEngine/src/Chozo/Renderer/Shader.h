@@ -5,6 +5,8 @@
 #include "Chozo/Core/Thread.h"
 
 #include "czpch.h"
+#include <atomic>
+#include <mutex>
 #include <glm/glm.hpp>
 
 namespace Chozo {
@@ -88,18 +90,36 @@ namespace Chozo {
         virtual const std::string& GetName() const = 0;
         virtual const RendererID& GetRendererID() const = 0;
         virtual ShaderReflection GetReflection() const = 0;
+        // Normalized paths of the stage sources and every file they include.
+        virtual const std::unordered_set<std::string>& GetDependencies() const = 0;
+        // Keywords declared with `#pragma multi_compile`, keyword i is bit i of a variant mask. Any thread.
+        virtual std::vector<std::string> GetKeywords() const = 0;
+        // Variant compiled with the keywords set in keywordMask defined. It's compiled on a pool worker the first time
+        // it's requested and the shader itself is returned until it's ready. Must be called on the render thread.
+        virtual Ref<Shader> GetVariant(uint32_t keywordMask) = 0;
+        virtual bool HasUniform(const std::string& name) const = 0;
 
         virtual void SetUniform(const std::string& name, const UniformValue& value, uint32_t count) const = 0;
         void SetUniform(const std::string& name, const UniformValue& value) const { SetUniform(name, value, 0); }
         virtual void ClearCache() = 0;
+        // CompileSources followed by Link.
         virtual void Compile() = 0;
-        virtual void AsyncCompile() = 0;
+        // Produces everything but the program, safe to call from any thread.
+        virtual void CompileSources() = 0;
+        // Creates the program from CompileSources' output, must run on a thread with a current context.
+        virtual void Link() = 0;
 
         static Ref<Shader> Create(const std::string& name, std::vector<std::string> filePaths);
     protected:
         ShaderReflection m_Reflection;
     };
 
+    struct ShaderSpecification
+    {
+        std::string Name;
+        std::vector<std::string> FilePaths;
+    };
+
     class ShaderLibrary : public RefCounted
     {
     public:
@@ -107,14 +127,28 @@ namespace Chozo {
         ~ShaderLibrary() override = default;
 
 		void Load(std::string_view name, std::vector<std::string> filePaths);
+		// Compiles the shaders across worker threads, only program linking runs on the render thread.
+		void Load(const std::vector<ShaderSpecification>& specs);
+		// Recompiles only the shaders depending on a source or include file modified since it was last compiled.
 		void Recompile();
+		void Recompile(const std::vector<std::string>& changedFiles);
 
-		const Ref<Shader>& Get(const std::string& name) const;
+		Ref<Shader> Get(const std::string& name) const;
+		std::unordered_set<std::string> GetDependents(const std::vector<std::string>& filePaths) const;
 
         static Ref<ShaderLibrary> Create();
+    private:
+        static void CompileSources(const std::vector<Ref<Shader>>& shaders);
+        void UpdateDependencies(const std::string& name);
+        std::vector<std::string> GetModifiedFiles() const;
     private:
         Thread m_Thread = Thread("ShaderLibrary");
-        bool m_IsCompiling = false;
+        std::atomic<bool> m_IsCompiling = false;
+		// Guards the members below, hot reload updates them on the render thread.
+		mutable std::mutex m_Mutex;
 		std::unordered_map<std::string, Ref<Shader>> m_Shaders;
+		// Reverse include graph: file path -> names of the shaders that read it.
+		std::unordered_map<std::string, std::unordered_set<std::string>> m_Dependents;
+		std::unordered_map<std::string, fs::file_time_type> m_FileWriteTimes;
     };
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "GlslIncluder.h"
 
+#include "ShaderIncludeCache.h"
 #include "Chozo/Utilities/FileUtils.h"
 
 #include <iostream>
@@ -23,7 +24,7 @@ namespace Chozo {
     		m_IncludedFiles.insert(requestedFullPath);
 
         const auto name = std::string(requestedFullPath);
-        const std::string contents = Utils::File::ReadTextFile(name);
+        const std::string contents = ShaderIncludeCache::Read(name);
 
         const auto container = new std::array<std::string, 2>;
         (*container)[0] = name;
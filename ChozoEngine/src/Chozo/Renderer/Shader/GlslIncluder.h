@@ -20,6 +20,9 @@ namespace Chozo {
         ) override;
 
         void ReleaseInclude(shaderc_include_result* data) override;
+
+        // Normalized paths of every file resolved by this includer.
+        const std::unordered_set<std::string>& GetIncludedFiles() const { return m_IncludedFiles; }
     private:
 		const shaderc_util::FileFinder& m_FileFinder;
         std::unordered_set<std::string> m_IncludedFiles;
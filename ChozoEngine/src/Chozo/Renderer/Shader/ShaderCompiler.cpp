@@ -1,12 +1,14 @@
 #include "ShaderCompiler.h"
 
 #include "../RenderCommand.h"
+#include "Chozo/Renderer/Renderer.h"
 #include "Chozo/Renderer/Backend/OpenGL/OpenGLShaderCompiler.h"
 #include "Chozo/FileSystem/FileStream.h"
 #include "Chozo/Renderer/Shader/GlslIncluder.h"
 
 #include <spirv_cross/spirv_cross.hpp>
 #include <spirv_cross/spirv_glsl.hpp>
+#include <thread>
 
 namespace Chozo {
     
@@ -115,24 +117,63 @@ namespace Chozo {
         }
     }
 
-    void ShaderCompiler::CompileToOrGetVulkanBinaries(ShaderSources &shaderSources, const ShaderPaths &shaderPaths)
+    // shaderc::Compiler instances must not be shared between threads, every compiler thread keeps its own.
+    static shaderc::Compiler& GetThreadCompiler()
+    {
+        thread_local shaderc::Compiler compiler;
+        return compiler;
+    }
+
+    // Bump when the cache file layout or the compile pipeline changes in a way the source hash can't see.
+    static constexpr uint32_t s_ShaderCacheVersion = 1;
+
+    void ShaderCompiler::SetCompileOptions(shaderc::CompileOptions& options, const std::vector<std::string>& defines)
     {
-        // Set compile options
-        shaderc::Compiler compiler;
-        shaderc::CompileOptions options;
         options.SetTargetEnvironment(shaderc_target_env_vulkan, shaderc_env_version_vulkan_1_2);
-        options.AddMacroDefinition("MAX_TEXTURE_SLOTS", std::to_string(RenderCommand::GetMaxTextureSlots()));
+        options.AddMacroDefinition("MAX_TEXTURE_SLOTS", std::to_string(Renderer::GetMaxTextureSlots()));
+        for (const auto& define : defines)
+            options.AddMacroDefinition(define, "1");
 
         const bool optimize = false;
         if (optimize)
             options.SetOptimizationLevel(shaderc_optimization_level_performance);
+    }
+
+    uint64_t ShaderCompiler::GetSourceHash(const std::string& preProcessedSource, const ShaderStage& stage, const std::vector<std::string>& defines)
+    {
+        // Macros are already expanded in the preprocessed source, the rest of the options are keyed explicitly.
+        std::string optionsKey = fmt::format("v{};vulkan_1_2;O0;MAX_TEXTURE_SLOTS={};{}",
+            s_ShaderCacheVersion, Renderer::GetMaxTextureSlots(), ShaderUtils::ShaderStageToString(stage));
+        for (const auto& define : defines)
+            optionsKey += ";" + define;
+
+        return Utils::Hash::FNV1a(preProcessedSource, Utils::Hash::FNV1a(optionsKey));
+    }
+
+    void ShaderCompiler::CompileToOrGetVulkanBinaries(ShaderSources &shaderSources, const ShaderPaths &shaderPaths)
+    {
+        // Set compile options
+        shaderc::Compiler& compiler = GetThreadCompiler();
+        shaderc::CompileOptions options;
+        SetCompileOptions(options, m_Defines);
 
-        fs::path cacheDirectory = Utils::File::GetShaderCacheDirectory();
+        m_Dependencies.clear();
+        m_CachePaths.clear();
+        m_SourceHashes.clear();
+        m_Keywords.clear();
 
         for (auto&& [stage, source] : shaderSources)
         {
             fs::path shaderFilepath = shaderPaths.at(stage);
-            fs::path cachePath = ShaderUtils::GetCachePathByNameAndStage(shaderFilepath.filename().stem().string(), stage);
+
+            // Preprocessing is cheap compared to compiling, and its output covers every included file.
+            PreProcess(shaderFilepath.string(), stage, source, m_Dependencies, m_Defines);
+            ParseKeywords(source, m_Keywords);
+
+            const uint64_t hash = GetSourceHash(source, stage, m_Defines);
+            m_SourceHashes[stage] = hash;
+            fs::path cachePath = ShaderUtils::GetCachePath(shaderFilepath.filename().stem().string(), stage, hash);
+            m_CachePaths[stage] = cachePath;
 
             auto& data = m_VulkanSpirV[stage];
 
@@ -145,8 +186,6 @@ namespace Chozo {
             else
             {
                 // Compile source string to vulkan shader binaries if doesn't exist.
-                PreProcess(shaderFilepath.string(), stage, source);
-
                 shaderc::SpvCompilationResult module = compiler.CompileGlslToSpv(
                     source,
                     ShaderUtils::ShaderStageToShaderC(stage),
@@ -161,22 +200,37 @@ namespace Chozo {
 
                 data = std::vector<uint32_t>(module.cbegin(), module.cend());
 
-                FileStreamWriter writer(cachePath);
-                if (writer.IsStreamGood())
+                // Shaders sharing a stage file compile concurrently to the same cache path,
+                // write to a per-thread file and rename it so readers never see a partial binary.
+                fs::path tempPath = cachePath;
+                tempPath += fmt::format(".{}.tmp", std::hash<std::thread::id>()(std::this_thread::get_id()));
                 {
-		            writer.WriteData((char*)data.data(), data.size() * sizeof(uint32_t));
+                    FileStreamWriter writer(tempPath);
+                    if (writer.IsStreamGood())
+                    {
+		                writer.WriteData((char*)data.data(), data.size() * sizeof(uint32_t));
+                    }
                 }
+
+                std::error_code error;
+                fs::rename(tempPath, cachePath, error);
+                if (error)
+                    fs::remove(tempPath, error);
             }
         }
     }
 
-    void ShaderCompiler::PreProcess(const std::string &shaderSourcePath, const ShaderStage &stage, std::string &shaderSource)
+    void ShaderCompiler::PreProcess(const std::string &shaderSourcePath, const ShaderStage &stage, std::string &shaderSource, ShaderDependencies& dependencies, const std::vector<std::string>& defines)
     {
-        shaderc::Compiler compiler;
+        shaderc::Compiler& compiler = GetThreadCompiler();
         shaderc::CompileOptions options;
 		shaderc_util::FileFinder fileFinder;
 
-        options.SetIncluder(std::make_unique<GlslIncluder>(&fileFinder));
+        SetCompileOptions(options, defines);
+
+        auto includer = std::make_unique<GlslIncluder>(&fileFinder);
+        const GlslIncluder* includerPtr = includer.get();
+        options.SetIncluder(std::move(includer));
 
         const auto preProcessingResult = compiler.PreprocessGlsl(
             shaderSource,
@@ -189,6 +243,35 @@ namespace Chozo {
             CZ_CORE_ASSERT("Renderer", fmt::format("Failed to pre-process \"{}\"'s {} shader.\nError: {}", shaderSourcePath, ShaderUtils::ShaderStageToString(stage), preProcessingResult.GetErrorMessage()));
         
         shaderSource = std::string(preProcessingResult.begin(), preProcessingResult.end());
+
+        dependencies.insert(ShaderUtils::NormalizePath(shaderSourcePath));
+        for (const auto& includedFile : includerPtr->GetIncludedFiles())
+            dependencies.insert(ShaderUtils::NormalizePath(includedFile));
+    }
+
+    void ShaderCompiler::ParseKeywords(const std::string& source, std::vector<std::string>& keywords)
+    {
+        std::istringstream stream(source);
+        std::string line;
+        while (std::getline(stream, line))
+        {
+            std::istringstream tokens(line);
+            std::string pragma, directive;
+            if (!(tokens >> pragma >> directive) || pragma != "#pragma" || directive != "multi_compile")
+                continue;
+
+            std::string keyword;
+            while (tokens >> keyword)
+            {
+                if (keyword.find_first_not_of('_') == std::string::npos)
+                    continue;
+                if (std::find(keywords.begin(), keywords.end(), keyword) == keywords.end())
+                    keywords.push_back(keyword);
+            }
+        }
+
+        std::sort(keywords.begin(), keywords.end());
+        CZ_CORE_ASSERT(keywords.size() <= MaxShaderKeywords, "Too many shader keywords!");
     }
 
     ShaderReflection ShaderCompiler::Reflect()
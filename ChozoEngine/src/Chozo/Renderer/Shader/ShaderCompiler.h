@@ -3,6 +3,7 @@
 #include "ShaderReflection.h"
 #include "Chozo/Renderer/RendererTypes.h"
 #include "Chozo/Utilities/StringUtils.h"
+#include "Chozo/Utilities/HashUtils.h"
 
 #include "czpch.h"
 #include <shaderc/shaderc.hpp>
@@ -77,34 +78,77 @@ namespace Chozo {
 			}
         }
 
-        inline fs::path GetCachePathByNameAndStage(const std::string& name, const ShaderStage& stage)
+        // Cache files are keyed by the hash of the preprocessed source, so edits to included files never hit a stale binary.
+        inline fs::path GetCachePath(const std::string& name, const ShaderStage& stage, const uint64_t hash)
         {
             const fs::path cacheDirectory = Utils::File::GetShaderCacheDirectory();
             Utils::File::CreateDirectoryIfNeeded(cacheDirectory);
 
-            return cacheDirectory / (name + ShaderUtils::ShaderStageToVulkanCacheFileExtension(stage));
+            return cacheDirectory / (name + "." + Utils::Hash::ToHexString(hash) + ShaderUtils::ShaderStageToVulkanCacheFileExtension(stage));
+        }
+
+        inline fs::path GetProgramCachePath(const std::string& name, const std::string& extension, const uint64_t hash)
+        {
+            const fs::path cacheDirectory = Utils::File::GetShaderCacheDirectory();
+            Utils::File::CreateDirectoryIfNeeded(cacheDirectory);
+
+            return cacheDirectory / (name + "." + Utils::Hash::ToHexString(hash) + extension);
+        }
+
+        inline std::string NormalizePath(const fs::path& path)
+        {
+            return path.lexically_normal().string();
         }
 	}
 
     using ShaderSources = std::unordered_map<ShaderStage, std::string>;
     using ShaderPaths = std::unordered_map<ShaderStage, fs::path>;
     using ShaderBinaries = std::unordered_map<ShaderStage, std::vector<u_int32_t>>;
+    using ShaderDependencies = std::unordered_set<std::string>;
+
+    // Keywords declared with `#pragma multi_compile`, keyword i is bit i of a variant mask.
+    constexpr uint32_t MaxShaderKeywords = 32;
     
     class ShaderCompiler : public RefCounted
     {
     public:
+        // CompileSources followed by Link.
         virtual RendererID Compile(std::vector<std::string> filePaths) = 0;
+        // Everything up to the backend program, makes no graphics API calls so it can run on any thread.
+        virtual void CompileSources(const std::vector<std::string>& filePaths) = 0;
+        // Creates and links the program from the compiled sources, must run on a thread with a current context.
+        virtual RendererID Link() = 0;
         virtual void Release() = 0;
 
         void CompileToOrGetVulkanBinaries(ShaderSources& shaderSources, const ShaderPaths& shaderPaths);
-        static void PreProcess(const std::string& shaderSourcePath, const ShaderStage& stage, std::string& shaderSource);
+        // Expands includes and macros in place and adds every file that was read to dependencies.
+        static void PreProcess(const std::string& shaderSourcePath, const ShaderStage& stage, std::string& shaderSource, ShaderDependencies& dependencies, const std::vector<std::string>& defines = {});
+        // Collects the keywords of every `#pragma multi_compile _ KEYWORD` line, "_" stands for the keyword-less variant.
+        static void ParseKeywords(const std::string& source, std::vector<std::string>& keywords);
         ShaderReflection Reflect();
 
+        // Keywords defined as 1 for this compile, set before CompileSources.
+        void SetDefines(const std::vector<std::string>& defines) { m_Defines = defines; }
+
+        // Source files of every stage plus their include closure, valid after Compile.
+        const ShaderDependencies& GetDependencies() const { return m_Dependencies; }
+        const ShaderPaths& GetCachePaths() const { return m_CachePaths; }
+        // Sorted keywords declared by all stages, valid after Compile.
+        const std::vector<std::string>& GetKeywords() const { return m_Keywords; }
+
         static Ref<ShaderCompiler> Create(std::string& name);
+    private:
+        static void SetCompileOptions(shaderc::CompileOptions& options, const std::vector<std::string>& defines);
+        static uint64_t GetSourceHash(const std::string& preProcessedSource, const ShaderStage& stage, const std::vector<std::string>& defines);
     protected:
         std::string m_Name;
+        std::vector<std::string> m_Defines;
+        std::vector<std::string> m_Keywords;
     	ShaderSources m_Sources;
     	ShaderPaths m_Paths;
+        ShaderPaths m_CachePaths;
+        std::unordered_map<ShaderStage, uint64_t> m_SourceHashes;
         ShaderBinaries m_VulkanSpirV;
+        ShaderDependencies m_Dependencies;
     };
 } // namespace Chozo
@@ -0,0 +1,43 @@
+#include "ShaderIncludeCache.h"
+
+#include <mutex>
+
+namespace Chozo {
+
+    struct ShaderIncludeCacheEntry
+    {
+        fs::file_time_type WriteTime;
+        std::string Contents;
+    };
+
+    static std::mutex s_Mutex;
+    static std::unordered_map<std::string, ShaderIncludeCacheEntry> s_Entries;
+
+    std::string ShaderIncludeCache::Read(const std::string& filePath)
+    {
+        std::error_code error;
+        const auto writeTime = fs::last_write_time(filePath, error);
+        if (error)
+            return Utils::File::ReadTextFile(filePath);
+
+        {
+            std::lock_guard lock(s_Mutex);
+            auto it = s_Entries.find(filePath);
+            if (it != s_Entries.end() && it->second.WriteTime == writeTime)
+                return it->second.Contents;
+        }
+
+        // Read outside the lock, two threads racing on the same file just read it twice.
+        std::string contents = Utils::File::ReadTextFile(filePath);
+
+        std::lock_guard lock(s_Mutex);
+        s_Entries[filePath] = { writeTime, contents };
+        return contents;
+    }
+
+    void ShaderIncludeCache::Clear()
+    {
+        std::lock_guard lock(s_Mutex);
+        s_Entries.clear();
+    }
+} // namespace Chozo
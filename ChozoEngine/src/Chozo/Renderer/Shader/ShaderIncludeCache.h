@@ -0,0 +1,15 @@
+#pragma once
+
+#include "czpch.h"
+
+namespace Chozo {
+
+    // In-memory cache of shader source and include files shared by all compiler threads.
+    // Entries are re-read when the file's last write time changes, so hot reload sees edits.
+    class ShaderIncludeCache
+    {
+    public:
+        static std::string Read(const std::string& filePath);
+        static void Clear();
+    };
+} // namespace Chozo
@@ -0,0 +1,161 @@
+#include "SphericalHarmonics.h"
+
+#include "ImageConverter.h"
+
+#include "Chozo/Core/Pool.h"
+
+#include <glm/gtc/constants.hpp>
+
+#include <cmath>
+
+namespace Chozo {
+
+    namespace Utils {
+
+        using SHSums = std::array<glm::vec3, 9>;
+
+        // Real spherical harmonics basis, bands 0 to 2.
+        static void EvaluateSHBasis(const glm::vec3& d, float basis[9])
+        {
+            basis[0] = 0.282095f;
+            basis[1] = 0.488603f * d.y;
+            basis[2] = 0.488603f * d.z;
+            basis[3] = 0.488603f * d.x;
+            basis[4] = 1.092548f * d.x * d.y;
+            basis[5] = 1.092548f * d.y * d.z;
+            basis[6] = 0.315392f * (3.0f * d.z * d.z - 1.0f);
+            basis[7] = 1.092548f * d.x * d.z;
+            basis[8] = 0.546274f * (d.x * d.x - d.y * d.y);
+        }
+
+        // Clamped cosine convolution of each band over PI (Ramamoorthi and Hanrahan 2001).
+        static constexpr float SHBandScale[9] = { 1.0f, 2.0f / 3.0f, 2.0f / 3.0f, 2.0f / 3.0f, 0.25f, 0.25f, 0.25f, 0.25f, 0.25f };
+
+        // Inverse of SampleSphericalMap in the cubemap sampler shader.
+        static glm::vec3 GetEquirectangularDirection(const float u, const float v)
+        {
+            const float phi = (u - 0.5f) * glm::two_pi<float>();
+            const float elevation = (v - 0.5f) * glm::pi<float>();
+            return { std::cos(elevation) * std::cos(phi), std::sin(elevation), std::cos(elevation) * std::sin(phi) };
+        }
+
+        // Integrates radiance(x, y, direction) over an equirectangular grid, rows are summed on the pool's workers.
+        template<typename RadianceFunc>
+        static IrradianceSH ProjectGrid(const uint32_t width, const uint32_t height, const RadianceFunc& radiance)
+        {
+            const float texelArea = (glm::two_pi<float>() / (float)width) * (glm::pi<float>() / (float)height);
+
+            std::vector<SHSums> rowSums(height);
+            Pool::ParallelFor(height, [&](const uint32_t y) {
+                SHSums& sums = rowSums[y];
+                sums.fill(glm::vec3(0.0f));
+
+                float basis[9];
+                const float v = ((float)y + 0.5f) / (float)height;
+                // Texels shrink towards the poles.
+                const float weight = std::cos((v - 0.5f) * glm::pi<float>()) * texelArea;
+                for (uint32_t x = 0; x < width; x++)
+                {
+                    const glm::vec3 direction = GetEquirectangularDirection(((float)x + 0.5f) / (float)width, v);
+                    const glm::vec3 L = radiance(x, y, direction) * weight;
+
+                    EvaluateSHBasis(direction, basis);
+                    for (uint32_t i = 0; i < 9; i++)
+                        sums[i] += L * basis[i];
+                }
+            });
+
+            IrradianceSH sh;
+            for (const auto& sums : rowSums)
+            {
+                for (uint32_t i = 0; i < 9; i++)
+                    sh.Coefficients[i] += glm::vec4(sums[i] * SHBandScale[i], 0.0f);
+            }
+            return sh;
+        }
+
+        // Port of PreethamSky.glsl.frag, see there for the references.
+        static glm::vec3 PreethamSkyRadiance(const glm::vec3& sunDirection, const glm::vec3& viewDirection, const float t)
+        {
+            const glm::vec3 A(0.1787f * t - 1.4630f, -0.0193f * t - 0.2592f, -0.0167f * t - 0.2608f);
+            const glm::vec3 B(-0.3554f * t + 0.4275f, -0.0665f * t + 0.0008f, -0.0950f * t + 0.0092f);
+            const glm::vec3 C(-0.0227f * t + 5.3251f, -0.0004f * t + 0.2125f, -0.0079f * t + 0.2102f);
+            const glm::vec3 D(0.1206f * t - 2.5771f, -0.0641f * t - 0.8989f, -0.0441f * t - 1.6537f);
+            const glm::vec3 E(-0.0670f * t + 0.3703f, -0.0033f * t + 0.0452f, -0.0109f * t + 0.0529f);
+
+            auto perez = [&](const float theta, const float gamma) {
+                return (1.0f + A * glm::exp(B / std::cos(theta))) * (1.0f + C * glm::exp(D * gamma) + E * std::cos(gamma) * std::cos(gamma));
+            };
+
+            const float thetaS = std::acos(glm::max(sunDirection.y, 0.0f));
+            // The model diverges at the horizon, directions below it get the value just above.
+            const float thetaE = std::acos(glm::max(viewDirection.y, 0.001f));
+            const float gammaE = std::acos(glm::clamp(glm::dot(sunDirection, viewDirection), 0.0f, 1.0f));
+
+            const float chi = (4.0f / 9.0f - t / 120.0f) * (glm::pi<float>() - 2.0f * thetaS);
+            const float Yz = (4.0453f * t - 4.9710f) * std::tan(chi) - 0.2155f * t + 2.4192f;
+
+            const float theta2 = thetaS * thetaS;
+            const float theta3 = theta2 * thetaS;
+            const float T2 = t * t;
+            const float xz =
+                ( 0.00165f * theta3 - 0.00375f * theta2 + 0.00209f * thetaS + 0.0f)     * T2 +
+                (-0.02903f * theta3 + 0.06377f * theta2 - 0.03202f * thetaS + 0.00394f) * t +
+                ( 0.11693f * theta3 - 0.21196f * theta2 + 0.06052f * thetaS + 0.25886f);
+            const float yz =
+                ( 0.00275f * theta3 - 0.00610f * theta2 + 0.00317f * thetaS + 0.0f)     * T2 +
+                (-0.04214f * theta3 + 0.08970f * theta2 - 0.04153f * thetaS + 0.00516f) * t +
+                ( 0.15346f * theta3 - 0.26756f * theta2 + 0.06670f * thetaS + 0.26688f);
+
+            const glm::vec3 Yp = glm::vec3(Yz, xz, yz) * (perez(thetaE, gammaE) / perez(0.0f, thetaS));
+
+            const glm::vec3 XYZ(Yp.y * (Yp.x / Yp.z), Yp.x, (1.0f - Yp.y - Yp.z) * (Yp.x / Yp.z));
+            const glm::mat3 M(
+                 2.3706743f, -0.9000405f, -0.4706338f,
+                -0.5138850f,  1.4253036f,  0.0885814f,
+                 0.0052982f, -0.0146949f,  1.0093968f);
+
+            return XYZ * M;
+        }
+    }
+
+    IrradianceSH SphericalHarmonics::ProjectEquirectangular(const void* pixels, const uint32_t width, const uint32_t height, const ImageFormat format)
+    {
+        if (!pixels || width == 0 || height == 0)
+            return {};
+
+        if (Image::IsHDRFormat(format))
+        {
+            return Utils::ProjectGrid(width, height, [pixels, width, format](const uint32_t x, const uint32_t y, const glm::vec3&) {
+                return glm::vec3(ImageConverter::ReadPixel(pixels, (uint64_t)y * width + x, format));
+            });
+        }
+
+        const auto* texels = static_cast<const uint8_t*>(pixels);
+        return Utils::ProjectGrid(width, height, [texels, width](const uint32_t x, const uint32_t y, const glm::vec3&) {
+            const uint8_t* texel = texels + ((size_t)y * width + x) * 4;
+            return glm::vec3(texel[0], texel[1], texel[2]) / 255.0f;
+        });
+    }
+
+    IrradianceSH SphericalHarmonics::ProjectPreethamSky(const float turbidity, const float azimuth, const float inclination, const uint32_t resolution)
+    {
+        const glm::vec3 sunDirection = glm::normalize(glm::vec3(
+            std::sin(inclination) * std::cos(azimuth), std::cos(inclination), std::sin(inclination) * std::sin(azimuth)));
+
+        return Utils::ProjectGrid(resolution, std::max(resolution / 2, 1u), [&](const uint32_t, const uint32_t, const glm::vec3& direction) {
+            return Utils::PreethamSkyRadiance(sunDirection, direction, turbidity) * 0.05f;
+        });
+    }
+
+    glm::vec3 SphericalHarmonics::Evaluate(const IrradianceSH& sh, const glm::vec3& direction)
+    {
+        float basis[9];
+        Utils::EvaluateSHBasis(direction, basis);
+
+        glm::vec3 irradiance(0.0f);
+        for (uint32_t i = 0; i < 9; i++)
+            irradiance += glm::vec3(sh.Coefficients[i]) * basis[i];
+        return glm::max(irradiance, glm::vec3(0.0f));
+    }
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "czpch.h"
+
+#include "Image.h"
+
+#include <glm/glm.hpp>
+
+namespace Chozo {
+
+    // Diffuse irradiance of an environment in 9 spherical harmonics coefficients (bands 0 to 2).
+    // The clamped cosine lobe and the Lambert 1/PI are folded in, evaluating gives what the irradiance
+    // cubemap used to store. vec4 so the coefficients can be copied into a std140 block as they are.
+    struct IrradianceSH
+    {
+        glm::vec4 Coefficients[9] = {};
+    };
+
+    class SphericalHarmonics
+    {
+    public:
+        // Rows are split over worker threads. Pixels are in one of the HDR formats (see Image::IsHDRFormat)
+        // or 8-bit RGBA, laid out like the textures the cubemap sampler reads.
+        static IrradianceSH ProjectEquirectangular(const void* pixels, uint32_t width, uint32_t height, ImageFormat format);
+        // Same sky model and scale as PreethamSky.glsl.frag, evaluated on a resolution x resolution / 2 grid.
+        static IrradianceSH ProjectPreethamSky(float turbidity, float azimuth, float inclination, uint32_t resolution = 64);
+
+        static glm::vec3 Evaluate(const IrradianceSH& sh, const glm::vec3& direction);
+    };
+}
@@ -0,0 +1,19 @@
+#include "StorageBuffer.h"
+
+#include "RenderCommand.h"
+#include "Chozo/Renderer/Backend/OpenGL/OpenGLStorageBuffer.h"
+
+namespace Chozo {
+
+    Ref<StorageBuffer> StorageBuffer::Create(uint32_t size)
+    {
+        switch (RenderCommand::GetType())
+        {
+            case RenderAPI::Type::None:     CZ_CORE_ASSERT(false, "RenderAPI::None is currently not supported!"); return nullptr;
+            case RenderAPI::Type::OpenGL:   return Ref<OpenGLStorageBuffer>::Create(size);
+        }
+
+        CZ_CORE_ASSERT(false, "Unknown RenderAPI!");
+        return nullptr;
+    }
+}
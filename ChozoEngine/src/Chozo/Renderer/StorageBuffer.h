@@ -0,0 +1,20 @@
+#pragma once
+
+#include "czpch.h"
+
+namespace Chozo {
+
+    // Array of 32-bit unsigned words that shaders read with texelFetch from a usamplerBuffer.
+    class StorageBuffer : public RefCounted
+    {
+    public:
+        virtual ~StorageBuffer() {}
+        virtual void SetData(const void* data, uint32_t size, uint32_t offset = 0) = 0;
+        // Reallocates the storage, previous contents are discarded.
+        virtual void Resize(uint32_t size) = 0;
+
+        virtual uint32_t GetSize() const = 0;
+
+        static Ref<StorageBuffer> Create(uint32_t size);
+    };
+}
@@ -16,11 +16,41 @@ namespace Chozo {
         TextureCube
     };
 
+    // What the pixels of an imported texture hold, picks the block compression it is stored in.
+    // None keeps the texture uncompressed (render targets, UI icons, lookup tables).
+    enum class TextureUsage : uint8_t
+    {
+        None = 0,
+        Color,
+        Normal, // Tangent space, only x and y are kept and z is rebuilt when sampling
+        Data    // Masks like metallic, roughness or occlusion
+    };
+
+    enum class TextureCompressionQuality : uint8_t
+    {
+        None = 0,
+        Fast, // BC1/BC3 for color and data, BC5 for normal maps
+        High  // BC7 where the driver supports it, with endpoint refinement
+    };
+
+    // Downsampling filter of the mip chains built at import.
+    enum class MipFilter : uint8_t
+    {
+        None = 0, // Level 0 only
+        Box,
+        Kaiser    // Kaiser windowed sinc, sharper than the box, 6x its taps per axis
+    };
+
     struct Texture2DSpecification
     {
 		ImageFormat Format = ImageFormat::RGBA;
 
         bool FlipY = true;
+        TextureUsage Usage = TextureUsage::None;
+        // Levels of the chain, the pixel buffer holds them from ResidentMip on, each followed by the next smaller one.
+        uint32_t MipLevels = 1;
+        // First level held by the pixel buffer and the GPU, the larger ones are streamed in by the TextureStreamer.
+        uint32_t ResidentMip = 0;
 
         uint32_t Samples = 1;
         uint32_t Width = 1, Height = 1;
@@ -77,6 +107,13 @@ namespace Chozo {
 		virtual void SetData(const void* data, uint32_t size) = 0;
         virtual void Resize(uint32_t width, uint32_t height) = 0;
 
+        virtual uint32_t GetResidentMip() const = 0;
+        // levels holds mip up to the resident mip, laid out like the chain. They are put in front of the
+        // pixel buffer right away, the upload is submitted to the render thread.
+        virtual void StreamIn(uint32_t mip, const Buffer& levels) = 0;
+        // Drops the levels larger than mip from the pixel buffer and the GPU.
+        virtual void Evict(uint32_t mip) = 0;
+
         static Ref<Texture2D> Create(const Texture2DSpecification& spec = Texture2DSpecification());
         static Ref<Texture2D> Create(Ref<Texture2D> other);
         static Ref<Texture2D> Create(const std::string& path, const Texture2DSpecification& spec = Texture2DSpecification());
@@ -93,6 +130,13 @@ namespace Chozo {
 
         virtual void SetData(void* data, uint32_t size) = 0;
 
+        // Mip levels in the chain, all of them when the spec asks for mipmaps.
+        virtual uint32_t GetMipLevelCount() const = 0;
+        // Bytes of every face of every level, ordered by level then face. ExtractBuffer reads back this
+        // layout and SetMipChainData takes it.
+        virtual uint64_t GetMipChainSize() const = 0;
+        virtual void SetMipChainData(const void* data, uint64_t size) = 0;
+
         static Ref<TextureCube> Create(const TextureCubeSpecification& spec = TextureCubeSpecification());
     private:
         static TextureType s_Type;
@@ -0,0 +1,672 @@
+#include "TextureCompressor.h"
+
+#include "Renderer.h"
+
+#include "Chozo/Core/Pool.h"
+
+#include <glm/glm.hpp>
+
+#include <cfloat>
+#include <climits>
+#include <cmath>
+
+namespace Chozo {
+
+    namespace Utils {
+
+        // 4x4 RGBA pixels, row major.
+        struct ColorBlock
+        {
+            uint8_t Pixels[16][4];
+        };
+
+        static void FetchBlock(const uint8_t* pixels, const uint32_t width, const uint32_t height, const uint32_t blockX, const uint32_t blockY, ColorBlock& block)
+        {
+            for (uint32_t y = 0; y < 4; y++)
+            {
+                const uint32_t py = std::min(blockY * 4 + y, height - 1);
+                for (uint32_t x = 0; x < 4; x++)
+                {
+                    const uint32_t px = std::min(blockX * 4 + x, width - 1);
+                    memcpy(block.Pixels[y * 4 + x], pixels + ((uint64_t)py * width + px) * 4, 4);
+                }
+            }
+        }
+
+        static void StoreBlock(const ColorBlock& block, const uint32_t width, const uint32_t height, const uint32_t blockX, const uint32_t blockY, uint8_t* pixels)
+        {
+            for (uint32_t y = 0; y < 4 && blockY * 4 + y < height; y++)
+            {
+                for (uint32_t x = 0; x < 4 && blockX * 4 + x < width; x++)
+                    memcpy(pixels + ((uint64_t)(blockY * 4 + y) * width + blockX * 4 + x) * 4, block.Pixels[y * 4 + x], 4);
+            }
+        }
+
+        static glm::vec4 GetPixel(const ColorBlock& block, const uint32_t index)
+        {
+            const uint8_t* p = block.Pixels[index];
+            return glm::vec4(p[0], p[1], p[2], p[3]);
+        }
+
+        static float GetError(const glm::vec4& a, const glm::vec4& b, const bool withAlpha)
+        {
+            glm::vec4 d = a - b;
+            if (!withAlpha)
+                d.w = 0.0f;
+            return glm::dot(d, d);
+        }
+
+        // Endpoints at the extremes of the block along its principal axis, found by power iteration
+        // on the covariance. Alpha is left out of the fit for the opaque formats.
+        static void FitEndpoints(const ColorBlock& block, const bool withAlpha, glm::vec4& low, glm::vec4& high)
+        {
+            glm::vec4 mean(0.0f);
+            for (uint32_t i = 0; i < 16; i++)
+                mean += GetPixel(block, i);
+            mean /= 16.0f;
+
+            glm::mat4 covariance(0.0f);
+            for (uint32_t i = 0; i < 16; i++)
+            {
+                glm::vec4 d = GetPixel(block, i) - mean;
+                if (!withAlpha)
+                    d.w = 0.0f;
+                covariance += glm::outerProduct(d, d);
+            }
+
+            // Start from the channel with the largest spread, (1, 1, 1) misses blocks varying in hue only.
+            uint32_t widest = 0;
+            for (uint32_t c = 1; c < 4; c++)
+            {
+                if (covariance[c][c] > covariance[widest][widest])
+                    widest = c;
+            }
+
+            glm::vec4 axis = covariance[widest];
+            for (uint32_t i = 0; i < 8; i++)
+            {
+                const float length = glm::length(axis);
+                if (length < 1e-4f)
+                {
+                    low = high = mean;
+                    return;
+                }
+                axis = covariance * (axis / length);
+            }
+            axis = glm::normalize(axis);
+
+            float minT = FLT_MAX, maxT = -FLT_MAX;
+            for (uint32_t i = 0; i < 16; i++)
+            {
+                const float t = glm::dot(GetPixel(block, i) - mean, axis);
+                minT = std::min(minT, t);
+                maxT = std::max(maxT, t);
+            }
+
+            low = glm::clamp(mean + axis * minT, 0.0f, 255.0f);
+            high = glm::clamp(mean + axis * maxT, 0.0f, 255.0f);
+        }
+
+        // Least squares endpoints for the interpolation weights the indices picked (0 is low, 1 is high).
+        static bool RefineEndpoints(const ColorBlock& block, const float weights[16], glm::vec4& low, glm::vec4& high)
+        {
+            float a = 0.0f, b = 0.0f, c = 0.0f;
+            glm::vec4 x0(0.0f), x1(0.0f);
+            for (uint32_t i = 0; i < 16; i++)
+            {
+                const float w = weights[i];
+                const glm::vec4 p = GetPixel(block, i);
+                a += (1.0f - w) * (1.0f - w);
+                b += (1.0f - w) * w;
+                c += w * w;
+                x0 += (1.0f - w) * p;
+                x1 += w * p;
+            }
+
+            const float determinant = a * c - b * b;
+            if (std::abs(determinant) < 1e-6f)
+                return false;
+
+            low = glm::clamp((c * x0 - b * x1) / determinant, 0.0f, 255.0f);
+            high = glm::clamp((a * x1 - b * x0) / determinant, 0.0f, 255.0f);
+            return true;
+        }
+
+        static void WriteLE(uint8_t* out, const uint64_t value, const uint32_t byteCount)
+        {
+            for (uint32_t i = 0; i < byteCount; i++)
+                out[i] = (uint8_t)(value >> (8 * i));
+        }
+
+        static uint64_t ReadLE(const uint8_t* in, const uint32_t byteCount)
+        {
+            uint64_t value = 0;
+            for (uint32_t i = 0; i < byteCount; i++)
+                value |= (uint64_t)in[i] << (8 * i);
+            return value;
+        }
+
+        //==============================================================================
+        // BC1, color part of BC3
+
+        static uint16_t PackRGB565(const glm::vec4& color)
+        {
+            const auto r = (uint16_t)std::lround(glm::clamp(color.r, 0.0f, 255.0f) * 31.0f / 255.0f);
+            const auto g = (uint16_t)std::lround(glm::clamp(color.g, 0.0f, 255.0f) * 63.0f / 255.0f);
+            const auto b = (uint16_t)std::lround(glm::clamp(color.b, 0.0f, 255.0f) * 31.0f / 255.0f);
+            return (uint16_t)((r << 11) | (g << 5) | b);
+        }
+
+        static glm::vec4 UnpackRGB565(const uint16_t value)
+        {
+            const uint32_t r = (value >> 11) & 31, g = (value >> 5) & 63, b = value & 31;
+            return { (float)((r << 3) | (r >> 2)), (float)((g << 2) | (g >> 4)), (float)((b << 3) | (b >> 2)), 255.0f };
+        }
+
+        // Fractions of the way from color0 to color1 of each index in four color mode.
+        static constexpr float BC1Weights[4] = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+
+        static void GetBC1Palette(const uint16_t color0, const uint16_t color1, const bool fourColor, glm::vec4 palette[4])
+        {
+            palette[0] = UnpackRGB565(color0);
+            palette[1] = UnpackRGB565(color1);
+            if (fourColor)
+            {
+                palette[2] = glm::floor((2.0f * palette[0] + palette[1]) / 3.0f);
+                palette[3] = glm::floor((palette[0] + 2.0f * palette[1]) / 3.0f);
+            }
+            else
+            {
+                palette[2] = glm::floor((palette[0] + palette[1]) * 0.5f);
+                palette[3] = glm::vec4(0.0f);
+            }
+        }
+
+        // color0 > color1 selects four color mode, equal endpoints only ever use index 0.
+        static float FitBC1Indices(const ColorBlock& block, const uint16_t color0, const uint16_t color1, uint32_t& indices)
+        {
+            glm::vec4 palette[4];
+            GetBC1Palette(color0, color1, true, palette);
+            const uint32_t paletteSize = color0 == color1 ? 1 : 4;
+
+            indices = 0;
+            float error = 0.0f;
+            for (uint32_t i = 0; i < 16; i++)
+            {
+                const glm::vec4 pixel = GetPixel(block, i);
+                uint32_t best = 0;
+                float bestError = FLT_MAX;
+                for (uint32_t p = 0; p < paletteSize; p++)
+                {
+                    const float e = GetError(pixel, palette[p], false);
+                    if (e < bestError)
+                    {
+                        bestError = e;
+                        best = p;
+                    }
+                }
+                indices |= best << (2 * i);
+                error += bestError;
+            }
+            return error;
+        }
+
+        static void EncodeBC1(const ColorBlock& block, const bool refine, uint8_t* out)
+        {
+            glm::vec4 low, high;
+            FitEndpoints(block, false, low, high);
+
+            uint16_t color0 = PackRGB565(high), color1 = PackRGB565(low);
+            if (color0 < color1)
+                std::swap(color0, color1);
+
+            uint32_t indices;
+            float error = FitBC1Indices(block, color0, color1, indices);
+
+            if (refine && color0 != color1)
+            {
+                float weights[16];
+                for (uint32_t i = 0; i < 16; i++)
+                    weights[i] = BC1Weights[(indices >> (2 * i)) & 3];
+
+                glm::vec4 end0, end1;
+                if (RefineEndpoints(block, weights, end0, end1))
+                {
+                    uint16_t refined0 = PackRGB565(end0), refined1 = PackRGB565(end1);
+                    if (refined0 < refined1)
+                        std::swap(refined0, refined1);
+
+                    uint32_t refinedIndices;
+                    if (refined0 != refined1 && FitBC1Indices(block, refined0, refined1, refinedIndices) < error)
+                    {
+                        color0 = refined0;
+                        color1 = refined1;
+                        indices = refinedIndices;
+                    }
+                }
+            }
+
+            WriteLE(out, color0, 2);
+            WriteLE(out + 2, color1, 2);
+            WriteLE(out + 4, indices, 4);
+        }
+
+        static void DecodeBC1(const uint8_t* in, const bool forceFourColor, ColorBlock& block)
+        {
+            const auto color0 = (uint16_t)ReadLE(in, 2);
+            const auto color1 = (uint16_t)ReadLE(in + 2, 2);
+            const auto indices = (uint32_t)ReadLE(in + 4, 4);
+
+            glm::vec4 palette[4];
+            GetBC1Palette(color0, color1, forceFourColor || color0 > color1, palette);
+            for (uint32_t i = 0; i < 16; i++)
+            {
+                const glm::vec4& color = palette[(indices >> (2 * i)) & 3];
+                for (uint32_t c = 0; c < 4; c++)
+                    block.Pixels[i][c] = (uint8_t)color[c];
+            }
+        }
+
+        //==============================================================================
+        // BC4, alpha of BC3 and both channels of BC5
+
+        static void GetBC4Palette(const uint8_t value0, const uint8_t value1, uint8_t palette[8])
+        {
+            palette[0] = value0;
+            palette[1] = value1;
+            if (value0 > value1)
+            {
+                for (uint32_t i = 2; i < 8; i++)
+                    palette[i] = (uint8_t)(((8 - i) * value0 + (i - 1) * value1 + 3) / 7);
+            }
+            else
+            {
+                for (uint32_t i = 2; i < 6; i++)
+                    palette[i] = (uint8_t)(((6 - i) * value0 + (i - 1) * value1 + 2) / 5);
+                palette[6] = 0;
+                palette[7] = 255;
+            }
+        }
+
+        // Always in eight value mode, the range of the block is interpolated evenly.
+        static void EncodeBC4(const uint8_t values[16], uint8_t* out)
+        {
+            uint8_t low = 255, high = 0;
+            for (uint32_t i = 0; i < 16; i++)
+            {
+                low = std::min(low, values[i]);
+                high = std::max(high, values[i]);
+            }
+
+            uint8_t palette[8];
+            GetBC4Palette(high, low, palette);
+            const uint32_t paletteSize = high == low ? 1 : 8;
+
+            uint64_t indices = 0;
+            for (uint32_t i = 0; i < 16; i++)
+            {
+                uint32_t best = 0;
+                int bestError = INT_MAX;
+                for (uint32_t p = 0; p < paletteSize; p++)
+                {
+                    const int e = std::abs((int)values[i] - (int)palette[p]);
+                    if (e < bestError)
+                    {
+                        bestError = e;
+                        best = p;
+                    }
+                }
+                indices |= (uint64_t)best << (3 * i);
+            }
+
+            out[0] = high;
+            out[1] = low;
+            WriteLE(out + 2, indices, 6);
+        }
+
+        static void DecodeBC4(const uint8_t* in, uint8_t values[16])
+        {
+            uint8_t palette[8];
+            GetBC4Palette(in[0], in[1], palette);
+
+            const uint64_t indices = ReadLE(in + 2, 6);
+            for (uint32_t i = 0; i < 16; i++)
+                values[i] = palette[(indices >> (3 * i)) & 7];
+        }
+
+        static void EncodeBC4Channel(const ColorBlock& block, const uint32_t channel, uint8_t* out)
+        {
+            uint8_t values[16];
+            for (uint32_t i = 0; i < 16; i++)
+                values[i] = block.Pixels[i][channel];
+            EncodeBC4(values, out);
+        }
+
+        //==============================================================================
+        // BC7 mode 6
+
+        static constexpr uint32_t BC7Weights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+        // Bits are filled from the least significant bit of the first byte.
+        struct BlockBits
+        {
+            uint8_t* Data;
+            uint32_t Position = 0;
+
+            void Write(const uint32_t value, const uint32_t count)
+            {
+                for (uint32_t i = 0; i < count; i++, Position++)
+                {
+                    if ((value >> i) & 1)
+                        Data[Position / 8] |= (uint8_t)(1 << (Position % 8));
+                }
+            }
+
+            uint32_t Read(const uint32_t count)
+            {
+                uint32_t value = 0;
+                for (uint32_t i = 0; i < count; i++, Position++)
+                    value |= (uint32_t)((Data[Position / 8] >> (Position % 8)) & 1) << i;
+                return value;
+            }
+        };
+
+        struct BC7Endpoint
+        {
+            glm::uvec4 Value; // 7 bits per channel
+            uint32_t PBit;
+
+            glm::uvec4 Expand() const { return Value * 2u + PBit; }
+        };
+
+        // Tries both shared low bits and keeps the one landing closer.
+        static BC7Endpoint QuantizeBC7Endpoint(const glm::vec4& color)
+        {
+            BC7Endpoint best{};
+            float bestError = FLT_MAX;
+            for (uint32_t p = 0; p < 2; p++)
+            {
+                BC7Endpoint endpoint;
+                endpoint.PBit = p;
+                endpoint.Value = glm::uvec4(glm::clamp(glm::round((color - (float)p) * 0.5f), 0.0f, 127.0f));
+
+                const float error = GetError(glm::vec4(endpoint.Expand()), color, true);
+                if (error < bestError)
+                {
+                    bestError = error;
+                    best = endpoint;
+                }
+            }
+            return best;
+        }
+
+        static void GetBC7Palette(const BC7Endpoint& end0, const BC7Endpoint& end1, glm::vec4 palette[16])
+        {
+            const glm::uvec4 e0 = end0.Expand(), e1 = end1.Expand();
+            for (uint32_t i = 0; i < 16; i++)
+                palette[i] = glm::vec4((e0 * (64u - BC7Weights[i]) + e1 * BC7Weights[i] + 32u) / 64u);
+        }
+
+        static float FitBC7Indices(const ColorBlock& block, const BC7Endpoint& end0, const BC7Endpoint& end1, uint32_t indices[16])
+        {
+            glm::vec4 palette[16];
+            GetBC7Palette(end0, end1, palette);
+
+            float error = 0.0f;
+            for (uint32_t i = 0; i < 16; i++)
+            {
+                const glm::vec4 pixel = GetPixel(block, i);
+                float bestError = FLT_MAX;
+                for (uint32_t p = 0; p < 16; p++)
+                {
+                    const float e = GetError(pixel, palette[p], true);
+                    if (e < bestError)
+                    {
+                        bestError = e;
+                        indices[i] = p;
+                    }
+                }
+                error += bestError;
+            }
+            return error;
+        }
+
+        static void EncodeBC7(const ColorBlock& block, const bool refine, uint8_t* out)
+        {
+            glm::vec4 low, high;
+            FitEndpoints(block, true, low, high);
+
+            BC7Endpoint end0 = QuantizeBC7Endpoint(low), end1 = QuantizeBC7Endpoint(high);
+            uint32_t indices[16];
+            float error = FitBC7Indices(block, end0, end1, indices);
+
+            // Each pass fits the endpoints to the indices of the last one, kept while the error drops.
+            for (uint32_t pass = 0; refine && pass < 2; pass++)
+            {
+                float weights[16];
+                for (uint32_t i = 0; i < 16; i++)
+                    weights[i] = (float)BC7Weights[indices[i]] / 64.0f;
+
+                if (!RefineEndpoints(block, weights, low, high))
+                    break;
+
+                const BC7Endpoint refined0 = QuantizeBC7Endpoint(low), refined1 = QuantizeBC7Endpoint(high);
+                uint32_t refinedIndices[16];
+                const float refinedError = FitBC7Indices(block, refined0, refined1, refinedIndices);
+                if (refinedError >= error)
+                    break;
+
+                end0 = refined0;
+                end1 = refined1;
+                error = refinedError;
+                std::copy(std::begin(refinedIndices), std::end(refinedIndices), std::begin(indices));
+            }
+
+            // The first index is stored without its top bit, the endpoints swap to keep it clear.
+            if (indices[0] & 8)
+            {
+                std::swap(end0, end1);
+                for (uint32_t& index : indices)
+                    index = 15 - index;
+            }
+
+            memset(out, 0, 16);
+            BlockBits bits{ out };
+            bits.Write(1 << 6, 7);
+            for (uint32_t c = 0; c < 4; c++)
+            {
+                bits.Write(end0.Value[c], 7);
+                bits.Write(end1.Value[c], 7);
+            }
+            bits.Write(end0.PBit, 1);
+            bits.Write(end1.PBit, 1);
+            for (uint32_t i = 0; i < 16; i++)
+                bits.Write(indices[i], i == 0 ? 3 : 4);
+        }
+
+        static void DecodeBC7(const uint8_t* in, ColorBlock& block)
+        {
+            // Only mode 6 is ever written, anything else shows up magenta.
+            if ((in[0] & 0x7F) != 0x40)
+            {
+                for (auto& pixel : block.Pixels)
+                {
+                    pixel[0] = 255; pixel[1] = 0; pixel[2] = 255; pixel[3] = 255;
+                }
+                return;
+            }
+
+            uint8_t data[16];
+            memcpy(data, in, 16);
+            BlockBits bits{ data, 7 };
+
+            BC7Endpoint end0{}, end1{};
+            for (uint32_t c = 0; c < 4; c++)
+            {
+                end0.Value[c] = bits.Read(7);
+                end1.Value[c] = bits.Read(7);
+            }
+            end0.PBit = bits.Read(1);
+            end1.PBit = bits.Read(1);
+
+            glm::vec4 palette[16];
+            GetBC7Palette(end0, end1, palette);
+            for (uint32_t i = 0; i < 16; i++)
+            {
+                const glm::vec4& color = palette[bits.Read(i == 0 ? 3 : 4)];
+                for (uint32_t c = 0; c < 4; c++)
+                    block.Pixels[i][c] = (uint8_t)color[c];
+            }
+        }
+
+        static bool HasTranslucentPixels(const uint8_t* pixels, const uint64_t pixelCount)
+        {
+            for (uint64_t i = 0; i < pixelCount; i++)
+            {
+                if (pixels[i * 4 + 3] != 255)
+                    return true;
+            }
+            return false;
+        }
+    }
+
+    ImageFormat TextureCompressor::SelectFormat(const TextureUsage usage, const uint8_t* pixels, const uint32_t width, const uint32_t height, const TextureCompressionQuality quality)
+    {
+        if (usage == TextureUsage::None || quality == TextureCompressionQuality::None || !pixels)
+            return ImageFormat::None;
+
+        if (usage == TextureUsage::Normal)
+            return Renderer::IsCompressedFormatSupported(ImageFormat::BC5) ? ImageFormat::BC5 : ImageFormat::None;
+
+        if (quality == TextureCompressionQuality::High && Renderer::IsCompressedFormatSupported(ImageFormat::BC7))
+            return ImageFormat::BC7;
+
+        // BC1 and BC3 come with the same extension.
+        if (!Renderer::IsCompressedFormatSupported(ImageFormat::BC1))
+            return ImageFormat::None;
+
+        if (usage == TextureUsage::Color && Utils::HasTranslucentPixels(pixels, (uint64_t)width * height))
+            return ImageFormat::BC3;
+
+        return ImageFormat::BC1;
+    }
+
+    Buffer TextureCompressor::Compress(const uint8_t* pixels, const uint32_t width, const uint32_t height, const ImageFormat format, const TextureCompressionQuality quality)
+    {
+        CZ_CORE_ASSERT(Image::IsCompressedFormat(format), "Not a block compressed format!");
+
+        const uint32_t blocksX = (width + 3) / 4, blocksY = (height + 3) / 4;
+        const uint32_t blockSize = Image::GetBlockSize(format);
+        const bool refine = quality == TextureCompressionQuality::High;
+
+        Buffer blocks;
+        blocks.Allocate(Image::GetImageSize(format, width, height));
+        auto* data = static_cast<uint8_t*>(blocks.Data);
+
+        Pool::ParallelFor(blocksY, [&](const uint32_t blockY) {
+            Utils::ColorBlock block;
+            for (uint32_t blockX = 0; blockX < blocksX; blockX++)
+            {
+                Utils::FetchBlock(pixels, width, height, blockX, blockY, block);
+                uint8_t* out = data + ((uint64_t)blockY * blocksX + blockX) * blockSize;
+                switch (format)
+                {
+                    case ImageFormat::BC1:
+                        Utils::EncodeBC1(block, refine, out);
+                        break;
+                    case ImageFormat::BC3:
+                        Utils::EncodeBC4Channel(block, 3, out);
+                        Utils::EncodeBC1(block, refine, out + 8);
+                        break;
+                    case ImageFormat::BC5:
+                        Utils::EncodeBC4Channel(block, 0, out);
+                        Utils::EncodeBC4Channel(block, 1, out + 8);
+                        break;
+                    case ImageFormat::BC7:
+                        Utils::EncodeBC7(block, refine, out);
+                        break;
+                    default:
+                        break;
+                }
+            }
+        });
+
+        return blocks;
+    }
+
+    Buffer TextureCompressor::Decompress(const void* blocks, const uint32_t width, const uint32_t height, const ImageFormat format)
+    {
+        CZ_CORE_ASSERT(Image::IsCompressedFormat(format), "Not a block compressed format!");
+
+        const uint32_t blocksX = (width + 3) / 4, blocksY = (height + 3) / 4;
+        const uint32_t blockSize = Image::GetBlockSize(format);
+        const auto* data = static_cast<const uint8_t*>(blocks);
+
+        Buffer pixels;
+        pixels.Allocate((uint64_t)width * height * 4);
+        auto* out = static_cast<uint8_t*>(pixels.Data);
+
+        Pool::ParallelFor(blocksY, [&](const uint32_t blockY) {
+            Utils::ColorBlock block;
+            uint8_t red[16], green[16];
+            for (uint32_t blockX = 0; blockX < blocksX; blockX++)
+            {
+                const uint8_t* in = data + ((uint64_t)blockY * blocksX + blockX) * blockSize;
+                switch (format)
+                {
+                    case ImageFormat::BC1:
+                        Utils::DecodeBC1(in, false, block);
+                        break;
+                    case ImageFormat::BC3:
+                        // The color block of BC3 always interpolates four colors.
+                        Utils::DecodeBC1(in + 8, true, block);
+                        Utils::DecodeBC4(in, red);
+                        for (uint32_t i = 0; i < 16; i++)
+                            block.Pixels[i][3] = red[i];
+                        break;
+                    case ImageFormat::BC5:
+                        Utils::DecodeBC4(in, red);
+                        Utils::DecodeBC4(in + 8, green);
+                        for (uint32_t i = 0; i < 16; i++)
+                        {
+                            // Same reconstruction as the geometry pass.
+                            const glm::vec2 xy = glm::vec2(red[i], green[i]) / 255.0f * 2.0f - 1.0f;
+                            const float z = std::sqrt(std::max(1.0f - glm::dot(xy, xy), 0.0f));
+                            block.Pixels[i][0] = red[i];
+                            block.Pixels[i][1] = green[i];
+                            block.Pixels[i][2] = (uint8_t)std::lround((z * 0.5f + 0.5f) * 255.0f);
+                            block.Pixels[i][3] = 255;
+                        }
+                        break;
+                    case ImageFormat::BC7:
+                        Utils::DecodeBC7(in, block);
+                        break;
+                    default:
+                        break;
+                }
+                Utils::StoreBlock(block, width, height, blockX, blockY, out);
+            }
+        });
+
+        return pixels;
+    }
+
+    float TextureCompressor::ComputePSNR(const uint8_t* reference, const uint8_t* pixels, const uint64_t pixelCount, const uint32_t channelCount)
+    {
+        double squaredError = 0.0;
+        for (uint64_t i = 0; i < pixelCount; i++)
+        {
+            for (uint32_t c = 0; c < channelCount; c++)
+            {
+                const double d = (double)reference[i * 4 + c] - (double)pixels[i * 4 + c];
+                squaredError += d * d;
+            }
+        }
+
+        const double mse = squaredError / (double)(pixelCount * channelCount);
+        if (mse <= 0.0)
+            return std::numeric_limits<float>::infinity();
+
+        return (float)(10.0 * std::log10(255.0 * 255.0 / mse));
+    }
+}
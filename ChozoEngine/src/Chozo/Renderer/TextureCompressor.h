@@ -0,0 +1,29 @@
+#pragma once
+
+#include "czpch.h"
+
+#include "Chozo/Core/Buffer.h"
+#include "Texture.h"
+
+namespace Chozo {
+
+    // CPU block compression of 8-bit RGBA pixels into the BC formats, and decoding back for previews.
+    // BC1 and BC3 fit the color endpoints along the principal axis of each block, BC5 stores two
+    // BC4 channels. BC7 only encodes mode 6 (one subset, 7-bit RGBA endpoints, 4-bit indices),
+    // which covers most blocks of photographic and painted textures at a fraction of the search.
+    class TextureCompressor
+    {
+    public:
+        // Format the pixels of a texture with the given usage are stored in, None when it stays RGBA.
+        static ImageFormat SelectFormat(TextureUsage usage, const uint8_t* pixels, uint32_t width, uint32_t height, TextureCompressionQuality quality);
+
+        // Rows of blocks are split over worker threads. Edge blocks of sizes that are not a multiple of
+        // four repeat the last row and column.
+        static Buffer Compress(const uint8_t* pixels, uint32_t width, uint32_t height, ImageFormat format, TextureCompressionQuality quality);
+        // Back to 8-bit RGBA, BC5 gets the normal z rebuilt into blue.
+        static Buffer Decompress(const void* blocks, uint32_t width, uint32_t height, ImageFormat format);
+
+        // Peak signal to noise ratio in dB over the first channelCount channels of two RGBA images.
+        static float ComputePSNR(const uint8_t* reference, const uint8_t* pixels, uint64_t pixelCount, uint32_t channelCount = 3);
+    };
+}
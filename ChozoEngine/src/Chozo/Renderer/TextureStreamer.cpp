@@ -0,0 +1,386 @@
+#include "TextureStreamer.h"
+
+#include "Renderer.h"
+
+#include "Chozo/Core/Pool.h"
+
+#include <cmath>
+#include <fstream>
+#include <future>
+#include <mutex>
+
+namespace Chozo {
+
+    namespace Utils {
+
+        // Reads in flight at once, each one covers the missing levels of a single texture.
+        static constexpr uint32_t MaxStreamingReads = 4;
+
+        static Buffer ReadLevels(const fs::path& filepath, const uint64_t offset, const uint64_t size)
+        {
+            Buffer levels;
+            std::ifstream stream(filepath, std::ios::binary);
+            if (!stream)
+                return levels;
+
+            levels.Allocate(size);
+            stream.seekg((std::streamoff)offset);
+            if (!stream.read(static_cast<char*>(levels.Data), (std::streamsize)size))
+                levels.Release();
+            return levels;
+        }
+    }
+
+    struct StreamedTexture
+    {
+        WeakRef<Texture2D> Texture;
+        fs::path FilePath;
+        uint64_t PixelOffset = 0;
+
+        ImageFormat Format = ImageFormat::RGBA;
+        uint32_t Width = 1, Height = 1;
+        uint32_t MipLevels = 1;
+        // Levels read at load, they are never evicted.
+        uint32_t MinResidentMip = 0;
+        uint32_t ResidentMip = 0;
+
+        uint32_t RequiredMip = 0;
+        float Priority = 0.0f;
+        uint64_t LastUsedFrame = 0;
+
+        // Read of the levels from PendingMip up to the resident mip, which stays put until it is streamed in.
+        std::future<Buffer> PendingRead;
+        uint32_t PendingMip = 0;
+
+        // Bytes of the levels [firstLevel, lastLevel).
+        uint64_t GetLevelsSize(const uint32_t firstLevel, const uint32_t lastLevel) const
+        {
+            return Image::GetMipChainSize(Format, Width, Height, lastLevel) - Image::GetMipChainSize(Format, Width, Height, firstLevel);
+        }
+    };
+
+    static std::unordered_map<const Texture2D*, StreamedTexture> s_StreamedTextures;
+    // Reads of textures destroyed while reading, kept so the destructor doesn't wait on the file.
+    static std::vector<std::future<Buffer>> s_AbandonedReads;
+    static std::mutex s_StreamingMutex;
+    static uint64_t s_StreamingFrame = 0;
+    static uint64_t s_StreamedSize = 0, s_EvictedSize = 0;
+
+    static void CompleteRead(StreamedTexture& entry, const Ref<Texture2D>& texture)
+    {
+        Buffer levels = entry.PendingRead.get();
+        if (!levels)
+        {
+            CZ_CORE_ERROR("Failed to stream mips {} to {} of texture from {}", entry.PendingMip, entry.ResidentMip - 1, entry.FilePath.string());
+            return;
+        }
+
+        texture->StreamIn(entry.PendingMip, levels);
+        entry.ResidentMip = entry.PendingMip;
+        s_StreamedSize += levels.Size;
+        levels.Release();
+    }
+
+    uint32_t TextureStreamer::GetInitialResidentMip(const Texture2DSpecification& spec)
+    {
+        const auto& config = Renderer::GetConfig();
+        if (!config.EnableTextureStreaming || spec.MipLevels <= 1)
+            return 0;
+
+        uint32_t mip = 0;
+        while (mip + 1 < spec.MipLevels && std::max(spec.Width >> mip, spec.Height >> mip) > config.StreamingMinResidentSize)
+            mip++;
+        return mip;
+    }
+
+    void TextureStreamer::Register(const Ref<Texture2D>& texture, const fs::path& filepath, const uint64_t pixelOffset)
+    {
+        const Texture2DSpecification spec = texture->GetSpecification();
+
+        std::lock_guard lock(s_StreamingMutex);
+        StreamedTexture& entry = s_StreamedTextures[texture.Raw()];
+        entry.Texture = texture;
+        entry.FilePath = filepath;
+        entry.PixelOffset = pixelOffset;
+        entry.Format = spec.Format;
+        entry.Width = spec.Width;
+        entry.Height = spec.Height;
+        entry.MipLevels = spec.MipLevels;
+        entry.MinResidentMip = spec.ResidentMip;
+        entry.ResidentMip = spec.ResidentMip;
+        entry.RequiredMip = spec.ResidentMip;
+        entry.LastUsedFrame = s_StreamingFrame;
+    }
+
+    void TextureStreamer::Unregister(const Texture2D* texture)
+    {
+        std::lock_guard lock(s_StreamingMutex);
+        const auto it = s_StreamedTextures.find(texture);
+        if (it == s_StreamedTextures.end())
+            return;
+
+        if (it->second.PendingRead.valid())
+            s_AbandonedReads.push_back(std::move(it->second.PendingRead));
+        s_StreamedTextures.erase(it);
+    }
+
+    void TextureStreamer::RequestMip(const Ref<Texture2D>& texture, uint32_t mip, const float priority)
+    {
+        std::lock_guard lock(s_StreamingMutex);
+        const auto it = s_StreamedTextures.find(texture.Raw());
+        if (it == s_StreamedTextures.end())
+            return;
+
+        StreamedTexture& entry = it->second;
+        mip = std::min(mip, entry.MipLevels - 1);
+        if (entry.LastUsedFrame != s_StreamingFrame)
+        {
+            entry.RequiredMip = mip;
+            entry.Priority = priority;
+        }
+        else
+        {
+            entry.RequiredMip = std::min(entry.RequiredMip, mip);
+            entry.Priority = std::max(entry.Priority, priority);
+        }
+        entry.LastUsedFrame = s_StreamingFrame;
+    }
+
+    void TextureStreamer::RequestMaterial(const Ref<Material>& material, const float uvPerPixel, const float priority)
+    {
+        for (const auto& texture : material->GetAllTextures())
+        {
+            if (!texture || texture->GetType() != TextureType::Texture2D)
+                continue;
+
+            // One texel per pixel, rounded towards the sharper level.
+            uint32_t mip = ~0u;
+            if (uvPerPixel > 0.0f)
+            {
+                const float texelsPerPixel = (float)std::max(texture->GetWidth(), texture->GetHeight()) * uvPerPixel;
+                mip = texelsPerPixel > 1.0f ? (uint32_t)std::floor(std::log2(texelsPerPixel)) : 0;
+            }
+
+            RequestMip(texture.As<Texture2D>(), mip, priority);
+        }
+    }
+
+    void TextureStreamer::MakeResident(const Ref<Texture2D>& texture)
+    {
+        // The file is read without the lock. When NextFrame evicted or started a read of the texture meanwhile,
+        // the levels no longer line up with the resident ones and are read again.
+        while (true)
+        {
+            fs::path filepath;
+            uint64_t offset = 0, size = 0;
+            uint32_t residentMip = 0;
+            {
+                std::lock_guard lock(s_StreamingMutex);
+                const auto it = s_StreamedTextures.find(texture.Raw());
+                if (it == s_StreamedTextures.end())
+                    return;
+
+                StreamedTexture& entry = it->second;
+                if (entry.PendingRead.valid())
+                    CompleteRead(entry, texture);
+                if (entry.ResidentMip == 0)
+                    return;
+
+                filepath = entry.FilePath;
+                offset = entry.PixelOffset;
+                residentMip = entry.ResidentMip;
+                size = entry.GetLevelsSize(0, residentMip);
+            }
+
+            Buffer levels = Utils::ReadLevels(filepath, offset, size);
+            if (!levels)
+            {
+                CZ_CORE_ERROR("Failed to read the mips of texture from {}", filepath.string());
+                return;
+            }
+
+            std::lock_guard lock(s_StreamingMutex);
+            const auto it = s_StreamedTextures.find(texture.Raw());
+            if (it != s_StreamedTextures.end() && it->second.ResidentMip == residentMip && !it->second.PendingRead.valid())
+            {
+                texture->StreamIn(0, levels);
+                s_StreamedSize += levels.Size;
+                it->second.ResidentMip = 0;
+                levels.Release();
+                return;
+            }
+
+            levels.Release();
+            if (it == s_StreamedTextures.end())
+                return;
+        }
+    }
+
+    uint32_t TextureStreamer::CopyToHostBuffer(const Ref<Texture2D>& texture, Buffer& buffer)
+    {
+        std::lock_guard lock(s_StreamingMutex);
+        texture->CopyToHostBuffer(buffer);
+        return texture->GetResidentMip();
+    }
+
+    void TextureStreamer::NextFrame()
+    {
+        // Declared before the lock, a texture whose last reference is dropped here unregisters after it's released.
+        std::vector<Ref<Texture2D>> textures;
+        std::lock_guard lock(s_StreamingMutex);
+        const auto& config = Renderer::GetConfig();
+        const uint64_t budget = config.TextureStreamingBudget;
+
+        s_AbandonedReads.erase(std::remove_if(s_AbandonedReads.begin(), s_AbandonedReads.end(), [](std::future<Buffer>& read) {
+            if (read.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+                return false;
+            read.get().Release();
+            return true;
+        }), s_AbandonedReads.end());
+
+        textures.reserve(s_StreamedTextures.size());
+        std::vector<StreamedTexture*> entries;
+        uint64_t residentSize = 0, pendingSize = 0, neededSize = 0;
+        uint32_t reads = 0;
+        for (auto& [key, entry] : s_StreamedTextures)
+        {
+            if (!entry.Texture.IsValid())
+                continue;
+
+            const Ref<Texture2D>& texture = textures.emplace_back(&*entry.Texture);
+            if (entry.PendingRead.valid() && entry.PendingRead.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+                CompleteRead(entry, texture);
+
+            const bool used = entry.LastUsedFrame == s_StreamingFrame;
+            residentSize += entry.GetLevelsSize(entry.ResidentMip, entry.MipLevels);
+            if (entry.PendingRead.valid())
+            {
+                pendingSize += entry.GetLevelsSize(entry.PendingMip, entry.ResidentMip);
+                reads++;
+            }
+            else if (used && entry.RequiredMip < entry.ResidentMip)
+            {
+                neededSize += entry.GetLevelsSize(entry.RequiredMip, entry.ResidentMip);
+            }
+            entries.push_back(&entry);
+        }
+
+        // Least recently used first, lower priority first among textures of the same frame.
+        std::sort(entries.begin(), entries.end(), [](const StreamedTexture* a, const StreamedTexture* b) {
+            if (a->LastUsedFrame != b->LastUsedFrame)
+                return a->LastUsedFrame < b->LastUsedFrame;
+            return a->Priority < b->Priority;
+        });
+
+        // Levels no mesh asked for make room for the requested ones, levels in use only go once the
+        // resident ones alone are over the budget (after it was lowered).
+        for (const bool inUse : { false, true })
+        {
+            for (StreamedTexture* entry : entries)
+            {
+                const uint64_t demand = residentSize + pendingSize + (inUse ? 0 : neededSize);
+                if (demand <= budget)
+                    break;
+                if (entry->PendingRead.valid())
+                    continue;
+
+                const bool used = entry->LastUsedFrame == s_StreamingFrame;
+                const uint32_t target = inUse || !used ? entry->MinResidentMip : std::min(entry->RequiredMip, entry->MinResidentMip);
+
+                uint32_t mip = entry->ResidentMip;
+                uint64_t freed = 0;
+                while (mip < target && demand - freed > budget)
+                {
+                    freed += entry->GetLevelsSize(mip, mip + 1);
+                    mip++;
+                }
+                if (mip == entry->ResidentMip)
+                    continue;
+
+                Ref<Texture2D>(&*entry->Texture)->Evict(mip);
+                entry->ResidentMip = mip;
+                residentSize -= freed;
+                s_EvictedSize += freed;
+            }
+        }
+
+        // Reads of the most important requests, as many of the missing levels as the budget has room for.
+        std::stable_sort(entries.begin(), entries.end(), [](const StreamedTexture* a, const StreamedTexture* b) {
+            return a->Priority > b->Priority;
+        });
+        for (StreamedTexture* entry : entries)
+        {
+            if (reads >= Utils::MaxStreamingReads)
+                break;
+            if (entry->PendingRead.valid() || entry->LastUsedFrame != s_StreamingFrame || entry->RequiredMip >= entry->ResidentMip)
+                continue;
+
+            uint32_t mip = entry->ResidentMip;
+            uint64_t size = 0;
+            while (mip > entry->RequiredMip && residentSize + pendingSize + size + entry->GetLevelsSize(mip - 1, mip) <= budget)
+            {
+                mip--;
+                size += entry->GetLevelsSize(mip, mip + 1);
+            }
+            if (mip == entry->ResidentMip)
+                continue;
+
+            const uint64_t offset = entry->PixelOffset + Image::GetMipChainSize(entry->Format, entry->Width, entry->Height, mip);
+            entry->PendingMip = mip;
+            auto read = std::make_shared<std::promise<Buffer>>();
+            entry->PendingRead = read->get_future();
+            Pool::Dispatch([read, filepath = entry->FilePath, offset, size]() {
+                read->set_value(Utils::ReadLevels(filepath, offset, size));
+            });
+            pendingSize += size;
+            reads++;
+        }
+
+        s_StreamingFrame++;
+    }
+
+    void TextureStreamer::Shutdown()
+    {
+        std::lock_guard lock(s_StreamingMutex);
+        for (auto& [key, entry] : s_StreamedTextures)
+        {
+            if (entry.PendingRead.valid())
+                entry.PendingRead.get().Release();
+        }
+        for (auto& read : s_AbandonedReads)
+            read.get().Release();
+
+        s_StreamedTextures.clear();
+        s_AbandonedReads.clear();
+    }
+
+    TextureStreamingStatistics TextureStreamer::GetStatistics()
+    {
+        std::lock_guard lock(s_StreamingMutex);
+
+        TextureStreamingStatistics stats;
+        stats.Budget = Renderer::GetConfig().TextureStreamingBudget;
+        stats.StreamedSize = s_StreamedSize;
+        stats.EvictedSize = s_EvictedSize;
+        stats.Textures.reserve(s_StreamedTextures.size());
+        for (const auto& [key, entry] : s_StreamedTextures)
+        {
+            auto& residency = stats.Textures.emplace_back();
+            residency.Name = entry.FilePath.stem().string();
+            residency.Width = entry.Width;
+            residency.Height = entry.Height;
+            residency.MipLevels = entry.MipLevels;
+            residency.ResidentMip = entry.ResidentMip;
+            residency.RequiredMip = entry.RequiredMip;
+            residency.ResidentSize = entry.GetLevelsSize(entry.ResidentMip, entry.MipLevels);
+            residency.IdleFrames = s_StreamingFrame - entry.LastUsedFrame;
+            residency.Streaming = entry.PendingRead.valid();
+
+            stats.ResidentSize += residency.ResidentSize;
+            stats.FullSize += entry.GetLevelsSize(0, entry.MipLevels);
+            stats.PendingReads += residency.Streaming ? 1 : 0;
+        }
+
+        return stats;
+    }
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "czpch.h"
+
+#include "Texture.h"
+#include "Material.h"
+
+namespace Chozo {
+
+    struct TextureStreamingStatistics
+    {
+        struct Residency
+        {
+            std::string Name;
+            uint32_t Width = 0, Height = 0;
+            uint32_t MipLevels = 0;
+            uint32_t ResidentMip = 0;
+            uint32_t RequiredMip = 0;
+            uint64_t ResidentSize = 0;
+            // Frames since a mesh last requested the texture.
+            uint64_t IdleFrames = 0;
+            bool Streaming = false;
+        };
+
+        uint64_t Budget = 0;
+        uint64_t ResidentSize = 0;
+        // What the same textures would take with every level resident.
+        uint64_t FullSize = 0;
+        uint32_t PendingReads = 0;
+        // Since startup.
+        uint64_t StreamedSize = 0;
+        uint64_t EvictedSize = 0;
+        std::vector<Residency> Textures;
+    };
+
+    // Keeps the large mips of textures loaded from asset files on disk until meshes on screen need them.
+    // Every frame the submitted meshes request the mip matching the texel density of their UVs on screen,
+    // the missing levels are read on worker threads and streamed in on the first frame after the read.
+    // Over the budget, the levels of the least recently used textures go first and lower priority first among
+    // textures used in the same frame, down to the levels read at load.
+    class TextureStreamer
+    {
+    public:
+        // Resident mip a texture with spec is loaded at, 0 when it isn't streamed.
+        static uint32_t GetInitialResidentMip(const Texture2DSpecification& spec);
+        // pixelOffset is where level 0 starts in filepath, the rest of the chain follows it like Image::GetMipChainSize.
+        static void Register(const Ref<Texture2D>& texture, const fs::path& filepath, uint64_t pixelOffset);
+        static void Unregister(const Texture2D* texture);
+
+        // The smallest mip requested within a frame wins, priority ranks the texture for reads and evictions.
+        static void RequestMip(const Ref<Texture2D>& texture, uint32_t mip, float priority);
+        // Streamed textures of material on a surface showing uvPerPixel UV units per screen pixel,
+        // 0 for surfaces without UVs, which only need the smallest level.
+        static void RequestMaterial(const Ref<Material>& material, float uvPerPixel, float priority);
+
+        // Reads the missing levels before returning, for saving the whole chain back to the asset file.
+        static void MakeResident(const Ref<Texture2D>& texture);
+        // Copies the host pixels of texture while no stream in or eviction changes them, returns the mip they start at.
+        static uint32_t CopyToHostBuffer(const Ref<Texture2D>& texture, Buffer& buffer);
+
+        // Streams in finished reads, evicts over the budget and starts the reads of last frame's requests.
+        static void NextFrame();
+        static void Shutdown();
+
+        static TextureStreamingStatistics GetStatistics();
+    };
+}
@@ -9,6 +9,8 @@ namespace Chozo {
     {
     public:
         virtual ~UniformBuffer() {}
+        // Writing from offset 0 starts a new version of the block, bytes past size are undefined until written.
+        // Earlier draws keep reading the version that was current when they were recorded.
         virtual void SetData(const void* data, uint32_t size, uint32_t offset = 0) = 0;
 
         virtual unsigned int GetBindingPoint() = 0;
@@ -8,7 +8,9 @@ namespace Chozo {
 
     enum class ShaderDataType
     {
-        None = 0, Float, Float2, Float3, Float4, Mat3, Mat4, Int, Int2, Int3, Int4, Bool
+        None = 0, Float, Float2, Float3, Float4, Mat3, Mat4, Int, Int2, Int3, Int4, Bool,
+        // Packed vertex attributes, read as floats in the shader (use Normalized for [0, 1] / [-1, 1]).
+        Half2, Short4, UShort4
     };
 
     static uint32_t ShaderDataTypeSize(ShaderDataType type)
@@ -27,6 +29,9 @@ namespace Chozo {
             case ShaderDataType::Int3:      return 4 * 3;
             case ShaderDataType::Int4:      return 4 * 4;
             case ShaderDataType::Bool:      return 1;
+            case ShaderDataType::Half2:     return 2 * 2;
+            case ShaderDataType::Short4:    return 2 * 4;
+            case ShaderDataType::UShort4:   return 2 * 4;
         }
 
         CZ_CORE_ASSERT(false, "Unknown ShaderDataType!");
@@ -64,6 +69,9 @@ namespace Chozo {
                 case ShaderDataType::Int3:      return 3;
                 case ShaderDataType::Int4:      return 4;
                 case ShaderDataType::Bool:      return 1;
+                case ShaderDataType::Half2:     return 2;
+                case ShaderDataType::Short4:    return 4;
+                case ShaderDataType::UShort4:   return 4;
             }
 
             CZ_CORE_ASSERT(false, "Unknown ShaderDataType!");
@@ -5,6 +5,7 @@
 #include "Chozo/Renderer/Material.h"
 #include "Chozo/Renderer/Geometry/Geometry.h"
 #include "Chozo/Renderer/Environment.h"
+#include "Chozo/Asset/AssetRef.h"
 #include "Chozo/Core/UUID.h"
 #include "Chozo/Math/Math.h"
 #include "SceneCamera.h"
@@ -155,7 +156,7 @@ namespace Chozo {
     {
         Ref<Mesh> MeshInstance;
 		uint32_t SubmeshIndex = 0;
-        AssetHandle MaterialHandle;
+        AssetRef<Material> MaterialHandle;
 
         MeshType Type = MeshType::Dynamic;
 
@@ -230,7 +231,7 @@ namespace Chozo {
         float Lod = 0.0f;
 
         bool Dynamic = true;
-        AssetHandle Source;
+        AssetRef<Texture2D> Source;
         glm::vec3 TurbidityAzimuthInclination = { 2.74f, 0.0f, 0.0f };
     };
 
@@ -254,6 +255,7 @@ namespace Chozo {
 	{
         glm::vec3 Color = { 1.0f, 1.0f, 1.0f };;
         float Intensity = 1.0f;
+        float Radius = 10.0f; // Attenuation cut-off, also bounds the light in the light grid.
 	};
 
     struct SpotLightComponent : Component
@@ -264,5 +266,6 @@ namespace Chozo {
 		float AngleAttenuation = 5.0f;
         glm::vec3 Color = { 1.0f, 1.0f, 1.0f };;
 		float Angle = 10.0f;
+        float Radius = 10.0f;
 	};
 }
@@ -255,11 +255,11 @@ namespace Chozo {
 
                     Ref<TextureCube> radiance = Renderer::GetPreethamSkyTextureCube();
                     skyLight.SceneEnvironment = Ref<Environment>::Create(radiance, radiance);
-                } else if (skyLight.Source != 0)
+                } else if (skyLight.Source.IsSet())
                 {
                     if (!skyLight.SceneEnvironment)
                     {
-                        Ref<Texture2D> texture = Application::GetAssetManager()->GetAsset(skyLight.Source);
+                        const auto& texture = skyLight.Source.Get();
                         if (texture)
                             Renderer::CreateStaticSky(texture);
                     }
@@ -315,6 +315,40 @@ namespace Chozo {
         }
     }
 
+    uint32_t Scene::SelectSubmeshLOD(const Submesh& submesh, const glm::mat4& transform, const EditorCamera& camera, uint32_t currentLOD)
+    {
+        const auto& config = Renderer::GetConfig();
+        uint32_t lodCount = submesh.GetLODCount();
+        if (!config.EnableMeshLOD || lodCount == 1)
+            return 0;
+
+        // Bounding sphere of the submesh in world space.
+        glm::vec3 center = (submesh.BoundingBox.Min + submesh.BoundingBox.Max) * 0.5f;
+        float radius = glm::length(submesh.BoundingBox.Max - submesh.BoundingBox.Min) * 0.5f;
+        float scale = glm::max(glm::length(glm::vec3(transform[0])), glm::max(glm::length(glm::vec3(transform[1])), glm::length(glm::vec3(transform[2]))));
+        radius *= scale;
+
+        glm::vec4 viewCenter = camera.GetViewMatrix() * transform * glm::vec4(center, 1.0f);
+        float depth = -viewCenter.z;
+        if (depth <= radius)
+            return 0;
+
+        // Projected sphere height as a fraction of the viewport height.
+        float coverage = radius * camera.GetProjection()[1][1] / depth;
+
+        auto threshold = [&config](uint32_t lod) {
+            return config.LODScreenSize * glm::pow(0.5f, (float)(lod - 1));
+        };
+
+        uint32_t lod = glm::min(currentLOD, lodCount - 1);
+        while (lod + 1 < lodCount && coverage < threshold(lod + 1) * (1.0f - config.LODHysteresis))
+            lod++;
+        while (lod > 0 && coverage > threshold(lod) * (1.0f + config.LODHysteresis))
+            lod--;
+
+        return lod;
+    }
+
     void Scene::SubmitMeshes(Ref<SceneRenderer> renderer)
     {
         auto view = m_Registry.view<TransformComponent, MeshComponent>();
@@ -329,10 +363,13 @@ namespace Chozo {
             {
                 Entity e = Entity(entity, this);
                 Ref<DynamicMesh> dynamicMesh = mesh.MeshInstance.As<DynamicMesh>();
-                auto material = Application::GetAssetManager()->GetAsset(mesh.MaterialHandle);
+                const auto& material = mesh.MaterialHandle.Get();
                 auto transform = GetWorldSpaceTransformMatrix(e);
-                
-                renderer->SubmitMesh(dynamicMesh, mesh.SubmeshIndex, material, transform, (uint64_t)entity);
+
+                const auto& submesh = dynamicMesh->GetMeshSource()->GetSubmeshes()[mesh.SubmeshIndex];
+                const uint32_t lod = SelectSubmeshLOD(submesh, transform, renderer->GetSceneCamera(), renderer->GetSubmittedLOD((uint64_t)entity));
+
+                renderer->SubmitMesh(dynamicMesh, mesh.SubmeshIndex, material, transform, (uint64_t)entity, lod);
             }
             else if (mesh.Type == MeshType::Static)
             {
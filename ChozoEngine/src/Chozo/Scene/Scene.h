@@ -14,6 +14,7 @@ namespace Chozo {
 
     class Entity;
     class SceneRenderer;
+    class Submesh;
 
 	using EntityMap = std::unordered_map<UUID, Entity>;
 
@@ -53,6 +54,8 @@ namespace Chozo {
 
         void PrepareRender(Ref<SceneRenderer> renderer);
         void SubmitMeshes(Ref<SceneRenderer> renderer);
+        // Picks a LOD from the projected size of the submesh bounds, with hysteresis around currentLOD.
+        static uint32_t SelectSubmeshLOD(const Submesh& submesh, const glm::mat4& transform, const EditorCamera& camera, uint32_t currentLOD);
 
         Entity GetPrimaryCameraEntity();
 
@@ -40,6 +40,12 @@ namespace Chozo {
             return "../caches/thumbnail";
         }
 
+        static const char* GetIBLCacheDirectory()
+        {
+            // TODO: make sure the assets directory is valid
+            return "../caches/ibl";
+        }
+
         static void CreateDirectoryIfNeeded(std::string directory)
         {
             if (!fs::exists(directory))
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <string_view>
+
+namespace Chozo::Utils {
+
+    namespace Hash {
+
+        constexpr uint64_t FNVOffsetBasis = 14695981039346656037ull;
+        constexpr uint64_t FNVPrime = 1099511628211ull;
+
+        // 64-bit FNV-1a, pass a previous result as seed to hash several buffers in sequence.
+        inline uint64_t FNV1a(const void* data, const size_t size, uint64_t seed = FNVOffsetBasis)
+        {
+            const auto* bytes = static_cast<const uint8_t*>(data);
+            for (size_t i = 0; i < size; i++)
+            {
+                seed ^= bytes[i];
+                seed *= FNVPrime;
+            }
+            return seed;
+        }
+
+        inline uint64_t FNV1a(const std::string_view string, const uint64_t seed = FNVOffsetBasis)
+        {
+            return FNV1a(string.data(), string.size(), seed);
+        }
+
+        inline std::string ToHexString(const uint64_t hash)
+        {
+            return fmt::format("{:016x}", hash);
+        }
+    }
+}
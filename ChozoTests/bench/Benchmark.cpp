@@ -0,0 +1,37 @@
+#include "Benchmark.h"
+
+namespace Chozo::Benchmark {
+
+    std::map<std::string, BenchmarkFunc>& GetRegistry()
+    {
+        static std::map<std::string, BenchmarkFunc> registry;
+        return registry;
+    }
+}
+
+// ChozoBenchmarks [name], runs every benchmark without a name. Results are printed, nothing is asserted.
+int main(const int argc, char** argv)
+{
+    Chozo::Log::Init();
+
+    const auto& registry = Chozo::Benchmark::GetRegistry();
+    if (argc > 1)
+    {
+        const auto it = registry.find(argv[1]);
+        if (it == registry.end())
+        {
+            fmt::print("Unknown benchmark {}\n", argv[1]);
+            return 1;
+        }
+        fmt::print("[ RUN  ] {}\n", it->first);
+        it->second();
+        return 0;
+    }
+
+    for (const auto& [name, func] : registry)
+    {
+        fmt::print("[ RUN  ] {}\n", name);
+        func();
+    }
+    return 0;
+}
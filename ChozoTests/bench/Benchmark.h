@@ -0,0 +1,22 @@
+#pragma once
+
+#include "czpch.h"
+
+#include <map>
+
+namespace Chozo::Benchmark {
+
+    using BenchmarkFunc = void(*)();
+
+    std::map<std::string, BenchmarkFunc>& GetRegistry();
+
+    struct Registrar
+    {
+        Registrar(const char* name, const BenchmarkFunc func) { GetRegistry()[name] = func; }
+    };
+}
+
+#define CZ_BENCHMARK(name) \
+    static void name(); \
+    static ::Chozo::Benchmark::Registrar s_##name##Registrar(#name, name); \
+    static void name()
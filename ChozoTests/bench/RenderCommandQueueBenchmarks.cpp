@@ -0,0 +1,64 @@
+#include "Benchmark.h"
+
+#include "Chozo/Core/Timer.h"
+#include "Chozo/Renderer/RenderCommandQueue.h"
+
+#include <glm/glm.hpp>
+
+namespace Chozo {
+
+    // 100k submits and executes through the command queue against a vector of std::function.
+    CZ_BENCHMARK(RenderCommandQueueSubmitExecute)
+    {
+        constexpr uint32_t count = 100000;
+
+        // Typical draw capture: a few refs, an index and a transform.
+        struct Payload
+        {
+            glm::mat4 Transform;
+            uint64_t Handles[4];
+            uint32_t Index;
+        };
+
+        Payload payload{};
+        uint64_t sink = 0;
+
+        float functionSubmit, functionExecute;
+        {
+            std::vector<std::function<void()>> queue;
+            Timer timer;
+            for (uint32_t i = 0; i < count; i++)
+            {
+                payload.Index = i;
+                queue.emplace_back([payload, &sink]() { sink += payload.Index + (uint64_t)payload.Transform[0][0]; });
+            }
+            functionSubmit = timer.ElapsedMillis();
+
+            timer.Reset();
+            for (auto& cmd : queue)
+                cmd();
+            queue.clear();
+            functionExecute = timer.ElapsedMillis();
+        }
+
+        float queueSubmit, queueExecute;
+        {
+            RenderCommandQueue queue;
+            Timer timer;
+            for (uint32_t i = 0; i < count; i++)
+            {
+                payload.Index = i;
+                queue.Submit([payload, &sink]() { sink += payload.Index + (uint64_t)payload.Transform[0][0]; });
+            }
+            queueSubmit = timer.ElapsedMillis();
+
+            timer.Reset();
+            queue.Execute();
+            queueExecute = timer.ElapsedMillis();
+        }
+
+        fmt::print("  {} commands, checksum {}\n", count, sink);
+        fmt::print("  std::function      submit {:.3f}ms, execute {:.3f}ms\n", functionSubmit, functionExecute);
+        fmt::print("  RenderCommandQueue submit {:.3f}ms, execute {:.3f}ms\n", queueSubmit, queueExecute);
+    }
+}
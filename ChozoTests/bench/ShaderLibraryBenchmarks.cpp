@@ -0,0 +1,32 @@
+#include "Benchmark.h"
+#include "GLTestContext.h"
+
+#include "Chozo/Core/Pool.h"
+#include "Chozo/Core/Timer.h"
+#include "Chozo/Renderer/Renderer.h"
+
+namespace Chozo {
+
+    // Startup shader load, run from the editor's working directory so the shader and cache paths resolve. The first
+    // load is cold only when the shader cache is empty, the second one always hits the SPIR-V and program binaries.
+    CZ_BENCHMARK(ShaderLibraryLoad)
+    {
+        const Test::GLTestContext context;
+        if (!context.IsValid())
+        {
+            fmt::print("  skipped, no OpenGL 4.1 context\n");
+            return;
+        }
+
+        // Sources compile on the pool's workers, like they do in the editor.
+        const auto pool = Ref<Pool>::Create();
+        const auto specs = Renderer::GetShaderSpecifications();
+        for (const char* pass : { "first", "cached" })
+        {
+            const auto library = ShaderLibrary::Create();
+            const Timer timer;
+            library->Load(specs);
+            fmt::print("  {} load of {} shaders: {:.1f}ms\n", pass, specs.size(), timer.ElapsedMillis());
+        }
+    }
+}
@@ -0,0 +1,60 @@
+#include "GLTestContext.h"
+
+#include "Chozo/Renderer/RenderCommand.h"
+#include "Chozo/Renderer/Backend/OpenGL/OpenGLShaderCompiler.h"
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+namespace Chozo::Test {
+
+    GLTestContext::GLTestContext()
+    {
+        if (!glfwInit())
+            return;
+
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 1);
+        glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+        glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
+        m_Window = glfwCreateWindow(64, 64, "ChozoTests", nullptr, nullptr);
+        if (!m_Window)
+        {
+            glfwTerminate();
+            return;
+        }
+
+        glfwMakeContextCurrent(m_Window);
+        if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+        {
+            glfwDestroyWindow(m_Window);
+            glfwTerminate();
+            m_Window = nullptr;
+            return;
+        }
+
+        if (RenderCommand::GetType() != RenderAPI::Type::OpenGL)
+            RenderCommand::SwitchAPI(RenderAPI::Type::OpenGL);
+        OpenGLShaderCompiler::InitProgramBinaryCache();
+    }
+
+    GLTestContext::~GLTestContext()
+    {
+        if (!m_Window)
+            return;
+
+        glfwMakeContextCurrent(nullptr);
+        glfwDestroyWindow(m_Window);
+        glfwTerminate();
+    }
+
+    std::string GLTestContext::GetRenderer() const
+    {
+        if (!m_Window)
+            return {};
+
+        return (const char*)glGetString(GL_RENDERER);
+    }
+}
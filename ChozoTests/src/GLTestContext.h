@@ -0,0 +1,25 @@
+#pragma once
+
+#include "czpch.h"
+
+struct GLFWwindow;
+
+namespace Chozo::Test {
+
+    // Hidden window with an OpenGL 4.1 core context current on the calling thread, the engine's backend is selected
+    // and the program binary cache initialized. IsValid() is false on machines without a GL driver, tests skip then.
+    class GLTestContext
+    {
+    public:
+        GLTestContext();
+        ~GLTestContext();
+
+        GLTestContext(const GLTestContext&) = delete;
+        GLTestContext& operator=(const GLTestContext&) = delete;
+
+        bool IsValid() const { return m_Window != nullptr; }
+        std::string GetRenderer() const;
+    private:
+        GLFWwindow* m_Window = nullptr;
+    };
+}
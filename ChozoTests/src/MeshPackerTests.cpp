@@ -0,0 +1,63 @@
+#include "Test.h"
+
+#include "Chozo/Renderer/MeshPacker.h"
+
+#include <cfloat>
+
+namespace Chozo {
+
+    // Two quads of different size sharing the edge x = 1, each submesh with its own copy of the edge vertices.
+    CZ_TEST(MeshPackerQuantizesSharedEdges)
+    {
+        const std::vector<glm::vec3> positions = {
+            { 0.0f, 0.0f, 0.0f }, { 1.0f, 0.0f, 0.0f }, { 1.0f, 0.37f, 0.0f }, { 0.0f, 0.37f, 0.0f },
+            { 1.0f, 0.0f, 0.0f }, { 7.3f, 0.0f, 0.0f }, { 7.3f, 0.37f, 2.9f }, { 1.0f, 0.37f, 0.0f }
+        };
+
+        std::vector<Vertex> vertexs(positions.size());
+        for (size_t i = 0; i < positions.size(); i++)
+        {
+            vertexs[i].Position = positions[i];
+            vertexs[i].Normal = { 0.0f, 0.0f, 1.0f };
+            vertexs[i].Tangent = { 1.0f, 0.0f, 0.0f };
+            vertexs[i].Binormal = { 0.0f, 1.0f, 0.0f };
+            vertexs[i].TexCoord = { 0.0f, 0.0f };
+        }
+
+        std::vector<Submesh> submeshes(2);
+        for (uint32_t s = 0; s < 2; s++)
+        {
+            auto& submesh = submeshes[s];
+            submesh.BaseVertex = s * 4;
+            submesh.VertexCount = 4;
+            submesh.BaseIndex = s * 6;
+            submesh.IndexCount = 6;
+            submesh.MaterialIndex = 0;
+            submesh.BoundingBox.Min = glm::vec3(FLT_MAX);
+            submesh.BoundingBox.Max = glm::vec3(-FLT_MAX);
+            for (uint32_t v = submesh.BaseVertex; v < submesh.BaseVertex + 4; v++)
+            {
+                submesh.BoundingBox.Min = glm::min(submesh.BoundingBox.Min, positions[v]);
+                submesh.BoundingBox.Max = glm::max(submesh.BoundingBox.Max, positions[v]);
+            }
+        }
+
+        const VertexFormat format = MeshPacker::ChooseVertexFormat(vertexs, submeshes);
+        CZ_CHECK(format == VertexFormat::Quantized);
+
+        const auto unpacked = MeshPacker::UnpackVertices(MeshPacker::PackVertices(vertexs, submeshes, format), submeshes, format);
+        CZ_CHECK(unpacked.size() == vertexs.size());
+
+        // The copies of the shared edge decode to exactly the same point, not just nearby ones.
+        CZ_CHECK(unpacked[1].Position == unpacked[4].Position);
+        CZ_CHECK(unpacked[2].Position == unpacked[7].Position);
+
+        glm::vec3 offset, scale;
+        MeshPacker::GetPositionTransform(submeshes, format, offset, scale);
+        for (size_t i = 0; i < vertexs.size(); i++)
+        {
+            const glm::vec3 error = glm::abs(unpacked[i].Position - vertexs[i].Position);
+            CZ_CHECK_MSG(glm::all(glm::lessThanEqual(error, scale / 65535.0f)), "vertex {}", i);
+        }
+    }
+}
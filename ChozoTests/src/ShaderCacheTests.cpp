@@ -0,0 +1,96 @@
+#include "Test.h"
+#include "GLTestContext.h"
+
+#include "Chozo/Renderer/Backend/OpenGL/OpenGLShaderCompiler.h"
+
+#include <fstream>
+
+namespace Chozo {
+
+    namespace Utils {
+
+        // Runs the test from a fresh scratch directory, so the relative shader cache lands in it and starts empty.
+        class ScopedScratchDirectory
+        {
+        public:
+            ScopedScratchDirectory()
+                : m_PreviousPath(fs::current_path())
+            {
+                const auto stamp = std::chrono::steady_clock::now().time_since_epoch().count();
+                m_Root = fs::temp_directory_path() / fmt::format("ChozoTests-{}", stamp);
+                fs::create_directories(m_Root / "work");
+                fs::current_path(m_Root / "work");
+            }
+
+            ~ScopedScratchDirectory()
+            {
+                std::error_code error;
+                fs::current_path(m_PreviousPath, error);
+                fs::remove_all(m_Root, error);
+            }
+
+            fs::path Write(const std::string& fileName, const std::string& source) const
+            {
+                const fs::path path = m_Root / fileName;
+                std::ofstream(path) << source;
+                return path;
+            }
+        private:
+            fs::path m_PreviousPath;
+            fs::path m_Root;
+        };
+
+        static bool IsLinked(const RendererID program)
+        {
+            GLint isLinked = GL_FALSE;
+            glGetProgramiv(program, GL_LINK_STATUS, &isLinked);
+            return isLinked == GL_TRUE;
+        }
+    }
+
+    // The first compile saves the program binary, a second compiler of the same sources links from it.
+    CZ_TEST(ShaderProgramBinaryRoundTrip)
+    {
+        const Test::GLTestContext context;
+        if (!context.IsValid())
+            CZ_SKIP("no OpenGL 4.1 context");
+
+        GLint formatCount = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+        if (formatCount == 0)
+            CZ_SKIP("{} exposes no program binary formats", context.GetRenderer());
+
+        const Utils::ScopedScratchDirectory scratch;
+        const std::vector<std::string> filePaths = {
+            scratch.Write("RoundTrip.glsl.vert",
+                "#version 450\n"
+                "layout(location = 0) in vec3 a_Position;\n"
+                "void main() { gl_Position = vec4(a_Position, 1.0); }\n").string(),
+            scratch.Write("RoundTrip.glsl.frag",
+                "#version 450\n"
+                "layout(location = 0) out vec4 o_Color;\n"
+                "void main() { o_Color = vec4(1.0, 0.5, 0.25, 1.0); }\n").string()
+        };
+
+        std::string name = "RoundTrip";
+        OpenGLShaderCompiler first(name);
+        first.CompileSources(filePaths);
+        CZ_CHECK(!first.HasProgramBinary());
+
+        const RendererID compiled = first.Link();
+        CZ_CHECK(compiled != 0 && Utils::IsLinked(compiled));
+        CZ_CHECK_MSG(fs::exists(first.GetProgramCachePath()), "{} was not written", first.GetProgramCachePath().string());
+
+        OpenGLShaderCompiler second(name);
+        second.CompileSources(filePaths);
+        CZ_CHECK(second.HasProgramBinary());
+        CZ_CHECK(second.GetProgramCachePath() == first.GetProgramCachePath());
+
+        const RendererID loaded = second.Link();
+        CZ_CHECK(loaded != 0 && Utils::IsLinked(loaded));
+        CZ_CHECK_MSG(second.HasProgramBinary(), "{} rejected its own program binary", context.GetRenderer());
+
+        glDeleteProgram(compiled);
+        glDeleteProgram(loaded);
+    }
+}
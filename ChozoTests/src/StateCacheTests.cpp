@@ -0,0 +1,109 @@
+#include "Test.h"
+#include "GLTestContext.h"
+
+#include "Chozo/Core/Application.h"
+#include "Chozo/Renderer/SceneRenderer.h"
+#include "Chozo/Renderer/Geometry/SphereGeometry.h"
+#include "Chozo/Renderer/Backend/OpenGL/OpenGLStateCache.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace Chozo {
+
+    // Binding what is already bound is dropped and counted, the GL binding still ends up as requested.
+    CZ_TEST(StateCacheFiltersRedundantBinds)
+    {
+        const Test::GLTestContext context;
+        if (!context.IsValid())
+            CZ_SKIP("no OpenGL 4.1 context");
+
+        OpenGLStateCache::Invalidate();
+        OpenGLStateCache::ResetCallCounts();
+
+        GLuint vertexArray = 0, texture = 0;
+        glGenVertexArrays(1, &vertexArray);
+        glGenTextures(1, &texture);
+
+        OpenGLStateCache::BindVertexArray(vertexArray);
+        OpenGLStateCache::BindTextureUnit(0, GL_TEXTURE_2D, texture);
+        CZ_CHECK_MSG(OpenGLStateCache::GetFilteredCallCount() == 0, "{} first binds were dropped", OpenGLStateCache::GetFilteredCallCount());
+
+        OpenGLStateCache::BindVertexArray(vertexArray);
+        OpenGLStateCache::BindTextureUnit(0, GL_TEXTURE_2D, texture);
+        OpenGLStateCache::BindVertexArray(vertexArray);
+        CZ_CHECK_MSG(OpenGLStateCache::GetFilteredCallCount() == 3, "{} of 3 redundant binds were dropped", OpenGLStateCache::GetFilteredCallCount());
+
+        GLint bound = 0;
+        glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &bound);
+        CZ_CHECK((GLuint)bound == vertexArray);
+        glGetIntegerv(GL_TEXTURE_BINDING_2D, &bound);
+        CZ_CHECK((GLuint)bound == texture);
+
+        // After an invalidate the shadow knows nothing, the same bind reaches GL again.
+        OpenGLStateCache::Invalidate();
+        OpenGLStateCache::BindVertexArray(vertexArray);
+        CZ_CHECK(OpenGLStateCache::GetFilteredCallCount() == 3);
+
+        OpenGLStateCache::OnVertexArrayDeleted(vertexArray);
+        OpenGLStateCache::OnTextureDeleted(texture);
+        glDeleteVertexArrays(1, &vertexArray);
+        glDeleteTextures(1, &texture);
+        OpenGLStateCache::Invalidate();
+    }
+
+    // A grid of lit spheres through the scene renderer, the same frame once with the cache and once without it.
+    // Every pass sets its program, target and textures again for each mesh, the cache has to cut what reaches GL.
+    CZ_TEST(StateCacheReducesSceneCalls)
+    {
+        {
+            const Test::GLTestContext context;
+            if (!context.IsValid())
+                CZ_SKIP("no OpenGL 4.1 context");
+        }
+
+        // The scene renderer's materials resolve their textures through the application's asset manager.
+        Application application("ChozoTests");
+        RenderThread& renderThread = application.GetRenderThread();
+        // Culled meshlets would make the draws depend on the camera.
+        Renderer::GetConfig().EnableMeshletCulling = false;
+
+        const auto sceneRenderer = Ref<SceneRenderer>::Create(Ref<Scene>::Create());
+        sceneRenderer->SetActive(true);
+        sceneRenderer->SetViewportSize(128.0f, 128.0f);
+        EditorCamera camera(30.0f, 1.0f, 0.1f, 1000.0f);
+
+        const Ref<Geometry> sphere = Geometry::Create<SphereGeometry>();
+        const auto mesh = Ref<DynamicMesh>::Create(sphere->GetMeshSource());
+        const Ref<Material> material = Material::Create("Lit");
+
+        // The calls of a frame are counted from its BeginFrame on, on this thread since it executes the queue.
+        const auto renderFrame = [&]() {
+            Renderer::Begin();
+            sceneRenderer->BeginScene(camera);
+            for (uint32_t i = 0; i < 16; i++)
+            {
+                const glm::vec3 position((float)(i % 4) * 2.5f - 3.75f, (float)(i / 4) * 2.5f - 3.75f, -20.0f);
+                sceneRenderer->SubmitMesh(mesh, 0, material, glm::translate(glm::mat4(1.0f), position), i);
+            }
+            sceneRenderer->EndScene();
+            renderThread.Pump();
+        };
+
+        // Links the variants and allocates the pass targets, the measured frames only draw.
+        renderFrame();
+
+        OpenGLStateCache::SetEnabled(true);
+        renderFrame();
+        const uint32_t cachedCalls = OpenGLStateCache::GetIssuedCallCount();
+        const uint32_t filteredCalls = OpenGLStateCache::GetFilteredCallCount();
+
+        OpenGLStateCache::SetEnabled(false);
+        renderFrame();
+        const uint32_t uncachedCalls = OpenGLStateCache::GetIssuedCallCount();
+        CZ_CHECK(OpenGLStateCache::GetFilteredCallCount() == 0);
+        OpenGLStateCache::SetEnabled(true);
+
+        CZ_CHECK_MSG(filteredCalls > 0, "no state call of the scene was dropped");
+        CZ_CHECK_MSG(cachedCalls < uncachedCalls, "{} state calls reached GL with the cache, {} without it", cachedCalls, uncachedCalls);
+    }
+}
@@ -0,0 +1,57 @@
+#include "Test.h"
+
+namespace Chozo::Test {
+
+    std::map<std::string, TestFunc>& GetRegistry()
+    {
+        static std::map<std::string, TestFunc> registry;
+        return registry;
+    }
+
+    static int Run(const std::string& name, const TestFunc func)
+    {
+        try
+        {
+            func();
+        }
+        catch (const Skip& skip)
+        {
+            fmt::print("[ SKIP ] {}: {}\n", name, skip.Reason);
+            return SkipReturnCode;
+        }
+        catch (const Failure& failure)
+        {
+            fmt::print("[ FAIL ] {}: {}\n", name, failure.Message);
+            return 1;
+        }
+
+        fmt::print("[  OK  ] {}\n", name);
+        return 0;
+    }
+}
+
+// ChozoTests [name], runs every test without a name.
+int main(const int argc, char** argv)
+{
+    Chozo::Log::Init();
+
+    const auto& registry = Chozo::Test::GetRegistry();
+    if (argc > 1)
+    {
+        const auto it = registry.find(argv[1]);
+        if (it == registry.end())
+        {
+            fmt::print("Unknown test {}\n", argv[1]);
+            return 1;
+        }
+        return Chozo::Test::Run(it->first, it->second);
+    }
+
+    int result = 0;
+    for (const auto& [name, func] : registry)
+    {
+        if (Chozo::Test::Run(name, func) == 1)
+            result = 1;
+    }
+    return result;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "czpch.h"
+
+#include <map>
+
+namespace Chozo::Test {
+
+    using TestFunc = void(*)();
+
+    struct Failure
+    {
+        std::string Message;
+    };
+
+    // Returned by a test that can't run on this machine, CTest reports it as skipped.
+    static constexpr int SkipReturnCode = 77;
+
+    struct Skip
+    {
+        std::string Reason;
+    };
+
+    std::map<std::string, TestFunc>& GetRegistry();
+
+    struct Registrar
+    {
+        Registrar(const char* name, const TestFunc func) { GetRegistry()[name] = func; }
+    };
+}
+
+#define CZ_TEST(name) \
+    static void name(); \
+    static ::Chozo::Test::Registrar s_##name##Registrar(#name, name); \
+    static void name()
+
+#define CZ_CHECK(condition) \
+    do { if (!(condition)) throw ::Chozo::Test::Failure{ fmt::format("{}:{}: CHECK({}) failed", __FILE__, __LINE__, #condition) }; } while (false)
+
+#define CZ_CHECK_MSG(condition, ...) \
+    do { if (!(condition)) throw ::Chozo::Test::Failure{ fmt::format("{}:{}: CHECK({}) failed, {}", __FILE__, __LINE__, #condition, fmt::format(__VA_ARGS__)) }; } while (false)
+
+#define CZ_SKIP(...) throw ::Chozo::Test::Skip{ fmt::format(__VA_ARGS__) }
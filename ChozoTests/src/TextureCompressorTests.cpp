@@ -0,0 +1,94 @@
+#include "Test.h"
+
+#include "Chozo/Renderer/TextureCompressor.h"
+
+#include <cmath>
+
+namespace Chozo {
+
+    namespace Utils {
+
+        static constexpr uint32_t ImageSize = 64;
+
+        // Smooth color waves with a sawtooth alpha, no block is flat.
+        static std::vector<uint8_t> MakeColorImage()
+        {
+            std::vector<uint8_t> pixels(ImageSize * ImageSize * 4);
+            for (uint32_t y = 0; y < ImageSize; y++)
+            {
+                for (uint32_t x = 0; x < ImageSize; x++)
+                {
+                    uint8_t* pixel = &pixels[(y * ImageSize + x) * 4];
+                    pixel[0] = (uint8_t)(128.0f + 100.0f * std::sin((float)x * 0.1f));
+                    pixel[1] = (uint8_t)(128.0f + 100.0f * std::cos((float)y * 0.13f));
+                    pixel[2] = (uint8_t)(128.0f + 90.0f * std::sin((float)(x + y) * 0.05f));
+                    pixel[3] = (uint8_t)(255 - (x % 32) * 4);
+                }
+            }
+            return pixels;
+        }
+
+        // Tangent space normals tilting up to 0.4 along both axes.
+        static std::vector<uint8_t> MakeNormalMap()
+        {
+            std::vector<uint8_t> pixels(ImageSize * ImageSize * 4);
+            for (uint32_t y = 0; y < ImageSize; y++)
+            {
+                for (uint32_t x = 0; x < ImageSize; x++)
+                {
+                    const float nx = 0.4f * std::sin((float)x * 0.15f), ny = 0.4f * std::cos((float)y * 0.11f);
+                    const float nz = std::sqrt(1.0f - nx * nx - ny * ny);
+                    uint8_t* pixel = &pixels[(y * ImageSize + x) * 4];
+                    pixel[0] = (uint8_t)std::lround((nx * 0.5f + 0.5f) * 255.0f);
+                    pixel[1] = (uint8_t)std::lround((ny * 0.5f + 0.5f) * 255.0f);
+                    pixel[2] = (uint8_t)std::lround((nz * 0.5f + 0.5f) * 255.0f);
+                    pixel[3] = 255;
+                }
+            }
+            return pixels;
+        }
+
+        static float EncodeAndMeasure(const std::vector<uint8_t>& pixels, const ImageFormat format, const TextureCompressionQuality quality, const uint32_t channelCount)
+        {
+            Buffer blocks = TextureCompressor::Compress(pixels.data(), ImageSize, ImageSize, format, quality);
+            Buffer decoded = TextureCompressor::Decompress(blocks.Data, ImageSize, ImageSize, format);
+            const float psnr = TextureCompressor::ComputePSNR(pixels.data(), static_cast<const uint8_t*>(decoded.Data), (uint64_t)ImageSize * ImageSize, channelCount);
+            blocks.Release();
+            decoded.Release();
+            return psnr;
+        }
+    }
+
+    // Round trips through every format and quality, the thresholds sit about 1.5 dB under what the encoders reach.
+    CZ_TEST(TextureCompressorPSNR)
+    {
+        struct Case
+        {
+            const char* Name;
+            ImageFormat Format;
+            TextureCompressionQuality Quality;
+            bool Normals;
+            uint32_t ChannelCount;
+            float MinPSNR;
+        };
+
+        const Case cases[] = {
+            { "BC1 fast", ImageFormat::BC1, TextureCompressionQuality::Fast, false, 3, 33.0f },
+            { "BC1 high", ImageFormat::BC1, TextureCompressionQuality::High, false, 3, 33.0f },
+            { "BC3 fast", ImageFormat::BC3, TextureCompressionQuality::Fast, false, 4, 34.0f },
+            { "BC3 high", ImageFormat::BC3, TextureCompressionQuality::High, false, 4, 34.0f },
+            // Only x and y are stored, z is rebuilt when decoding.
+            { "BC5", ImageFormat::BC5, TextureCompressionQuality::Fast, true, 2, 52.0f },
+            { "BC7 fast", ImageFormat::BC7, TextureCompressionQuality::Fast, false, 4, 34.0f },
+            { "BC7 high", ImageFormat::BC7, TextureCompressionQuality::High, false, 4, 34.0f },
+        };
+
+        const auto color = Utils::MakeColorImage();
+        const auto normals = Utils::MakeNormalMap();
+        for (const auto& test : cases)
+        {
+            const float psnr = Utils::EncodeAndMeasure(test.Normals ? normals : color, test.Format, test.Quality, test.ChannelCount);
+            CZ_CHECK_MSG(psnr >= test.MinPSNR, "{} reached {:.2f} dB, expected at least {:.1f} dB", test.Name, psnr, test.MinPSNR);
+        }
+    }
+}